@@ -83,6 +83,7 @@ namespace GlacirerEditor
         m_MainPanel.RenderGUI(world);
         m_ResourcesPanel->RenderGUI();
         m_StatisticsWindow.RenderGUI();
+        m_MemoryWindow.RenderGUI();
     }
 
     void Editor::UpdateSelectedGameObject(const Glacirer::World& world)
@@ -26,12 +26,22 @@ namespace GlacirerEditor
 
             ImGui::Text("Mesh: %s", meshName.c_str());
 
+            if(mesh && mesh->GetTotalLODs() > 1)
+            {
+                ImGui::Text("LOD: %d / %d", meshComponent->GetLOD(), mesh->GetTotalLODs() - 1);
+            }
+
             RenderMaterialGUI(*meshComponent);
 
             bool bIsOutlined = meshComponent->IsOutlined();
             ImGui::Checkbox("Outlined", &bIsOutlined);
 
             meshComponent->SetIsOutlined(bIsOutlined);
+
+            bool bIsOccluder = meshComponent->IsOccluder();
+            ImGui::Checkbox("Occluder", &bIsOccluder);
+
+            meshComponent->SetIsOccluder(bIsOccluder);
         }
 
         int MeshComponentInspector::GetComponentHash()
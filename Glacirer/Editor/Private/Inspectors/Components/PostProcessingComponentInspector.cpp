@@ -27,6 +27,28 @@ namespace GlacirerEditor
             bool bIsBlurEnabled = postProcessing->IsBlurEnabled();
             ImGui::Checkbox("Blur", &bIsBlurEnabled);
 
+            const char* resolutions[] = { "Full", "Half", "Quarter" };
+            int blurResolutionIndex = static_cast<int>(postProcessing->GetBlurResolution());
+
+            if(ImGui::BeginCombo("Blur Resolution", resolutions[blurResolutionIndex]))
+            {
+                for(int i = 0; i < IM_ARRAYSIZE(resolutions); i++)
+                {
+                    const bool isSelected = blurResolutionIndex == i;
+                    if(ImGui::Selectable(resolutions[i], isSelected))
+                    {
+                        blurResolutionIndex = i;
+                    }
+
+                    if(isSelected)
+                    {
+                        ImGui::SetItemDefaultFocus();
+                    }
+                }
+
+                ImGui::EndCombo();
+            }
+
             bool bIsEdgeDetectionEnabled = postProcessing->IsEdgeDetectionEnabled();
             ImGui::Checkbox("Edge Detection", &bIsEdgeDetectionEnabled);
 
@@ -35,6 +57,7 @@ namespace GlacirerEditor
             postProcessing->SetGrayScale(bIsGrayScaleEnabled);
             postProcessing->SetSharpen(bIsSharpenEnabled);
             postProcessing->SetBlur(bIsBlurEnabled);
+            postProcessing->SetBlurResolution(static_cast<Glacirer::PostProcessingResolution>(blurResolutionIndex));
             postProcessing->SetEdgeDetection(bIsEdgeDetectionEnabled);
         }
 
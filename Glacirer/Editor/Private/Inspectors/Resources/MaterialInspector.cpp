@@ -25,6 +25,13 @@ namespace GlacirerEditor
             ImGui::Text("Shader: %s", shaderName.c_str());
 
             RenderRenderingMode(material);
+
+            bool bReceivesShadows = material.ReceivesShadows();
+            if(ImGui::Checkbox("Receive Shadows", &bReceivesShadows))
+            {
+                material.SetReceivesShadows(bReceivesShadows);
+            }
+
             RenderColorProperties(material);
             RenderTextureProperties(material);
             RenderBoolProperties(material);
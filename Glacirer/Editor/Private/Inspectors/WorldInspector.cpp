@@ -2,6 +2,7 @@
 
 #include "World.h"
 #include "Rendering/RenderSystem.h"
+#include "Resources/ResourceManager.h"
 #include <imgui/imgui.h>
 
 namespace GlacirerEditor
@@ -56,6 +57,82 @@ namespace GlacirerEditor
                     device.DisableFaceCulling();
                 }
             }
+
+            bool bIsDeferredShadingEnabled = renderSystem.GetRenderPath() == Glacirer::Rendering::RenderPath::Deferred;
+            ImGui::Checkbox("Deferred shading", &bIsDeferredShadingEnabled);
+
+            renderSystem.SetRenderPath(bIsDeferredShadingEnabled ? Glacirer::Rendering::RenderPath::Deferred : Glacirer::Rendering::RenderPath::Forward);
+
+            RenderDepthPrePassProperties(renderSystem);
+
+            bool bIsOcclusionCullingEnabled = renderSystem.IsOcclusionCullingEnabled();
+            ImGui::Checkbox("Occlusion culling", &bIsOcclusionCullingEnabled);
+
+            renderSystem.ToggleOcclusionCulling(bIsOcclusionCullingEnabled);
+
+            if(bIsOcclusionCullingEnabled)
+            {
+                const Glacirer::Rendering::SoftwareOcclusionCuller& occlusionCuller = renderSystem.GetOcclusionCuller();
+                ImGui::Text("Occluded: %u / %u", occlusionCuller.GetTotalOccluded(), occlusionCuller.GetTotalTested());
+            }
+
+            int shadowLODBias = renderSystem.GetShadowLODBias();
+            ImGui::SliderInt("Shadow LOD bias", &shadowLODBias, 0, 3);
+
+            renderSystem.SetShadowLODBias(shadowLODBias);
+
+            const Glacirer::Rendering::RenderGraph& renderGraph = renderSystem.GetRenderGraph();
+            ImGui::Text("Render graph passes: %u (%u culled)", renderGraph.GetTotalPasses(), renderGraph.GetTotalCulledPasses());
+            const Glacirer::Rendering::RenderTargetPool& renderTargetPool = renderSystem.GetRenderTargetPool();
+            ImGui::Text("Transient targets: %u at once, %u pooled", renderGraph.GetPeakTransientTargets(), renderTargetPool.GetTotalTargets());
+            ImGui::Text("Render target pool: %.1f MB", static_cast<float>(renderTargetPool.GetGpuMemory()) / (1024 * 1024));
+
+            RenderTextureStreamingProperties();
+        }
+
+        void WorldInspector::RenderTextureStreamingProperties()
+        {
+            constexpr size_t BYTES_PER_MEGABYTE = 1024 * 1024;
+
+            Glacirer::Resources::TextureStreamer& textureStreamer = Glacirer::Resources::ResourceManager::GetTextureStreamer();
+            Glacirer::Resources::TextureStreamingSettings streamingSettings = textureStreamer.GetSettings();
+
+            int budgetMegabytes = static_cast<int>(streamingSettings.BudgetBytes / BYTES_PER_MEGABYTE);
+            ImGui::SliderInt("Texture budget (MB)", &budgetMegabytes, 16, 2048);
+
+            streamingSettings.BudgetBytes = static_cast<size_t>(budgetMegabytes) * BYTES_PER_MEGABYTE;
+            textureStreamer.SetSettings(streamingSettings);
+
+            ImGui::Text("Streamed textures: %u (%.1f MB resident)", textureStreamer.GetTotalStreamedTextures(), static_cast<float>(textureStreamer.GetResidentBytes()) / BYTES_PER_MEGABYTE);
+        }
+
+        void WorldInspector::RenderDepthPrePassProperties(Glacirer::Rendering::RenderSystem& renderSystem)
+        {
+            const char* depthPrePassModes[] = { "Disabled", "Enabled", "Automatic" };
+            int currentModeIndex = static_cast<int>(renderSystem.GetDepthPrePassMode());
+
+            if(ImGui::BeginCombo("Depth pre-pass", depthPrePassModes[currentModeIndex]))
+            {
+                for(int i = 0; i < IM_ARRAYSIZE(depthPrePassModes); i++)
+                {
+                    const bool isSelected = currentModeIndex == i;
+                    if(ImGui::Selectable(depthPrePassModes[i], isSelected))
+                    {
+                        currentModeIndex = i;
+                    }
+
+                    if(isSelected)
+                    {
+                        ImGui::SetItemDefaultFocus();
+                    }
+                }
+
+                ImGui::EndCombo();
+            }
+
+            renderSystem.SetDepthPrePassMode(static_cast<Glacirer::Rendering::DepthPrePassMode>(currentModeIndex));
+
+            ImGui::Text("Opaque overdraw: %.2f (pre-pass %s)", renderSystem.GetOpaqueOverdraw(), renderSystem.IsDepthPrePassActive() ? "active" : "inactive");
         }
     }
 }
@@ -0,0 +1,162 @@
+#include "MemoryWindow.h"
+
+#include <iostream>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "MemoryTracker.h"
+
+namespace
+{
+    constexpr float BYTES_PER_MEGABYTE = 1024.f * 1024.f;
+
+    float ToMegabytes(size_t bytes)
+    {
+        return static_cast<float>(bytes) / BYTES_PER_MEGABYTE;
+    }
+}
+
+namespace GlacirerEditor
+{
+    void MemoryWindow::RenderGUI()
+    {
+        ImGui::SetNextWindowPos(m_InitialPosition, ImGuiCond_FirstUseEver);
+
+        if(ImGui::Begin("Memory"))
+        {
+            ImGui::Text("GPU: %.1f MB (peak %.1f MB)", ToMegabytes(Glacirer::MemoryTracker::GetLiveGpuBytes()), ToMegabytes(Glacirer::MemoryTracker::GetPeakGpuBytes()));
+            ImGui::Text("Tracked CPU buffers: %.1f MB (peak %.1f MB)", ToMegabytes(Glacirer::MemoryTracker::GetLiveCpuBytes()), ToMegabytes(Glacirer::MemoryTracker::GetPeakCpuBytes()));
+
+            if(ImGui::Button("Dump to console"))
+            {
+                Glacirer::MemoryTracker::Dump(std::cout);
+            }
+
+            if(ImGui::CollapsingHeader("Categories", ImGuiTreeNodeFlags_DefaultOpen))
+            {
+                RenderCategoriesTable();
+            }
+
+            if(ImGui::CollapsingHeader("Heap allocations by tag"))
+            {
+                RenderAllocationTagsTable();
+            }
+
+            if(ImGui::CollapsingHeader("Largest resources"))
+            {
+                ImGui::SliderInt("Shown", &m_TotalLargestResources, 1, 128);
+                RenderLargestResourcesTable();
+            }
+        }
+
+        ImGui::End();
+    }
+
+    void MemoryWindow::RenderCategoriesTable()
+    {
+        if(!ImGui::BeginTable("MemoryCategories", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        {
+            return;
+        }
+
+        ImGui::TableSetupColumn("Category");
+        ImGui::TableSetupColumn("Live (MB)");
+        ImGui::TableSetupColumn("Peak (MB)");
+        ImGui::TableSetupColumn("Resources");
+        ImGui::TableHeadersRow();
+
+        for(size_t i = 0; i < static_cast<size_t>(Glacirer::MemoryCategory::Count); i++)
+        {
+            const Glacirer::MemoryCategory category = static_cast<Glacirer::MemoryCategory>(i);
+            const Glacirer::MemoryCategoryStats stats = Glacirer::MemoryTracker::GetCategoryStats(category);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("%s (%s)", Glacirer::MemoryTracker::GetCategoryName(category), Glacirer::MemoryTracker::IsGpuCategory(category) ? "GPU" : "CPU");
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", ToMegabytes(stats.LiveBytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", ToMegabytes(stats.PeakBytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%u", stats.TotalResources);
+        }
+
+        ImGui::EndTable();
+    }
+
+    void MemoryWindow::RenderAllocationTagsTable()
+    {
+        if(!Glacirer::AllocationCounter::IsTaggingSupported())
+        {
+            ImGui::TextUnformatted("Only recorded by debug builds");
+            return;
+        }
+
+        if(!ImGui::BeginTable("AllocationTags", 4, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        {
+            return;
+        }
+
+        ImGui::TableSetupColumn("Tag");
+        ImGui::TableSetupColumn("Live (MB)");
+        ImGui::TableSetupColumn("Peak (MB)");
+        ImGui::TableSetupColumn("Allocations");
+        ImGui::TableHeadersRow();
+
+        size_t totalTaggedBytes = 0;
+
+        // Untagged allocations aren't recorded
+        for(size_t i = 1; i < static_cast<size_t>(Glacirer::AllocationTag::Count); i++)
+        {
+            const Glacirer::AllocationTag tag = static_cast<Glacirer::AllocationTag>(i);
+            const Glacirer::AllocationTagStats stats = Glacirer::AllocationCounter::GetTagStats(tag);
+            totalTaggedBytes += stats.LiveBytes;
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(Glacirer::AllocationCounter::GetTagName(tag));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", ToMegabytes(stats.LiveBytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", ToMegabytes(stats.PeakBytes));
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", stats.LiveAllocations);
+        }
+
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted("Total");
+        ImGui::TableNextColumn();
+        ImGui::Text("%.2f", ToMegabytes(totalTaggedBytes));
+
+        ImGui::EndTable();
+    }
+
+    void MemoryWindow::RenderLargestResourcesTable()
+    {
+        if(!ImGui::BeginTable("LargestResources", 3, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+        {
+            return;
+        }
+
+        ImGui::TableSetupColumn("Resource");
+        ImGui::TableSetupColumn("Category");
+        ImGui::TableSetupColumn("Size (MB)");
+        ImGui::TableHeadersRow();
+
+        const std::vector<Glacirer::MemoryResourceInfo> largestResources = Glacirer::MemoryTracker::GetLargestResources(static_cast<size_t>(m_TotalLargestResources));
+
+        for(const Glacirer::MemoryResourceInfo& resourceInfo : largestResources)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(resourceInfo.Name.empty() ? "(unnamed)" : resourceInfo.Name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(Glacirer::MemoryTracker::GetCategoryName(resourceInfo.Category));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.2f", ToMegabytes(resourceInfo.Bytes));
+        }
+
+        ImGui::EndTable();
+    }
+}
@@ -40,11 +40,10 @@ namespace GlacirerEditor
 
     void ResourceCollection::RenderMaterialsList()
     {
-        const std::unordered_map<std::string, std::shared_ptr<Glacirer::Rendering::Material>>& materials = Glacirer::Resources::ResourceManager::GetAllMaterials();
+        const std::vector<std::shared_ptr<Glacirer::Rendering::Material>> materials = Glacirer::Resources::ResourceManager::GetAllMaterials();
 
-        for(const auto& materialPair : materials)
+        for(const std::shared_ptr<Glacirer::Rendering::Material>& material : materials)
         {
-            const std::shared_ptr<Glacirer::Rendering::Material>& material = materialPair.second;
             std::string materialName = material->GetName();
 
             if(m_EngineHiddenMaterials.find(materialName) != m_EngineHiddenMaterials.end())
@@ -16,6 +16,7 @@
 #include "Basics/Objects/Skybox.h"
 #include "Basics/Objects/Sphere.h"
 #include "Basics/Objects/SpotLight.h"
+#include "Basics/Components/MeshComponent.h"
 
 namespace GlacirerEditor
 {
@@ -38,9 +39,7 @@ namespace GlacirerEditor
             auto anotherMaterial = Glacirer::Resources::ResourceManager::CreateMaterial("AnotherMaterial");
             anotherMaterial->SetColor("u_Color", glm::vec4(0.f));
 
-            Glacirer::Rendering::TextureSettings pigeonTextureSettings{false};
-            pigeonTextureSettings.GenerateMipmap = true;
-            anotherMaterial->SetTexture("u_Diffuse", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/FancyPigeon.png", "Pigeon", pigeonTextureSettings), 0);
+            anotherMaterial->SetTexture("u_Diffuse", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/FancyPigeon.png", "Pigeon", Glacirer::Rendering::TextureSettings{false}), 0);
             cube->SetMaterial(anotherMaterial);
 
             SpawnBridge(world);
@@ -64,6 +63,9 @@ namespace GlacirerEditor
             auto skybox = world.Spawn<Glacirer::Skybox>();
             skybox->SetName("Skybox");
             skybox->SetDefaultSky();
+
+            // Crates never move, they end up drawn as a single chunk
+            world.BuildStaticBatches();
         }
 
         void SandboxSceneSpawner::SpawnCrates(Glacirer::World& world)
@@ -71,7 +73,10 @@ namespace GlacirerEditor
             std::shared_ptr<Glacirer::Rendering::Material> crateMaterial = Glacirer::Resources::ResourceManager::CreateMaterial("M_Crate");
             crateMaterial->SetColor("u_Color", glm::vec4(0.f)); // When using a texture, we need to set default color to black
             crateMaterial->SetTexture("u_Diffuse", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/Container_Diff.png", "Container_Diffuse", Glacirer::Rendering::TextureSettings{false}), 0);
-            crateMaterial->SetTexture("u_Specular", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/Container_Spec.png", "Container_Specular", Glacirer::Rendering::TextureSettings{false, false}), 1);
+
+            Glacirer::Rendering::TextureSettings crateSpecularSettings{false, false};
+            crateSpecularSettings.Usage = Glacirer::Rendering::TextureUsage::Mask;
+            crateMaterial->SetTexture("u_Specular", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/Container_Spec.png", "Container_Specular", crateSpecularSettings), 1);
         
             int crateIndex = 0;
             for(int x = 0; x < 3; x++)
@@ -82,6 +87,7 @@ namespace GlacirerEditor
                     auto crate = world.Spawn<Glacirer::Cube>(position);
                     crate->SetName("Crate" + std::to_string(crateIndex));
                     crate->SetMaterial(crateMaterial);
+                    crate->SetMobility(Glacirer::Mobility::Static);
 
                     crateIndex++;
                 }
@@ -92,9 +98,13 @@ namespace GlacirerEditor
         {
             auto bridgeMaterial = Glacirer::Resources::ResourceManager::CreateMaterial("M_Bridge");
             bridgeMaterial->SetColor("u_Color", glm::vec4(0.f));
-            bridgeMaterial->SetTexture("u_Diffuse", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/Atlas04_Diff.png", "T_Bridge_Diffuse", Glacirer::Rendering::TextureSettings{false}), 0);
 
-            auto bridgeModel = Glacirer::Resources::ResourceManager::LoadModel(SANDBOX_RESOURCES_PATH + "Models/Bridge.fbx", "Bridge");
+            Glacirer::Rendering::TextureSettings bridgeDiffuseSettings{false};
+            bridgeDiffuseSettings.bCompress = true;
+            bridgeDiffuseSettings.bStream = true;
+            bridgeMaterial->SetTexture("u_Diffuse", Glacirer::Resources::ResourceManager::LoadTextureAsync(SANDBOX_RESOURCES_PATH + "Textures/Atlas04_Diff.png", "T_Bridge_Diffuse", bridgeDiffuseSettings), 0);
+
+            auto bridgeModel = Glacirer::Resources::ResourceManager::LoadModelAsync(SANDBOX_RESOURCES_PATH + "Models/Bridge.fbx", "Bridge");
 
             auto bridge = world.Spawn<Glacirer::Model>(glm::vec3(0.f, 0.f, -20.f));
             bridge->Setup(bridgeModel, bridgeMaterial);
@@ -105,10 +115,19 @@ namespace GlacirerEditor
         {
             auto warriorMaterial = Glacirer::Resources::ResourceManager::CreateMaterial("M_Liz");
             warriorMaterial->SetColor("u_Color", glm::vec4(0.f));
-            warriorMaterial->SetTexture("u_Diffuse", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/liz/T_Liz_Diffuse.png", "T_Liz_Diffuse", Glacirer::Rendering::TextureSettings{false}), 0);
-            warriorMaterial->SetTexture("u_Specular", Glacirer::Resources::ResourceManager::LoadTexture(SANDBOX_RESOURCES_PATH + "Textures/liz/T_Liz_Specular.png", "T_Liz_Specular", Glacirer::Rendering::TextureSettings{false}), 1);
+
+            Glacirer::Rendering::TextureSettings warriorDiffuseSettings{false};
+            warriorDiffuseSettings.bCompress = true;
+            warriorDiffuseSettings.bStream = true;
+            warriorMaterial->SetTexture("u_Diffuse", Glacirer::Resources::ResourceManager::LoadTextureAsync(SANDBOX_RESOURCES_PATH + "Textures/liz/T_Liz_Diffuse.png", "T_Liz_Diffuse", warriorDiffuseSettings), 0);
+
+            Glacirer::Rendering::TextureSettings warriorSpecularSettings{false, false};
+            warriorSpecularSettings.Usage = Glacirer::Rendering::TextureUsage::Mask;
+            warriorSpecularSettings.bCompress = true;
+            warriorSpecularSettings.bStream = true;
+            warriorMaterial->SetTexture("u_Specular", Glacirer::Resources::ResourceManager::LoadTextureAsync(SANDBOX_RESOURCES_PATH + "Textures/liz/T_Liz_Specular.png", "T_Liz_Specular", warriorSpecularSettings), 1);
         
-            auto warriorModel = Glacirer::Resources::ResourceManager::LoadModel(SANDBOX_RESOURCES_PATH + "Models/PigeonsAttack_Liz.fbx", "Liz");
+            auto warriorModel = Glacirer::Resources::ResourceManager::LoadModelAsync(SANDBOX_RESOURCES_PATH + "Models/PigeonsAttack_Liz.fbx", "Liz");
 
             glm::vec3 spawnPosition{0.f, -0.5f, -4.f};
             glm::vec3 spawnRotation{0.f, -31.f, 0.f};
@@ -154,6 +173,13 @@ namespace GlacirerEditor
             glm::vec3 floorScale{44.f, 0.5f, 44.f};
             std::shared_ptr<Glacirer::Cube> floor = world.Spawn<Glacirer::Cube>(floorPosition, floorRotation, floorScale);
             floor->SetName("Floor");
+
+            // Large and static, a good occluder candidate for software occlusion culling
+            std::shared_ptr<Glacirer::MeshComponent> floorMeshComponent = floor->GetComponent<Glacirer::MeshComponent>().lock();
+            if(floorMeshComponent)
+            {
+                floorMeshComponent->SetIsOccluder(true);
+            }
         }
 
         void SandboxSceneSpawner::SpawnLights(Glacirer::World& world, Glacirer::GameObject& camera)
@@ -1,5 +1,9 @@
 #include "StatisticsWindow.h"
 
+#include <iostream>
+
+#include "GameObject/TransformBatch.h"
+
 namespace GlacirerEditor
 {
     void StatisticsWindow::RenderGUI()
@@ -9,6 +13,12 @@ namespace GlacirerEditor
         ImGui::SetNextWindowPos(m_InitialPosition, ImGuiCond_FirstUseEver);
         ImGui::Begin("Statistics");
         ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / io.Framerate, io.Framerate);
+
+        if(ImGui::Button("Benchmark transform composition"))
+        {
+            Glacirer::TransformBatch::Benchmark(std::cout);
+        }
+
         ImGui::End();
     }
 }
@@ -2,6 +2,7 @@
 #include "Engine.h"
 #include "MainMenuBar.h"
 #include "MainPanel.h"
+#include "MemoryWindow.h"
 #include "ResourcesPanel.h"
 #include "StatisticsWindow.h"
 
@@ -33,6 +34,7 @@ namespace GlacirerEditor
         MainPanel m_MainPanel{};
         std::shared_ptr<ResourcesPanel> m_ResourcesPanel{};
         StatisticsWindow m_StatisticsWindow{};
+        MemoryWindow m_MemoryWindow{};
         int m_SelectedGameObjectIndex{-1};
         bool bShowPanelsEnabled{true};
 
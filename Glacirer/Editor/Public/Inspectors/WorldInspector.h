@@ -3,6 +3,11 @@
 namespace Glacirer
 {
     class World;
+
+    namespace Rendering
+    {
+        class RenderSystem;
+    }
 }
 
 namespace GlacirerEditor
@@ -19,6 +24,8 @@ namespace GlacirerEditor
 
             void RenderLightingProperties(Glacirer::World& world);
             void RenderRenderingProperties(Glacirer::World& world);
+            void RenderDepthPrePassProperties(Glacirer::Rendering::RenderSystem& renderSystem);
+            void RenderTextureStreamingProperties();
         };
     }
 }
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "imgui/imgui.h"
+
+namespace GlacirerEditor
+{
+    class MemoryWindow
+    {
+        public:
+            void RenderGUI();
+
+        private:
+            void RenderCategoriesTable();
+            void RenderAllocationTagsTable();
+            void RenderLargestResourcesTable();
+
+            ImVec2 m_InitialPosition{380.f, 80.f};
+            int m_TotalLargestResources{16};
+    };
+}
@@ -0,0 +1,183 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(_DEBUG) && defined(_MSC_VER)
+#define GLACIRER_ALLOCATION_TAGS 1
+#include <crtdbg.h>
+#endif
+
+#ifdef _DEBUG
+namespace
+{
+    // Trivial types, usable from operator new before and while threads start
+    thread_local size_t g_TotalThreadAllocations = 0;
+    thread_local Glacirer::AllocationTag g_CurrentTag = Glacirer::AllocationTag::Untagged;
+
+#ifdef GLACIRER_ALLOCATION_TAGS
+    constexpr size_t TOTAL_TAGS = static_cast<size_t>(Glacirer::AllocationTag::Count);
+
+    struct TagCounters
+    {
+        std::atomic<size_t> LiveBytes;
+        std::atomic<size_t> PeakBytes;
+        std::atomic<size_t> LiveAllocations;
+    };
+
+    // Zero initialized before any allocation can happen
+    TagCounters g_TagCounters[TOTAL_TAGS];
+
+    void AddTaggedBytes(size_t tagIndex, size_t bytes)
+    {
+        TagCounters& counters = g_TagCounters[tagIndex];
+        counters.LiveAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        const size_t liveBytes = counters.LiveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t peakBytes = counters.PeakBytes.load(std::memory_order_relaxed);
+
+        while(liveBytes > peakBytes && !counters.PeakBytes.compare_exchange_weak(peakBytes, liveBytes, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void RemoveTaggedBytes(size_t tagIndex, size_t bytes)
+    {
+        TagCounters& counters = g_TagCounters[tagIndex];
+        counters.LiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+        counters.LiveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+#endif
+}
+
+// Array and nothrow forms go through this one
+void* operator new(size_t size)
+{
+    g_TotalThreadAllocations++;
+
+    const size_t blockSize = size > 0 ? size : 1;
+
+#ifdef GLACIRER_ALLOCATION_TAGS
+    // Tag is kept by the debug heap block itself instead of a header of ours, blocks allocated here
+    // are freed by the operator delete of whichever module releases them (e.g. containers returned to the editor)
+    if(g_CurrentTag != Glacirer::AllocationTag::Untagged)
+    {
+        const int tagIndex = static_cast<int>(g_CurrentTag);
+
+        if(void* memory = _malloc_dbg(blockSize, _CLIENT_BLOCK | (tagIndex << 16), nullptr, 0))
+        {
+            AddTaggedBytes(static_cast<size_t>(tagIndex), blockSize);
+            return memory;
+        }
+
+        throw std::bad_alloc();
+    }
+#endif
+
+    if(void* memory = std::malloc(blockSize))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+#ifdef GLACIRER_ALLOCATION_TAGS
+    // Also receives blocks other modules allocated, only the client blocks with one of our tags are counted
+    if(memory)
+    {
+        const int blockUse = _CrtReportBlockType(memory);
+        const size_t tagIndex = static_cast<size_t>(_BLOCK_SUBTYPE(blockUse));
+
+        if(blockUse != -1 && _BLOCK_TYPE(blockUse) == _CLIENT_BLOCK && tagIndex > 0 && tagIndex < TOTAL_TAGS)
+        {
+            RemoveTaggedBytes(tagIndex, _msize_dbg(memory, _CLIENT_BLOCK));
+            _free_dbg(memory, _CLIENT_BLOCK);
+            return;
+        }
+    }
+#endif
+
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    operator delete(memory);
+}
+#endif
+
+namespace Glacirer
+{
+    AllocationTagScope::AllocationTagScope(AllocationTag tag)
+#ifdef _DEBUG
+        : m_PreviousTag(g_CurrentTag)
+    {
+        g_CurrentTag = tag;
+    }
+#else
+        : m_PreviousTag(tag)
+    { }
+#endif
+
+    AllocationTagScope::~AllocationTagScope()
+    {
+#ifdef _DEBUG
+        g_CurrentTag = m_PreviousTag;
+#endif
+    }
+
+    size_t AllocationCounter::GetTotalAllocationsOnCurrentThread()
+    {
+#ifdef _DEBUG
+        return g_TotalThreadAllocations;
+#else
+        return 0;
+#endif
+    }
+
+    const char* AllocationCounter::GetTagName(AllocationTag tag)
+    {
+        switch(tag)
+        {
+            case AllocationTag::Untagged:
+                return "Untagged";
+            case AllocationTag::World:
+                return "World";
+            case AllocationTag::Rendering:
+                return "Rendering";
+            case AllocationTag::Resources:
+                return "Resources";
+            case AllocationTag::SceneQueries:
+                return "Scene queries";
+            default:
+                return "Unknown";
+        }
+    }
+
+    AllocationTagStats AllocationCounter::GetTagStats(AllocationTag tag)
+    {
+        AllocationTagStats stats{};
+
+#ifdef GLACIRER_ALLOCATION_TAGS
+        const TagCounters& counters = g_TagCounters[static_cast<size_t>(tag)];
+        stats.LiveBytes = counters.LiveBytes.load(std::memory_order_relaxed);
+        stats.PeakBytes = counters.PeakBytes.load(std::memory_order_relaxed);
+        stats.LiveAllocations = counters.LiveAllocations.load(std::memory_order_relaxed);
+#endif
+
+        return stats;
+    }
+
+    bool AllocationCounter::IsTaggingSupported()
+    {
+#ifdef GLACIRER_ALLOCATION_TAGS
+        return true;
+#else
+        return false;
+#endif
+    }
+}
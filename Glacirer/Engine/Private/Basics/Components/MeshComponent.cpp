@@ -1,8 +1,21 @@
 #include "Basics/Components/MeshComponent.h"
 
+#include <limits>
+
 #include "GameObject/GameObject.h"
 #include "World.h"
 #include "Rendering/Material.h"
+#include "Rendering/Mesh.h"
+#include <glm/glm.hpp>
+
+namespace
+{
+    // Screen height fraction under which each LOD switches to the next one
+    constexpr int TOTAL_LOD_SCREEN_SIZES = 3;
+    constexpr float LOD_SCREEN_SIZES[TOTAL_LOD_SCREEN_SIZES] = { 0.4f, 0.2f, 0.1f };
+    // LOD only changes once the screen size crosses a threshold by this fraction, so it doesn't pop back and forth
+    constexpr float LOD_HYSTERESIS = 0.1f;
+}
 
 namespace Glacirer
 {
@@ -14,6 +27,7 @@ namespace Glacirer
         }
 
         m_Mesh = mesh;
+        m_LOD = 0;
 
         if(IsReadyToDraw())
         {
@@ -56,6 +70,119 @@ namespace Glacirer
         }
     }
 
+    void MeshComponent::SetIsOccluder(const bool bOccluder)
+    {
+        if(bIsOccluder == bOccluder)
+        {
+            return;
+        }
+
+        if(bIsAddedToWorld)
+        {
+            RemoveFromWorld();
+        }
+
+        bIsOccluder = bOccluder;
+
+        if(IsReadyToDraw())
+        {
+            AddToWorld();
+        }
+    }
+
+    void MeshComponent::SetIsStaticBatched(const bool bStaticBatched)
+    {
+        if(bIsStaticBatched == bStaticBatched)
+        {
+            return;
+        }
+
+        if(bIsAddedToWorld)
+        {
+            RemoveFromWorld();
+        }
+
+        bIsStaticBatched = bStaticBatched;
+
+        if(IsReadyToDraw())
+        {
+            AddToWorld();
+        }
+    }
+
+    void MeshComponent::SetIsQueryable(const bool bQueryable)
+    {
+        if(bIsQueryable == bQueryable)
+        {
+            return;
+        }
+
+        if(bIsAddedToWorld)
+        {
+            RemoveFromWorld();
+        }
+
+        bIsQueryable = bQueryable;
+
+        if(IsReadyToDraw())
+        {
+            AddToWorld();
+        }
+    }
+
+    void MeshComponent::UpdateLOD(const glm::mat4& projection, const glm::vec3& viewPosition)
+    {
+        const int totalLODs = m_Mesh ? m_Mesh->GetTotalLODs() : 1;
+
+        if(totalLODs <= 1)
+        {
+            m_LOD = 0;
+            return;
+        }
+
+        const float screenSize = GetScreenSize(projection, viewPosition);
+
+        const int lastLOD = glm::min(totalLODs, TOTAL_LOD_SCREEN_SIZES + 1) - 1;
+        int lod = glm::min(m_LOD, lastLOD);
+
+        while(lod < lastLOD && screenSize < LOD_SCREEN_SIZES[lod] * (1.f - LOD_HYSTERESIS))
+        {
+            lod++;
+        }
+
+        while(lod > 0 && screenSize > LOD_SCREEN_SIZES[lod - 1] * (1.f + LOD_HYSTERESIS))
+        {
+            lod--;
+        }
+
+        m_LOD = lod;
+    }
+
+    float MeshComponent::GetScreenSize(const glm::mat4& projection, const glm::vec3& viewPosition) const
+    {
+        const Rendering::Bounds worldBounds = m_Mesh->GetBounds().Transform(GetOwnerTransform().GetMatrix());
+        const float radius = glm::length(worldBounds.GetExtents());
+
+        // projection[1][1] is cot(fov / 2) for perspective and 2 / height for orthographic projections
+        // perspective one also needs to be divided by distance, orthographic has w = 1 (projection[3][3])
+        const float screenSize = radius * projection[1][1];
+
+        if(projection[3][3] == 0.f)
+        {
+            const float distance = glm::distance(worldBounds.GetCenter(), viewPosition);
+            return distance > radius ? screenSize / distance : std::numeric_limits<float>::max();
+        }
+
+        return screenSize;
+    }
+
+    const Rendering::Mesh& MeshComponent::GetMeshForLOD(int lodBias) const
+    {
+        assert(m_Mesh);
+
+        return m_Mesh->GetLOD(glm::min(m_LOD + lodBias, m_Mesh->GetTotalLODs() - 1));
+    }
+
     std::shared_ptr<Rendering::Shader> MeshComponent::GetShader() const
     {
         return m_Material ? m_Material->GetShader() : nullptr;   
@@ -106,5 +233,8 @@ namespace Glacirer
         {
             RemoveFromWorld();
         }
+
+        // Already out of the world, un-batching it on the next rebuild must not add it back
+        bIsStaticBatched = false;
     }
 }
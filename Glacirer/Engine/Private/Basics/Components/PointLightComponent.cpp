@@ -54,22 +54,19 @@ namespace Glacirer
         return glm::perspective(glm::radians(fov), aspect, near, far);
     }
 
-    std::vector<glm::mat4> PointLightComponent::GetViewProjectionMatrices(const Rendering::Resolution& shadowResolution) const
+    std::array<glm::mat4, 6> PointLightComponent::GetViewProjectionMatrices(const Rendering::Resolution& shadowResolution) const
     {
         glm::mat4 projection = GetProjectionMatrix(shadowResolution);
         glm::vec3 position = GetPosition();
-    
-        std::vector<glm::mat4> matrices{};
-        matrices.reserve(6);
 
         // Look at each direction of the point light to be used by cubemap shadow map (right, left, top, bottom, near and far)
-        matrices.emplace_back(projection * glm::lookAt(position, position + glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, -1.f, 0.f)));
-        matrices.emplace_back(projection * glm::lookAt(position, position + glm::vec3(-1.f, 0.f, 0.f), glm::vec3(0.f, -1.f, 0.f)));
-        matrices.emplace_back(projection * glm::lookAt(position, position + glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 0.f, 1.f)));
-        matrices.emplace_back(projection * glm::lookAt(position, position + glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 0.f, -1.f)));
-        matrices.emplace_back(projection * glm::lookAt(position, position + glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, -1.f, 0.f)));
-        matrices.emplace_back(projection * glm::lookAt(position, position + glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, -1.f, 0.f)));
-
-        return matrices;
+        return std::array<glm::mat4, 6>{{
+            projection * glm::lookAt(position, position + glm::vec3(1.f, 0.f, 0.f), glm::vec3(0.f, -1.f, 0.f)),
+            projection * glm::lookAt(position, position + glm::vec3(-1.f, 0.f, 0.f), glm::vec3(0.f, -1.f, 0.f)),
+            projection * glm::lookAt(position, position + glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 0.f, 1.f)),
+            projection * glm::lookAt(position, position + glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 0.f, -1.f)),
+            projection * glm::lookAt(position, position + glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, -1.f, 0.f)),
+            projection * glm::lookAt(position, position + glm::vec3(0.f, 0.f, -1.f), glm::vec3(0.f, -1.f, 0.f))
+        }};
     }
 }
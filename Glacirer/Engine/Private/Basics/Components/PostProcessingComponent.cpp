@@ -56,4 +56,10 @@ namespace Glacirer
         bIsEdgeDetectionEnabled = bEnabled;
         bIsDirty = true;
     }
+
+    void PostProcessingComponent::SetBlurResolution(const PostProcessingResolution blurResolution)
+    {
+        m_BlurResolution = blurResolution;
+        bIsDirty = true;
+    }
 }
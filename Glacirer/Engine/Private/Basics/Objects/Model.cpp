@@ -2,19 +2,77 @@
 
 #include "Basics/Components/MeshComponent.h"
 #include "Rendering/ModelData.h"
+#include "Resources/ResourceManager.h"
 
 namespace Glacirer
 {
     void Model::Setup(const std::shared_ptr<Rendering::ModelData>& modelData, const std::shared_ptr<Rendering::Material>& material)
     {
+        if(!modelData->IsLoaded())
+        {
+            m_PendingModelData = modelData;
+            m_PendingMaterial = material;
+            m_PlaceholderComponent = AddMeshComponent(Resources::ResourceManager::GetDefaultCube(), material);
+
+            return;
+        }
+
         for (const std::shared_ptr<Rendering::Mesh>& mesh : modelData->GetMeshes())
         {
-            std::weak_ptr<MeshComponent> component = AddComponent<MeshComponent>();
-            std::shared_ptr<MeshComponent> meshComponent = component.lock();
-            assert(meshComponent);
+            AddMeshComponent(mesh, material);
+        }
+    }
+
+    void Model::Update(float deltaTime)
+    {
+        GameObject::Update(deltaTime);
+
+        if(m_PendingModelData && m_PendingModelData->IsLoaded())
+        {
+            ReplacePlaceholder();
+        }
+    }
+
+    std::weak_ptr<MeshComponent> Model::AddMeshComponent(const std::shared_ptr<Rendering::Mesh>& mesh, const std::shared_ptr<Rendering::Material>& material)
+    {
+        std::weak_ptr<MeshComponent> component = AddComponent<MeshComponent>();
+        std::shared_ptr<MeshComponent> meshComponent = component.lock();
+        assert(meshComponent);
+
+        meshComponent->SetMesh(mesh);
+        meshComponent->SetMaterial(material);
+
+        return component;
+    }
+
+    void Model::ReplacePlaceholder()
+    {
+        const std::vector<std::shared_ptr<Rendering::Mesh>>& meshes = m_PendingModelData->GetMeshes();
+
+        // Placeholder may have been removed by the user meanwhile
+        if(std::shared_ptr<MeshComponent> placeholder = m_PlaceholderComponent.lock())
+        {
+            if(meshes.empty())
+            {
+                RemoveComponent(placeholder);
+            }
+            else
+            {
+                placeholder->SetMesh(meshes[0]);
+            }
+        }
+        else if(!meshes.empty())
+        {
+            AddMeshComponent(meshes[0], m_PendingMaterial);
+        }
 
-            meshComponent->SetMesh(mesh);
-            meshComponent->SetMaterial(material);
+        for(size_t i = 1; i < meshes.size(); i++)
+        {
+            AddMeshComponent(meshes[i], m_PendingMaterial);
         }
+
+        m_PendingModelData.reset();
+        m_PendingMaterial.reset();
+        m_PlaceholderComponent.reset();
     }
 }
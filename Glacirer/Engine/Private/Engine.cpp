@@ -1,9 +1,15 @@
 #include "Engine.h"
 
+#include <iostream>
+
+#include "AllocationCounter.h"
 #include "Application.h"
+#include "FrameArena.h"
 #include "GameTime.h"
 #include "Input.h"
+#include "Rendering/Shader.h"
 #include "Resources/ResourceManager.h"
+#include "Resources/ShaderCache.h"
 #include "Screen.h"
 
 namespace
@@ -33,16 +39,26 @@ namespace Glacirer
         bSuccess = InitializeGlew();
         assert(bSuccess);
 
+        Rendering::Shader::EnableParallelCompilation();
+        Resources::ShaderCache::Initialize();
+
         bIsInitialized = bSuccess;
     }
 
     void Engine::Setup()
     {
-        Resources::ResourceManager::LoadDefaultResources();
+        {
+            AllocationTagScope tagScope{AllocationTag::Resources};
+            Resources::ResourceManager::LoadDefaultResources();
+        }
 
-        m_RenderSystem = std::make_shared<Rendering::RenderSystem>(static_cast<unsigned int>(DEFAULT_MSAA_TOTAL_SAMPLES));
-        m_RenderSystem->Setup();
-        
+        {
+            AllocationTagScope tagScope{AllocationTag::Rendering};
+            m_RenderSystem = std::make_shared<Rendering::RenderSystem>(static_cast<unsigned int>(DEFAULT_MSAA_TOTAL_SAMPLES));
+            m_RenderSystem->Setup();
+        }
+
+        AllocationTagScope tagScope{AllocationTag::World};
         m_World = std::make_unique<World>();
         m_World->Initialize(m_RenderSystem);
         m_World->Setup();
@@ -73,6 +89,11 @@ namespace Glacirer
 
     void Engine::Update()
     {
+        const size_t updateStartAllocations = AllocationCounter::GetTotalAllocationsOnCurrentThread();
+
+        // Nothing allocated on it during the previous frame is used anymore
+        FrameArena::GetForCurrentThread().Reset();
+
         /* Poll for and process events, like keyboard input and mouse movement */
         Input::SwapBuffers();
         glfwPollEvents();
@@ -83,23 +104,60 @@ namespace Glacirer
         GameTime::DeltaTime = GameTime::Time - m_LastFrameTime;
         m_LastFrameTime = GameTime::Time;
         
-        m_World->Update(GameTime::DeltaTime);
+        {
+            AllocationTagScope tagScope{AllocationTag::Resources};
+            Resources::ResourceManager::ProcessAsyncLoads();
+            Resources::ResourceManager::UpdateTextureStreaming();
+            Resources::ResourceManager::UpdateResources();
+        }
+
+        {
+            AllocationTagScope tagScope{AllocationTag::World};
+            m_World->Update(GameTime::DeltaTime);
+        }
+
+        // Editor code running between update and render isn't counted
+        m_TotalFrameAllocations = AllocationCounter::GetTotalAllocationsOnCurrentThread() - updateStartAllocations;
     }
 
     void Engine::Render()
     {
+        const size_t renderStartAllocations = AllocationCounter::GetTotalAllocationsOnCurrentThread();
+
         /* Swap front and back buffers */
         glfwSwapBuffers(m_Window);
 
-        std::shared_ptr<CameraComponent> activeCamera = m_World->GetActiveCamera();
-        if(!activeCamera)
         {
-            // TODO: Log warning (create a log class)
-            m_RenderSystem->RenderEmpty();
-            return;
+            AllocationTagScope tagScope{AllocationTag::Rendering};
+
+            std::shared_ptr<CameraComponent> activeCamera = m_World->GetActiveCamera();
+            if(!activeCamera)
+            {
+                // TODO: Log warning (create a log class)
+                m_RenderSystem->RenderEmpty();
+            }
+            else
+            {
+                m_RenderSystem->Render(*activeCamera);
+            }
+        }
+
+        m_TotalFrameAllocations += AllocationCounter::GetTotalAllocationsOnCurrentThread() - renderStartAllocations;
+        CheckFrameAllocations();
+    }
+
+    void Engine::CheckFrameAllocations()
+    {
+#ifdef _DEBUG
+        // Frame arena, pools and caches grow during the first frames, a warm frame should then reuse all of it.
+        // Loading and spawning still allocate later on, so it's reported instead of stopping the program
+        if(m_TotalFrames >= ALLOCATION_CHECK_WARM_UP_FRAMES && m_TotalFrameAllocations > 0)
+        {
+            std::cout << "ERROR::ENGINE: " << m_TotalFrameAllocations << " heap allocations during frame " << m_TotalFrames << "\n";
         }
+#endif
 
-        m_RenderSystem->Render(*activeCamera);
+        m_TotalFrames++;
     }
 
     bool Engine::CreateWindow(const char* windowTitle)
@@ -0,0 +1,64 @@
+#include "FrameArena.h"
+
+#include <cassert>
+#include <cstdint>
+
+namespace Glacirer
+{
+    FrameArena::FrameArena(size_t capacity)
+        : m_Block(std::make_unique<unsigned char[]>(capacity)), m_Capacity(capacity)
+    {
+        m_TrackedMemory.SetName("Frame arena");
+        m_TrackedMemory.SetSize(m_Capacity);
+    }
+
+    FrameArena& FrameArena::GetForCurrentThread()
+    {
+        thread_local FrameArena frameArena{};
+
+        return frameArena;
+    }
+
+    void* FrameArena::Allocate(size_t size, size_t alignment)
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+        const uintptr_t blockAddress = reinterpret_cast<uintptr_t>(m_Block.get());
+        const uintptr_t alignedAddress = (blockAddress + m_Offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        const size_t alignedOffset = static_cast<size_t>(alignedAddress - blockAddress);
+
+        if(alignedOffset + size <= m_Capacity)
+        {
+            m_Offset = alignedOffset + size;
+            return reinterpret_cast<void*>(alignedAddress);
+        }
+
+        // Arena is full for this frame, the block only lives until the next reset
+        const size_t overflowBlockSize = size + alignment;
+        m_OverflowBlocks.emplace_back(std::make_unique<unsigned char[]>(overflowBlockSize));
+        m_OverflowSize += overflowBlockSize;
+
+        const uintptr_t overflowBlockAddress = reinterpret_cast<uintptr_t>(m_OverflowBlocks.back().get());
+
+        return reinterpret_cast<void*>((overflowBlockAddress + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+    }
+
+    void FrameArena::Reset()
+    {
+        const size_t usedSize = GetUsedSize();
+        m_PeakUsedSize = usedSize > m_PeakUsedSize ? usedSize : m_PeakUsedSize;
+
+        if(!m_OverflowBlocks.empty())
+        {
+            // Sized for the whole last frame, so the next similar ones never overflow
+            m_Capacity = m_Capacity * 2 > usedSize ? m_Capacity * 2 : usedSize;
+            m_Block = std::make_unique<unsigned char[]>(m_Capacity);
+            m_TrackedMemory.SetSize(m_Capacity);
+
+            m_OverflowBlocks.clear();
+            m_OverflowSize = 0;
+        }
+
+        m_Offset = 0;
+    }
+}
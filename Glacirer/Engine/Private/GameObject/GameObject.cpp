@@ -1,5 +1,7 @@
 #include "GameObject/GameObject.h"
 
+#include <algorithm>
+
 #include "World.h"
 
 namespace Glacirer
@@ -1,81 +1,83 @@
 #include "GameObject/Transform.h"
 
-#include <glm/gtc/quaternion.hpp>
-
 namespace Glacirer
 {
     Transform::Transform(const glm::vec3& position, const glm::vec3& eulerRotation, const glm::vec3& scale)
-        : m_Position(position), m_Rotation(eulerRotation), m_Scale(scale)
-    { }
+        : m_Position(position), m_EulerRotation(eulerRotation), m_Rotation(glm::radians(eulerRotation)), m_Scale(scale)
+    {
+        UpdateRotationBasis();
+    }
 
     void Transform::SetPosition(const glm::vec3& position)
     {
         m_Position = position;
-        bIsDirty = true;
+        MarkChanged();
     }
 
     void Transform::SetRotation(const glm::vec3& eulerRotation)
     {
-        m_Rotation = eulerRotation;
-        bIsDirty = true;
+        m_EulerRotation = eulerRotation;
+        m_Rotation = glm::quat(glm::radians(eulerRotation));
+        UpdateRotationBasis();
+        MarkChanged();
+    }
+
+    void Transform::SetRotation(const glm::quat& rotation)
+    {
+        m_Rotation = glm::normalize(rotation);
+        m_EulerRotation = glm::degrees(glm::eulerAngles(m_Rotation));
+        UpdateRotationBasis();
+        MarkChanged();
     }
 
     void Transform::SetScale(const glm::vec3& scale)
     {
         m_Scale = scale;
-        bIsDirty = true;
+        MarkChanged();
     }
 
     void Transform::SetPositionRotationScale(const glm::vec3& position, const glm::vec3& eulerRotation, const glm::vec3& scale)
     {
         m_Position = position;
-        m_Rotation = eulerRotation;
         m_Scale = scale;
 
-        bIsDirty = true;
-    }
-
-    glm::vec3 Transform::GetForwardVector() const
-    {
-        glm::quat rotationQuat = glm::quat(glm::radians(m_Rotation));
-        glm::mat3 rotationMatrix = glm::mat3_cast(rotationQuat);
-        glm::vec3 worldForward{0.f, 0.f, -1.f};
-        glm::vec3 forward = glm::normalize(rotationMatrix * worldForward);
-
-        return forward;
-    }
-
-    glm::vec3 Transform::GetRightVector() const
-    {
-        return glm::normalize(glm::cross(GetForwardVector(), GetUpVector()));
-    }
-
-    glm::vec3 Transform::GetUpVector() const
-    {
-        glm::quat rotationQuat = glm::quat(glm::radians(m_Rotation));
-        glm::mat3 rotationMatrix = glm::mat3_cast(rotationQuat);
-        glm::vec3 worldUp{0.f, 1.f, 0.f};
-        glm::vec3 up = glm::normalize(rotationMatrix * worldUp);
+        // Inspector sets everything each frame, the rotation only needs converting when it actually changed
+        if(eulerRotation != m_EulerRotation)
+        {
+            m_EulerRotation = eulerRotation;
+            m_Rotation = glm::quat(glm::radians(eulerRotation));
+            UpdateRotationBasis();
+        }
 
-        return up;
+        MarkChanged();
     }
 
-    glm::mat4 Transform::GetMatrix() const
+    const glm::mat4& Transform::GetMatrix() const
     {
         if(!bIsDirty)
         {
             return m_CachedMatrix;
         }
 
-        m_CachedMatrix = glm::mat4(1.f);
-        m_CachedMatrix = glm::translate(m_CachedMatrix, m_Position);
-        glm::quat rotationQuat = glm::quat(glm::radians(m_Rotation));
-        glm::mat4 rotationMatrix = glm::mat4_cast(rotationQuat);
-        m_CachedMatrix *= rotationMatrix;
-        m_CachedMatrix = glm::scale(m_CachedMatrix, m_Scale);
+        // Same as translate * rotate * scale, each basis axis scaled and the position as the last column
+        m_CachedMatrix[0] = glm::vec4(m_RotationBasis[0] * m_Scale.x, 0.f);
+        m_CachedMatrix[1] = glm::vec4(m_RotationBasis[1] * m_Scale.y, 0.f);
+        m_CachedMatrix[2] = glm::vec4(m_RotationBasis[2] * m_Scale.z, 0.f);
+        m_CachedMatrix[3] = glm::vec4(m_Position, 1.f);
 
         bIsDirty = false;
 
         return m_CachedMatrix;
     }
+
+    void Transform::UpdateRotationBasis()
+    {
+        m_RotationBasis = glm::mat3_cast(m_Rotation);
+    }
+
+    void Transform::MarkChanged()
+    {
+        bIsDirty = true;
+        m_Version++;
+    }
 }
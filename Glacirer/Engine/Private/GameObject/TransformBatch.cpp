@@ -0,0 +1,204 @@
+#include "GameObject/TransformBatch.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define GLACIRER_TRANSFORM_BATCH_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    using BenchmarkClock = std::chrono::high_resolution_clock;
+
+    // Best of all iterations, the first ones also pay for cache misses on the inputs
+    template <typename TCompose>
+    double MeasureBestMilliseconds(unsigned int totalIterations, TCompose&& compose)
+    {
+        double bestMilliseconds = std::numeric_limits<double>::max();
+
+        for(unsigned int iteration = 0; iteration < totalIterations; iteration++)
+        {
+            const BenchmarkClock::time_point start = BenchmarkClock::now();
+            compose();
+            const std::chrono::duration<double, std::milli> elapsed = BenchmarkClock::now() - start;
+
+            bestMilliseconds = std::min(bestMilliseconds, elapsed.count());
+        }
+
+        return bestMilliseconds;
+    }
+
+    float GetLargestDifference(const std::vector<glm::mat4>& lhs, const std::vector<glm::mat4>& rhs)
+    {
+        float largestDifference = 0.f;
+
+        for(size_t i = 0; i < lhs.size(); i++)
+        {
+            for(int column = 0; column < 4; column++)
+            {
+                const glm::vec4 difference = glm::abs(lhs[i][column] - rhs[i][column]);
+                largestDifference = glm::max(largestDifference, glm::max(glm::max(difference.x, difference.y), glm::max(difference.z, difference.w)));
+            }
+        }
+
+        return largestDifference;
+    }
+
+#ifdef GLACIRER_TRANSFORM_BATCH_SSE
+    // Lanes hold the same matrix element of four transforms, transposing four element rows gives one column per matrix
+    void StoreColumn(glm::mat4* outMatrices, int column, __m128 x, __m128 y, __m128 z, __m128 w)
+    {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+
+        _mm_storeu_ps(&outMatrices[0][column][0], x);
+        _mm_storeu_ps(&outMatrices[1][column][0], y);
+        _mm_storeu_ps(&outMatrices[2][column][0], z);
+        _mm_storeu_ps(&outMatrices[3][column][0], w);
+    }
+#endif
+}
+
+namespace Glacirer
+{
+    void TransformBatch::Compose(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* outMatrices, size_t count)
+    {
+        size_t i = 0;
+
+#ifdef GLACIRER_TRANSFORM_BATCH_SSE
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.f);
+        const __m128 two = _mm_set1_ps(2.f);
+
+        for(; i + 4 <= count; i += 4)
+        {
+            const glm::quat* q = rotations + i;
+            const glm::vec3* s = scales + i;
+            const glm::vec3* p = positions + i;
+
+            const __m128 qx = _mm_set_ps(q[3].x, q[2].x, q[1].x, q[0].x);
+            const __m128 qy = _mm_set_ps(q[3].y, q[2].y, q[1].y, q[0].y);
+            const __m128 qz = _mm_set_ps(q[3].z, q[2].z, q[1].z, q[0].z);
+            const __m128 qw = _mm_set_ps(q[3].w, q[2].w, q[1].w, q[0].w);
+
+            // Same terms as glm::mat3_cast
+            const __m128 xx = _mm_mul_ps(qx, qx);
+            const __m128 yy = _mm_mul_ps(qy, qy);
+            const __m128 zz = _mm_mul_ps(qz, qz);
+            const __m128 xy = _mm_mul_ps(qx, qy);
+            const __m128 xz = _mm_mul_ps(qx, qz);
+            const __m128 yz = _mm_mul_ps(qy, qz);
+            const __m128 wx = _mm_mul_ps(qw, qx);
+            const __m128 wy = _mm_mul_ps(qw, qy);
+            const __m128 wz = _mm_mul_ps(qw, qz);
+
+            const __m128 sx = _mm_set_ps(s[3].x, s[2].x, s[1].x, s[0].x);
+            const __m128 sy = _mm_set_ps(s[3].y, s[2].y, s[1].y, s[0].y);
+            const __m128 sz = _mm_set_ps(s[3].z, s[2].z, s[1].z, s[0].z);
+
+            const __m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+            const __m128 m01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+            const __m128 m02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+
+            const __m128 m10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+            const __m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+            const __m128 m12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+
+            const __m128 m20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+            const __m128 m21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+            const __m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+            const __m128 px = _mm_set_ps(p[3].x, p[2].x, p[1].x, p[0].x);
+            const __m128 py = _mm_set_ps(p[3].y, p[2].y, p[1].y, p[0].y);
+            const __m128 pz = _mm_set_ps(p[3].z, p[2].z, p[1].z, p[0].z);
+
+            StoreColumn(outMatrices + i, 0, m00, m01, m02, zero);
+            StoreColumn(outMatrices + i, 1, m10, m11, m12, zero);
+            StoreColumn(outMatrices + i, 2, m20, m21, m22, zero);
+            StoreColumn(outMatrices + i, 3, px, py, pz, one);
+        }
+#endif
+
+        ComposeScalar(positions + i, rotations + i, scales + i, outMatrices + i, count - i);
+    }
+
+    void TransformBatch::ComposeScalar(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* outMatrices, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            const glm::mat3 rotationBasis = glm::mat3_cast(rotations[i]);
+
+            outMatrices[i][0] = glm::vec4(rotationBasis[0] * scales[i].x, 0.f);
+            outMatrices[i][1] = glm::vec4(rotationBasis[1] * scales[i].y, 0.f);
+            outMatrices[i][2] = glm::vec4(rotationBasis[2] * scales[i].z, 0.f);
+            outMatrices[i][3] = glm::vec4(positions[i], 1.f);
+        }
+    }
+
+    void TransformBatch::Benchmark(std::ostream& stream, size_t totalTransforms, unsigned int totalIterations)
+    {
+        std::mt19937 generator{42};
+        std::uniform_real_distribution<float> positionDistribution{-100.f, 100.f};
+        std::uniform_real_distribution<float> unitDistribution{-1.f, 1.f};
+        std::uniform_real_distribution<float> scaleDistribution{0.1f, 10.f};
+
+        std::vector<glm::vec3> positions(totalTransforms);
+        std::vector<glm::quat> rotations(totalTransforms);
+        std::vector<glm::vec3> scales(totalTransforms);
+
+        for(size_t i = 0; i < totalTransforms; i++)
+        {
+            positions[i] = glm::vec3{positionDistribution(generator), positionDistribution(generator), positionDistribution(generator)};
+            rotations[i] = glm::normalize(glm::quat{unitDistribution(generator), unitDistribution(generator), unitDistribution(generator), unitDistribution(generator)});
+            scales[i] = glm::vec3{scaleDistribution(generator), scaleDistribution(generator), scaleDistribution(generator)};
+        }
+
+        std::vector<glm::mat4> glmMatrices(totalTransforms);
+        std::vector<glm::mat4> scalarMatrices(totalTransforms);
+        std::vector<glm::mat4> batchMatrices(totalTransforms);
+
+        const double glmMilliseconds = MeasureBestMilliseconds(totalIterations, [&]()
+        {
+            for(size_t i = 0; i < totalTransforms; i++)
+            {
+                glmMatrices[i] = glm::translate(glm::mat4{1.f}, positions[i]) * glm::mat4_cast(rotations[i]) * glm::scale(glm::mat4{1.f}, scales[i]);
+            }
+        });
+
+        const double scalarMilliseconds = MeasureBestMilliseconds(totalIterations, [&]()
+        {
+            ComposeScalar(positions.data(), rotations.data(), scales.data(), scalarMatrices.data(), totalTransforms);
+        });
+
+        const double batchMilliseconds = MeasureBestMilliseconds(totalIterations, [&]()
+        {
+            Compose(positions.data(), rotations.data(), scales.data(), batchMatrices.data(), totalTransforms);
+        });
+
+        const std::ios::fmtflags previousFlags = stream.flags();
+        const std::streamsize previousPrecision = stream.precision();
+        stream << std::fixed << std::setprecision(3);
+
+        stream << "Transform composition, " << totalTransforms << " transforms (best of " << totalIterations << "):\n"
+               << "  glm multiplies " << glmMilliseconds << " ms\n"
+               << "  scalar         " << scalarMilliseconds << " ms (" << glmMilliseconds / scalarMilliseconds << "x)\n"
+#ifdef GLACIRER_TRANSFORM_BATCH_SSE
+               << "  SSE            "
+#else
+               << "  batch (no SSE) "
+#endif
+               << batchMilliseconds << " ms (" << glmMilliseconds / batchMilliseconds << "x)\n"
+               << std::scientific << std::setprecision(1)
+               << "  largest difference from glm " << glm::max(GetLargestDifference(glmMatrices, scalarMatrices), GetLargestDifference(glmMatrices, batchMatrices)) << "\n";
+
+        stream.flags(previousFlags);
+        stream.precision(previousPrecision);
+    }
+}
@@ -0,0 +1,318 @@
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <array>
+#include <iomanip>
+#include <mutex>
+#include <unordered_set>
+
+#include "AllocationCounter.h"
+
+namespace
+{
+    constexpr size_t TOTAL_CATEGORIES = static_cast<size_t>(Glacirer::MemoryCategory::Count);
+    constexpr double BYTES_PER_MEGABYTE = 1024.0 * 1024.0;
+
+    struct MemoryTrackerState
+    {
+        std::mutex Mutex{};
+        std::array<Glacirer::MemoryCategoryStats, TOTAL_CATEGORIES> CategoryStats{};
+        std::unordered_set<Glacirer::TrackedMemory*> Resources{};
+        size_t LiveGpuBytes{0};
+        size_t PeakGpuBytes{0};
+        size_t LiveCpuBytes{0};
+        size_t PeakCpuBytes{0};
+    };
+
+    MemoryTrackerState& GetState()
+    {
+        // Never destroyed, resources held by other statics are still released after this translation unit ones
+        static MemoryTrackerState* state = new MemoryTrackerState();
+
+        return *state;
+    }
+
+    // Resources without storage yet (or anymore) aren't counted in their category
+    void AddBytes(MemoryTrackerState& state, Glacirer::MemoryCategory category, size_t bytes)
+    {
+        if(bytes == 0)
+        {
+            return;
+        }
+
+        Glacirer::MemoryCategoryStats& stats = state.CategoryStats[static_cast<size_t>(category)];
+        stats.TotalResources++;
+        stats.LiveBytes += bytes;
+        stats.PeakBytes = std::max(stats.PeakBytes, stats.LiveBytes);
+
+        if(Glacirer::MemoryTracker::IsGpuCategory(category))
+        {
+            state.LiveGpuBytes += bytes;
+            state.PeakGpuBytes = std::max(state.PeakGpuBytes, state.LiveGpuBytes);
+        }
+        else
+        {
+            state.LiveCpuBytes += bytes;
+            state.PeakCpuBytes = std::max(state.PeakCpuBytes, state.LiveCpuBytes);
+        }
+    }
+
+    void RemoveBytes(MemoryTrackerState& state, Glacirer::MemoryCategory category, size_t bytes)
+    {
+        if(bytes == 0)
+        {
+            return;
+        }
+
+        Glacirer::MemoryCategoryStats& stats = state.CategoryStats[static_cast<size_t>(category)];
+        stats.LiveBytes -= bytes;
+        stats.TotalResources--;
+        (Glacirer::MemoryTracker::IsGpuCategory(category) ? state.LiveGpuBytes : state.LiveCpuBytes) -= bytes;
+    }
+
+    double ToMegabytes(size_t bytes)
+    {
+        return static_cast<double>(bytes) / BYTES_PER_MEGABYTE;
+    }
+}
+
+namespace Glacirer
+{
+    TrackedMemory::TrackedMemory(MemoryCategory category)
+        : m_Category(category)
+    {
+        MemoryTracker::Register(*this);
+    }
+
+    TrackedMemory::~TrackedMemory()
+    {
+        MemoryTracker::Unregister(*this);
+    }
+
+    void TrackedMemory::SetSize(size_t bytes)
+    {
+        if(bytes != m_Size)
+        {
+            MemoryTracker::Update(*this, m_Category, bytes);
+        }
+    }
+
+    void TrackedMemory::SetCategory(MemoryCategory category)
+    {
+        if(category != m_Category)
+        {
+            MemoryTracker::Update(*this, category, m_Size);
+        }
+    }
+
+    void TrackedMemory::SetName(const std::string& name)
+    {
+        MemoryTracker::Rename(*this, name);
+    }
+
+    const char* MemoryTracker::GetCategoryName(MemoryCategory category)
+    {
+        switch(category)
+        {
+            case MemoryCategory::Textures:
+                return "Textures";
+            case MemoryCategory::Cubemaps:
+                return "Cubemaps";
+            case MemoryCategory::RenderTargets:
+                return "Render targets";
+            case MemoryCategory::ShadowMaps:
+                return "Shadow maps";
+            case MemoryCategory::VertexBuffers:
+                return "Vertex buffers";
+            case MemoryCategory::IndexBuffers:
+                return "Index buffers";
+            case MemoryCategory::GeometryBuffers:
+                return "Geometry buffers";
+            case MemoryCategory::UniformBuffers:
+                return "Uniform buffers";
+            case MemoryCategory::RingBuffers:
+                return "Ring buffers";
+            case MemoryCategory::MeshData:
+                return "Mesh data";
+            case MemoryCategory::SceneQueries:
+                return "Scene queries";
+            case MemoryCategory::FrameArenas:
+                return "Frame arenas";
+            default:
+                return "Unknown";
+        }
+    }
+
+    bool MemoryTracker::IsGpuCategory(MemoryCategory category)
+    {
+        return category < MemoryCategory::MeshData;
+    }
+
+    MemoryCategoryStats MemoryTracker::GetCategoryStats(MemoryCategory category)
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        return state.CategoryStats[static_cast<size_t>(category)];
+    }
+
+    size_t MemoryTracker::GetLiveGpuBytes()
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        return state.LiveGpuBytes;
+    }
+
+    size_t MemoryTracker::GetPeakGpuBytes()
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        return state.PeakGpuBytes;
+    }
+
+    size_t MemoryTracker::GetLiveCpuBytes()
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        return state.LiveCpuBytes;
+    }
+
+    size_t MemoryTracker::GetPeakCpuBytes()
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        return state.PeakCpuBytes;
+    }
+
+    std::vector<MemoryResourceInfo> MemoryTracker::GetLargestResources(size_t maxResources)
+    {
+        MemoryTrackerState& state = GetState();
+        std::vector<const TrackedMemory*> resources{};
+
+        std::lock_guard<std::mutex> lock(state.Mutex);
+        resources.reserve(state.Resources.size());
+
+        for(const TrackedMemory* resource : state.Resources)
+        {
+            if(resource->m_Size > 0)
+            {
+                resources.push_back(resource);
+            }
+        }
+
+        const size_t totalResources = std::min(maxResources, resources.size());
+        std::partial_sort(resources.begin(), resources.begin() + totalResources, resources.end(), [](const TrackedMemory* lhs, const TrackedMemory* rhs)
+        {
+            return lhs->m_Size > rhs->m_Size;
+        });
+
+        std::vector<MemoryResourceInfo> largestResources{};
+        largestResources.reserve(totalResources);
+
+        for(size_t i = 0; i < totalResources; i++)
+        {
+            MemoryResourceInfo resourceInfo{};
+            resourceInfo.Name = resources[i]->m_Name;
+            resourceInfo.Category = resources[i]->m_Category;
+            resourceInfo.Bytes = resources[i]->m_Size;
+            largestResources.push_back(std::move(resourceInfo));
+        }
+
+        return largestResources;
+    }
+
+    void MemoryTracker::Dump(std::ostream& stream, size_t maxResources)
+    {
+        const std::ios::fmtflags previousFlags = stream.flags();
+        const std::streamsize previousPrecision = stream.precision();
+        stream << std::fixed << std::setprecision(2);
+
+        stream << "Memory: GPU " << ToMegabytes(GetLiveGpuBytes()) << " MB (peak " << ToMegabytes(GetPeakGpuBytes()) << " MB), "
+               << "tracked CPU buffers " << ToMegabytes(GetLiveCpuBytes()) << " MB (peak " << ToMegabytes(GetPeakCpuBytes()) << " MB)\n";
+
+        for(size_t i = 0; i < TOTAL_CATEGORIES; i++)
+        {
+            const MemoryCategory category = static_cast<MemoryCategory>(i);
+            const MemoryCategoryStats stats = GetCategoryStats(category);
+
+            stream << "  " << std::left << std::setw(18) << GetCategoryName(category) << std::right
+                   << (IsGpuCategory(category) ? " GPU " : " CPU ")
+                   << std::setw(10) << ToMegabytes(stats.LiveBytes) << " MB, peak "
+                   << std::setw(10) << ToMegabytes(stats.PeakBytes) << " MB, " << stats.TotalResources << " resources\n";
+        }
+
+        if(AllocationCounter::IsTaggingSupported())
+        {
+            size_t totalTaggedBytes = 0;
+
+            stream << "Heap allocations by tag:\n";
+
+            for(size_t i = 1; i < static_cast<size_t>(AllocationTag::Count); i++)
+            {
+                const AllocationTag tag = static_cast<AllocationTag>(i);
+                const AllocationTagStats stats = AllocationCounter::GetTagStats(tag);
+                totalTaggedBytes += stats.LiveBytes;
+
+                stream << "  " << std::left << std::setw(18) << AllocationCounter::GetTagName(tag) << std::right
+                       << "     " << std::setw(10) << ToMegabytes(stats.LiveBytes) << " MB, peak "
+                       << std::setw(10) << ToMegabytes(stats.PeakBytes) << " MB, " << stats.LiveAllocations << " allocations\n";
+            }
+
+            stream << "  " << std::left << std::setw(18) << "Total" << std::right
+                   << "     " << std::setw(10) << ToMegabytes(totalTaggedBytes) << " MB\n";
+        }
+
+        stream << "Largest resources:\n";
+
+        for(const MemoryResourceInfo& resourceInfo : GetLargestResources(maxResources))
+        {
+            stream << "  " << std::setw(10) << ToMegabytes(resourceInfo.Bytes) << " MB  "
+                   << GetCategoryName(resourceInfo.Category) << "  " << (resourceInfo.Name.empty() ? "(unnamed)" : resourceInfo.Name) << "\n";
+        }
+
+        stream.flags(previousFlags);
+        stream.precision(previousPrecision);
+    }
+
+    void MemoryTracker::Register(TrackedMemory& trackedMemory)
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        state.Resources.insert(&trackedMemory);
+    }
+
+    void MemoryTracker::Unregister(TrackedMemory& trackedMemory)
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        state.Resources.erase(&trackedMemory);
+        RemoveBytes(state, trackedMemory.m_Category, trackedMemory.m_Size);
+    }
+
+    void MemoryTracker::Update(TrackedMemory& trackedMemory, MemoryCategory category, size_t bytes)
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        RemoveBytes(state, trackedMemory.m_Category, trackedMemory.m_Size);
+
+        trackedMemory.m_Category = category;
+        trackedMemory.m_Size = bytes;
+
+        AddBytes(state, category, bytes);
+    }
+
+    void MemoryTracker::Rename(TrackedMemory& trackedMemory, const std::string& name)
+    {
+        MemoryTrackerState& state = GetState();
+        std::lock_guard<std::mutex> lock(state.Mutex);
+
+        trackedMemory.m_Name = name;
+    }
+}
@@ -0,0 +1,126 @@
+#include "Physics/BoundingVolumeHierarchy.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Glacirer
+{
+    namespace Physics
+    {
+        void BoundingVolumeHierarchy::Build(const std::vector<Rendering::Bounds>& primitiveBounds, uint32_t maxLeafPrimitives)
+        {
+            Clear();
+
+            const uint32_t totalPrimitives = static_cast<uint32_t>(primitiveBounds.size());
+
+            if(totalPrimitives == 0)
+            {
+                return;
+            }
+
+            m_PrimitiveIndices.resize(totalPrimitives);
+            std::iota(m_PrimitiveIndices.begin(), m_PrimitiveIndices.end(), 0u);
+
+            std::vector<glm::vec3> primitiveCenters{};
+            primitiveCenters.reserve(totalPrimitives);
+
+            for(const Rendering::Bounds& bounds : primitiveBounds)
+            {
+                primitiveCenters.push_back(bounds.GetCenter());
+            }
+
+            m_Nodes.reserve(2 * totalPrimitives);
+            m_Nodes.emplace_back();
+
+            BuildNode(0, 0, totalPrimitives, glm::max(maxLeafPrimitives, 1u), primitiveBounds, primitiveCenters);
+        }
+
+        void BoundingVolumeHierarchy::Refit(const std::vector<Rendering::Bounds>& primitiveBounds)
+        {
+            for(size_t i = m_Nodes.size(); i-- > 0;)
+            {
+                Node& node = m_Nodes[i];
+                node.Bounds = Rendering::Bounds{};
+
+                if(node.IsLeaf())
+                {
+                    for(uint32_t j = 0; j < node.TotalPrimitives; j++)
+                    {
+                        node.Bounds.Encapsulate(primitiveBounds[m_PrimitiveIndices[node.FirstIndex + j]]);
+                    }
+                }
+                else
+                {
+                    node.Bounds.Encapsulate(m_Nodes[node.FirstIndex].Bounds);
+                    node.Bounds.Encapsulate(m_Nodes[node.FirstIndex + 1].Bounds);
+                }
+            }
+        }
+
+        void BoundingVolumeHierarchy::Clear()
+        {
+            m_Nodes.clear();
+            m_PrimitiveIndices.clear();
+        }
+
+        bool BoundingVolumeHierarchy::IntersectRay(const Rendering::Bounds& bounds, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& outDistance)
+        {
+            // Slab test, infinite inverse direction components (rays parallel to an axis) end up as infinite slabs
+            const glm::vec3 minDistances = (bounds.Min - origin) * inverseDirection;
+            const glm::vec3 maxDistances = (bounds.Max - origin) * inverseDirection;
+            const glm::vec3 nearDistances = glm::min(minDistances, maxDistances);
+            const glm::vec3 farDistances = glm::max(minDistances, maxDistances);
+
+            const float entryDistance = glm::max(glm::max(nearDistances.x, nearDistances.y), glm::max(nearDistances.z, 0.f));
+            const float exitDistance = glm::min(glm::min(farDistances.x, farDistances.y), glm::min(farDistances.z, maxDistance));
+
+            outDistance = entryDistance;
+
+            return entryDistance <= exitDistance;
+        }
+
+        void BoundingVolumeHierarchy::BuildNode(uint32_t nodeIndex, uint32_t firstPrimitive, uint32_t totalPrimitives, uint32_t maxLeafPrimitives,
+            const std::vector<Rendering::Bounds>& primitiveBounds, const std::vector<glm::vec3>& primitiveCenters)
+        {
+            Rendering::Bounds bounds{};
+            Rendering::Bounds centerBounds{};
+
+            for(uint32_t i = firstPrimitive; i < firstPrimitive + totalPrimitives; i++)
+            {
+                const uint32_t primitiveIndex = m_PrimitiveIndices[i];
+                bounds.Encapsulate(primitiveBounds[primitiveIndex]);
+                centerBounds.Encapsulate(primitiveCenters[primitiveIndex]);
+            }
+
+            m_Nodes[nodeIndex].Bounds = bounds;
+
+            if(totalPrimitives <= maxLeafPrimitives)
+            {
+                m_Nodes[nodeIndex].FirstIndex = firstPrimitive;
+                m_Nodes[nodeIndex].TotalPrimitives = totalPrimitives;
+                return;
+            }
+
+            const glm::vec3 centerExtents = centerBounds.GetExtents();
+            int axis = centerExtents.x > centerExtents.y ? 0 : 1;
+            axis = centerExtents.z > centerExtents[axis] ? 2 : axis;
+
+            // Splitting by count rather than position keeps the tree balanced even for coincident centers
+            const uint32_t totalFirstPrimitives = totalPrimitives / 2;
+            auto first = m_PrimitiveIndices.begin() + firstPrimitive;
+
+            std::nth_element(first, first + totalFirstPrimitives, first + totalPrimitives, [&primitiveCenters, axis](uint32_t a, uint32_t b)
+            {
+                return primitiveCenters[a][axis] < primitiveCenters[b][axis];
+            });
+
+            const uint32_t firstChildIndex = static_cast<uint32_t>(m_Nodes.size());
+            m_Nodes[nodeIndex].FirstIndex = firstChildIndex;
+            m_Nodes.emplace_back();
+            m_Nodes.emplace_back();
+
+            BuildNode(firstChildIndex, firstPrimitive, totalFirstPrimitives, maxLeafPrimitives, primitiveBounds, primitiveCenters);
+            BuildNode(firstChildIndex + 1, firstPrimitive + totalFirstPrimitives, totalPrimitives - totalFirstPrimitives, maxLeafPrimitives, primitiveBounds, primitiveCenters);
+        }
+    }
+}
@@ -0,0 +1,309 @@
+#include "Physics/SceneQuerySystem.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "AllocationCounter.h"
+#include "Basics/Components/MeshComponent.h"
+#include "GameObject/Transform.h"
+#include "GameObject/TransformBatch.h"
+#include "Physics/TriangleBVH.h"
+#include "Rendering/Mesh.h"
+
+namespace Glacirer
+{
+    namespace Physics
+    {
+        void SceneQuerySystem::AddMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent)
+        {
+            if(m_EntryIndices.count(meshComponent.get()) > 0)
+            {
+                return;
+            }
+
+            Entry entry{};
+            entry.MeshComponent = meshComponent;
+
+            m_EntryIndices[meshComponent.get()] = static_cast<uint32_t>(m_Entries.size());
+            m_Entries.push_back(entry);
+            m_EntryBounds.emplace_back();
+
+            m_TrackedMemory.SetSize(GetCpuMemory());
+        }
+
+        void SceneQuerySystem::RemoveMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent)
+        {
+            auto iterator = m_EntryIndices.find(meshComponent.get());
+
+            if(iterator == m_EntryIndices.end())
+            {
+                std::cout << "ERROR::SCENE_QUERY_SYSTEM: Removing a mesh component that was never added\n";
+                return;
+            }
+
+            // Entry stays where it is so the tree doesn't change, it's dropped on the next build
+            m_Entries[iterator->second].MeshComponent.reset();
+            m_EntryIndices.erase(iterator);
+            m_TotalRemovedEntries++;
+        }
+
+        void SceneQuerySystem::Clear()
+        {
+            m_Entries.clear();
+            m_EntryBounds.clear();
+            m_EntryIndices.clear();
+            m_BVH.Clear();
+            m_TotalIndexedEntries = 0;
+            m_TotalRemovedEntries = 0;
+            bAreTransformsOutdated = false;
+
+            m_TrackedMemory.SetSize(GetCpuMemory());
+        }
+
+        bool SceneQuerySystem::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& outHit)
+        {
+            Refresh();
+
+            const glm::vec3 normalizedDirection = glm::normalize(direction);
+            const glm::vec3 inverseDirection = 1.f / normalizedDirection;
+            float closestDistance = maxDistance;
+            bool bHasHit = false;
+
+            auto raycastEntry = [&](uint32_t entryIndex)
+            {
+                const Entry& entry = m_Entries[entryIndex];
+                float entryDistance;
+
+                if(!entry.MeshComponent || !BoundingVolumeHierarchy::IntersectRay(m_EntryBounds[entryIndex], origin, inverseDirection, closestDistance, entryDistance))
+                {
+                    return;
+                }
+
+                // Ray goes to object space instead of triangles to world space, the direction isn't normalized
+                // again so distances along it stay world space ones
+                const glm::mat4 inverseMatrix = glm::inverse(entry.Matrix);
+                const glm::vec3 localOrigin = glm::vec3(inverseMatrix * glm::vec4(origin, 1.f));
+                const glm::vec3 localDirection = glm::mat3(inverseMatrix) * normalizedDirection;
+
+                RayTriangleHit triangleHit{};
+                if(!entry.MeshComponent->GetMesh()->GetTriangleBVH().Raycast(localOrigin, localDirection, closestDistance, triangleHit))
+                {
+                    return;
+                }
+
+                glm::vec3 normal = glm::normalize(glm::transpose(glm::mat3(inverseMatrix)) * triangleHit.Normal);
+                normal = glm::dot(normal, normalizedDirection) > 0.f ? -normal : normal;
+
+                closestDistance = triangleHit.Distance;
+                bHasHit = true;
+
+                outHit.MeshComponent = entry.MeshComponent;
+                outHit.Distance = triangleHit.Distance;
+                outHit.Point = origin + normalizedDirection * triangleHit.Distance;
+                outHit.Normal = normal;
+                outHit.TriangleIndex = triangleHit.TriangleIndex;
+            };
+
+            const std::vector<uint32_t>& primitiveIndices = m_BVH.GetPrimitiveIndices();
+
+            m_BVH.Raycast(origin, normalizedDirection, closestDistance, [&](const BoundingVolumeHierarchy::Node& node)
+            {
+                for(uint32_t i = 0; i < node.TotalPrimitives; i++)
+                {
+                    raycastEntry(primitiveIndices[node.FirstIndex + i]);
+                }
+            });
+
+            for(uint32_t entryIndex = m_TotalIndexedEntries; entryIndex < m_Entries.size(); entryIndex++)
+            {
+                raycastEntry(entryIndex);
+            }
+
+            return bHasHit;
+        }
+
+        void SceneQuerySystem::OverlapSphere(const glm::vec3& center, float radius, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents)
+        {
+            Refresh();
+
+            QueryEntries([&center, radius](const Rendering::Bounds& bounds)
+            {
+                const glm::vec3 offset = glm::clamp(center, bounds.Min, bounds.Max) - center;
+                return glm::dot(offset, offset) <= radius * radius;
+            },
+            [&](const Entry& entry)
+            {
+                if(entry.MeshComponent->GetMesh()->GetTriangleBVH().OverlapsSphere(entry.Matrix, center, radius))
+                {
+                    outMeshComponents.push_back(entry.MeshComponent);
+                }
+            });
+        }
+
+        void SceneQuerySystem::OverlapBox(const glm::vec3& center, const glm::vec3& halfExtents, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents)
+        {
+            Refresh();
+
+            Rendering::Bounds box{};
+            box.Min = center - halfExtents;
+            box.Max = center + halfExtents;
+
+            QueryEntries([&box](const Rendering::Bounds& bounds)
+            {
+                return glm::all(glm::lessThanEqual(bounds.Min, box.Max)) && glm::all(glm::greaterThanEqual(bounds.Max, box.Min));
+            },
+            [&](const Entry& entry)
+            {
+                if(entry.MeshComponent->GetMesh()->GetTriangleBVH().OverlapsBox(entry.Matrix, box))
+                {
+                    outMeshComponents.push_back(entry.MeshComponent);
+                }
+            });
+        }
+
+        size_t SceneQuerySystem::GetCpuMemory() const
+        {
+            return m_Entries.capacity() * sizeof(Entry)
+                + m_EntryBounds.capacity() * sizeof(Rendering::Bounds)
+                + m_EntryIndices.size() * (sizeof(const MeshComponent*) + sizeof(uint32_t))
+                + m_MovedEntryIndices.capacity() * sizeof(uint32_t)
+                + (m_MovedPositions.capacity() + m_MovedScales.capacity()) * sizeof(glm::vec3)
+                + m_MovedRotations.capacity() * sizeof(glm::quat)
+                + m_MovedMatrices.capacity() * sizeof(glm::mat4)
+                + m_BVH.GetCpuMemory();
+        }
+
+        void SceneQuerySystem::Refresh()
+        {
+            // Queries can come from any system, rebuilds are still accounted to scene queries
+            AllocationTagScope tagScope{AllocationTag::SceneQueries};
+
+            const uint32_t totalUnindexedEntries = static_cast<uint32_t>(m_Entries.size()) - m_TotalIndexedEntries;
+
+            if(totalUnindexedEntries + m_TotalRemovedEntries > MAX_PENDING_CHANGES)
+            {
+                Rebuild();
+                return;
+            }
+
+            // Transforms only need to be compared once per world update, entries added since still need their bounds
+            const uint32_t firstEntryToUpdate = bAreTransformsOutdated ? 0 : m_TotalIndexedEntries;
+            if(UpdateEntryBounds(firstEntryToUpdate))
+            {
+                m_BVH.Refit(m_EntryBounds);
+            }
+
+            bAreTransformsOutdated = false;
+        }
+
+        void SceneQuerySystem::Rebuild()
+        {
+            m_Entries.erase(std::remove_if(m_Entries.begin(), m_Entries.end(), [](const Entry& entry)
+            {
+                return !entry.MeshComponent;
+            }), m_Entries.end());
+
+            m_EntryBounds.resize(m_Entries.size());
+            m_EntryIndices.clear();
+
+            for(uint32_t entryIndex = 0; entryIndex < m_Entries.size(); entryIndex++)
+            {
+                m_EntryIndices[m_Entries[entryIndex].MeshComponent.get()] = entryIndex;
+
+                // Compaction moved entries around, their bounds have to follow them
+                m_Entries[entryIndex].bIsBoundsOutdated = true;
+            }
+
+            UpdateEntryBounds(0);
+
+            m_BVH.Build(m_EntryBounds, MAX_LEAF_COMPONENTS);
+
+            m_TotalIndexedEntries = static_cast<uint32_t>(m_Entries.size());
+            m_TotalRemovedEntries = 0;
+            bAreTransformsOutdated = false;
+
+            m_TrackedMemory.SetSize(GetCpuMemory());
+        }
+
+        bool SceneQuerySystem::UpdateEntryBounds(uint32_t firstEntryIndex)
+        {
+            m_MovedEntryIndices.clear();
+            m_MovedPositions.clear();
+            m_MovedRotations.clear();
+            m_MovedScales.clear();
+
+            for(uint32_t entryIndex = firstEntryIndex; entryIndex < m_Entries.size(); entryIndex++)
+            {
+                Entry& entry = m_Entries[entryIndex];
+
+                if(!entry.MeshComponent)
+                {
+                    continue;
+                }
+
+                const Transform& transform = entry.MeshComponent->GetOwnerTransform();
+
+                if(!entry.bIsBoundsOutdated && transform.GetVersion() == entry.TransformVersion)
+                {
+                    continue;
+                }
+
+                entry.TransformVersion = transform.GetVersion();
+                entry.bIsBoundsOutdated = false;
+
+                m_MovedEntryIndices.push_back(entryIndex);
+                m_MovedPositions.push_back(transform.GetPosition());
+                m_MovedRotations.push_back(transform.GetRotationQuaternion());
+                m_MovedScales.push_back(transform.GetScale());
+            }
+
+            // Moved entries are gathered first so their matrices are composed in one batch
+            m_MovedMatrices.resize(m_MovedEntryIndices.size());
+            TransformBatch::Compose(m_MovedPositions.data(), m_MovedRotations.data(), m_MovedScales.data(), m_MovedMatrices.data(), m_MovedMatrices.size());
+
+            bool bHasIndexedEntryMoved = false;
+
+            for(size_t i = 0; i < m_MovedEntryIndices.size(); i++)
+            {
+                const uint32_t entryIndex = m_MovedEntryIndices[i];
+                Entry& entry = m_Entries[entryIndex];
+
+                entry.Matrix = m_MovedMatrices[i];
+                m_EntryBounds[entryIndex] = entry.MeshComponent->GetMesh()->GetBounds().Transform(entry.Matrix);
+
+                bHasIndexedEntryMoved |= entryIndex < m_TotalIndexedEntries;
+            }
+
+            return bHasIndexedEntryMoved;
+        }
+
+        template <typename TBoundsTest, typename TEntryVisitor>
+        void SceneQuerySystem::QueryEntries(TBoundsTest&& boundsTest, TEntryVisitor&& entryVisitor)
+        {
+            const std::vector<uint32_t>& primitiveIndices = m_BVH.GetPrimitiveIndices();
+
+            auto queryEntry = [&](uint32_t entryIndex)
+            {
+                if(m_Entries[entryIndex].MeshComponent && boundsTest(m_EntryBounds[entryIndex]))
+                {
+                    entryVisitor(m_Entries[entryIndex]);
+                }
+            };
+
+            m_BVH.Query(boundsTest, [&](const BoundingVolumeHierarchy::Node& node)
+            {
+                for(uint32_t i = 0; i < node.TotalPrimitives; i++)
+                {
+                    queryEntry(primitiveIndices[node.FirstIndex + i]);
+                }
+
+                return true;
+            });
+
+            for(uint32_t entryIndex = m_TotalIndexedEntries; entryIndex < m_Entries.size(); entryIndex++)
+            {
+                queryEntry(entryIndex);
+            }
+        }
+    }
+}
@@ -0,0 +1,391 @@
+#include "Physics/TriangleBVH.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define GLACIRER_TRIANGLE_BVH_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    // Rays closer than this to the triangle plane (relative to the edges and direction lengths) count as parallel
+    constexpr float DETERMINANT_EPSILON = 1e-12f;
+
+    glm::vec3 GetClosestPointOnTriangle(const glm::vec3& point, const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+    {
+        // Voronoi regions of the triangle features (Ericson, Real-Time Collision Detection 5.1.5)
+        const glm::vec3 ab = b - a;
+        const glm::vec3 ac = c - a;
+        const glm::vec3 ap = point - a;
+
+        const float d1 = glm::dot(ab, ap);
+        const float d2 = glm::dot(ac, ap);
+        if(d1 <= 0.f && d2 <= 0.f)
+        {
+            return a;
+        }
+
+        const glm::vec3 bp = point - b;
+        const float d3 = glm::dot(ab, bp);
+        const float d4 = glm::dot(ac, bp);
+        if(d3 >= 0.f && d4 <= d3)
+        {
+            return b;
+        }
+
+        const float vc = d1 * d4 - d3 * d2;
+        if(vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+        {
+            return a + ab * (d1 / (d1 - d3));
+        }
+
+        const glm::vec3 cp = point - c;
+        const float d5 = glm::dot(ab, cp);
+        const float d6 = glm::dot(ac, cp);
+        if(d6 >= 0.f && d5 <= d6)
+        {
+            return c;
+        }
+
+        const float vb = d5 * d2 - d1 * d6;
+        if(vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+        {
+            return a + ac * (d2 / (d2 - d6));
+        }
+
+        const float va = d3 * d6 - d5 * d4;
+        if(va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f)
+        {
+            return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        }
+
+        const float denominator = 1.f / (va + vb + vc);
+        return a + ab * (vb * denominator) + ac * (vc * denominator);
+    }
+
+    bool IsSeparatingAxis(const glm::vec3& axis, const glm::vec3 vertices[3], const glm::vec3& boxExtents)
+    {
+        const float p0 = glm::dot(axis, vertices[0]);
+        const float p1 = glm::dot(axis, vertices[1]);
+        const float p2 = glm::dot(axis, vertices[2]);
+        const float radius = glm::dot(boxExtents, glm::abs(axis));
+
+        return std::min({p0, p1, p2}) > radius || std::max({p0, p1, p2}) < -radius;
+    }
+
+    bool TriangleOverlapsBox(const glm::vec3 triangle[3], const Glacirer::Rendering::Bounds& box)
+    {
+        // Separating axis test (Akenine-Moller), relative to the box center: box axes, triangle normal and edge/axis cross products
+        const glm::vec3 center = box.GetCenter();
+        const glm::vec3 extents = box.GetExtents();
+        const glm::vec3 vertices[3] = {triangle[0] - center, triangle[1] - center, triangle[2] - center};
+        const glm::vec3 edges[3] = {vertices[1] - vertices[0], vertices[2] - vertices[1], vertices[0] - vertices[2]};
+
+        for(int axis = 0; axis < 3; axis++)
+        {
+            glm::vec3 boxAxis{0.f};
+            boxAxis[axis] = 1.f;
+
+            if(IsSeparatingAxis(boxAxis, vertices, extents))
+            {
+                return false;
+            }
+
+            for(const glm::vec3& edge : edges)
+            {
+                if(IsSeparatingAxis(glm::cross(edge, boxAxis), vertices, extents))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return !IsSeparatingAxis(glm::cross(edges[0], edges[1]), vertices, extents);
+    }
+
+    bool BoundsOverlapSphere(const Glacirer::Rendering::Bounds& bounds, const glm::vec3& center, float radius)
+    {
+        const glm::vec3 closestPoint = glm::clamp(center, bounds.Min, bounds.Max);
+        const glm::vec3 offset = closestPoint - center;
+
+        return glm::dot(offset, offset) <= radius * radius;
+    }
+
+    bool BoundsOverlap(const Glacirer::Rendering::Bounds& a, const Glacirer::Rendering::Bounds& b)
+    {
+        return a.Min.x <= b.Max.x && a.Max.x >= b.Min.x
+            && a.Min.y <= b.Max.y && a.Max.y >= b.Min.y
+            && a.Min.z <= b.Max.z && a.Max.z >= b.Min.z;
+    }
+}
+
+namespace Glacirer
+{
+    namespace Physics
+    {
+        TriangleBVH::TriangleBVH(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+        {
+            m_TotalTriangles = static_cast<unsigned int>(indices.size() / 3);
+
+            std::vector<Rendering::Bounds> triangleBounds(m_TotalTriangles);
+
+            for(unsigned int i = 0; i < m_TotalTriangles; i++)
+            {
+                for(unsigned int j = 0; j < 3; j++)
+                {
+                    triangleBounds[i].Encapsulate(positions[indices[i * 3 + j]]);
+                }
+            }
+
+            m_BVH.Build(triangleBounds, PACKET_SIZE);
+
+            const std::vector<BoundingVolumeHierarchy::Node>& nodes = m_BVH.GetNodes();
+            const std::vector<uint32_t>& primitiveIndices = m_BVH.GetPrimitiveIndices();
+
+            m_NodePackets.resize(nodes.size(), 0);
+            m_Packets.reserve(nodes.size() / 2 + 1);
+
+            for(size_t nodeIndex = 0; nodeIndex < nodes.size(); nodeIndex++)
+            {
+                const BoundingVolumeHierarchy::Node& node = nodes[nodeIndex];
+
+                if(!node.IsLeaf())
+                {
+                    continue;
+                }
+
+                TrianglePacket packet{};
+                packet.TotalTriangles = node.TotalPrimitives;
+
+                for(uint32_t lane = 0; lane < node.TotalPrimitives; lane++)
+                {
+                    const uint32_t triangle = primitiveIndices[node.FirstIndex + lane];
+                    const glm::vec3& vertex0 = positions[indices[triangle * 3]];
+                    const glm::vec3 edge1 = positions[indices[triangle * 3 + 1]] - vertex0;
+                    const glm::vec3 edge2 = positions[indices[triangle * 3 + 2]] - vertex0;
+
+                    for(int axis = 0; axis < 3; axis++)
+                    {
+                        packet.Vertex0[axis][lane] = vertex0[axis];
+                        packet.Edge1[axis][lane] = edge1[axis];
+                        packet.Edge2[axis][lane] = edge2[axis];
+                    }
+
+                    packet.Triangles[lane] = triangle;
+                }
+
+                m_NodePackets[nodeIndex] = static_cast<uint32_t>(m_Packets.size());
+                m_Packets.push_back(packet);
+            }
+        }
+
+        bool TriangleBVH::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayTriangleHit& outHit) const
+        {
+            const BoundingVolumeHierarchy::Node* firstNode = m_BVH.GetNodes().data();
+            bool bHasHit = false;
+
+            m_BVH.Raycast(origin, direction, maxDistance, [&](const BoundingVolumeHierarchy::Node& node)
+            {
+                const TrianglePacket& packet = m_Packets[m_NodePackets[&node - firstNode]];
+
+                if(IntersectPacket(packet, origin, direction, maxDistance, outHit))
+                {
+                    maxDistance = outHit.Distance;
+                    bHasHit = true;
+                }
+            });
+
+            return bHasHit;
+        }
+
+        bool TriangleBVH::OverlapsSphere(const glm::mat4& modelMatrix, const glm::vec3& center, float radius) const
+        {
+            return AnyTriangle(modelMatrix, [&center, radius](const Rendering::Bounds& bounds)
+            {
+                return BoundsOverlapSphere(bounds, center, radius);
+            },
+            [&center, radius](const glm::vec3 triangle[3])
+            {
+                const glm::vec3 offset = GetClosestPointOnTriangle(center, triangle[0], triangle[1], triangle[2]) - center;
+                return glm::dot(offset, offset) <= radius * radius;
+            });
+        }
+
+        bool TriangleBVH::OverlapsBox(const glm::mat4& modelMatrix, const Rendering::Bounds& box) const
+        {
+            return AnyTriangle(modelMatrix, [&box](const Rendering::Bounds& bounds)
+            {
+                return BoundsOverlap(bounds, box);
+            },
+            [&box](const glm::vec3 triangle[3])
+            {
+                return TriangleOverlapsBox(triangle, box);
+            });
+        }
+
+        size_t TriangleBVH::GetCpuMemory() const
+        {
+            return m_BVH.GetCpuMemory() + m_Packets.capacity() * sizeof(TrianglePacket) + m_NodePackets.capacity() * sizeof(uint32_t);
+        }
+
+        template <typename TNodeTest, typename TTriangleTest>
+        bool TriangleBVH::AnyTriangle(const glm::mat4& modelMatrix, TNodeTest&& nodeTest, TTriangleTest&& triangleTest) const
+        {
+            // Tested in world space, an object space shape wouldn't stay a sphere/box under non-uniform scale or rotation
+            const BoundingVolumeHierarchy::Node* firstNode = m_BVH.GetNodes().data();
+            bool bOverlaps = false;
+
+            m_BVH.Query([&](const Rendering::Bounds& bounds)
+            {
+                return nodeTest(bounds.Transform(modelMatrix));
+            },
+            [&](const BoundingVolumeHierarchy::Node& node)
+            {
+                const TrianglePacket& packet = m_Packets[m_NodePackets[&node - firstNode]];
+
+                for(uint32_t lane = 0; lane < packet.TotalTriangles; lane++)
+                {
+                    glm::vec3 triangle[3];
+                    GetTriangle(packet, lane, modelMatrix, triangle);
+
+                    if(triangleTest(triangle))
+                    {
+                        bOverlaps = true;
+                        return false;
+                    }
+                }
+
+                return true;
+            });
+
+            return bOverlaps;
+        }
+
+        bool TriangleBVH::IntersectPacket(const TrianglePacket& packet, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayTriangleHit& outHit)
+        {
+            // Moller-Trumbore on every lane
+            alignas(16) float distances[PACKET_SIZE];
+            alignas(16) float u[PACKET_SIZE];
+            alignas(16) float v[PACKET_SIZE];
+            int hitMask = 0;
+
+#ifdef GLACIRER_TRIANGLE_BVH_SSE
+            const __m128 directionX = _mm_set1_ps(direction.x);
+            const __m128 directionY = _mm_set1_ps(direction.y);
+            const __m128 directionZ = _mm_set1_ps(direction.z);
+            const __m128 edge1X = _mm_loadu_ps(packet.Edge1[0]);
+            const __m128 edge1Y = _mm_loadu_ps(packet.Edge1[1]);
+            const __m128 edge1Z = _mm_loadu_ps(packet.Edge1[2]);
+            const __m128 edge2X = _mm_loadu_ps(packet.Edge2[0]);
+            const __m128 edge2Y = _mm_loadu_ps(packet.Edge2[1]);
+            const __m128 edge2Z = _mm_loadu_ps(packet.Edge2[2]);
+
+            // p = direction x edge2, determinant = edge1 . p
+            const __m128 pX = _mm_sub_ps(_mm_mul_ps(directionY, edge2Z), _mm_mul_ps(directionZ, edge2Y));
+            const __m128 pY = _mm_sub_ps(_mm_mul_ps(directionZ, edge2X), _mm_mul_ps(directionX, edge2Z));
+            const __m128 pZ = _mm_sub_ps(_mm_mul_ps(directionX, edge2Y), _mm_mul_ps(directionY, edge2X));
+            const __m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1X, pX), _mm_mul_ps(edge1Y, pY)), _mm_mul_ps(edge1Z, pZ));
+            const __m128 inverseDeterminant = _mm_div_ps(_mm_set1_ps(1.f), determinant);
+
+            // s = origin - vertex0, q = s x edge1
+            const __m128 sX = _mm_sub_ps(_mm_set1_ps(origin.x), _mm_loadu_ps(packet.Vertex0[0]));
+            const __m128 sY = _mm_sub_ps(_mm_set1_ps(origin.y), _mm_loadu_ps(packet.Vertex0[1]));
+            const __m128 sZ = _mm_sub_ps(_mm_set1_ps(origin.z), _mm_loadu_ps(packet.Vertex0[2]));
+            const __m128 qX = _mm_sub_ps(_mm_mul_ps(sY, edge1Z), _mm_mul_ps(sZ, edge1Y));
+            const __m128 qY = _mm_sub_ps(_mm_mul_ps(sZ, edge1X), _mm_mul_ps(sX, edge1Z));
+            const __m128 qZ = _mm_sub_ps(_mm_mul_ps(sX, edge1Y), _mm_mul_ps(sY, edge1X));
+
+            const __m128 laneU = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sX, pX), _mm_mul_ps(sY, pY)), _mm_mul_ps(sZ, pZ)), inverseDeterminant);
+            const __m128 laneV = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, qX), _mm_mul_ps(directionY, qY)), _mm_mul_ps(directionZ, qZ)), inverseDeterminant);
+            const __m128 laneDistance = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)), _mm_mul_ps(edge2Z, qZ)), inverseDeterminant);
+
+            // Comparisons against NaN (degenerate or unused lanes) are false, those lanes never pass
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 absoluteDeterminant = _mm_andnot_ps(_mm_set1_ps(-0.f), determinant);
+            __m128 mask = _mm_cmpgt_ps(absoluteDeterminant, _mm_set1_ps(DETERMINANT_EPSILON));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(laneU, zero));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(laneV, zero));
+            mask = _mm_and_ps(mask, _mm_cmple_ps(_mm_add_ps(laneU, laneV), _mm_set1_ps(1.f)));
+            mask = _mm_and_ps(mask, _mm_cmpge_ps(laneDistance, zero));
+            mask = _mm_and_ps(mask, _mm_cmplt_ps(laneDistance, _mm_set1_ps(maxDistance)));
+
+            hitMask = _mm_movemask_ps(mask);
+
+            if(hitMask == 0)
+            {
+                return false;
+            }
+
+            _mm_store_ps(distances, laneDistance);
+            _mm_store_ps(u, laneU);
+            _mm_store_ps(v, laneV);
+#else
+            for(uint32_t lane = 0; lane < packet.TotalTriangles; lane++)
+            {
+                const glm::vec3 edge1{packet.Edge1[0][lane], packet.Edge1[1][lane], packet.Edge1[2][lane]};
+                const glm::vec3 edge2{packet.Edge2[0][lane], packet.Edge2[1][lane], packet.Edge2[2][lane]};
+                const glm::vec3 p = glm::cross(direction, edge2);
+                const float determinant = glm::dot(edge1, p);
+
+                if(glm::abs(determinant) <= DETERMINANT_EPSILON)
+                {
+                    continue;
+                }
+
+                const float inverseDeterminant = 1.f / determinant;
+                const glm::vec3 s = origin - glm::vec3{packet.Vertex0[0][lane], packet.Vertex0[1][lane], packet.Vertex0[2][lane]};
+                const glm::vec3 q = glm::cross(s, edge1);
+
+                u[lane] = glm::dot(s, p) * inverseDeterminant;
+                v[lane] = glm::dot(direction, q) * inverseDeterminant;
+                distances[lane] = glm::dot(edge2, q) * inverseDeterminant;
+
+                if(u[lane] >= 0.f && v[lane] >= 0.f && u[lane] + v[lane] <= 1.f && distances[lane] >= 0.f && distances[lane] < maxDistance)
+                {
+                    hitMask |= 1 << lane;
+                }
+            }
+
+            if(hitMask == 0)
+            {
+                return false;
+            }
+#endif
+
+            uint32_t closestLane = 0;
+            float closestDistance = std::numeric_limits<float>::max();
+
+            for(uint32_t lane = 0; lane < PACKET_SIZE; lane++)
+            {
+                if((hitMask & (1 << lane)) && distances[lane] < closestDistance)
+                {
+                    closestLane = lane;
+                    closestDistance = distances[lane];
+                }
+            }
+
+            const glm::vec3 edge1{packet.Edge1[0][closestLane], packet.Edge1[1][closestLane], packet.Edge1[2][closestLane]};
+            const glm::vec3 edge2{packet.Edge2[0][closestLane], packet.Edge2[1][closestLane], packet.Edge2[2][closestLane]};
+
+            outHit.Distance = closestDistance;
+            outHit.TriangleIndex = packet.Triangles[closestLane];
+            outHit.Barycentrics = glm::vec2{u[closestLane], v[closestLane]};
+            outHit.Normal = glm::cross(edge1, edge2);
+
+            return true;
+        }
+
+        void TriangleBVH::GetTriangle(const TrianglePacket& packet, uint32_t lane, const glm::mat4& modelMatrix, glm::vec3 outVertices[3])
+        {
+            const glm::vec3 vertex0{packet.Vertex0[0][lane], packet.Vertex0[1][lane], packet.Vertex0[2][lane]};
+            const glm::vec3 edge1{packet.Edge1[0][lane], packet.Edge1[1][lane], packet.Edge1[2][lane]};
+            const glm::vec3 edge2{packet.Edge2[0][lane], packet.Edge2[1][lane], packet.Edge2[2][lane]};
+
+            outVertices[0] = glm::vec3(modelMatrix * glm::vec4(vertex0, 1.f));
+            outVertices[1] = glm::vec3(modelMatrix * glm::vec4(vertex0 + edge1, 1.f));
+            outVertices[2] = glm::vec3(modelMatrix * glm::vec4(vertex0 + edge2, 1.f));
+        }
+    }
+}
@@ -1,6 +1,7 @@
 #include "Rendering/Cubemap.h"
 
 #include "Rendering/OpenGLCore.h"
+#include "Rendering/Texture.h"
 #include "Rendering/TextureSettings.h"
 
 namespace Glacirer
@@ -54,6 +55,20 @@ namespace Glacirer
             const TextureSettings& settings)
         {
             GLCall(glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + sideIndex,0, settings.InternalFormat, static_cast<int>(width), static_cast<int>(height), 0, settings.Format, settings.Type, data));
+
+            m_SideSizes[sideIndex] = static_cast<size_t>(width) * height * Texture::GetBytesPerPixel(settings.InternalFormat);
+            m_TrackedMemory.SetSize(GetGpuMemory());
+        }
+
+        size_t Cubemap::GetGpuMemory() const
+        {
+            size_t gpuMemory = 0;
+            for(const size_t sideSize : m_SideSizes)
+            {
+                gpuMemory += sideSize;
+            }
+
+            return gpuMemory;
         }
     }
 }
@@ -0,0 +1,96 @@
+#include "Rendering/DeferredShadingSystem.h"
+
+#include "Rendering/Device.h"
+#include "Rendering/FrameBuffer.h"
+#include "Rendering/Material.h"
+#include "Rendering/Primitive.h"
+#include "Rendering/Shader.h"
+#include "Resources/ResourceManager.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        DeferredShadingSystem::DeferredShadingSystem()
+        {
+            m_ScreenQuad = Primitive::CreateScreenQuad();
+
+            m_GeometryShader = Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/GBuffer.glsl", "GBuffer");
+
+            const std::string LIGHTING_SHADER_NAME = "DeferredLighting";
+            m_LightingShader = Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/DeferredLighting.glsl", LIGHTING_SHADER_NAME);
+
+            m_LightingMaterial = Resources::ResourceManager::CreateMaterial("M_DeferredLighting", LIGHTING_SHADER_NAME);
+        }
+
+        RenderTargetDesc DeferredShadingSystem::GetGBufferDesc(const Resolution& resolution)
+        {
+            // Position and normal need more precision than a regular color attachment
+            RenderTargetAttachmentDesc highPrecisionAttachment{};
+            highPrecisionAttachment.InternalFormat = GL_RGBA16F;
+            highPrecisionAttachment.Format = GL_RGBA;
+            highPrecisionAttachment.Type = GL_FLOAT;
+
+            RenderTargetAttachmentDesc specularAttachment{};
+            specularAttachment.InternalFormat = GL_RGBA;
+            specularAttachment.Format = GL_RGBA;
+
+            RenderTargetDesc desc{};
+            desc.Resolution = resolution;
+            desc.bHasDepthStencil = true;
+            desc.AdditionalAttachments[0] = highPrecisionAttachment;
+            desc.AdditionalAttachments[1] = highPrecisionAttachment;
+            desc.AdditionalAttachments[2] = specularAttachment;
+            desc.TotalAdditionalAttachments = 3;
+
+            return desc;
+        }
+
+        RenderTargetDesc DeferredShadingSystem::GetLightingDesc(const Resolution& resolution)
+        {
+            RenderTargetDesc desc{};
+            desc.Resolution = resolution;
+            desc.bHasDepthStencil = true;
+
+            return desc;
+        }
+
+        bool DeferredShadingSystem::IsShadedByGeometryPass(const Material& material)
+        {
+            return material.GetShader() == Resources::ResourceManager::GetDefaultShader();
+        }
+
+        void DeferredShadingSystem::RenderLightingPass(const RenderGraphContext& context, RenderGraphResource gBuffer, RenderGraphResource lighting, const glm::vec4& clearColor) const
+        {
+            const Device& device = context.GetDevice();
+            const Framebuffer* gBufferFramebuffer = context.GetFramebuffer(gBuffer);
+            const Framebuffer* lightingFramebuffer = context.GetFramebuffer(lighting);
+            const Resolution& resolution = context.GetDesc(lighting).Resolution;
+
+            context.BindTarget(lighting);
+            device.SetClearColor(clearColor);
+            device.Clear();
+
+            // Copy G-buffer depth and stencil so the forward passes rendered after lighting are properly occluded.
+            // Both may be pooled framebuffers larger than the viewport, only the rendered region is copied
+            gBufferFramebuffer->BindAsReadOnly();
+            lightingFramebuffer->BindAsWriteOnly();
+            gBufferFramebuffer->BlitDepthStencilBuffer(resolution, resolution);
+            lightingFramebuffer->Bind();
+
+            // The pool may back the G-buffer with another framebuffer from one frame to the next
+            m_LightingMaterial->SetTexture("u_GAlbedo", gBufferFramebuffer->GetMainColorBufferTexture(), 0);
+            m_LightingMaterial->SetTexture("u_GPosition", gBufferFramebuffer->GetAdditionalColorTexture(0), 1);
+            m_LightingMaterial->SetTexture("u_GNormal", gBufferFramebuffer->GetAdditionalColorTexture(1), 2);
+            m_LightingMaterial->SetTexture("u_GSpecular", gBufferFramebuffer->GetAdditionalColorTexture(2), 3);
+
+            // Not a material property, has to be set on the shader once bound
+            m_LightingMaterial->Bind();
+            m_LightingMaterial->SetVec2("u_UVScale", context.GetUVScale(gBuffer));
+
+            device.DisableDepthTest();
+            m_MeshRenderer.Render(*m_ScreenQuad, *m_LightingMaterial);
+            device.EnableDepthTest();
+        }
+    }
+}
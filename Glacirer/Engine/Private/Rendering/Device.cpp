@@ -10,11 +10,21 @@ namespace Glacirer
             GLCall(glViewport(0, 0, static_cast<int>(resolution.Width), static_cast<int>(resolution.Height)));
         }
 
+        void Device::SetClearColor(const glm::vec4& clearColor) const
+        {
+            GLCall(glClearColor(clearColor.r, clearColor.g, clearColor.b, clearColor.a));
+        }
+
         void Device::Clear() const
         {
             GLCall(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT));
         }
 
+        void Device::ClearColorBuffer() const
+        {
+            GLCall(glClear(GL_COLOR_BUFFER_BIT));
+        }
+
         void Device::EnableDepthTest() const
         {
             GLCall(glEnable(GL_DEPTH_TEST));
@@ -40,6 +50,16 @@ namespace Glacirer
             GLCall(glDepthFunc(function));
         }
 
+        void Device::EnableColorWrite() const
+        {
+            GLCall(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+        }
+
+        void Device::DisableColorWrite() const
+        {
+            GLCall(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+        }
+
         void Device::EnableStencilTest() const
         {
             GLCall(glEnable(GL_STENCIL_TEST));
@@ -0,0 +1,147 @@
+#include "Rendering/DrawBatch.h"
+
+#include <cassert>
+
+#include <glm/matrix.hpp>
+
+#include "Rendering/DynamicRingBuffer.h"
+#include "Rendering/GeometryBuffer.h"
+#include "Rendering/InstancedArray.h"
+#include "Rendering/Material.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/OpenGLCore.h"
+#include "Rendering/VertexArray.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        DrawBatch::DrawBatch(unsigned int maxInstances, DynamicRingBuffer& ringBuffer)
+            : m_RingBuffer(ringBuffer), m_MaxInstances(maxInstances), bUsesMultiDrawIndirect(IsMultiDrawIndirectSupported())
+        {
+            m_InstanceRows.reserve(maxInstances);
+        }
+
+        bool DrawBatch::IsMultiDrawIndirectSupported()
+        {
+            // Extension alone needs base instance support too, for instanced attributes of each command
+            return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance);
+        }
+
+        bool DrawBatch::CanAdd(const Mesh& mesh) const
+        {
+            return m_InstanceRows.size() < m_MaxInstances && (!m_GeometryBuffer || m_GeometryBuffer == &mesh.GetGeometryBuffer());
+        }
+
+        void DrawBatch::Add(const Mesh& mesh, const glm::mat4& instanceMatrix)
+        {
+            assert(CanAdd(mesh));
+
+            // Only consecutive instances share a command, reordering them would break sorted draws
+            if(&mesh == m_LastMesh)
+            {
+                m_Commands.back().TotalInstances++;
+            }
+            else
+            {
+                const GeometryAllocation& allocation = mesh.GetGeometryAllocation();
+
+                DrawElementsIndirectCommand command{};
+                command.TotalIndices = allocation.TotalIndices;
+                command.TotalInstances = 1;
+                command.FirstIndex = allocation.FirstIndex;
+                command.BaseVertex = static_cast<int>(allocation.BaseVertex);
+                command.BaseInstance = static_cast<unsigned int>(m_InstanceRows.size());
+
+                m_Commands.push_back(command);
+                m_GeometryBuffer = &mesh.GetGeometryBuffer();
+                m_LastMesh = &mesh;
+            }
+
+            // Translation ends up in the fourth component of each row, the dropped row is always (0, 0, 0, 1)
+            m_InstanceRows.push_back(glm::mat3x4(glm::transpose(instanceMatrix)));
+        }
+
+        void DrawBatch::Submit(const Material& material, const std::shared_ptr<Shader>& overrideShader, InstancedArray& instancedArray)
+        {
+            if(IsEmpty())
+            {
+                return;
+            }
+
+            if(overrideShader)
+            {
+                material.Bind(*overrideShader);
+            }
+            else
+            {
+                material.Bind();
+            }
+
+            // Render sets only set up the VAO of the base mesh, LODs may live in another geometry buffer
+            VertexArray& vertexArray = m_GeometryBuffer->GetVertexArray();
+            if(!vertexArray.IsInstancedRenderingConfigured())
+            {
+                instancedArray.SetupInstancedAttributesFor(vertexArray);
+            }
+
+            m_GeometryBuffer->Bind();
+
+            const DynamicAllocation instances = instancedArray.Upload(m_InstanceRows.data(), static_cast<unsigned int>(m_InstanceRows.size() * sizeof(glm::mat3x4)));
+
+            if(bUsesMultiDrawIndirect)
+            {
+                instancedArray.BindAttributesTo(m_GeometryBuffer->GetVertexArray(), instances);
+                DrawMultiIndirect();
+            }
+            else
+            {
+                DrawEachCommand(instancedArray, instances);
+            }
+
+            if(overrideShader)
+            {
+                material.Unbind(*overrideShader);
+            }
+            else
+            {
+                material.Unbind();
+            }
+
+            Clear();
+        }
+
+        void DrawBatch::Clear()
+        {
+            m_Commands.clear();
+            m_InstanceRows.clear();
+            m_GeometryBuffer = nullptr;
+            m_LastMesh = nullptr;
+        }
+
+        void DrawBatch::DrawMultiIndirect() const
+        {
+            const unsigned int totalCommands = static_cast<unsigned int>(m_Commands.size());
+            const DynamicAllocation commands = m_RingBuffer.Write(m_Commands.data(), totalCommands * static_cast<unsigned int>(sizeof(DrawElementsIndirectCommand)), sizeof(unsigned int));
+
+            // Base instance of each command is relative to the instance attributes, already pointing at this batch instances
+            GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.BufferId));
+            GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, m_GeometryBuffer->GetIndexType(), reinterpret_cast<const void*>(static_cast<size_t>(commands.Offset)), static_cast<GLsizei>(totalCommands), 0));
+            GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+        }
+
+        void DrawBatch::DrawEachCommand(InstancedArray& instancedArray, const DynamicAllocation& instances) const
+        {
+            // No base instance before GL 4.2, instance attributes are moved to the instances of each command instead
+            const unsigned int indexSize = m_GeometryBuffer->GetIndexSize();
+
+            for(const DrawElementsIndirectCommand& command : m_Commands)
+            {
+                instancedArray.BindAttributesTo(m_GeometryBuffer->GetVertexArray(), instances, command.BaseInstance);
+
+                const void* indicesOffset = reinterpret_cast<const void*>(static_cast<size_t>(command.FirstIndex) * indexSize);
+                GLCall(glDrawElementsInstancedBaseVertex(GL_TRIANGLES, command.TotalIndices, m_GeometryBuffer->GetIndexType(), indicesOffset, command.TotalInstances, command.BaseVertex));
+            }
+        }
+    }
+}
@@ -0,0 +1,209 @@
+#include "Rendering/DynamicRingBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "Rendering/OpenGLCore.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        DynamicRingBuffer::DynamicRingBuffer(unsigned int frameCapacity)
+            : m_FrameCapacity(frameCapacity), bIsPersistentlyMapped(IsPersistentMappingSupported())
+        {
+            int uniformOffsetAlignment = 0;
+            GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformOffsetAlignment));
+
+            if(uniformOffsetAlignment > 0)
+            {
+                m_UniformOffsetAlignment = static_cast<unsigned int>(uniformOffsetAlignment);
+            }
+
+            CreateBuffer();
+        }
+
+        DynamicRingBuffer::~DynamicRingBuffer()
+        {
+            for(void*& fence : m_FrameFences)
+            {
+                if(fence)
+                {
+                    GLCall(glDeleteSync(static_cast<GLsync>(fence)));
+                }
+            }
+
+            // Deleting a buffer also unmaps it, the driver keeps its storage while draws still use it
+            for(RetiredBuffer& retiredBuffer : m_RetiredBuffers)
+            {
+                if(retiredBuffer.Fence)
+                {
+                    GLCall(glDeleteSync(static_cast<GLsync>(retiredBuffer.Fence)));
+                }
+
+                GLCall(glDeleteBuffers(1, &retiredBuffer.RendererID));
+            }
+
+            GLCall(glDeleteBuffers(1, &m_RendererID));
+        }
+
+        bool DynamicRingBuffer::IsPersistentMappingSupported()
+        {
+            return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+        }
+
+        void DynamicRingBuffer::BeginFrame()
+        {
+            m_FrameIndex = (m_FrameIndex + 1) % FRAMES_IN_FLIGHT;
+            m_FrameOffset = 0;
+
+            // Only stalls if CPU runs more than FRAMES_IN_FLIGHT frames ahead of GPU
+            WaitFence(m_FrameFences[m_FrameIndex]);
+
+            DeleteFinishedRetiredBuffers();
+        }
+
+        void DynamicRingBuffer::EndFrame()
+        {
+            GLCall(m_FrameFences[m_FrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+            for(RetiredBuffer& retiredBuffer : m_RetiredBuffers)
+            {
+                if(!retiredBuffer.Fence)
+                {
+                    GLCall(retiredBuffer.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+                }
+            }
+        }
+
+        DynamicAllocation DynamicRingBuffer::Write(const void* data, unsigned int size, unsigned int alignment)
+        {
+            assert(alignment > 0);
+
+            unsigned int offset = (m_FrameOffset + alignment - 1) / alignment * alignment;
+
+            if(offset + size > m_FrameCapacity)
+            {
+                Grow(offset + size);
+                offset = 0;
+            }
+
+            DynamicAllocation allocation{};
+            allocation.BufferId = m_RendererID;
+            allocation.Offset = m_FrameIndex * m_FrameCapacity + offset;
+
+            if(bIsPersistentlyMapped)
+            {
+                // Coherent mapping, visible to commands issued after this without flushing
+                std::memcpy(m_MappedData + allocation.Offset, data, size);
+            }
+            else
+            {
+                GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID));
+                GLCall(void* mappedRange = glMapBufferRange(GL_COPY_WRITE_BUFFER, allocation.Offset, size, GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+                std::memcpy(mappedRange, data, size);
+                GLCall(glUnmapBuffer(GL_COPY_WRITE_BUFFER));
+                GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+            }
+
+            m_FrameOffset = offset + size;
+
+            return allocation;
+        }
+
+        void DynamicRingBuffer::CreateBuffer()
+        {
+            const GLsizeiptr bufferSize = static_cast<GLsizeiptr>(m_FrameCapacity) * FRAMES_IN_FLIGHT;
+
+            GLCall(glGenBuffers(1, &m_RendererID));
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_RendererID));
+
+            if(bIsPersistentlyMapped)
+            {
+                constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+                GLCall(glBufferStorage(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, flags));
+                GLCall(m_MappedData = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bufferSize, flags)));
+            }
+            else
+            {
+                GLCall(glBufferData(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, GL_STREAM_DRAW));
+            }
+
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+
+            // Retired buffers aren't counted, they're gone a few frames later
+            m_TrackedMemory.SetName("Frame ring buffer");
+            m_TrackedMemory.SetSize(GetGpuMemory());
+        }
+
+        void DynamicRingBuffer::Grow(unsigned int minFrameCapacity)
+        {
+            // Ranges written earlier this frame may still be bound, so the old buffer stays alive until this frame is done
+            RetiredBuffer retiredBuffer{};
+            retiredBuffer.RendererID = m_RendererID;
+            m_RetiredBuffers.push_back(retiredBuffer);
+
+            // Nothing was written to the new buffer yet, no region of it needs to be waited for
+            for(void*& fence : m_FrameFences)
+            {
+                if(fence)
+                {
+                    GLCall(glDeleteSync(static_cast<GLsync>(fence)));
+                    fence = nullptr;
+                }
+            }
+
+            // Regions start at multiples of the capacity, kept a multiple of any offset alignment writes may ask for
+            constexpr unsigned int CAPACITY_GRANULARITY = 4096;
+            const unsigned int frameCapacity = std::max(m_FrameCapacity * 2, minFrameCapacity);
+            m_FrameCapacity = (frameCapacity + CAPACITY_GRANULARITY - 1) / CAPACITY_GRANULARITY * CAPACITY_GRANULARITY;
+            m_MappedData = nullptr;
+            CreateBuffer();
+        }
+
+        void DynamicRingBuffer::WaitFence(void*& fence)
+        {
+            if(!fence)
+            {
+                return;
+            }
+
+            constexpr GLuint64 WAIT_TIMEOUT_NANOSECONDS = 1000000000;
+            GLenum waitResult = GL_TIMEOUT_EXPIRED;
+
+            // First wait flushes so the fence is guaranteed to be signaled eventually
+            GLCall(waitResult = glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT_NANOSECONDS));
+
+            while(waitResult == GL_TIMEOUT_EXPIRED)
+            {
+                GLCall(waitResult = glClientWaitSync(static_cast<GLsync>(fence), 0, WAIT_TIMEOUT_NANOSECONDS));
+            }
+
+            GLCall(glDeleteSync(static_cast<GLsync>(fence)));
+            fence = nullptr;
+        }
+
+        void DynamicRingBuffer::DeleteFinishedRetiredBuffers()
+        {
+            m_RetiredBuffers.erase(std::remove_if(m_RetiredBuffers.begin(), m_RetiredBuffers.end(), [](RetiredBuffer& retiredBuffer)
+            {
+                if(!retiredBuffer.Fence)
+                {
+                    return false;
+                }
+
+                GLCall(const GLenum waitResult = glClientWaitSync(static_cast<GLsync>(retiredBuffer.Fence), 0, 0));
+
+                if(waitResult != GL_ALREADY_SIGNALED && waitResult != GL_CONDITION_SATISFIED)
+                {
+                    return false;
+                }
+
+                GLCall(glDeleteSync(static_cast<GLsync>(retiredBuffer.Fence)));
+                GLCall(glDeleteBuffers(1, &retiredBuffer.RendererID));
+                return true;
+            }), m_RetiredBuffers.end());
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include "Rendering/FrameBuffer.h"
 
+#include <algorithm>
 #include <iostream>
+#include <string>
 
 #include "Rendering/OpenGLCore.h"
 
@@ -60,13 +62,16 @@ namespace Glacirer
             assert(bSuccess);
 
             GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+
+            TrackAttachmentMemory(settings);
         }
 
         void Framebuffer::CreateColorAttachments(const FramebufferSettings& settings)
         {
             TextureSettings mainColorTextureSettings{};
-            mainColorTextureSettings.InternalFormat = GL_RGB;
-            mainColorTextureSettings.Format = GL_RGB;
+            mainColorTextureSettings.InternalFormat = settings.ColorInternalFormat;
+            mainColorTextureSettings.Format = settings.ColorFormat;
+            mainColorTextureSettings.Type = settings.ColorType;
             mainColorTextureSettings.Samples = settings.Samples;
 
             m_MainColorBufferTexture = std::make_shared<Texture>(nullptr, settings.Resolution.Width, settings.Resolution.Height, mainColorTextureSettings);
@@ -181,6 +186,40 @@ namespace Glacirer
             GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
 
             GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_RBO));
+
+            // GL_DEPTH24_STENCIL8 takes 4 bytes per sample
+            m_RenderBufferMemory.SetName("Depth stencil " + std::to_string(m_Resolution.Width) + "x" + std::to_string(m_Resolution.Height));
+            m_RenderBufferMemory.SetSize(static_cast<size_t>(m_Resolution.Width) * m_Resolution.Height * 4 * std::max(samples, 1u));
+        }
+
+        void Framebuffer::TrackAttachmentMemory(const FramebufferSettings& settings) const
+        {
+            const MemoryCategory category = settings.EnableDepthMapOnly ? MemoryCategory::ShadowMaps : MemoryCategory::RenderTargets;
+            const std::string resolutionName = std::to_string(m_Resolution.Width) + "x" + std::to_string(m_Resolution.Height);
+
+            if(m_MainColorBufferTexture)
+            {
+                m_MainColorBufferTexture->SetName("Color " + resolutionName);
+                m_MainColorBufferTexture->SetMemoryCategory(category);
+            }
+
+            for(unsigned int i = 0; i < m_AdditionalColorTextures.size(); i++)
+            {
+                m_AdditionalColorTextures[i]->SetName("Color " + std::to_string(i + 1) + " " + resolutionName);
+                m_AdditionalColorTextures[i]->SetMemoryCategory(category);
+            }
+
+            if(m_DepthBufferTexture)
+            {
+                m_DepthBufferTexture->SetName("Depth " + resolutionName);
+                m_DepthBufferTexture->SetMemoryCategory(category);
+            }
+
+            if(m_DepthBufferCubemap)
+            {
+                m_DepthBufferCubemap->SetName("Depth cubemap " + resolutionName);
+                m_DepthBufferCubemap->SetMemoryCategory(category);
+            }
         }
 
         Framebuffer::~Framebuffer()
@@ -244,18 +283,44 @@ namespace Glacirer
         }
 
         void Framebuffer::ResolveMultisampleImage(const Rendering::Resolution& destinationResolution) const
+        {
+            ResolveMultisampleImage(m_Resolution, destinationResolution);
+        }
+
+        void Framebuffer::ResolveMultisampleImage(const Rendering::Resolution& sourceRegion, const Rendering::Resolution& destinationRegion) const
         {
             glBlitFramebuffer(
                 0,
                 0,
-                static_cast<int>(m_Resolution.Width),
-                static_cast<int>(m_Resolution.Height),
+                static_cast<int>(sourceRegion.Width),
+                static_cast<int>(sourceRegion.Height),
                 0,
                 0,
-                static_cast<int>(destinationResolution.Width),
-                static_cast<int>(destinationResolution.Height),
+                static_cast<int>(destinationRegion.Width),
+                static_cast<int>(destinationRegion.Height),
                 GL_COLOR_BUFFER_BIT,
                 GL_NEAREST);
         }
+
+        // Both framebuffers need matching depth/stencil format (GL_DEPTH24_STENCIL8 render buffer) and samples
+        void Framebuffer::BlitDepthStencilBuffer(const Rendering::Resolution& destinationResolution) const
+        {
+            BlitDepthStencilBuffer(m_Resolution, destinationResolution);
+        }
+
+        void Framebuffer::BlitDepthStencilBuffer(const Rendering::Resolution& sourceRegion, const Rendering::Resolution& destinationRegion) const
+        {
+            glBlitFramebuffer(
+                0,
+                0,
+                static_cast<int>(sourceRegion.Width),
+                static_cast<int>(sourceRegion.Height),
+                0,
+                0,
+                static_cast<int>(destinationRegion.Width),
+                static_cast<int>(destinationRegion.Height),
+                GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT,
+                GL_NEAREST);
+        }
     }
 }
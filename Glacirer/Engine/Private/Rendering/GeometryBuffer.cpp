@@ -0,0 +1,224 @@
+#include "Rendering/GeometryBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <string>
+
+#include "Rendering/OpenGLCore.h"
+
+namespace
+{
+    // Shared buffers start large enough for a few typical meshes, so small scenes never have to grow them
+    constexpr unsigned int SHARED_INITIAL_VERTICES = 1 << 16;
+    constexpr unsigned int SHARED_INITIAL_INDICES = 1 << 18;
+
+    std::map<unsigned int, std::weak_ptr<Glacirer::Rendering::GeometryBuffer>> SharedGeometryBuffers{};
+}
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        GeometryBuffer::GeometryBuffer(VertexBufferLayout&& layout, bool bUsesShortIndices, unsigned int vertexCapacity, unsigned int indexCapacity)
+            : m_Layout(std::move(layout)), m_VertexAllocator(vertexCapacity), m_IndexAllocator(indexCapacity), bUsesShortIndices(bUsesShortIndices)
+        {
+            m_VAO = std::make_unique<VertexArray>();
+
+            GLCall(glGenBuffers(1, &m_VertexBufferId));
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_VertexBufferId));
+            GLCall(glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(vertexCapacity) * GetVertexStride(), nullptr, GL_STATIC_DRAW));
+
+            GLCall(glGenBuffers(1, &m_IndexBufferId));
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_IndexBufferId));
+            GLCall(glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(indexCapacity) * GetIndexSize(), nullptr, GL_STATIC_DRAW));
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+
+            SetupVertexArray();
+
+            m_TrackedMemory.SetName("Geometry buffer (" + std::to_string(GetVertexStride()) + " byte vertices, " + std::to_string(GetIndexSize() * 8) + " bit indices)");
+            m_TrackedMemory.SetSize(GetGpuMemory());
+        }
+
+        GeometryBuffer::~GeometryBuffer()
+        {
+            GLCall(glDeleteBuffers(1, &m_VertexBufferId));
+            GLCall(glDeleteBuffers(1, &m_IndexBufferId));
+        }
+
+        std::shared_ptr<GeometryBuffer> GeometryBuffer::GetShared(unsigned int layoutKey, bool bUsesShortIndices, VertexBufferLayout&& layout)
+        {
+            std::weak_ptr<GeometryBuffer>& sharedBuffer = SharedGeometryBuffers[layoutKey * 2 + (bUsesShortIndices ? 1 : 0)];
+            std::shared_ptr<GeometryBuffer> geometryBuffer = sharedBuffer.lock();
+
+            if(!geometryBuffer)
+            {
+                geometryBuffer = std::make_shared<GeometryBuffer>(std::move(layout), bUsesShortIndices, SHARED_INITIAL_VERTICES, SHARED_INITIAL_INDICES);
+                sharedBuffer = geometryBuffer;
+            }
+
+            return geometryBuffer;
+        }
+
+        GeometryAllocation GeometryBuffer::Allocate(const void* verticesData, unsigned int totalVertices, const std::vector<unsigned int>& indices)
+        {
+            assert(!bUsesShortIndices || totalVertices <= MAX_SHORT_INDEX_VERTICES);
+
+            GeometryAllocation allocation{};
+            allocation.TotalVertices = totalVertices;
+            allocation.TotalIndices = static_cast<unsigned int>(indices.size());
+            allocation.BaseVertex = AllocateVertices(allocation.TotalVertices);
+            allocation.FirstIndex = AllocateIndices(allocation.TotalIndices);
+
+            // Copy targets leave the element buffer binding of whatever VAO is bound untouched
+            const unsigned int stride = GetVertexStride();
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_VertexBufferId));
+            GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(allocation.BaseVertex) * stride, static_cast<GLsizeiptr>(totalVertices) * stride, verticesData));
+
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, m_IndexBufferId));
+            const GLintptr indicesOffset = static_cast<GLintptr>(allocation.FirstIndex) * GetIndexSize();
+
+            if(bUsesShortIndices)
+            {
+                const std::vector<GLushort> shortIndices(indices.begin(), indices.end());
+                GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, indicesOffset, shortIndices.size() * sizeof(GLushort), shortIndices.data()));
+            }
+            else
+            {
+                GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, indicesOffset, indices.size() * sizeof(GLuint), indices.data()));
+            }
+
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+
+            return allocation;
+        }
+
+        void GeometryBuffer::Free(const GeometryAllocation& allocation)
+        {
+            m_VertexAllocator.Free(allocation.BaseVertex, allocation.TotalVertices);
+            m_IndexAllocator.Free(allocation.FirstIndex, allocation.TotalIndices);
+        }
+
+        void GeometryBuffer::ReadVertices(const GeometryAllocation& allocation, void* outVerticesData) const
+        {
+            const unsigned int stride = GetVertexStride();
+
+            GLCall(glBindBuffer(GL_COPY_READ_BUFFER, m_VertexBufferId));
+            GLCall(glGetBufferSubData(GL_COPY_READ_BUFFER, static_cast<GLintptr>(allocation.BaseVertex) * stride, static_cast<GLsizeiptr>(allocation.TotalVertices) * stride, outVerticesData));
+            GLCall(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+        }
+
+        void GeometryBuffer::ReadIndices(const GeometryAllocation& allocation, std::vector<unsigned int>& outIndices) const
+        {
+            const GLintptr indicesOffset = static_cast<GLintptr>(allocation.FirstIndex) * GetIndexSize();
+            outIndices.resize(allocation.TotalIndices);
+
+            GLCall(glBindBuffer(GL_COPY_READ_BUFFER, m_IndexBufferId));
+
+            if(bUsesShortIndices)
+            {
+                std::vector<GLushort> shortIndices(allocation.TotalIndices);
+                GLCall(glGetBufferSubData(GL_COPY_READ_BUFFER, indicesOffset, shortIndices.size() * sizeof(GLushort), shortIndices.data()));
+                std::copy(shortIndices.begin(), shortIndices.end(), outIndices.begin());
+            }
+            else
+            {
+                GLCall(glGetBufferSubData(GL_COPY_READ_BUFFER, indicesOffset, outIndices.size() * sizeof(GLuint), outIndices.data()));
+            }
+
+            GLCall(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+        }
+
+        unsigned int GeometryBuffer::GetIndexType() const
+        {
+            return bUsesShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+
+        size_t GeometryBuffer::GetGpuMemory() const
+        {
+            return static_cast<size_t>(m_VertexAllocator.GetCapacity()) * GetVertexStride() + static_cast<size_t>(m_IndexAllocator.GetCapacity()) * GetIndexSize();
+        }
+
+        unsigned int GeometryBuffer::AllocateVertices(unsigned int totalVertices)
+        {
+            unsigned int baseVertex = m_VertexAllocator.Allocate(totalVertices);
+
+            if(baseVertex == RangeAllocator::INVALID_OFFSET)
+            {
+                // Free space may be split into holes, only the grown tail is sure to fit the whole range
+                const unsigned int capacity = m_VertexAllocator.GetCapacity();
+                const unsigned int newCapacity = std::max(capacity * GROWTH_FACTOR, capacity + totalVertices);
+                const unsigned int stride = GetVertexStride();
+
+                m_VertexBufferId = GrowBuffer(m_VertexBufferId, capacity * stride, newCapacity * stride);
+                m_VertexAllocator.Grow(newCapacity);
+                m_TrackedMemory.SetSize(GetGpuMemory());
+
+                // Attribute pointers refer to the buffer bound when they were set
+                SetupVertexArray();
+
+                baseVertex = m_VertexAllocator.Allocate(totalVertices);
+                assert(baseVertex != RangeAllocator::INVALID_OFFSET);
+            }
+
+            return baseVertex;
+        }
+
+        unsigned int GeometryBuffer::AllocateIndices(unsigned int totalIndices)
+        {
+            unsigned int firstIndex = m_IndexAllocator.Allocate(totalIndices);
+
+            if(firstIndex == RangeAllocator::INVALID_OFFSET)
+            {
+                const unsigned int capacity = m_IndexAllocator.GetCapacity();
+                const unsigned int newCapacity = std::max(capacity * GROWTH_FACTOR, capacity + totalIndices);
+
+                m_IndexBufferId = GrowBuffer(m_IndexBufferId, capacity * GetIndexSize(), newCapacity * GetIndexSize());
+                m_IndexAllocator.Grow(newCapacity);
+                m_TrackedMemory.SetSize(GetGpuMemory());
+
+                SetupVertexArray();
+
+                firstIndex = m_IndexAllocator.Allocate(totalIndices);
+                assert(firstIndex != RangeAllocator::INVALID_OFFSET);
+            }
+
+            return firstIndex;
+        }
+
+        unsigned int GeometryBuffer::GrowBuffer(unsigned int bufferId, unsigned int size, unsigned int newSize)
+        {
+            unsigned int newBufferId = 0;
+            GLCall(glGenBuffers(1, &newBufferId));
+
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, newBufferId));
+            GLCall(glBufferData(GL_COPY_WRITE_BUFFER, newSize, nullptr, GL_STATIC_DRAW));
+            GLCall(glBindBuffer(GL_COPY_READ_BUFFER, bufferId));
+            GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, size));
+
+            GLCall(glBindBuffer(GL_COPY_READ_BUFFER, 0));
+            GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, 0));
+            GLCall(glDeleteBuffers(1, &bufferId));
+
+            return newBufferId;
+        }
+
+        void GeometryBuffer::SetupVertexArray() const
+        {
+            // Instanced attributes set up on this VAO by users stay after the mesh ones
+            m_VAO->Bind();
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_VertexBufferId));
+            GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_IndexBufferId));
+
+            const unsigned int nextAttributeLocation = m_Layout.CreateAttributes();
+
+            if(!m_VAO->IsInstancedRenderingConfigured())
+            {
+                m_VAO->SetNextAttributeLocation(nextAttributeLocation);
+            }
+
+            m_VAO->Unbind();
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        }
+    }
+}
@@ -1,5 +1,9 @@
 #include "Rendering/IndexBuffer.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #include "Rendering/OpenGLCore.h"
 
 namespace Glacirer
@@ -17,7 +21,33 @@ namespace Glacirer
     
             GLCall(glGenBuffers(1, &m_RendererID));
             GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-            GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, Count * sizeof(unsigned int), Data, GL_STATIC_DRAW));
+
+            // Meshes with fewer than 65536 vertices (most of them) only need half of the index memory and bandwidth
+            const unsigned int maxIndex = Count > 0 ? *std::max_element(Data, Data + Count) : 0;
+            bUsesShortIndices = maxIndex <= std::numeric_limits<GLushort>::max();
+
+            if(bUsesShortIndices)
+            {
+                const std::vector<GLushort> shortIndices(Data, Data + Count);
+                GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, Count * sizeof(GLushort), shortIndices.data(), GL_STATIC_DRAW));
+            }
+            else
+            {
+                GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, Count * sizeof(unsigned int), Data, GL_STATIC_DRAW));
+            }
+
+            m_TrackedMemory.SetSize(GetSize());
+        }
+
+        IndexBuffer::IndexBuffer(const unsigned short* Data, unsigned int Count)
+            : m_Count(Count), bUsesShortIndices(true)
+        {
+            ASSERT(sizeof(unsigned short) == sizeof(GLushort));
+
+            GLCall(glGenBuffers(1, &m_RendererID));
+            GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+            GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, Count * sizeof(GLushort), Data, GL_STATIC_DRAW));
+            m_TrackedMemory.SetSize(GetSize());
         }
 
         IndexBuffer::~IndexBuffer()
@@ -30,6 +60,11 @@ namespace Glacirer
             m_LastBoundIndexBufferId = 0;
         }
 
+        unsigned int IndexBuffer::GetIndexType() const
+        {
+            return bUsesShortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+
         void IndexBuffer::Bind() const
         {
             if(m_LastBoundIndexBufferId != m_RendererID)
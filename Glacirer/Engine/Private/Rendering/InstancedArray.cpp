@@ -1,15 +1,15 @@
 #include "Rendering/InstancedArray.h"
 
+#include "Rendering/OpenGLCore.h"
 #include "Rendering/VertexArray.h"
 
 namespace Glacirer
 {
     namespace Rendering
     {
-        InstancedArray::InstancedArray(const void* data, unsigned size, bool bIsDynamic, VertexBufferLayout&& layout)
+        InstancedArray::InstancedArray(VertexBufferLayout&& layout, DynamicRingBuffer& ringBuffer)
+            : m_RingBuffer(ringBuffer), m_Layout(std::move(layout))
         {
-            m_VBO = std::make_unique<VertexBuffer>(data, size, bIsDynamic);
-            m_Layout = std::move(layout);
         }
 
         void InstancedArray::SetupInstancedAttributesFor(VertexArray& vertexArray)
@@ -20,30 +20,30 @@ namespace Glacirer
                 return;
             }
 
-            Bind();
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RingBuffer.GetRendererID()));
             vertexArray.Bind();
 
-            const unsigned int nextAttributeLocation = m_Layout.CreateAttributes(vertexArray.GetNextAttributeLocation());
+            const unsigned int firstAttributeLocation = vertexArray.GetNextAttributeLocation();
+            const unsigned int nextAttributeLocation = m_Layout.CreateAttributes(firstAttributeLocation);
+            vertexArray.SetFirstInstancedAttributeLocation(firstAttributeLocation);
             vertexArray.SetNextAttributeLocation(nextAttributeLocation);
             vertexArray.SetIsInstancedRenderingConfigured(true);
 
             vertexArray.Unbind();
-            Unbind();
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
         }
 
-        void InstancedArray::SetSubData(const void* data, unsigned size) const
+        DynamicAllocation InstancedArray::Upload(const void* data, unsigned int size) const
         {
-            m_VBO->SetSubData(data, size);
+            return m_RingBuffer.Write(data, size, m_Layout.GetStride());
         }
 
-        void InstancedArray::Bind() const
+        void InstancedArray::BindAttributesTo(VertexArray& vertexArray, const DynamicAllocation& allocation, unsigned int firstInstance)
         {
-            m_VBO->Bind();
-        }
-
-        void InstancedArray::Unbind() const
-        {
-            m_VBO->Unbind();
+            // Attribute pointers take whatever buffer is bound to GL_ARRAY_BUFFER, the VAO keeps it
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, allocation.BufferId));
+            m_Layout.CreateAttributes(vertexArray.GetFirstInstancedAttributeLocation(), allocation.Offset + firstInstance * m_Layout.GetStride());
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0));
         }
     }
 }
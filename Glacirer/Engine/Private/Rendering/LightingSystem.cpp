@@ -1,6 +1,9 @@
 #include "Rendering/LightingSystem.h"
 
+#include <array>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "Rendering/Shader.h"
 #include "Basics/Components/CameraComponent.h"
@@ -8,13 +11,30 @@
 #include "Basics/Components/PointLightComponent.h"
 #include "Basics/Components/SpotLightComponent.h"
 
+namespace
+{
+    // "name[0]" to "name[count - 1]"
+    std::vector<std::string> CreateArrayUniformNames(const char* arrayName, int count)
+    {
+        std::vector<std::string> names{};
+        names.reserve(count);
+
+        for(int i = 0; i < count; i++)
+        {
+            names.push_back(std::string(arrayName) + "[" + std::to_string(i) + "]");
+        }
+
+        return names;
+    }
+}
+
 namespace Glacirer
 {
     namespace Rendering
     {
-        LightingSystem::LightingSystem()
+        LightingSystem::LightingSystem(DynamicRingBuffer& ringBuffer)
         {
-            CreateUniformBuffers();
+            CreateUniformBuffers(ringBuffer);
             CreateShadowMaps();
         }
 
@@ -140,22 +160,24 @@ namespace Glacirer
 
             shader.Bind();
 
+            // Names are only built once, every shader registered or overridden goes through here
+            static const std::vector<std::string> directionalShadowMapNames = CreateArrayUniformNames("u_DirectionalLightShadowMaps", MAX_DIRECTIONAL_LIGHTS);
+            static const std::vector<std::string> pointShadowMapNames = CreateArrayUniformNames("u_PointLightShadowMaps", MAX_POINT_LIGHTS);
+            static const std::vector<std::string> spotShadowMapNames = CreateArrayUniformNames("u_SpotLightShadowMaps", MAX_SPOT_LIGHTS);
+
             for(int i = 0; i < MAX_DIRECTIONAL_LIGHTS; i++)
             {
-                std::string uniformName = "u_DirectionalLightShadowMaps[" + std::to_string(i) + "]";
-                shader.SetUniform1i(uniformName, DIRECTIONAL_SHADOW_MAP_START_SLOT + i);
+                shader.SetUniform1i(directionalShadowMapNames[i], DIRECTIONAL_SHADOW_MAP_START_SLOT + i);
             }
 
             for(int i = 0; i < MAX_POINT_LIGHTS; i++)
             {
-                std::string uniformName = "u_PointLightShadowMaps[" + std::to_string(i) + "]";
-                shader.SetUniform1i(uniformName, POINT_SHADOW_MAP_START_SLOT + i);
+                shader.SetUniform1i(pointShadowMapNames[i], POINT_SHADOW_MAP_START_SLOT + i);
             }
 
             for(int i = 0; i < MAX_SPOT_LIGHTS; i++)
             {
-                std::string uniformName = "u_SpotLightShadowMaps[" + std::to_string(i) + "]";
-                shader.SetUniform1i(uniformName, SPOT_SHADOW_MAP_START_SLOT + i);
+                shader.SetUniform1i(spotShadowMapNames[i], SPOT_SHADOW_MAP_START_SLOT + i);
             }
 
             shader.Unbind();
@@ -231,21 +253,13 @@ namespace Glacirer
                 m_SpotsShaderData[i] = spotLightShaderData;
             }
 
-            m_GeneralUniformBuffer->Bind();
             m_GeneralUniformBuffer->SetSubData(&m_GeneralShaderData, sizeof(LightingGeneralShaderData));
-            m_GeneralUniformBuffer->Unbind();
 
-            m_DirectionalUniformBuffer->Bind();
             m_DirectionalUniformBuffer->SetSubData(m_DirectionalsShaderData, MAX_DIRECTIONAL_LIGHTS * sizeof(DirectionalLightShaderData));
-            m_DirectionalUniformBuffer->Unbind();
 
-            m_PointUniformBuffer->Bind();
             m_PointUniformBuffer->SetSubData(m_PointsShaderData, MAX_POINT_LIGHTS * sizeof(PointLightShaderData));
-            m_PointUniformBuffer->Unbind();
 
-            m_SpotsUniformBuffer->Bind();
             m_SpotsUniformBuffer->SetSubData(m_SpotsShaderData, MAX_SPOT_LIGHTS * sizeof(SpotLightShaderData));
-            m_SpotsUniformBuffer->Unbind();
 
             UpdateDirectionalShadowMapUniformBuffers();
             UpdatePointShadowMapUniformBuffers();
@@ -269,9 +283,7 @@ namespace Glacirer
                 m_DirectionalLightShadowMapShaderData[i].ViewProjectionMatrix = m_DirectionalLights[i]->GetViewProjectionMatrix();
             }
 
-            m_DirectionalMatrixUniformBuffer->Bind();
             m_DirectionalMatrixUniformBuffer->SetSubData(m_DirectionalLightShadowMapShaderData, MAX_DIRECTIONAL_LIGHTS * sizeof(glm::mat4));
-            m_DirectionalMatrixUniformBuffer->Unbind();
         }
 
         void LightingSystem::UpdatePointShadowMapUniformBuffers()
@@ -283,9 +295,8 @@ namespace Glacirer
     
             for(int i = 0; i < m_TotalActivePointLights; i++)
             {
-                std::vector<glm::mat4> lightSpaceMatrices = m_PointLights[i]->GetViewProjectionMatrices(m_ShadowResolution);
+                const std::array<glm::mat4, 6> lightSpaceMatrices = m_PointLights[i]->GetViewProjectionMatrices(m_ShadowResolution);
 
-                // TODO: maybe we could use pointers to avoid another loop
                 for(int j = 0; j < static_cast<int>(lightSpaceMatrices.size()); j++)
                 {
                     PointLightShadowMapShaderData& shaderData = m_PointLightShadowMapShaderData[i];
@@ -293,9 +304,7 @@ namespace Glacirer
                 }
             }
 
-            m_PointLightMatricesUniformBuffer->Bind();
             m_PointLightMatricesUniformBuffer->SetSubData(m_PointLightShadowMapShaderData, MAX_POINT_LIGHTS * sizeof(PointLightShadowMapShaderData));
-            m_PointLightMatricesUniformBuffer->Unbind();
         }
 
         void LightingSystem::UpdateSpotShadowMapUniformBuffers()
@@ -310,9 +319,7 @@ namespace Glacirer
                 m_SpotLightShadowMapShaderData[i].ViewProjectionMatrix = m_SpotLights[i]->GetViewProjectionMatrix(m_ShadowResolution);
             }
 
-            m_SpotLightMatricesUniformBuffer->Bind();
             m_SpotLightMatricesUniformBuffer->SetSubData(m_SpotLightShadowMapShaderData, MAX_SPOT_LIGHTS * sizeof(SpotLightShadowMapShaderData));
-            m_SpotLightMatricesUniformBuffer->Unbind();
         }
 
         Framebuffer& LightingSystem::GetDirectionalShadowMapFramebuffer(const int activeLightIndex) const
@@ -351,7 +358,7 @@ namespace Glacirer
             return *m_SpotLights[activeLightIndex];
         }
 
-        void LightingSystem::CreateUniformBuffers()
+        void LightingSystem::CreateUniformBuffers(DynamicRingBuffer& ringBuffer)
         {
             constexpr unsigned int UNIFORM_LIGHTING_GENERAL_BINDING_INDEX = 2;
             constexpr unsigned int UNIFORM_LIGHTING_DIRECTIONALS_BINDING_INDEX = 3;
@@ -362,53 +369,46 @@ namespace Glacirer
             constexpr unsigned int UNIFORM_LIGHTING_SPOT_MATRIX_BINDING_INDEX = 8;
 
             m_GeneralUniformBuffer = std::make_unique<UniformBuffer>(
-                nullptr,
                 sizeof(LightingGeneralShaderData),
                 UNIFORM_LIGHTING_GENERAL_BINDING_INDEX,
                 "LightingGeneral",
-                true);
+                ringBuffer);
 
             m_DirectionalUniformBuffer = std::make_unique<UniformBuffer>(
-                nullptr,
                 MAX_DIRECTIONAL_LIGHTS * sizeof(DirectionalLightShaderData),
                 UNIFORM_LIGHTING_DIRECTIONALS_BINDING_INDEX,
                 "LightingDirectionals",
-                true);
+                ringBuffer);
 
             m_PointUniformBuffer = std::make_unique<UniformBuffer>(
-                nullptr,
                 MAX_POINT_LIGHTS * sizeof(PointLightShaderData),
                 UNIFORM_LIGHTING_POINTS_BINDING_INDEX,
                 "LightingPoints",
-                true);
+                ringBuffer);
 
             m_SpotsUniformBuffer = std::make_unique<UniformBuffer>(
-                nullptr,
                 MAX_SPOT_LIGHTS * sizeof(SpotLightShaderData),
                 UNIFORM_LIGHTING_SPOTS_BINDING_INDEX,
                 "LightingSpots",
-                true);
+                ringBuffer);
 
             m_DirectionalMatrixUniformBuffer = std::make_unique<UniformBuffer>(
-                nullptr,
                 MAX_DIRECTIONAL_LIGHTS * sizeof(glm::mat4),
                 UNIFORM_LIGHTING_DIRECTIONAL_MATRIX_BINDING_INDEX,
                 "DirectionalLightShadowMapMatrices",
-                true);
+                ringBuffer);
 
             m_PointLightMatricesUniformBuffer = std::make_unique<UniformBuffer>(
-                nullptr,
                 MAX_POINT_LIGHTS * sizeof(PointLightShadowMapShaderData),
                 UNIFORM_LIGHTING_POINT_MATRIX_BINDING_INDEX,
                 "PointLightShadowMapMatrices",
-                true);
+                ringBuffer);
 
             m_SpotLightMatricesUniformBuffer = std::make_unique<UniformBuffer>(
-                nullptr,
                 MAX_SPOT_LIGHTS * sizeof(SpotLightShadowMapShaderData),
                 UNIFORM_LIGHTING_SPOT_MATRIX_BINDING_INDEX,
                 "SpotLightShadowMapMatrices",
-                true);
+                ringBuffer);
         }
 
         void LightingSystem::BindShadowMapTextures()
@@ -5,6 +5,8 @@
 #include "Rendering/Shader.h"
 #include "Rendering/Texture.h"
 
+#include <vector>
+
 namespace Glacirer
 {
     namespace Rendering
@@ -22,6 +24,7 @@ namespace Glacirer
             }
 
             m_TextureProperties[name].Texture = texture;
+            m_VariantShader = nullptr;
 
             if(slot < TOTAL_SYSTEM_RESERVED_TEXTURE_SLOTS)
             {
@@ -50,7 +53,12 @@ namespace Glacirer
 
         void Material::SetMat4(const std::string& name, const glm::mat4& matrix) const
         {
-            m_Shader->SetUniformMat4f(name, matrix);
+            GetVariantShader().SetUniformMat4f(name, matrix);
+        }
+
+        void Material::SetVec2(const std::string& name, const glm::vec2& value) const
+        {
+            GetVariantShader().SetUniform2f(name, value);
         }
 
         void Material::SetBool(const std::string& name, const bool value)
@@ -61,6 +69,7 @@ namespace Glacirer
         void Material::SetFloat(const std::string& name, const float value)
         {
             m_FloatProperties[name] = value;
+            m_VariantShader = nullptr;
         }
 
         void Material::SetInt(const std::string& name, const int value)
@@ -73,9 +82,15 @@ namespace Glacirer
             m_RenderingMode = renderingMode;
         }
 
+        void Material::SetReceivesShadows(bool bReceivesShadows)
+        {
+            this->bReceivesShadows = bReceivesShadows;
+            m_VariantShader = nullptr;
+        }
+
         void Material::Bind() const
         {
-            Bind(*m_Shader);
+            Bind(GetVariantShader());
         }
 
         void Material::Bind(Shader& shader) const
@@ -156,11 +171,44 @@ namespace Glacirer
         void Material::SetShader(const std::shared_ptr<Shader>& shader)
         {
             m_Shader = shader;
+            m_VariantShader = nullptr;
 
             const ShaderProperties& shaderProperties = shader->GetProperties();
             PopulateValuesFrom(shaderProperties);
         }
 
+        Shader& Material::GetVariantShader() const
+        {
+            if(m_VariantShader)
+            {
+                return *m_VariantShader;
+            }
+
+            std::vector<std::string> enabledKeywords{};
+
+            // Unset maps and zero factors contribute nothing, so their code is left out instead of sampled and discarded
+            auto specularIterator = m_TextureProperties.find("u_Specular");
+            if(specularIterator == m_TextureProperties.end() || !specularIterator->second.Texture)
+            {
+                enabledKeywords.push_back(NO_SPECULAR_MAP_KEYWORD);
+            }
+
+            auto reflectionIterator = m_FloatProperties.find("u_ReflectionValue");
+            if(reflectionIterator == m_FloatProperties.end() || reflectionIterator->second == 0.f)
+            {
+                enabledKeywords.push_back(NO_REFLECTION_KEYWORD);
+            }
+
+            if(!bReceivesShadows)
+            {
+                enabledKeywords.push_back(NO_SHADOWS_KEYWORD);
+            }
+
+            m_VariantShader = &m_Shader->GetVariant(m_Shader->GetVariantMask(enabledKeywords));
+
+            return *m_VariantShader;
+        }
+
         void Material::PopulateValuesFrom(const ShaderProperties& shaderProperties)
         {
             for(int i = 0; i < static_cast<int>(shaderProperties.Textures.size()); i++)
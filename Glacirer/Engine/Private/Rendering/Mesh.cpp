@@ -1,41 +1,370 @@
 #include "Rendering/Mesh.h"
 
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <glm/gtc/packing.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include "Physics/TriangleBVH.h"
 #include "Rendering/VertexBufferLayout.h"
 
 namespace Glacirer
 {
     namespace Rendering
     {
-        Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned>& indices)
+        Mesh::Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned>& indices, const VertexFormat& vertexFormat, bool bKeepCpuGeometry)
+            : m_VertexFormat(vertexFormat)
         {
-            m_VAO = std::make_unique<VertexArray>();
+            // Bounds are needed before upload to quantize positions
+            for(const Vertex& vertex : vertices)
+            {
+                m_Bounds.Encapsulate(vertex.Position);
+            }
+
+            if(bKeepCpuGeometry)
+            {
+                m_Positions.reserve(vertices.size());
+
+                for(const Vertex& vertex : vertices)
+                {
+                    m_Positions.emplace_back(vertex.Position);
+                }
 
-            m_VBO = std::make_unique<VertexBuffer>(vertices.data(), static_cast<unsigned int>(vertices.size() * sizeof(Vertex)), false);
+                m_Indices = indices;
+                UpdateTrackedCpuMemory();
+            }
 
             VertexBufferLayout layout{};
-            layout.PushFloat(3);
-            layout.PushFloat(3);
-            layout.PushFloat(2);
+            SetupVertexLayout(layout);
+
+            const unsigned int totalVertices = static_cast<unsigned int>(vertices.size());
+
+            if(m_VertexFormat.bQuantizePositions || m_VertexFormat.bPackNormals || m_VertexFormat.bUseHalfFloatTexCoords)
+            {
+                const std::vector<unsigned char> packedVertices = PackVertices(vertices, m_VertexFormat, m_Bounds);
+                UploadToSharedGeometryBuffer(packedVertices.data(), totalVertices, indices, std::move(layout));
+            }
+            else
+            {
+                UploadToSharedGeometryBuffer(vertices.data(), totalVertices, indices, std::move(layout));
+            }
+        }
+
+        Mesh::Mesh(const void* verticesData, unsigned int verticesSize, VertexBufferLayout&& layout, const std::vector<unsigned>& indices)
+            : bHasCustomLayout(true)
+        {
+            // Position is expected as the first attribute (3 floats), as on all our primitives
+            const unsigned int stride = layout.GetStride();
+            const unsigned int totalVertices = stride > 0 ? verticesSize / stride : 0;
+            const unsigned char* vertexBytes = static_cast<const unsigned char*>(verticesData);
+
+            for(unsigned int i = 0; i < totalVertices; i++)
+            {
+                const float* position = reinterpret_cast<const float*>(vertexBytes + i * stride);
+                m_Bounds.Encapsulate(glm::vec3(position[0], position[1], position[2]));
+            }
+
+            // Sized to fit exactly, it never grows
+            const bool bUsesShortIndices = totalVertices <= GeometryBuffer::MAX_SHORT_INDEX_VERTICES;
+            m_GeometryBuffer = std::make_shared<GeometryBuffer>(std::move(layout), bUsesShortIndices, totalVertices, static_cast<unsigned int>(indices.size()));
+            m_GeometryAllocation = m_GeometryBuffer->Allocate(verticesData, totalVertices, indices);
+        }
+
+        Mesh::Mesh(const void* packedVerticesData, unsigned int totalVertices, const VertexFormat& vertexFormat, const Bounds& bounds,
+                   const void* indicesData, unsigned int totalIndices, bool bUsesShortIndices, const glm::vec3* cpuPositions)
+            : m_Bounds(bounds), m_VertexFormat(vertexFormat)
+        {
+            VertexBufferLayout layout{};
+            SetupVertexLayout(layout);
+
+            std::vector<unsigned int> indices{};
+
+            if(bUsesShortIndices)
+            {
+                const unsigned short* shortIndices = static_cast<const unsigned short*>(indicesData);
+                indices.assign(shortIndices, shortIndices + totalIndices);
+            }
+            else
+            {
+                const unsigned int* intIndices = static_cast<const unsigned int*>(indicesData);
+                indices.assign(intIndices, intIndices + totalIndices);
+            }
+
+            UploadToSharedGeometryBuffer(packedVerticesData, totalVertices, indices, std::move(layout));
+
+            if(cpuPositions)
+            {
+                // Not decoded from the packed vertices, quantized positions would lose precision
+                m_Positions.assign(cpuPositions, cpuPositions + totalVertices);
+                m_Indices = std::move(indices);
+                UpdateTrackedCpuMemory();
+            }
+        }
+
+        Mesh::~Mesh()
+        {
+            if(m_GeometryBuffer)
+            {
+                m_GeometryBuffer->Free(m_GeometryAllocation);
+            }
+        }
+
+        const Physics::TriangleBVH& Mesh::GetTriangleBVH() const
+        {
+            if(!m_TriangleBVH)
+            {
+                m_TriangleBVH = std::make_unique<Physics::TriangleBVH>(m_Positions, m_Indices);
+                UpdateTrackedCpuMemory();
+            }
+
+            return *m_TriangleBVH;
+        }
+
+        void Mesh::SetupVertexLayout(VertexBufferLayout& outLayout)
+        {
+            bHasQuantizedPositions = CanQuantizePositions(m_VertexFormat, m_Bounds);
+
+            if(bHasQuantizedPositions)
+            {
+                m_DequantizationMatrix = glm::scale(glm::translate(glm::mat4{1.f}, m_Bounds.GetCenter()), glm::vec3{GetQuantizationScale(m_Bounds)});
+                // 4 components keep attribute 4 bytes aligned, w is stored as 1
+                outLayout.PushShort(4, true);
+            }
+            else
+            {
+                outLayout.PushFloat(3);
+            }
+
+            if(m_VertexFormat.bPackNormals)
+            {
+                outLayout.PushPackedInt2101010();
+            }
+            else
+            {
+                outLayout.PushFloat(3);
+            }
+
+            if(m_VertexFormat.bUseHalfFloatTexCoords)
+            {
+                outLayout.PushHalfFloat(2);
+            }
+            else
+            {
+                outLayout.PushFloat(2);
+            }
+        }
+
+        void Mesh::UploadToSharedGeometryBuffer(const void* packedVerticesData, unsigned int totalVertices, const std::vector<unsigned int>& indices, VertexBufferLayout&& layout)
+        {
+            // Vertex format flags that actually change the layout, quantization may have been skipped (see CanQuantizePositions)
+            const unsigned int layoutKey = (bHasQuantizedPositions ? 1u : 0u)
+                | (m_VertexFormat.bPackNormals ? 2u : 0u)
+                | (m_VertexFormat.bUseHalfFloatTexCoords ? 4u : 0u);
+
+            const bool bUsesShortIndices = totalVertices <= GeometryBuffer::MAX_SHORT_INDEX_VERTICES;
+
+            m_GeometryBuffer = GeometryBuffer::GetShared(layoutKey, bUsesShortIndices, std::move(layout));
+            m_GeometryAllocation = m_GeometryBuffer->Allocate(packedVerticesData, totalVertices, indices);
+        }
+
+        void Mesh::DecodePositions(const void* packedVerticesData, unsigned int totalVertices, unsigned int stride, std::vector<glm::vec3>& outPositions) const
+        {
+            const unsigned char* vertexBytes = static_cast<const unsigned char*>(packedVerticesData);
+            outPositions.reserve(totalVertices);
+
+            for(unsigned int i = 0; i < totalVertices; i++)
+            {
+                if(bHasQuantizedPositions)
+                {
+                    uint16_t position[3];
+                    std::memcpy(position, vertexBytes + i * stride, sizeof(position));
+
+                    const glm::vec3 normalizedPosition{glm::unpackSnorm1x16(position[0]), glm::unpackSnorm1x16(position[1]), glm::unpackSnorm1x16(position[2])};
+                    outPositions.emplace_back(glm::vec3(m_DequantizationMatrix * glm::vec4(normalizedPosition, 1.f)));
+                }
+                else
+                {
+                    glm::vec3 position{};
+                    std::memcpy(&position, vertexBytes + i * stride, sizeof(position));
+                    outPositions.emplace_back(position);
+                }
+            }
+        }
+
+        bool Mesh::CanQuantizePositions(const VertexFormat& vertexFormat, const Bounds& bounds)
+        {
+            return vertexFormat.bQuantizePositions && bounds.IsValid() && GetQuantizationScale(bounds) > 0.f;
+        }
+
+        // Same scale on all axes keeps the dequantization a similarity transform, so normals don't need correction
+        float Mesh::GetQuantizationScale(const Bounds& bounds)
+        {
+            const glm::vec3 extents = bounds.GetExtents();
+            return glm::max(extents.x, glm::max(extents.y, extents.z));
+        }
+
+        std::vector<unsigned char> Mesh::PackVertices(const std::vector<Vertex>& vertices, const VertexFormat& vertexFormat, const Bounds& bounds)
+        {
+            const bool bQuantizePositions = CanQuantizePositions(vertexFormat, bounds);
+            const float quantizationScale = GetQuantizationScale(bounds);
+
+            const unsigned int positionSize = bQuantizePositions ? 4 * sizeof(uint16_t) : sizeof(glm::vec3);
+            const unsigned int normalSize = vertexFormat.bPackNormals ? sizeof(uint32_t) : sizeof(glm::vec3);
+            const unsigned int texCoordSize = vertexFormat.bUseHalfFloatTexCoords ? sizeof(uint32_t) : sizeof(glm::vec2);
+            const unsigned int stride = positionSize + normalSize + texCoordSize;
+
+            std::vector<unsigned char> packedVertices(vertices.size() * stride);
 
-            m_VAO->AddBuffer(*m_VBO, layout);
+            for(size_t i = 0; i < vertices.size(); i++)
+            {
+                const Vertex& vertex = vertices[i];
+                unsigned char* destination = packedVertices.data() + i * stride;
 
-            m_IBO = std::make_unique<IndexBuffer>(indices.data(), static_cast<unsigned int>(indices.size()));
+                if(bQuantizePositions)
+                {
+                    const glm::vec3 normalizedPosition = (vertex.Position - bounds.GetCenter()) / quantizationScale;
+                    const uint16_t position[4]
+                    {
+                        glm::packSnorm1x16(normalizedPosition.x),
+                        glm::packSnorm1x16(normalizedPosition.y),
+                        glm::packSnorm1x16(normalizedPosition.z),
+                        glm::packSnorm1x16(1.f)
+                    };
 
-            m_IBO->Unbind();
-            m_VAO->Unbind();
+                    std::memcpy(destination, position, sizeof(position));
+                    destination += sizeof(position);
+                }
+                else
+                {
+                    std::memcpy(destination, &vertex.Position, sizeof(vertex.Position));
+                    destination += sizeof(vertex.Position);
+                }
+
+                if(vertexFormat.bPackNormals)
+                {
+                    const float normalLength = glm::length(vertex.Normal);
+                    const glm::vec3 normal = normalLength > 0.f ? vertex.Normal / normalLength : vertex.Normal;
+                    const uint32_t packedNormal = glm::packSnorm3x10_1x2(glm::vec4{normal, 0.f});
+
+                    std::memcpy(destination, &packedNormal, sizeof(packedNormal));
+                    destination += sizeof(packedNormal);
+                }
+                else
+                {
+                    std::memcpy(destination, &vertex.Normal, sizeof(vertex.Normal));
+                    destination += sizeof(vertex.Normal);
+                }
+
+                if(vertexFormat.bUseHalfFloatTexCoords)
+                {
+                    const uint32_t packedTexCoord = glm::packHalf2x16(vertex.TexCoord);
+                    std::memcpy(destination, &packedTexCoord, sizeof(packedTexCoord));
+                }
+                else
+                {
+                    std::memcpy(destination, &vertex.TexCoord, sizeof(vertex.TexCoord));
+                }
+            }
+
+            return packedVertices;
         }
 
-        Mesh::Mesh(const void* verticesData, unsigned int verticesSize, const VertexBufferLayout& layout, const std::vector<unsigned>& indices)
+        std::vector<Vertex> Mesh::ReadVertices() const
         {
-            m_VAO = std::make_unique<VertexArray>();
+            assert(!bHasCustomLayout);
+
+            const unsigned int totalVertices = m_GeometryAllocation.TotalVertices;
+            const unsigned int stride = m_GeometryBuffer->GetVertexStride();
+
+            std::vector<unsigned char> packedVertices(static_cast<size_t>(totalVertices) * stride);
+            m_GeometryBuffer->ReadVertices(m_GeometryAllocation, packedVertices.data());
+
+            std::vector<glm::vec3> positions{};
+            DecodePositions(packedVertices.data(), totalVertices, stride, positions);
+
+            const unsigned int normalOffset = bHasQuantizedPositions ? 4 * sizeof(uint16_t) : sizeof(glm::vec3);
+            const unsigned int texCoordOffset = normalOffset + (m_VertexFormat.bPackNormals ? sizeof(uint32_t) : sizeof(glm::vec3));
+
+            std::vector<Vertex> vertices(totalVertices);
+
+            for(unsigned int i = 0; i < totalVertices; i++)
+            {
+                const unsigned char* source = packedVertices.data() + static_cast<size_t>(i) * stride;
+                Vertex& vertex = vertices[i];
 
-            m_VBO = std::make_unique<VertexBuffer>(verticesData, verticesSize, false);
-            m_VAO->AddBuffer(*m_VBO, layout);
+                vertex.Position = positions[i];
+
+                if(m_VertexFormat.bPackNormals)
+                {
+                    uint32_t packedNormal;
+                    std::memcpy(&packedNormal, source + normalOffset, sizeof(packedNormal));
+                    vertex.Normal = glm::vec3(glm::unpackSnorm3x10_1x2(packedNormal));
+                }
+                else
+                {
+                    std::memcpy(&vertex.Normal, source + normalOffset, sizeof(vertex.Normal));
+                }
+
+                if(m_VertexFormat.bUseHalfFloatTexCoords)
+                {
+                    uint32_t packedTexCoord;
+                    std::memcpy(&packedTexCoord, source + texCoordOffset, sizeof(packedTexCoord));
+                    vertex.TexCoord = glm::unpackHalf2x16(packedTexCoord);
+                }
+                else
+                {
+                    std::memcpy(&vertex.TexCoord, source + texCoordOffset, sizeof(vertex.TexCoord));
+                }
+            }
+
+            return vertices;
+        }
+
+        std::vector<unsigned int> Mesh::ReadIndices() const
+        {
+            std::vector<unsigned int> indices{};
+            m_GeometryBuffer->ReadIndices(m_GeometryAllocation, indices);
+
+            return indices;
+        }
+
+        size_t Mesh::GetGpuMemory() const
+        {
+            // Only what this mesh takes from its geometry buffer, free space in there isn't counted
+            size_t gpuMemory = static_cast<size_t>(m_GeometryAllocation.TotalVertices) * m_GeometryBuffer->GetVertexStride()
+                + static_cast<size_t>(m_GeometryAllocation.TotalIndices) * m_GeometryBuffer->GetIndexSize();
+
+            for(const std::shared_ptr<Mesh>& lodMesh : m_LODs)
+            {
+                gpuMemory += lodMesh->GetGpuMemory();
+            }
+
+            return gpuMemory;
+        }
+
+        size_t Mesh::GetCpuMemory() const
+        {
+            size_t cpuMemory = m_CpuMemory.GetSize();
+
+            for(const std::shared_ptr<Mesh>& lodMesh : m_LODs)
+            {
+                cpuMemory += lodMesh->GetCpuMemory();
+            }
+
+            return cpuMemory;
+        }
+
+        void Mesh::UpdateTrackedCpuMemory() const
+        {
+            size_t cpuMemory = m_Positions.capacity() * sizeof(glm::vec3) + m_Indices.capacity() * sizeof(unsigned int);
 
-            m_IBO = std::make_unique<IndexBuffer>(indices.data(), static_cast<unsigned int>(indices.size()));
+            if(m_TriangleBVH)
+            {
+                cpuMemory += m_TriangleBVH->GetCpuMemory();
+            }
 
-            m_IBO->Unbind();
-            m_VAO->Unbind();
+            m_CpuMemory.SetSize(cpuMemory);
         }
     }
 }
@@ -1,5 +1,7 @@
 #include "Rendering/MeshComponentRenderSet.h"
 
+#include <algorithm>
+
 #include "Rendering/InstancedArray.h"
 #include "Rendering/Material.h"
 #include "Rendering/Mesh.h"
@@ -99,43 +101,10 @@ namespace Glacirer
             }
         }
 
-        void MeshComponentRenderSet::MultiplyAllObjectsScaleBy(const float factor)
-        {
-            for(const auto& meshMappingPair : m_MeshComponents)
-            {
-                for(const auto& meshComponentPair : meshMappingPair.second)
-                {
-                    for(const auto& meshComponent : meshComponentPair.second)
-                    {
-                        glm::vec3 originalScale = meshComponent->GetOwnerScale();
-                        
-                        meshComponent->SetOwnerScale(originalScale * factor);
-                    }
-                }
-            }
-        }
-
-        void MeshComponentRenderSet::DivideAllObjectsScaleBy(const float factor)
-        {
-            assert(factor != 0.f);
-
-            for(const auto& meshMappingPair : m_MeshComponents)
-            {
-                for(const auto& meshComponentPair : meshMappingPair.second)
-                {
-                    for(const auto& meshComponent : meshComponentPair.second)
-                    {
-                        glm::vec3 originalScale = meshComponent->GetOwnerScale();
-                        meshComponent->SetOwnerScale(originalScale / factor);
-                    }
-                }
-            }
-        }
-
-        // Using multimap to avoid two objects with same distance from camera override each other on single map entry
-        std::multimap<float, MeshComponentRenderElement> MeshComponentRenderSet::GetMeshComponentsSortedByDistance(const glm::vec3& cameraPosition) const
+        FrameVector<std::pair<float, MeshComponentRenderElement>> MeshComponentRenderSet::GetMeshComponentsSortedByDistance(const glm::vec3& cameraPosition) const
         {
-            std::multimap<float, MeshComponentRenderElement> sortedElements;
+            FrameVector<std::pair<float, MeshComponentRenderElement>> sortedElements{};
+            sortedElements.reserve(m_TotalMeshComponents);
 
             for(const auto& meshMappingPair : m_MeshComponents)
             {
@@ -146,11 +115,17 @@ namespace Glacirer
                         float distanceFromCamera = glm::length(cameraPosition - meshComponent->GetOwnerPosition());
 
                         MeshComponentRenderElement element{meshMappingPair.first, meshComponentPair.first, meshComponent};
-                        sortedElements.insert(std::pair<float, MeshComponentRenderElement>(distanceFromCamera, element));
+                        sortedElements.emplace_back(distanceFromCamera, element);
                     }
                 }
             }
 
+            // Not a stable sort, it would allocate a temporary buffer
+            std::sort(sortedElements.begin(), sortedElements.end(), [](const std::pair<float, MeshComponentRenderElement>& lhs, const std::pair<float, MeshComponentRenderElement>& rhs)
+            {
+                return lhs.first < rhs.first;
+            });
+
             return sortedElements;
         }
 
@@ -0,0 +1,420 @@
+#include "Rendering/MeshOptimizer.h"
+
+#include <algorithm>
+#include <limits>
+#include <glm/glm.hpp>
+
+#include "Rendering/Mesh.h"
+
+namespace
+{
+    constexpr int INVALID_VERTEX = -1;
+
+    // Triangles using each vertex, stored contiguously (vertex v owns [Offsets[v], Offsets[v + 1]))
+    struct TriangleAdjacency
+    {
+        std::vector<unsigned int> Offsets{};
+        std::vector<unsigned int> Triangles{};
+    };
+
+    TriangleAdjacency BuildTriangleAdjacency(const std::vector<unsigned int>& indices, const unsigned int totalVertices)
+    {
+        TriangleAdjacency adjacency{};
+        adjacency.Offsets.resize(totalVertices + 1, 0);
+        adjacency.Triangles.resize(indices.size());
+
+        for(const unsigned int vertex : indices)
+        {
+            adjacency.Offsets[vertex + 1]++;
+        }
+
+        for(unsigned int i = 0; i < totalVertices; i++)
+        {
+            adjacency.Offsets[i + 1] += adjacency.Offsets[i];
+        }
+
+        std::vector<unsigned int> insertPositions(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+
+        for(unsigned int i = 0; i < static_cast<unsigned int>(indices.size()); i++)
+        {
+            adjacency.Triangles[insertPositions[indices[i]]++] = i / 3;
+        }
+
+        return adjacency;
+    }
+
+    // Among the vertices of the last emitted fan, prefer the oldest one that would still be in cache
+    // after emitting all its remaining triangles (each one adds at most 2 new vertices)
+    int GetNextFanningVertex(
+        const std::vector<unsigned int>& candidates,
+        const std::vector<unsigned int>& cacheTimestamps,
+        const unsigned int timestamp,
+        const std::vector<unsigned int>& totalLiveTriangles,
+        const unsigned int cacheSize)
+    {
+        int nextVertex = INVALID_VERTEX;
+        int bestPriority = -1;
+
+        for(const unsigned int candidate : candidates)
+        {
+            if(totalLiveTriangles[candidate] == 0)
+            {
+                continue;
+            }
+
+            int priority = 0;
+            const unsigned int age = timestamp - cacheTimestamps[candidate];
+
+            if(age + 2 * totalLiveTriangles[candidate] <= cacheSize)
+            {
+                priority = static_cast<int>(age);
+            }
+
+            if(priority > bestPriority)
+            {
+                bestPriority = priority;
+                nextVertex = static_cast<int>(candidate);
+            }
+        }
+
+        return nextVertex;
+    }
+
+    // Recently used vertices first (likely still cached), otherwise the next vertex in input order
+    int SkipDeadEnd(
+        std::vector<unsigned int>& deadEndStack,
+        const std::vector<unsigned int>& totalLiveTriangles,
+        unsigned int& cursor)
+    {
+        while(!deadEndStack.empty())
+        {
+            const unsigned int vertex = deadEndStack.back();
+            deadEndStack.pop_back();
+
+            if(totalLiveTriangles[vertex] > 0)
+            {
+                return static_cast<int>(vertex);
+            }
+        }
+
+        for(; cursor < static_cast<unsigned int>(totalLiveTriangles.size()); cursor++)
+        {
+            if(totalLiveTriangles[cursor] > 0)
+            {
+                return static_cast<int>(cursor);
+            }
+        }
+
+        return INVALID_VERTEX;
+    }
+
+    // Simulated FIFO cache misses of a triangle, see MeshOptimizer::AnalyzeVertexCache
+    unsigned int UpdateVertexCache(
+        const std::vector<unsigned int>& indices,
+        const unsigned int triangle,
+        const unsigned int cacheSize,
+        std::vector<unsigned int>& cacheTimestamps,
+        unsigned int& timestamp)
+    {
+        unsigned int totalCacheMisses = 0;
+
+        for(unsigned int corner = 0; corner < 3; corner++)
+        {
+            const unsigned int vertex = indices[triangle * 3 + corner];
+
+            if(timestamp - cacheTimestamps[vertex] > cacheSize)
+            {
+                cacheTimestamps[vertex] = timestamp++;
+                totalCacheMisses++;
+            }
+        }
+
+        return totalCacheMisses;
+    }
+
+    // Tipsify vertex cache ordering, outputs triangles in emitted order and the first triangle of each cluster
+    // A cluster ends when fanning reaches a dead end, since cache locality is lost there anyway
+    void OrderTrianglesForVertexCache(
+        const std::vector<unsigned int>& indices,
+        const unsigned int totalVertices,
+        const unsigned int cacheSize,
+        std::vector<unsigned int>& outTriangles,
+        std::vector<unsigned int>& outClusterStarts)
+    {
+        const unsigned int totalTriangles = static_cast<unsigned int>(indices.size() / 3);
+        const TriangleAdjacency adjacency = BuildTriangleAdjacency(indices, totalVertices);
+
+        std::vector<unsigned int> totalLiveTriangles(totalVertices);
+        for(unsigned int i = 0; i < totalVertices; i++)
+        {
+            totalLiveTriangles[i] = adjacency.Offsets[i + 1] - adjacency.Offsets[i];
+        }
+
+        std::vector<unsigned int> cacheTimestamps(totalVertices, 0);
+        unsigned int timestamp = cacheSize + 1;
+
+        std::vector<bool> emittedTriangles(totalTriangles, false);
+        std::vector<unsigned int> deadEndStack{};
+        std::vector<unsigned int> candidates{};
+        unsigned int cursor = 0;
+
+        outTriangles.clear();
+        outTriangles.reserve(totalTriangles);
+        outClusterStarts.assign(1, 0);
+
+        int fanningVertex = SkipDeadEnd(deadEndStack, totalLiveTriangles, cursor);
+
+        while(fanningVertex != INVALID_VERTEX)
+        {
+            candidates.clear();
+
+            for(unsigned int i = adjacency.Offsets[fanningVertex]; i < adjacency.Offsets[fanningVertex + 1]; i++)
+            {
+                const unsigned int triangle = adjacency.Triangles[i];
+
+                if(emittedTriangles[triangle])
+                {
+                    continue;
+                }
+
+                for(unsigned int corner = 0; corner < 3; corner++)
+                {
+                    const unsigned int vertex = indices[triangle * 3 + corner];
+
+                    deadEndStack.push_back(vertex);
+                    candidates.push_back(vertex);
+                    totalLiveTriangles[vertex]--;
+
+                    // Cache miss, vertex enters cache now
+                    if(timestamp - cacheTimestamps[vertex] > cacheSize)
+                    {
+                        cacheTimestamps[vertex] = timestamp++;
+                    }
+                }
+
+                emittedTriangles[triangle] = true;
+                outTriangles.push_back(triangle);
+            }
+
+            fanningVertex = GetNextFanningVertex(candidates, cacheTimestamps, timestamp, totalLiveTriangles, cacheSize);
+
+            if(fanningVertex == INVALID_VERTEX)
+            {
+                fanningVertex = SkipDeadEnd(deadEndStack, totalLiveTriangles, cursor);
+
+                if(fanningVertex != INVALID_VERTEX && outTriangles.size() > outClusterStarts.back())
+                {
+                    outClusterStarts.push_back(static_cast<unsigned int>(outTriangles.size()));
+                }
+            }
+        }
+    }
+
+    // Dead end clusters are usually large, a cluster is split again once its own ACMR (starting from a cold cache) is under
+    // acmrThreshold times the one of the whole dead end cluster, so sorting clusters doesn't cost more than that in vertex cache
+    void SplitClustersForOverdraw(
+        const std::vector<unsigned int>& indices,
+        const unsigned int totalVertices,
+        const unsigned int cacheSize,
+        const float acmrThreshold,
+        const std::vector<unsigned int>& orderedTriangles,
+        std::vector<unsigned int>& inOutClusterStarts)
+    {
+        std::vector<unsigned int> cacheTimestamps(totalVertices, 0);
+        unsigned int timestamp = cacheSize + 1;
+
+        std::vector<unsigned int> clusterStarts{};
+        clusterStarts.reserve(inOutClusterStarts.size());
+
+        const unsigned int totalClusters = static_cast<unsigned int>(inOutClusterStarts.size());
+
+        for(unsigned int cluster = 0; cluster < totalClusters; cluster++)
+        {
+            const unsigned int start = inOutClusterStarts[cluster];
+            const unsigned int end = cluster + 1 < totalClusters ? inOutClusterStarts[cluster + 1] : static_cast<unsigned int>(orderedTriangles.size());
+
+            // Moving the timestamp past the cache size flushes it
+            timestamp += cacheSize + 1;
+            unsigned int totalClusterMisses = 0;
+
+            for(unsigned int i = start; i < end; i++)
+            {
+                totalClusterMisses += UpdateVertexCache(indices, orderedTriangles[i], cacheSize, cacheTimestamps, timestamp);
+            }
+
+            const float clusterThreshold = acmrThreshold * static_cast<float>(totalClusterMisses) / static_cast<float>(end - start);
+
+            clusterStarts.push_back(start);
+            timestamp += cacheSize + 1;
+
+            unsigned int totalSplitMisses = 0;
+            unsigned int totalSplitTriangles = 0;
+
+            for(unsigned int i = start; i + 1 < end; i++)
+            {
+                totalSplitMisses += UpdateVertexCache(indices, orderedTriangles[i], cacheSize, cacheTimestamps, timestamp);
+                totalSplitTriangles++;
+
+                if(static_cast<float>(totalSplitMisses) <= clusterThreshold * static_cast<float>(totalSplitTriangles))
+                {
+                    clusterStarts.push_back(i + 1);
+                    timestamp += cacheSize + 1;
+                    totalSplitMisses = 0;
+                    totalSplitTriangles = 0;
+                }
+            }
+        }
+
+        inOutClusterStarts = std::move(clusterStarts);
+    }
+}
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        void MeshOptimizer::OptimizeVertexCacheAndOverdraw(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, unsigned int cacheSize, float acmrThreshold)
+        {
+            const unsigned int totalVertices = static_cast<unsigned int>(vertices.size());
+
+            if(indices.size() < 3 || totalVertices == 0)
+            {
+                return;
+            }
+
+            std::vector<unsigned int> orderedTriangles{};
+            std::vector<unsigned int> clusterStarts{};
+            OrderTrianglesForVertexCache(indices, totalVertices, cacheSize, orderedTriangles, clusterStarts);
+            SplitClustersForOverdraw(indices, totalVertices, cacheSize, acmrThreshold, orderedTriangles, clusterStarts);
+
+            const unsigned int totalClusters = static_cast<unsigned int>(clusterStarts.size());
+            clusterStarts.push_back(static_cast<unsigned int>(orderedTriangles.size()));
+
+            glm::vec3 meshCentroid{0.f};
+            for(const Vertex& vertex : vertices)
+            {
+                meshCentroid += vertex.Position;
+            }
+            meshCentroid /= static_cast<float>(totalVertices);
+
+            // Clusters facing away from the mesh center are more likely to be in front of the others from any view point
+            std::vector<float> clusterSortKeys(totalClusters, 0.f);
+
+            for(unsigned int cluster = 0; cluster < totalClusters; cluster++)
+            {
+                glm::vec3 areaWeightedNormal{0.f};
+                glm::vec3 areaWeightedCentroid{0.f};
+                float totalArea = 0.f;
+
+                for(unsigned int i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; i++)
+                {
+                    const unsigned int triangle = orderedTriangles[i];
+                    const glm::vec3& a = vertices[indices[triangle * 3]].Position;
+                    const glm::vec3& b = vertices[indices[triangle * 3 + 1]].Position;
+                    const glm::vec3& c = vertices[indices[triangle * 3 + 2]].Position;
+
+                    const glm::vec3 cross = glm::cross(b - a, c - a);
+                    const float area = glm::length(cross);
+
+                    areaWeightedNormal += cross;
+                    areaWeightedCentroid += (a + b + c) * (area / 3.f);
+                    totalArea += area;
+                }
+
+                const float normalLength = glm::length(areaWeightedNormal);
+
+                if(totalArea > 0.f && normalLength > 0.f)
+                {
+                    clusterSortKeys[cluster] = glm::dot(areaWeightedCentroid / totalArea - meshCentroid, areaWeightedNormal / normalLength);
+                }
+            }
+
+            std::vector<unsigned int> sortedClusters(totalClusters);
+            for(unsigned int i = 0; i < totalClusters; i++)
+            {
+                sortedClusters[i] = i;
+            }
+
+            std::stable_sort(sortedClusters.begin(), sortedClusters.end(), [&clusterSortKeys](unsigned int a, unsigned int b)
+            {
+                return clusterSortKeys[a] > clusterSortKeys[b];
+            });
+
+            std::vector<unsigned int> optimizedIndices{};
+            optimizedIndices.reserve(indices.size());
+
+            for(const unsigned int cluster : sortedClusters)
+            {
+                for(unsigned int i = clusterStarts[cluster]; i < clusterStarts[cluster + 1]; i++)
+                {
+                    const unsigned int triangle = orderedTriangles[i];
+                    optimizedIndices.push_back(indices[triangle * 3]);
+                    optimizedIndices.push_back(indices[triangle * 3 + 1]);
+                    optimizedIndices.push_back(indices[triangle * 3 + 2]);
+                }
+            }
+
+            indices = std::move(optimizedIndices);
+        }
+
+        void MeshOptimizer::OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+        {
+            constexpr unsigned int INVALID_INDEX = std::numeric_limits<unsigned int>::max();
+            std::vector<unsigned int> vertexRemapping(vertices.size(), INVALID_INDEX);
+
+            std::vector<Vertex> reorderedVertices{};
+            reorderedVertices.reserve(vertices.size());
+
+            for(unsigned int& index : indices)
+            {
+                if(vertexRemapping[index] == INVALID_INDEX)
+                {
+                    vertexRemapping[index] = static_cast<unsigned int>(reorderedVertices.size());
+                    reorderedVertices.push_back(vertices[index]);
+                }
+
+                index = vertexRemapping[index];
+            }
+
+            vertices = std::move(reorderedVertices);
+        }
+
+        VertexCacheStatistics MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int totalVertices, unsigned int cacheSize)
+        {
+            VertexCacheStatistics statistics{};
+
+            if(indices.empty() || totalVertices == 0)
+            {
+                return statistics;
+            }
+
+            // Timestamp based FIFO, a vertex is cached while less than cacheSize other vertices entered after it
+            std::vector<unsigned int> cacheTimestamps(totalVertices, 0);
+            std::vector<bool> usedVertices(totalVertices, false);
+            unsigned int timestamp = cacheSize + 1;
+            unsigned int totalCacheMisses = 0;
+            unsigned int totalUsedVertices = 0;
+
+            for(unsigned int triangle = 0; triangle < static_cast<unsigned int>(indices.size() / 3); triangle++)
+            {
+                totalCacheMisses += UpdateVertexCache(indices, triangle, cacheSize, cacheTimestamps, timestamp);
+
+                for(unsigned int corner = 0; corner < 3; corner++)
+                {
+                    const unsigned int vertex = indices[triangle * 3 + corner];
+
+                    if(!usedVertices[vertex])
+                    {
+                        usedVertices[vertex] = true;
+                        totalUsedVertices++;
+                    }
+                }
+            }
+
+            statistics.ACMR = static_cast<float>(totalCacheMisses) / static_cast<float>(indices.size() / 3);
+            statistics.ATVR = static_cast<float>(totalCacheMisses) / static_cast<float>(totalUsedVertices);
+
+            return statistics;
+        }
+    }
+}
@@ -2,10 +2,9 @@
 
 #include "Rendering/OpenGLCore.h"
 
-#include "Rendering/IndexBuffer.h"
+#include "Rendering/GeometryBuffer.h"
 #include "Rendering/Material.h"
 #include "Rendering/Mesh.h"
-#include "Rendering/VertexArray.h"
 #include "GameObject/Transform.h"
 
 namespace Glacirer
@@ -15,14 +14,9 @@ namespace Glacirer
         void MeshRenderer::Render(const Mesh& mesh, const Transform& transform, const Material& material) const
         {
             material.Bind();
-            material.SetMat4("u_Model", transform.GetMatrix());
+            material.SetMat4("u_Model", mesh.HasQuantizedPositions() ? transform.GetMatrix() * mesh.GetDequantizationMatrix() : transform.GetMatrix());
 
-            mesh.GetVertexArray().Bind();
-
-            const IndexBuffer& ibo = mesh.GetIndexBuffer();
-            ibo.Bind();
-
-            GLCall(glDrawElements(GL_TRIANGLES, ibo.GetCount(), GL_UNSIGNED_INT, nullptr));
+            Draw(mesh);
 
             material.Unbind();
         }
@@ -31,46 +25,21 @@ namespace Glacirer
         {
             material.Bind();
 
-            mesh.GetVertexArray().Bind();
-
-            const IndexBuffer& ibo = mesh.GetIndexBuffer();
-            ibo.Bind();
-
-            GLCall(glDrawElements(GL_TRIANGLES, ibo.GetCount(), GL_UNSIGNED_INT, nullptr));
+            Draw(mesh);
 
             material.Unbind();
         }
 
-        void MeshRenderer::RenderInstanced(const Mesh& mesh, const Material& material, int amount, const std::shared_ptr<Shader>& overrideShader) const
+        void MeshRenderer::Draw(const Mesh& mesh) const
         {
-            if(overrideShader)
-            {
-                material.Bind(*overrideShader);
-            }
-            else
-            {
-                material.Bind();
-            }
-
-            mesh.GetVertexArray().Bind();
-            const IndexBuffer& ibo = mesh.GetIndexBuffer();
-            ibo.Bind();
-
-            GLCall(glDrawElementsInstanced(GL_TRIANGLES, ibo.GetCount(), GL_UNSIGNED_INT, nullptr, amount));
-            // glEnable(GL_PROGRAM_POINT_SIZE);
-            // GLCall(glDrawElementsInstanced(GL_POINTS, ibo.GetCount(), GL_UNSIGNED_INT, nullptr, amount));
+            const GeometryBuffer& geometryBuffer = mesh.GetGeometryBuffer();
+            const GeometryAllocation& allocation = mesh.GetGeometryAllocation();
 
-            ibo.Unbind();
-            mesh.GetVertexArray().Unbind();
+            geometryBuffer.Bind();
 
-            if(overrideShader)
-            {
-                material.Unbind(*overrideShader);
-            }
-            else
-            {
-                material.Unbind();
-            }
+            // Indices are relative to the mesh first vertex in the shared buffer
+            void* indicesOffset = reinterpret_cast<void*>(static_cast<size_t>(allocation.FirstIndex) * geometryBuffer.GetIndexSize());
+            GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, allocation.TotalIndices, geometryBuffer.GetIndexType(), indicesOffset, allocation.BaseVertex));
         }
     }
 }
@@ -0,0 +1,626 @@
+#include "Rendering/MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <glm/glm.hpp>
+
+#include "Rendering/Bounds.h"
+#include "Rendering/Mesh.h"
+
+namespace
+{
+    // Open borders get an extra plane perpendicular to the border, so they don't shrink inwards
+    constexpr double BOUNDARY_PLANE_WEIGHT = 10.0;
+    // How much a normal/texture coordinate mismatch costs compared to the (relative) squared position error
+    constexpr double ATTRIBUTE_ERROR_WEIGHT = 0.01;
+    // Collapses flipping or rotating any remaining triangle more than this (cosine) are rejected, avoids fold overs
+    constexpr double MIN_FLIP_COSINE = 0.2;
+
+    // Symmetric 4x4 matrix stored as its upper triangle
+    struct Quadric
+    {
+        double A00{0.0}, A01{0.0}, A02{0.0}, A03{0.0};
+        double A11{0.0}, A12{0.0}, A13{0.0};
+        double A22{0.0}, A23{0.0};
+        double A33{0.0};
+
+        static Quadric FromPlane(const glm::dvec3& normal, const double distance, const double weight)
+        {
+            Quadric quadric{};
+            quadric.A00 = weight * normal.x * normal.x;
+            quadric.A01 = weight * normal.x * normal.y;
+            quadric.A02 = weight * normal.x * normal.z;
+            quadric.A03 = weight * normal.x * distance;
+            quadric.A11 = weight * normal.y * normal.y;
+            quadric.A12 = weight * normal.y * normal.z;
+            quadric.A13 = weight * normal.y * distance;
+            quadric.A22 = weight * normal.z * normal.z;
+            quadric.A23 = weight * normal.z * distance;
+            quadric.A33 = weight * distance * distance;
+
+            return quadric;
+        }
+
+        void Add(const Quadric& other)
+        {
+            A00 += other.A00; A01 += other.A01; A02 += other.A02; A03 += other.A03;
+            A11 += other.A11; A12 += other.A12; A13 += other.A13;
+            A22 += other.A22; A23 += other.A23;
+            A33 += other.A33;
+        }
+
+        // Sum of squared distances from point to every accumulated plane
+        double Evaluate(const glm::dvec3& point) const
+        {
+            const double x = point.x;
+            const double y = point.y;
+            const double z = point.z;
+
+            const double error = A00 * x * x + 2.0 * A01 * x * y + 2.0 * A02 * x * z + 2.0 * A03 * x
+                + A11 * y * y + 2.0 * A12 * y * z + 2.0 * A13 * y
+                + A22 * z * z + 2.0 * A23 * z
+                + A33;
+
+            return error > 0.0 ? error : 0.0;
+        }
+    };
+
+    struct CollapseCandidate
+    {
+        double Cost;
+        unsigned int From;
+        unsigned int To;
+        unsigned int FromVersion;
+        unsigned int ToVersion;
+
+        bool operator>(const CollapseCandidate& other) const { return Cost > other.Cost; }
+    };
+
+    using CollapseQueue = std::priority_queue<CollapseCandidate, std::vector<CollapseCandidate>, std::greater<CollapseCandidate>>;
+
+    // Vertices with the same position are welded into a point, collapses move a whole point (all its vertices)
+    struct SimplificationContext
+    {
+        const std::vector<Glacirer::Rendering::Vertex>& Vertices;
+
+        std::vector<unsigned int> VertexPoints{};
+        std::vector<glm::dvec3> PointPositions{};
+        std::vector<std::vector<unsigned int>> PointVertices{};
+        std::vector<std::vector<unsigned int>> PointTriangles{}; // may contain removed triangles, compacted lazily
+        std::vector<Quadric> PointQuadrics{};
+        std::vector<unsigned int> PointVersions{}; // bumped whenever point quadric changes, invalidates queued candidates
+        std::vector<bool> PointAlive{};
+
+        std::vector<std::array<unsigned int, 3>> Triangles{}; // vertex indices
+        std::vector<bool> TriangleAlive{};
+        unsigned int TotalAliveTriangles{0};
+
+        double ErrorScale{1.0};
+    };
+
+    void WeldPoints(SimplificationContext& context)
+    {
+        std::map<std::tuple<float, float, float>, unsigned int> pointsByPosition{};
+        context.VertexPoints.resize(context.Vertices.size());
+
+        for(unsigned int i = 0; i < static_cast<unsigned int>(context.Vertices.size()); i++)
+        {
+            const glm::vec3& position = context.Vertices[i].Position;
+            const unsigned int newPoint = static_cast<unsigned int>(context.PointPositions.size());
+
+            auto result = pointsByPosition.emplace(std::make_tuple(position.x, position.y, position.z), newPoint);
+            if(result.second)
+            {
+                context.PointPositions.emplace_back(position);
+                context.PointVertices.emplace_back();
+            }
+
+            const unsigned int point = result.first->second;
+            context.VertexPoints[i] = point;
+            context.PointVertices[point].push_back(i);
+        }
+
+        const size_t totalPoints = context.PointPositions.size();
+        context.PointTriangles.resize(totalPoints);
+        context.PointQuadrics.resize(totalPoints);
+        context.PointVersions.resize(totalPoints, 0);
+        context.PointAlive.resize(totalPoints, true);
+    }
+
+    void BuildTriangles(SimplificationContext& context, const std::vector<unsigned int>& indices)
+    {
+        const size_t totalTriangles = indices.size() / 3;
+        context.Triangles.reserve(totalTriangles);
+
+        for(size_t i = 0; i < totalTriangles; i++)
+        {
+            const std::array<unsigned int, 3> triangle{indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2]};
+
+            const unsigned int pointA = context.VertexPoints[triangle[0]];
+            const unsigned int pointB = context.VertexPoints[triangle[1]];
+            const unsigned int pointC = context.VertexPoints[triangle[2]];
+
+            // Already degenerated triangles don't contribute to the surface
+            if(pointA == pointB || pointB == pointC || pointA == pointC)
+            {
+                continue;
+            }
+
+            const unsigned int triangleIndex = static_cast<unsigned int>(context.Triangles.size());
+            context.Triangles.push_back(triangle);
+            context.TriangleAlive.push_back(true);
+
+            context.PointTriangles[pointA].push_back(triangleIndex);
+            context.PointTriangles[pointB].push_back(triangleIndex);
+            context.PointTriangles[pointC].push_back(triangleIndex);
+        }
+
+        context.TotalAliveTriangles = static_cast<unsigned int>(context.Triangles.size());
+    }
+
+    glm::dvec3 GetTriangleCross(const SimplificationContext& context, const std::array<unsigned int, 3>& triangle)
+    {
+        const glm::dvec3& a = context.PointPositions[context.VertexPoints[triangle[0]]];
+        const glm::dvec3& b = context.PointPositions[context.VertexPoints[triangle[1]]];
+        const glm::dvec3& c = context.PointPositions[context.VertexPoints[triangle[2]]];
+
+        return glm::cross(b - a, c - a);
+    }
+
+    void BuildQuadrics(SimplificationContext& context)
+    {
+        std::map<std::pair<unsigned int, unsigned int>, int> edgeUsage{};
+
+        for(const std::array<unsigned int, 3>& triangle : context.Triangles)
+        {
+            const glm::dvec3 cross = GetTriangleCross(context, triangle);
+            const double crossLength = glm::length(cross);
+
+            for(int corner = 0; corner < 3; corner++)
+            {
+                const unsigned int point = context.VertexPoints[triangle[corner]];
+                const unsigned int nextPoint = context.VertexPoints[triangle[(corner + 1) % 3]];
+                edgeUsage[std::minmax(point, nextPoint)]++;
+
+                if(crossLength > 0.0)
+                {
+                    const glm::dvec3 normal = cross / crossLength;
+                    const double distance = -glm::dot(normal, context.PointPositions[point]);
+                    context.PointQuadrics[point].Add(Quadric::FromPlane(normal, distance, 1.0));
+                }
+            }
+        }
+
+        for(const std::array<unsigned int, 3>& triangle : context.Triangles)
+        {
+            const glm::dvec3 cross = GetTriangleCross(context, triangle);
+            const double crossLength = glm::length(cross);
+
+            if(crossLength <= 0.0)
+            {
+                continue;
+            }
+
+            for(int corner = 0; corner < 3; corner++)
+            {
+                const unsigned int point = context.VertexPoints[triangle[corner]];
+                const unsigned int nextPoint = context.VertexPoints[triangle[(corner + 1) % 3]];
+
+                if(edgeUsage[std::minmax(point, nextPoint)] != 1)
+                {
+                    continue;
+                }
+
+                const glm::dvec3 edge = context.PointPositions[nextPoint] - context.PointPositions[point];
+                const glm::dvec3 boundaryNormal = glm::cross(edge, cross / crossLength);
+                const double boundaryNormalLength = glm::length(boundaryNormal);
+
+                if(boundaryNormalLength <= 0.0)
+                {
+                    continue;
+                }
+
+                const glm::dvec3 normal = boundaryNormal / boundaryNormalLength;
+                const double distance = -glm::dot(normal, context.PointPositions[point]);
+                const Quadric boundaryQuadric = Quadric::FromPlane(normal, distance, BOUNDARY_PLANE_WEIGHT);
+
+                context.PointQuadrics[point].Add(boundaryQuadric);
+                context.PointQuadrics[nextPoint].Add(boundaryQuadric);
+            }
+        }
+    }
+
+    double GetAttributeDistance(const Glacirer::Rendering::Vertex& a, const Glacirer::Rendering::Vertex& b)
+    {
+        const glm::vec3 normalDelta = a.Normal - b.Normal;
+        const glm::vec2 texCoordDelta = a.TexCoord - b.TexCoord;
+
+        return static_cast<double>(glm::dot(normalDelta, normalDelta) + glm::dot(texCoordDelta, texCoordDelta));
+    }
+
+    // Vertex on the given point whose attributes best match the vertex, used to keep seams when a point moves
+    unsigned int FindClosestVertex(const SimplificationContext& context, const unsigned int vertex, const unsigned int point, double& outDistance)
+    {
+        unsigned int closestVertex = context.PointVertices[point].front();
+        outDistance = std::numeric_limits<double>::max();
+
+        for(const unsigned int candidate : context.PointVertices[point])
+        {
+            const double distance = GetAttributeDistance(context.Vertices[vertex], context.Vertices[candidate]);
+
+            if(distance < outDistance)
+            {
+                outDistance = distance;
+                closestVertex = candidate;
+            }
+        }
+
+        return closestVertex;
+    }
+
+    double ComputeCollapseCost(const SimplificationContext& context, const unsigned int from, const unsigned int to)
+    {
+        Quadric quadric = context.PointQuadrics[from];
+        quadric.Add(context.PointQuadrics[to]);
+
+        double attributeError = 0.0;
+
+        for(const unsigned int vertex : context.PointVertices[from])
+        {
+            double distance = 0.0;
+            FindClosestVertex(context, vertex, to, distance);
+            attributeError = glm::max(attributeError, distance);
+        }
+
+        return quadric.Evaluate(context.PointPositions[to]) * context.ErrorScale + attributeError * ATTRIBUTE_ERROR_WEIGHT;
+    }
+
+    // Also drops removed triangles from the point adjacency
+    void GatherNeighbours(SimplificationContext& context, const unsigned int point, std::vector<unsigned int>& outNeighbours)
+    {
+        outNeighbours.clear();
+        std::vector<unsigned int>& pointTriangles = context.PointTriangles[point];
+
+        size_t totalAliveTriangles = 0;
+        for(const unsigned int triangleIndex : pointTriangles)
+        {
+            if(!context.TriangleAlive[triangleIndex])
+            {
+                continue;
+            }
+
+            pointTriangles[totalAliveTriangles++] = triangleIndex;
+
+            for(const unsigned int vertex : context.Triangles[triangleIndex])
+            {
+                const unsigned int neighbour = context.VertexPoints[vertex];
+
+                if(neighbour != point && std::find(outNeighbours.begin(), outNeighbours.end(), neighbour) == outNeighbours.end())
+                {
+                    outNeighbours.push_back(neighbour);
+                }
+            }
+        }
+
+        pointTriangles.resize(totalAliveTriangles);
+    }
+
+    void PushCandidate(const SimplificationContext& context, CollapseQueue& queue, const unsigned int from, const unsigned int to)
+    {
+        queue.push(CollapseCandidate{
+            ComputeCollapseCost(context, from, to),
+            from,
+            to,
+            context.PointVersions[from],
+            context.PointVersions[to]});
+    }
+
+    bool IsCandidateUpToDate(const SimplificationContext& context, const CollapseCandidate& candidate)
+    {
+        return context.PointAlive[candidate.From]
+            && context.PointAlive[candidate.To]
+            && context.PointVersions[candidate.From] == candidate.FromVersion
+            && context.PointVersions[candidate.To] == candidate.ToVersion;
+    }
+
+    // Points sharing an alive triangle with the given one, the ones opposite to the edge towards edgePoint are added to outEdgeOpposites
+    void GatherLink(const SimplificationContext& context, const unsigned int point, const unsigned int edgePoint,
+                    std::vector<unsigned int>& outLink, std::vector<unsigned int>& outEdgeOpposites)
+    {
+        for(const unsigned int triangleIndex : context.PointTriangles[point])
+        {
+            if(!context.TriangleAlive[triangleIndex])
+            {
+                continue;
+            }
+
+            const std::array<unsigned int, 3>& triangle = context.Triangles[triangleIndex];
+            const bool bHasEdge = context.VertexPoints[triangle[0]] == edgePoint
+                || context.VertexPoints[triangle[1]] == edgePoint
+                || context.VertexPoints[triangle[2]] == edgePoint;
+
+            for(const unsigned int vertex : triangle)
+            {
+                const unsigned int neighbour = context.VertexPoints[vertex];
+
+                if(neighbour == point)
+                {
+                    continue;
+                }
+
+                if(std::find(outLink.begin(), outLink.end(), neighbour) == outLink.end())
+                {
+                    outLink.push_back(neighbour);
+                }
+
+                if(bHasEdge && neighbour != edgePoint && std::find(outEdgeOpposites.begin(), outEdgeOpposites.end(), neighbour) == outEdgeOpposites.end())
+                {
+                    outEdgeOpposites.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    // Link condition (Dey et al.): the only points both ends of the edge connect to have to be the ones opposite to the edge,
+    // otherwise the collapse pinches the surface into non-manifold geometry (e.g. closing a tunnel or merging two sheets)
+    bool SatisfiesLinkCondition(const SimplificationContext& context, const unsigned int from, const unsigned int to)
+    {
+        std::vector<unsigned int> fromLink{};
+        std::vector<unsigned int> toLink{};
+        std::vector<unsigned int> edgeOpposites{};
+        std::vector<unsigned int> unusedEdgeOpposites{};
+
+        GatherLink(context, from, to, fromLink, edgeOpposites);
+        GatherLink(context, to, from, toLink, unusedEdgeOpposites);
+
+        for(const unsigned int neighbour : fromLink)
+        {
+            if(neighbour != to
+                && std::find(toLink.begin(), toLink.end(), neighbour) != toLink.end()
+                && std::find(edgeOpposites.begin(), edgeOpposites.end(), neighbour) == edgeOpposites.end())
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool IsCollapseValid(const SimplificationContext& context, const unsigned int from, const unsigned int to)
+    {
+        if(!SatisfiesLinkCondition(context, from, to))
+        {
+            return false;
+        }
+
+        for(const unsigned int triangleIndex : context.PointTriangles[from])
+        {
+            if(!context.TriangleAlive[triangleIndex])
+            {
+                continue;
+            }
+
+            const std::array<unsigned int, 3>& triangle = context.Triangles[triangleIndex];
+
+            std::array<glm::dvec3, 3> movedPositions{};
+            bool bIsRemovedByCollapse = false;
+
+            for(int corner = 0; corner < 3; corner++)
+            {
+                const unsigned int point = context.VertexPoints[triangle[corner]];
+                bIsRemovedByCollapse |= point == to;
+                movedPositions[corner] = point == from ? context.PointPositions[to] : context.PointPositions[point];
+            }
+
+            if(bIsRemovedByCollapse)
+            {
+                continue;
+            }
+
+            const glm::dvec3 crossBefore = GetTriangleCross(context, triangle);
+            const glm::dvec3 crossAfter = glm::cross(movedPositions[1] - movedPositions[0], movedPositions[2] - movedPositions[0]);
+            const double lengthsProduct = glm::length(crossBefore) * glm::length(crossAfter);
+            const double crossesDot = glm::dot(crossBefore, crossAfter);
+
+            // Negative dot product is a flipped face normal, a degenerated triangle has none left
+            if(lengthsProduct <= 0.0 || crossesDot <= 0.0 || crossesDot < MIN_FLIP_COSINE * lengthsProduct)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void Collapse(SimplificationContext& context, const unsigned int from, const unsigned int to)
+    {
+        // Each vertex of the removed point is replaced by the vertex on target point with closest attributes
+        std::vector<std::pair<unsigned int, unsigned int>> vertexReplacements{};
+        vertexReplacements.reserve(context.PointVertices[from].size());
+
+        for(const unsigned int vertex : context.PointVertices[from])
+        {
+            double distance = 0.0;
+            vertexReplacements.emplace_back(vertex, FindClosestVertex(context, vertex, to, distance));
+        }
+
+        for(const unsigned int triangleIndex : context.PointTriangles[from])
+        {
+            if(!context.TriangleAlive[triangleIndex])
+            {
+                continue;
+            }
+
+            std::array<unsigned int, 3>& triangle = context.Triangles[triangleIndex];
+
+            const bool bIsRemovedByCollapse = context.VertexPoints[triangle[0]] == to
+                || context.VertexPoints[triangle[1]] == to
+                || context.VertexPoints[triangle[2]] == to;
+
+            if(bIsRemovedByCollapse)
+            {
+                context.TriangleAlive[triangleIndex] = false;
+                context.TotalAliveTriangles--;
+                continue;
+            }
+
+            for(unsigned int& vertex : triangle)
+            {
+                if(context.VertexPoints[vertex] != from)
+                {
+                    continue;
+                }
+
+                for(const std::pair<unsigned int, unsigned int>& replacement : vertexReplacements)
+                {
+                    if(replacement.first == vertex)
+                    {
+                        vertex = replacement.second;
+                        break;
+                    }
+                }
+            }
+
+            context.PointTriangles[to].push_back(triangleIndex);
+        }
+
+        context.PointQuadrics[to].Add(context.PointQuadrics[from]);
+        context.PointTriangles[from].clear();
+        context.PointAlive[from] = false;
+        context.PointVersions[to]++;
+    }
+}
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        bool MeshSimplifier::Simplify(
+            const std::vector<Vertex>& vertices,
+            const std::vector<unsigned int>& indices,
+            unsigned int targetTotalIndices,
+            float maxRelativeError,
+            std::vector<Vertex>& outVertices,
+            std::vector<unsigned int>& outIndices)
+        {
+            outVertices.clear();
+            outIndices.clear();
+
+            if(vertices.empty() || indices.size() < 3 || targetTotalIndices >= indices.size())
+            {
+                return false;
+            }
+
+            SimplificationContext context{vertices};
+            WeldPoints(context);
+            BuildTriangles(context, indices);
+            BuildQuadrics(context);
+
+            // Errors are measured relative to mesh size, so the same threshold works for any model scale
+            Bounds bounds{};
+            for(const Vertex& vertex : vertices)
+            {
+                bounds.Encapsulate(vertex.Position);
+            }
+
+            const double diagonalLength = static_cast<double>(glm::length(bounds.Max - bounds.Min));
+            if(diagonalLength <= 0.0)
+            {
+                return false;
+            }
+
+            context.ErrorScale = 1.0 / (diagonalLength * diagonalLength);
+            const double maxCost = static_cast<double>(maxRelativeError) * static_cast<double>(maxRelativeError);
+
+            const unsigned int targetTotalTriangles = targetTotalIndices / 3;
+            const unsigned int initialTotalTriangles = context.TotalAliveTriangles;
+
+            CollapseQueue queue{};
+            std::vector<unsigned int> neighbours{};
+
+            for(unsigned int point = 0; point < static_cast<unsigned int>(context.PointPositions.size()); point++)
+            {
+                GatherNeighbours(context, point, neighbours);
+
+                for(const unsigned int neighbour : neighbours)
+                {
+                    // Each edge is seen from both points, only queue it once (on both directions)
+                    if(neighbour > point)
+                    {
+                        PushCandidate(context, queue, point, neighbour);
+                        PushCandidate(context, queue, neighbour, point);
+                    }
+                }
+            }
+
+            while(context.TotalAliveTriangles > targetTotalTriangles && !queue.empty())
+            {
+                const CollapseCandidate candidate = queue.top();
+                queue.pop();
+
+                if(!IsCandidateUpToDate(context, candidate))
+                {
+                    continue;
+                }
+
+                if(candidate.Cost > maxCost)
+                {
+                    break;
+                }
+
+                if(!IsCollapseValid(context, candidate.From, candidate.To))
+                {
+                    continue;
+                }
+
+                Collapse(context, candidate.From, candidate.To);
+
+                // Only edges touching the target point changed their cost
+                GatherNeighbours(context, candidate.To, neighbours);
+
+                for(const unsigned int neighbour : neighbours)
+                {
+                    PushCandidate(context, queue, candidate.To, neighbour);
+                    PushCandidate(context, queue, neighbour, candidate.To);
+                }
+            }
+
+            if(context.TotalAliveTriangles == initialTotalTriangles)
+            {
+                return false;
+            }
+
+            // Compact, keeping only vertices still referenced by a triangle
+            constexpr unsigned int INVALID_INDEX = std::numeric_limits<unsigned int>::max();
+            std::vector<unsigned int> vertexRemapping(vertices.size(), INVALID_INDEX);
+
+            outIndices.reserve(context.TotalAliveTriangles * 3);
+
+            for(size_t i = 0; i < context.Triangles.size(); i++)
+            {
+                if(!context.TriangleAlive[i])
+                {
+                    continue;
+                }
+
+                for(const unsigned int vertex : context.Triangles[i])
+                {
+                    if(vertexRemapping[vertex] == INVALID_INDEX)
+                    {
+                        vertexRemapping[vertex] = static_cast<unsigned int>(outVertices.size());
+                        outVertices.push_back(vertices[vertex]);
+                    }
+
+                    outIndices.push_back(vertexRemapping[vertex]);
+                }
+            }
+
+            return true;
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#include "Rendering/PixelUnpackBuffer.h"
+
+#include <cstring>
+
+#include "Rendering/OpenGLCore.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        PixelUnpackBuffer::PixelUnpackBuffer()
+        {
+            GLCall(glGenBuffers(1, &m_RendererID));
+        }
+
+        PixelUnpackBuffer::~PixelUnpackBuffer()
+        {
+            GLCall(glDeleteBuffers(1, &m_RendererID));
+        }
+
+        void PixelUnpackBuffer::Bind() const
+        {
+            GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_RendererID));
+        }
+
+        void PixelUnpackBuffer::Unbind() const
+        {
+            GLCall(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
+        }
+
+        void PixelUnpackBuffer::SetData(const void* data, unsigned int size) const
+        {
+            GLCall(glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW));
+
+            GLCall(void* mappedData = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+
+            if(mappedData)
+            {
+                std::memcpy(mappedData, data, size);
+                GLCall(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+            }
+        }
+    }
+}
@@ -1,11 +1,32 @@
 #include "Rendering/PostProcessingSystem.h"
 
-#include "Rendering/FrameBuffer.h"
+#include <algorithm>
+
 #include "Rendering/Material.h"
 #include "Rendering/Primitive.h"
 #include "Resources/ResourceManager.h"
 #include "Basics/Components/PostProcessingComponent.h"
 
+namespace
+{
+    Glacirer::Rendering::Resolution GetScaledResolution(const Glacirer::Rendering::Resolution& resolution, Glacirer::PostProcessingResolution scale)
+    {
+        const unsigned int shift = static_cast<unsigned int>(scale);
+
+        return Glacirer::Rendering::Resolution{
+            std::max(resolution.Width >> shift, 1u),
+            std::max(resolution.Height >> shift, 1u)};
+    }
+
+    std::shared_ptr<Glacirer::Rendering::Material> CreatePassMaterial(const std::string& shaderFile, const std::string& name)
+    {
+        const std::string shaderName = "PostProcessing" + name;
+        Glacirer::Resources::ResourceManager::LoadShader(Glacirer::Resources::ResourceManager::RESOURCES_PATH + "Shaders/" + shaderFile, shaderName);
+
+        return Glacirer::Resources::ResourceManager::CreateMaterial("M_" + shaderName, shaderName);
+    }
+}
+
 namespace Glacirer
 {
     namespace Rendering
@@ -17,12 +38,11 @@ namespace Glacirer
             const std::string POST_PROCESSING_SHADER_NAME = "PostProcessing";
             Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/PostProcessing.glsl", POST_PROCESSING_SHADER_NAME);
 
-            m_PostProcessingMaterial = Resources::ResourceManager::CreateMaterial("M_PostProcessing", POST_PROCESSING_SHADER_NAME);
-        }
-
-        void PostProcessingSystem::SetFramebuffer(const Framebuffer& framebuffer) const
-        {
-            m_PostProcessingMaterial->SetTexture("u_ScreenTexture", framebuffer.GetMainColorBufferTexture(), 0);
+            m_CompositeMaterial = Resources::ResourceManager::CreateMaterial("M_PostProcessing", POST_PROCESSING_SHADER_NAME);
+            m_SharpenMaterial = CreatePassMaterial("PostProcessing/Sharpen.glsl", "Sharpen");
+            m_DownsampleMaterial = CreatePassMaterial("PostProcessing/Downsample.glsl", "Downsample");
+            m_BlurMaterial = CreatePassMaterial("PostProcessing/GaussianBlur.glsl", "GaussianBlur");
+            m_EdgeDetectionMaterial = CreatePassMaterial("PostProcessing/EdgeDetection.glsl", "EdgeDetection");
         }
 
         void PostProcessingSystem::SetPostProcessingComponent(const std::shared_ptr<PostProcessingComponent>& postProcessingComponent)
@@ -30,7 +50,8 @@ namespace Glacirer
             m_PostProcessingComponent = postProcessingComponent;
 
             UpdatePostProcessingMaterial();
-            m_PostProcessingComponent->SetDirty(false); 
+            UpdatePasses();
+            m_PostProcessingComponent->SetDirty(false);
         }
 
         void PostProcessingSystem::RemovePostProcessingComponent(const std::shared_ptr<PostProcessingComponent>& postProcessingComponent)
@@ -42,17 +63,43 @@ namespace Glacirer
 
             m_PostProcessingComponent = nullptr;
             UpdatePostProcessingMaterial();
+            UpdatePasses();
         }
 
-        void PostProcessingSystem::RenderToScreen()
+        void PostProcessingSystem::AddPasses(RenderGraph& renderGraph, RenderGraphResource source, RenderGraphResource output)
         {
             if(m_PostProcessingComponent && m_PostProcessingComponent->IsDirty())
             {
                 UpdatePostProcessingMaterial();
+                UpdatePasses();
                 m_PostProcessingComponent->SetDirty(false);
             }
-    
-            m_MeshRenderer.Render(*m_ScreenQuad, *m_PostProcessingMaterial);
+
+            const Resolution sourceResolution = renderGraph.GetDesc(source).Resolution;
+
+            for(const PostProcessingPass& pass : m_Passes)
+            {
+                RenderTargetDesc targetDesc{};
+                targetDesc.Resolution = GetScaledResolution(sourceResolution, pass.Scale);
+
+                const RenderGraphResource target = renderGraph.CreateTarget(pass.Name, targetDesc);
+
+                // Passes only change before the graph is built, a reference keeps the capture small enough for std::function not to allocate
+                renderGraph.AddPass(pass.Name, [this, &pass, source, target](const RenderGraphContext& context)
+                {
+                    context.BindTarget(target);
+                    RenderPass(pass, context.GetTexture(source), context.GetUVScale(source));
+                }).Read(source).Write(target);
+
+                source = target;
+            }
+
+            renderGraph.AddPass("PostProcessingComposite", [this, source, output](const RenderGraphContext& context)
+            {
+                context.BindTarget(output);
+                m_CompositeMaterial->SetTexture("u_ScreenTexture", context.GetTexture(source), 0);
+                RenderScreenQuad(*m_CompositeMaterial, context.GetUVScale(source));
+            }).Read(source).Write(output);
         }
 
         void PostProcessingSystem::UpdatePostProcessingMaterial()
@@ -60,26 +107,78 @@ namespace Glacirer
             float gammaValue = 2.2f;
             bool bIsColorInversionEnabled = false;
             bool bIsGrayScaleEnabled = false;
-            bool bIsSharpenEnabled = false;
-            bool bIsBlurEnabled = false;
-            bool bIsEdgeDetectionEnabled = false;
 
             if(m_PostProcessingComponent)
             {
                 gammaValue = m_PostProcessingComponent->GetGammaValue();
                 bIsColorInversionEnabled = m_PostProcessingComponent->IsColorInversionEnabled();
                 bIsGrayScaleEnabled = m_PostProcessingComponent->IsGrayScaleEnabled();
-                bIsSharpenEnabled = m_PostProcessingComponent->IsSharpenEnabled();
-                bIsBlurEnabled = m_PostProcessingComponent->IsBlurEnabled();
-                bIsEdgeDetectionEnabled = m_PostProcessingComponent->IsEdgeDetectionEnabled();
             }
 
-            m_PostProcessingMaterial->SetFloat("u_PostProcessing.Gamma", gammaValue);
-            m_PostProcessingMaterial->SetBool("u_PostProcessing.ColorInversionEnabled", bIsColorInversionEnabled);
-            m_PostProcessingMaterial->SetBool("u_PostProcessing.GrayScaleEnabled", bIsGrayScaleEnabled);
-            m_PostProcessingMaterial->SetBool("u_PostProcessing.SharpenEnabled", bIsSharpenEnabled);
-            m_PostProcessingMaterial->SetBool("u_PostProcessing.BlurEnabled", bIsBlurEnabled);
-            m_PostProcessingMaterial->SetBool("u_PostProcessing.EdgeDetectionEnabled", bIsEdgeDetectionEnabled);
+            m_CompositeMaterial->SetFloat("u_PostProcessing.Gamma", gammaValue);
+            m_CompositeMaterial->SetBool("u_PostProcessing.ColorInversionEnabled", bIsColorInversionEnabled);
+            m_CompositeMaterial->SetBool("u_PostProcessing.GrayScaleEnabled", bIsGrayScaleEnabled);
+        }
+
+        void PostProcessingSystem::UpdatePasses()
+        {
+            m_Passes.clear();
+
+            if(!m_PostProcessingComponent)
+            {
+                return;
+            }
+
+            if(m_PostProcessingComponent->IsSharpenEnabled())
+            {
+                m_Passes.push_back(PostProcessingPass{"Sharpen", m_SharpenMaterial});
+            }
+
+            if(m_PostProcessingComponent->IsBlurEnabled())
+            {
+                const PostProcessingResolution blurResolution = m_PostProcessingComponent->GetBlurResolution();
+
+                // Both blur passes read a source of their own resolution so the kernel covers the same size on each axis.
+                // The following full resolution pass (or the composite) upsamples with bilinear filtering
+                if(blurResolution != PostProcessingResolution::Full)
+                {
+                    m_Passes.push_back(PostProcessingPass{"BlurDownsample", m_DownsampleMaterial, blurResolution});
+                }
+
+                m_Passes.push_back(PostProcessingPass{"HorizontalBlur", m_BlurMaterial, blurResolution, true});
+                m_Passes.push_back(PostProcessingPass{"VerticalBlur", m_BlurMaterial, blurResolution, false});
+            }
+
+            if(m_PostProcessingComponent->IsEdgeDetectionEnabled())
+            {
+                m_Passes.push_back(PostProcessingPass{"EdgeDetection", m_EdgeDetectionMaterial});
+            }
+        }
+
+        void PostProcessingSystem::RenderPass(const PostProcessingPass& pass, const std::shared_ptr<Texture>& source, const glm::vec2& sourceUVScale) const
+        {
+            pass.Material->SetTexture("u_ScreenTexture", source, 0);
+
+            if(pass.Material == m_BlurMaterial)
+            {
+                pass.Material->SetBool("u_Horizontal", pass.bIsHorizontal);
+            }
+            else if(pass.Material == m_DownsampleMaterial)
+            {
+                // Passes before the blur all run at full resolution
+                pass.Material->SetFloat("u_DownsampleFactor", static_cast<float>(1u << static_cast<unsigned int>(pass.Scale)));
+            }
+
+            RenderScreenQuad(*pass.Material, sourceUVScale);
+        }
+
+        void PostProcessingSystem::RenderScreenQuad(const Material& material, const glm::vec2& sourceUVScale) const
+        {
+            // Not a material property, has to be set on the shader once bound
+            material.Bind();
+            material.SetVec2("u_UVScale", sourceUVScale);
+
+            m_MeshRenderer.Render(*m_ScreenQuad, material);
         }
     }
 }
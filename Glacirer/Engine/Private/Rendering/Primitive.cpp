@@ -1,10 +1,23 @@
 #include "Rendering/Primitive.h"
 
+#include <cstring>
 #include <memory>
 
 #include "Rendering/Mesh.h"
 #include "Rendering/VertexBufferLayout.h"
 
+namespace
+{
+ // Interleaved position, normal and UV floats are laid out as Vertex, meshes built from them share geometry buffers with imported ones
+ std::vector<Glacirer::Rendering::Vertex> ToVertices(const float* vertexData, size_t totalFloats)
+ {
+  std::vector<Glacirer::Rendering::Vertex> vertices(totalFloats * sizeof(float) / sizeof(Glacirer::Rendering::Vertex));
+  std::memcpy(vertices.data(), vertexData, vertices.size() * sizeof(Glacirer::Rendering::Vertex));
+
+  return vertices;
+ }
+}
+
 namespace Glacirer
 {
  namespace Rendering
@@ -72,12 +85,7 @@ namespace Glacirer
     22, 23, 20
    };
 
-   VertexBufferLayout layout{};
-   layout.PushFloat(3);
-   layout.PushFloat(3);
-   layout.PushFloat(2);
-
-   std::shared_ptr<Mesh> cube = std::make_shared<Mesh>(vertices, sizeof(vertices), layout, indices);
+   std::shared_ptr<Mesh> cube = std::make_shared<Mesh>(ToVertices(vertices, sizeof(vertices) / sizeof(float)), indices);
    cube->SetName("Cube");
 
    return cube;
@@ -99,12 +107,7 @@ namespace Glacirer
     2, 3, 0
    };
 
-   VertexBufferLayout layout{};
-   layout.PushFloat(3);
-   layout.PushFloat(3);
-   layout.PushFloat(2);
-
-   std::shared_ptr<Mesh> quad = std::make_shared<Mesh>(vertices, sizeof(vertices), layout, indices);
+   std::shared_ptr<Mesh> quad = std::make_shared<Mesh>(ToVertices(vertices, sizeof(vertices) / sizeof(float)), indices);
    quad->SetName("Quad");
 
    return quad;
@@ -131,7 +134,7 @@ namespace Glacirer
    layout.PushFloat(3);
    layout.PushFloat(2);
 
-   std::shared_ptr<Mesh> screenQuad = std::make_shared<Mesh>(vertices, sizeof(vertices), layout, indices);
+   std::shared_ptr<Mesh> screenQuad = std::make_shared<Mesh>(vertices, sizeof(vertices), std::move(layout), indices);
    screenQuad->SetName("ScreenQuad");
 
    return screenQuad;
@@ -205,7 +208,7 @@ namespace Glacirer
    VertexBufferLayout layout{};
    layout.PushFloat(3);
 
-   std::shared_ptr<Mesh> skyCube = std::make_shared<Mesh>(vertices, sizeof(vertices), layout, indices);
+   std::shared_ptr<Mesh> skyCube = std::make_shared<Mesh>(vertices, sizeof(vertices), std::move(layout), indices);
    skyCube->SetName("SkyCube");
 
    return skyCube;
@@ -0,0 +1,98 @@
+#include "Rendering/RangeAllocator.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        RangeAllocator::RangeAllocator(unsigned int capacity)
+            : m_Capacity(capacity)
+        {
+            if(capacity > 0)
+            {
+                m_FreeRanges[0] = capacity;
+            }
+        }
+
+        unsigned int RangeAllocator::Allocate(unsigned int size)
+        {
+            if(size == 0)
+            {
+                return 0;
+            }
+
+            for(auto iterator = m_FreeRanges.begin(); iterator != m_FreeRanges.end(); ++iterator)
+            {
+                if(iterator->second < size)
+                {
+                    continue;
+                }
+
+                const unsigned int offset = iterator->first;
+                const unsigned int remainingSize = iterator->second - size;
+
+                m_FreeRanges.erase(iterator);
+
+                if(remainingSize > 0)
+                {
+                    m_FreeRanges[offset + size] = remainingSize;
+                }
+
+                m_UsedSize += size;
+
+                return offset;
+            }
+
+            return INVALID_OFFSET;
+        }
+
+        void RangeAllocator::Free(unsigned int offset, unsigned int size)
+        {
+            if(size == 0)
+            {
+                return;
+            }
+
+            assert(offset + size <= m_Capacity);
+            m_UsedSize -= size;
+
+            auto next = m_FreeRanges.lower_bound(offset);
+
+            if(next != m_FreeRanges.end() && offset + size == next->first)
+            {
+                size += next->second;
+                next = m_FreeRanges.erase(next);
+            }
+
+            if(next != m_FreeRanges.begin())
+            {
+                auto previous = std::prev(next);
+
+                if(previous->first + previous->second == offset)
+                {
+                    previous->second += size;
+                    return;
+                }
+            }
+
+            m_FreeRanges[offset] = size;
+        }
+
+        void RangeAllocator::Grow(unsigned int capacity)
+        {
+            if(capacity <= m_Capacity)
+            {
+                return;
+            }
+
+            const unsigned int previousCapacity = m_Capacity;
+            m_Capacity = capacity;
+
+            // Freed the same way a range would be, so it merges with a free range left at the end
+            m_UsedSize += capacity - previousCapacity;
+            Free(previousCapacity, capacity - previousCapacity);
+        }
+    }
+}
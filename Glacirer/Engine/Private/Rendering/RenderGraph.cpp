@@ -0,0 +1,431 @@
+#include "Rendering/RenderGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+#include "FrameArena.h"
+#include "Rendering/Device.h"
+#include "Rendering/FrameBuffer.h"
+#include "Rendering/OpenGLCore.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        RenderGraphContext::RenderGraphContext(const RenderGraph& graph, const Device& device)
+            : m_Graph(graph), m_Device(device)
+        { }
+
+        const Framebuffer* RenderGraphContext::GetFramebuffer(RenderGraphResource resource) const
+        {
+            const RenderGraph::Resource& graphResource = m_Graph.m_Resources[resource.Index];
+
+            return graphResource.Type == RenderGraph::ResourceType::Transient
+                ? graphResource.TransientFramebuffer.get()
+                : graphResource.ImportedFramebuffer;
+        }
+
+        std::shared_ptr<Texture> RenderGraphContext::GetTexture(RenderGraphResource resource) const
+        {
+            const Framebuffer* framebuffer = GetFramebuffer(resource);
+
+            return framebuffer ? framebuffer->GetMainColorBufferTexture() : nullptr;
+        }
+
+        const RenderTargetDesc& RenderGraphContext::GetDesc(RenderGraphResource resource) const
+        {
+            return m_Graph.GetDesc(resource);
+        }
+
+        void RenderGraphContext::BindTarget(RenderGraphResource resource) const
+        {
+            if(const Framebuffer* framebuffer = GetFramebuffer(resource))
+            {
+                framebuffer->Bind();
+            }
+            else
+            {
+                assert(m_Graph.m_Resources[resource.Index].Type == RenderGraph::ResourceType::Backbuffer);
+                GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+            }
+
+            m_Device.SetViewportResolution(GetDesc(resource).Resolution);
+        }
+
+        glm::vec2 RenderGraphContext::GetUVScale(RenderGraphResource resource) const
+        {
+            const Framebuffer* framebuffer = GetFramebuffer(resource);
+
+            if(!framebuffer)
+            {
+                return glm::vec2{1.f};
+            }
+
+            const Resolution& resolution = GetDesc(resource).Resolution;
+            const Resolution allocatedResolution = framebuffer->GetResolution();
+
+            return glm::vec2{
+                static_cast<float>(resolution.Width) / static_cast<float>(allocatedResolution.Width),
+                static_cast<float>(resolution.Height) / static_cast<float>(allocatedResolution.Height)};
+        }
+
+        RenderGraphPassBuilder::RenderGraphPassBuilder(RenderGraph& graph, uint32_t passIndex)
+            : m_Graph(graph), m_PassIndex(passIndex)
+        { }
+
+        RenderGraphPassBuilder& RenderGraphPassBuilder::Read(RenderGraphResource resource)
+        {
+            assert(resource.IsValid());
+            m_Graph.m_Passes[m_PassIndex].Reads.push_back(resource.Index);
+
+            return *this;
+        }
+
+        RenderGraphPassBuilder& RenderGraphPassBuilder::Write(RenderGraphResource resource)
+        {
+            assert(resource.IsValid());
+            m_Graph.m_Passes[m_PassIndex].Writes.push_back(resource.Index);
+            m_Graph.m_Resources[resource.Index].Writers.push_back(m_PassIndex);
+
+            return *this;
+        }
+
+        RenderGraphPassBuilder& RenderGraphPassBuilder::SetSideEffect()
+        {
+            m_Graph.m_Passes[m_PassIndex].bHasSideEffect = true;
+
+            return *this;
+        }
+
+        RenderGraphResource RenderGraph::CreateTarget(const char* name, const RenderTargetDesc& desc)
+        {
+            const RenderGraphResource resource = AddResource(name, ResourceType::Transient);
+            m_Resources[resource.Index].Desc = desc;
+
+            return resource;
+        }
+
+        RenderGraphResource RenderGraph::ImportTarget(const char* name, const Framebuffer& framebuffer)
+        {
+            const RenderGraphResource resource = AddResource(name, ResourceType::Imported);
+            m_Resources[resource.Index].ImportedFramebuffer = &framebuffer;
+            m_Resources[resource.Index].Desc.Resolution = framebuffer.GetResolution();
+
+            return resource;
+        }
+
+        RenderGraphResource RenderGraph::ImportBackbuffer(const Resolution& resolution)
+        {
+            const RenderGraphResource resource = AddResource("Backbuffer", ResourceType::Backbuffer);
+            m_Resources[resource.Index].Desc.Resolution = resolution;
+
+            return resource;
+        }
+
+        RenderGraphResource RenderGraph::ImportExternal(const char* name)
+        {
+            return AddResource(name, ResourceType::External);
+        }
+
+        void RenderGraph::MarkAsOutput(RenderGraphResource resource)
+        {
+            m_Resources[resource.Index].bIsOutput = true;
+        }
+
+        RenderGraphPassBuilder RenderGraph::AddPass(const char* name, RenderGraphExecuteFunction execute)
+        {
+            if(m_RecycledPasses.empty())
+            {
+                m_Passes.emplace_back();
+            }
+            else
+            {
+                m_Passes.push_back(std::move(m_RecycledPasses.back()));
+                m_RecycledPasses.pop_back();
+            }
+
+            Pass& pass = m_Passes.back();
+            pass.Name = name;
+            pass.Execute = std::move(execute);
+            bIsCompiled = false;
+
+            return RenderGraphPassBuilder(*this, static_cast<uint32_t>(m_Passes.size() - 1));
+        }
+
+        bool RenderGraph::Compile()
+        {
+            m_ExecutionOrder.clear();
+
+            if(!ValidateReads())
+            {
+                bIsCompiled = false;
+                return false;
+            }
+
+            CullPasses();
+
+            for(uint32_t passIndex = 0; passIndex < static_cast<uint32_t>(m_Passes.size()); passIndex++)
+            {
+                if(!m_Passes[passIndex].bIsCulled)
+                {
+                    m_ExecutionOrder.push_back(passIndex);
+                }
+            }
+
+            ComputeTargetLifetimes();
+            bIsCompiled = true;
+
+            return true;
+        }
+
+        void RenderGraph::Execute(const Device& device, RenderTargetPool& renderTargetPool)
+        {
+            assert(bIsCompiled);
+
+            const RenderGraphContext context(*this, device);
+
+            for(uint32_t passIndex : m_ExecutionOrder)
+            {
+                Pass& pass = m_Passes[passIndex];
+
+                for(uint32_t resourceIndex : pass.TargetsToAcquire)
+                {
+                    Resource& resource = m_Resources[resourceIndex];
+                    resource.TransientFramebuffer = renderTargetPool.Acquire(resource.Desc);
+                }
+
+                pass.Execute(context);
+
+                // Released as soon as their last reader is done, so the pool can hand them to the next passes
+                for(uint32_t resourceIndex : pass.TargetsToRelease)
+                {
+                    Resource& resource = m_Resources[resourceIndex];
+                    renderTargetPool.Release(resource.TransientFramebuffer);
+                    resource.TransientFramebuffer.reset();
+                }
+            }
+        }
+
+        void RenderGraph::Reset()
+        {
+            // Lists are moved with their storage, everything else goes back to defaults
+            for(Resource& resource : m_Resources)
+            {
+                Resource recycledResource{};
+                recycledResource.Writers = std::move(resource.Writers);
+                recycledResource.Writers.clear();
+                m_RecycledResources.push_back(std::move(recycledResource));
+            }
+
+            for(Pass& pass : m_Passes)
+            {
+                Pass recycledPass{};
+                recycledPass.Reads = std::move(pass.Reads);
+                recycledPass.Writes = std::move(pass.Writes);
+                recycledPass.TargetsToAcquire = std::move(pass.TargetsToAcquire);
+                recycledPass.TargetsToRelease = std::move(pass.TargetsToRelease);
+                recycledPass.Reads.clear();
+                recycledPass.Writes.clear();
+                recycledPass.TargetsToAcquire.clear();
+                recycledPass.TargetsToRelease.clear();
+                m_RecycledPasses.push_back(std::move(recycledPass));
+            }
+
+            m_Resources.clear();
+            m_Passes.clear();
+            m_ExecutionOrder.clear();
+            bIsCompiled = false;
+        }
+
+        RenderGraphResource RenderGraph::AddResource(const char* name, ResourceType type)
+        {
+            if(m_RecycledResources.empty())
+            {
+                m_Resources.emplace_back();
+            }
+            else
+            {
+                m_Resources.push_back(std::move(m_RecycledResources.back()));
+                m_RecycledResources.pop_back();
+            }
+
+            Resource& resource = m_Resources.back();
+            resource.Name = name;
+            resource.Type = type;
+            bIsCompiled = false;
+
+            return RenderGraphResource{static_cast<uint32_t>(m_Resources.size() - 1)};
+        }
+
+        bool RenderGraph::IsReadOnlyBy(const Pass& pass, uint32_t resourceIndex) const
+        {
+            return std::find(pass.Writes.begin(), pass.Writes.end(), resourceIndex) == pass.Writes.end();
+        }
+
+        bool RenderGraph::ValidateReads() const
+        {
+            for(uint32_t passIndex = 0; passIndex < static_cast<uint32_t>(m_Passes.size()); passIndex++)
+            {
+                const Pass& pass = m_Passes[passIndex];
+
+                for(uint32_t resourceIndex : pass.Reads)
+                {
+                    const Resource& resource = m_Resources[resourceIndex];
+
+                    // Imported data may come from previous frames, transient targets only exist once written
+                    if(resource.Type != ResourceType::Transient)
+                    {
+                        continue;
+                    }
+
+                    const bool bIsWrittenBefore = std::any_of(resource.Writers.begin(), resource.Writers.end(), [passIndex](uint32_t writer)
+                    {
+                        return writer < passIndex;
+                    });
+
+                    if(!bIsWrittenBefore)
+                    {
+                        std::cout << "ERROR::RENDER_GRAPH: Pass " << pass.Name << " reads " << resource.Name << " before any pass writes it\n";
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        void RenderGraph::CullPasses()
+        {
+            // A pass is needed while something needs one of its writes, and a resource while a pass needing it reads it.
+            // Reads of a resource the pass also writes (e.g. drawing on top of it) don't keep that resource alive
+            for(Pass& pass : m_Passes)
+            {
+                pass.bIsCulled = false;
+                pass.RefCount = static_cast<unsigned int>(pass.Writes.size());
+
+                for(uint32_t resourceIndex : pass.Reads)
+                {
+                    if(IsReadOnlyBy(pass, resourceIndex))
+                    {
+                        m_Resources[resourceIndex].RefCount++;
+                    }
+                }
+            }
+
+            FrameVector<uint32_t> unusedResources{};
+            unusedResources.reserve(m_Resources.size());
+
+            for(uint32_t resourceIndex = 0; resourceIndex < static_cast<uint32_t>(m_Resources.size()); resourceIndex++)
+            {
+                Resource& resource = m_Resources[resourceIndex];
+
+                if(resource.bIsOutput)
+                {
+                    resource.RefCount++;
+                }
+
+                if(resource.RefCount == 0)
+                {
+                    unusedResources.push_back(resourceIndex);
+                }
+            }
+
+            auto cullPass = [this, &unusedResources](Pass& pass)
+            {
+                pass.bIsCulled = true;
+
+                for(uint32_t resourceIndex : pass.Reads)
+                {
+                    if(IsReadOnlyBy(pass, resourceIndex) && --m_Resources[resourceIndex].RefCount == 0)
+                    {
+                        unusedResources.push_back(resourceIndex);
+                    }
+                }
+            };
+
+            // Passes writing nothing are only kept for their side effects
+            for(Pass& pass : m_Passes)
+            {
+                if(pass.RefCount == 0 && !pass.bHasSideEffect)
+                {
+                    cullPass(pass);
+                }
+            }
+
+            while(!unusedResources.empty())
+            {
+                const uint32_t resourceIndex = unusedResources.back();
+                unusedResources.pop_back();
+
+                for(uint32_t writerIndex : m_Resources[resourceIndex].Writers)
+                {
+                    Pass& writer = m_Passes[writerIndex];
+
+                    if(!writer.bIsCulled && --writer.RefCount == 0 && !writer.bHasSideEffect)
+                    {
+                        cullPass(writer);
+                    }
+                }
+            }
+        }
+
+        void RenderGraph::ComputeTargetLifetimes()
+        {
+            constexpr uint32_t NOT_USED = 0xFFFFFFFF;
+
+            FrameVector<uint32_t> firstUses(m_Resources.size(), NOT_USED);
+            FrameVector<uint32_t> lastUses(m_Resources.size(), NOT_USED);
+
+            for(uint32_t position = 0; position < static_cast<uint32_t>(m_ExecutionOrder.size()); position++)
+            {
+                Pass& pass = m_Passes[m_ExecutionOrder[position]];
+                pass.TargetsToAcquire.clear();
+                pass.TargetsToRelease.clear();
+
+                auto use = [&firstUses, &lastUses, position](uint32_t resourceIndex)
+                {
+                    if(firstUses[resourceIndex] == NOT_USED)
+                    {
+                        firstUses[resourceIndex] = position;
+                    }
+
+                    lastUses[resourceIndex] = position;
+                };
+
+                std::for_each(pass.Reads.begin(), pass.Reads.end(), use);
+                std::for_each(pass.Writes.begin(), pass.Writes.end(), use);
+            }
+
+            unsigned int totalAliveTargets = 0;
+            m_PeakTransientTargets = 0;
+
+            for(uint32_t position = 0; position < static_cast<uint32_t>(m_ExecutionOrder.size()); position++)
+            {
+                Pass& pass = m_Passes[m_ExecutionOrder[position]];
+
+                for(uint32_t resourceIndex = 0; resourceIndex < static_cast<uint32_t>(m_Resources.size()); resourceIndex++)
+                {
+                    if(m_Resources[resourceIndex].Type != ResourceType::Transient || firstUses[resourceIndex] == NOT_USED)
+                    {
+                        continue;
+                    }
+
+                    if(firstUses[resourceIndex] == position)
+                    {
+                        pass.TargetsToAcquire.push_back(resourceIndex);
+                        totalAliveTargets++;
+                    }
+
+                    if(lastUses[resourceIndex] == position)
+                    {
+                        pass.TargetsToRelease.push_back(resourceIndex);
+                    }
+                }
+
+                m_PeakTransientTargets = std::max(m_PeakTransientTargets, totalAliveTargets);
+                totalAliveTargets -= static_cast<unsigned int>(pass.TargetsToRelease.size());
+            }
+        }
+    }
+}
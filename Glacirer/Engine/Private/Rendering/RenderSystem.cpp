@@ -1,4 +1,5 @@
 #include "Rendering/RenderSystem.h"
+#include <algorithm>
 #include <glm/glm.hpp>
 
 #include "Rendering/Cubemap.h"
@@ -37,13 +38,16 @@ namespace Glacirer
 
             SetupOutlineRendering();
             SetupShadowRendering();
+            SetupDepthPrePassRendering();
         }
 
         void RenderSystem::Setup()
         {
             SetupUniformsFor(*m_DirectionalDepthShader);
             SetupUniformsFor(*m_OmnidirectionalDepthShader);
-            SetupUniformsFor(*m_OutlineShader);
+            SetupUniformsFor(*m_DepthPrePassShader);
+            SetupUniformsFor(*m_DeferredShadingSystem.GetGeometryShader());
+            SetupUniformsFor(*m_DeferredShadingSystem.GetLightingShader());
         }
 
         void RenderSystem::Shutdown()
@@ -54,6 +58,8 @@ namespace Glacirer
             m_TransparentMeshComponentSet.Clear();
             m_OpaqueOutlinedMeshComponentSet.Clear();
             m_TransparentOutlinedMeshComponentSet.Clear();
+            m_OccluderMeshComponents.clear();
+            m_OccludedMeshComponents.clear();
 
             m_UniqueActiveShaderSet.Clear();
 
@@ -64,16 +70,9 @@ namespace Glacirer
 
         void RenderSystem::SetViewportResolution(const Resolution& resolution)
         {
-            constexpr glm::vec4 DEFAULT_CLEAR_COLOR{0.1f, 0.1f, 0.1f, 1.f};
-            glm::vec4 currentClearColor = m_MultisampleFramebuffer ? m_MultisampleFramebuffer->GetClearColor() : DEFAULT_CLEAR_COLOR;
-
+            // Scene targets (G-buffer included) come from the pool, which only reallocates once the size leaves the slack of the current ones
+            m_ViewportResolution = resolution;
             m_Device.SetViewportResolution(resolution);
-
-            m_MultisampleFramebuffer = std::make_unique<Framebuffer>(resolution, true, std::vector<TextureSettings>{}, m_TotalMSAASamples);
-            m_MultisampleFramebuffer->SetClearColor(currentClearColor);
-
-            m_IntermediateFramebuffer = std::make_unique<Framebuffer>(resolution, false, std::vector<TextureSettings>{});
-            m_PostProcessingSystem.SetFramebuffer(*m_IntermediateFramebuffer);
         }
 
         void RenderSystem::AddMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent)
@@ -83,6 +82,11 @@ namespace Glacirer
             Rendering::MeshComponentRenderSet& meshComponentSet = GetComponentRenderSetFor(meshComponent);
             meshComponentSet.Add(meshComponent, *m_InstancedArray);
 
+            if(meshComponent->IsOccluder())
+            {
+                AddOccluder(meshComponent);
+            }
+
             std::shared_ptr<Shader> shader = meshComponent->GetShader();
             assert(shader);
 
@@ -101,6 +105,11 @@ namespace Glacirer
             Rendering::MeshComponentRenderSet& meshComponentSet = GetComponentRenderSetFor(meshComponent);
             meshComponentSet.Remove(meshComponent);
             m_UniqueActiveShaderSet.Remove(meshComponent->GetShader());
+
+            if(meshComponent->IsOccluder())
+            {
+                RemoveOccluder(meshComponent);
+            }
         }
 
         void RenderSystem::RemoveMeshComponentsUsing(const std::shared_ptr<Material>& material)
@@ -133,6 +142,11 @@ namespace Glacirer
             Rendering::MeshComponentRenderSet& meshComponentSet = GetOutlinedComponentRenderSetFor(meshComponent);
             meshComponentSet.Add(meshComponent, *m_InstancedArray);
 
+            if(meshComponent->IsOccluder())
+            {
+                AddOccluder(meshComponent);
+            }
+
             std::shared_ptr<Shader> shader = meshComponent->GetShader();
             assert(shader);
 
@@ -151,6 +165,11 @@ namespace Glacirer
             Rendering::MeshComponentRenderSet& meshComponentSet = GetOutlinedComponentRenderSetFor(meshComponent);
             meshComponentSet.Remove(meshComponent);
             m_UniqueActiveShaderSet.Remove(meshComponent->GetShader());
+
+            if(meshComponent->IsOccluder())
+            {
+                RemoveOccluder(meshComponent);
+            }
         }
 
         Rendering::MeshComponentRenderSet& RenderSystem::GetComponentRenderSetFor(const std::shared_ptr<MeshComponent>& meshComponent)
@@ -247,27 +266,122 @@ namespace Glacirer
 
         void RenderSystem::Render(const CameraComponent& activeCamera)
         {
+            m_FrameDataRingBuffer.BeginFrame();
             m_Device.Clear();
+            m_RenderTargetPool.Update();
 
             UpdateGlobalShaderUniforms(activeCamera);
+            UpdateOpaqueOverdraw();
+            UpdateMeshLODs(activeCamera);
+
+            m_RenderGraph.Reset();
+            BuildRenderGraph(activeCamera);
 
-            RenderShadowPass(activeCamera);
+            if(m_RenderGraph.Compile())
+            {
+                m_RenderGraph.Execute(m_Device, m_RenderTargetPool);
+            }
 
-            m_MultisampleFramebuffer->BindAndClear();
+            // Once occlusion results are known, streamer applies requests on next update anyway
+            RequestStreamedTextures(activeCamera);
 
-            RenderWorld(activeCamera);
-            RenderOutlinedObjects(activeCamera);
+            m_OccludedMeshComponents.clear();
+            m_FrameDataRingBuffer.EndFrame();
+        }
+
+        void RenderSystem::BuildRenderGraph(const CameraComponent& activeCamera)
+        {
+            const Resolution& resolution = m_ViewportResolution;
+
+            // Data living outside the graph (shadow maps on LightingSystem, culling results on this system) only orders passes
+            const RenderGraphResource shadowMaps = m_RenderGraph.ImportExternal("ShadowMaps");
+            const RenderGraphResource occlusionResults = m_RenderGraph.ImportExternal("OcclusionResults");
+            const RenderGraphResource backbuffer = m_RenderGraph.ImportBackbuffer(resolution);
+            m_RenderGraph.MarkAsOutput(backbuffer);
+
+            // Single sampled copy of the scene post-processing reads from
+            RenderTargetDesc resolvedSceneColorDesc{};
+            resolvedSceneColorDesc.Resolution = resolution;
+            const RenderGraphResource resolvedSceneColor = m_RenderGraph.CreateTarget("ResolvedSceneColor", resolvedSceneColorDesc);
 
-            // Blit (resolve) multisample framebuffer so we can sample the result color texture on post-processing
-            m_MultisampleFramebuffer->BindAsReadOnly();
-            m_IntermediateFramebuffer->BindAsWriteOnly();
-            m_MultisampleFramebuffer->ResolveMultisampleImage(m_IntermediateFramebuffer->GetResolution());
-            m_MultisampleFramebuffer->Unbind();
+            RenderTargetDesc multisampleSceneColorDesc{};
+            multisampleSceneColorDesc.Resolution = resolution;
+            multisampleSceneColorDesc.Samples = m_TotalMSAASamples;
+            multisampleSceneColorDesc.bHasDepthStencil = true;
+
+            m_RenderGraph.AddPass("Shadows", [this, &activeCamera](const RenderGraphContext&)
+            {
+                RenderShadowPass(activeCamera);
+            }).Write(shadowMaps);
+
+            // After shadow pass, objects hidden from camera can still cast visible shadows
+            m_RenderGraph.AddPass("OcclusionCulling", [this, &activeCamera](const RenderGraphContext&)
+            {
+                UpdateOcclusionCulling(activeCamera);
+            }).Write(occlusionResults);
+
+            RenderGraphResource sceneColor{};
+
+            if(IsDeferredShadingActive())
+            {
+                const RenderGraphResource gBuffer = m_RenderGraph.CreateTarget("GBuffer", DeferredShadingSystem::GetGBufferDesc(resolution));
+                sceneColor = m_RenderGraph.CreateTarget("DeferredLighting", DeferredShadingSystem::GetLightingDesc(resolution));
+
+                m_RenderGraph.AddPass("DeferredGeometry", [this, gBuffer](const RenderGraphContext& context)
+                {
+                    // Position alpha must be cleared to zero so lighting pass knows which pixels are empty
+                    context.BindTarget(gBuffer);
+                    m_Device.SetClearColor(glm::vec4{0.f});
+                    m_Device.Clear();
+                    RenderDeferredGeometry();
+                }).Read(occlusionResults).Write(gBuffer);
+
+                m_RenderGraph.AddPass("DeferredLighting", [this, gBuffer, sceneColor](const RenderGraphContext& context)
+                {
+                    m_DeferredShadingSystem.RenderLightingPass(context, gBuffer, sceneColor, GetClearColor());
+                }).Read(shadowMaps).Read(gBuffer).Write(sceneColor);
+
+                m_RenderGraph.AddPass("DeferredForward", [this, &activeCamera, sceneColor](const RenderGraphContext& context)
+                {
+                    context.BindTarget(sceneColor);
+                    RenderWorldDeferred(activeCamera);
+                }).Read(shadowMaps).Read(occlusionResults).Read(sceneColor).Write(sceneColor);
+            }
+            else
+            {
+                sceneColor = m_RenderGraph.CreateTarget("MultisampleSceneColor", multisampleSceneColorDesc);
+
+                m_RenderGraph.AddPass("ForwardScene", [this, &activeCamera, sceneColor](const RenderGraphContext& context)
+                {
+                    context.BindTarget(sceneColor);
+                    m_Device.SetClearColor(m_ClearColor);
+                    m_Device.Clear();
+                    RenderWorld(activeCamera);
+                }).Read(shadowMaps).Read(occlusionResults).Write(sceneColor);
+            }
+
+            // Blit (resolve) multisample framebuffer so we can sample the result color texture on post-processing.
+            // Deferred path is not multisampled, there the blit is only a copy
+            m_RenderGraph.AddPass("ResolveSceneColor", [resolution, sceneColor, resolvedSceneColor](const RenderGraphContext& context)
+            {
+                const Framebuffer* source = context.GetFramebuffer(sceneColor);
+                const Framebuffer* destination = context.GetFramebuffer(resolvedSceneColor);
+
+                // Both may be pooled framebuffers larger than the viewport, only the rendered region is copied
+                source->BindAsReadOnly();
+                destination->BindAsWriteOnly();
+                source->ResolveMultisampleImage(resolution, resolution);
+                source->Unbind();
+            }).Read(sceneColor).Write(resolvedSceneColor);
+
+            if(!m_OpaqueOutlinedMeshComponentSet.IsEmpty() || !m_TransparentOutlinedMeshComponentSet.IsEmpty())
+            {
+                m_SelectionOutlineSystem.AddPasses(m_RenderGraph, sceneColor, resolvedSceneColor);
+            }
 
             // If we weren't gamma correction via shader and wanted to correct automatically with OpenGL
-            // m_Device.EnableGammaCorrection();
-            m_PostProcessingSystem.RenderToScreen();
-            // m_Device.DisableGammaCorrection();
+            // m_Device.EnableGammaCorrection() around the composite pass
+            m_PostProcessingSystem.AddPasses(m_RenderGraph, resolvedSceneColor, backbuffer);
         }
 
         void RenderSystem::RenderEmpty()
@@ -289,10 +403,8 @@ namespace Glacirer
         {
             UpdateCameraMatricesShaderUniforms(activeCamera);
 
-            m_CameraUniformBuffer->Bind();
             float cameraParams[2] { activeCamera.GetNearPlane(), activeCamera.GetFarPlane() };
             m_CameraUniformBuffer->SetSubData(cameraParams, sizeof(cameraParams));
-            m_CameraUniformBuffer->Unbind();
 
             m_LightingSystem.UpdateLightingUniformBuffer(activeCamera);
         }
@@ -302,54 +414,125 @@ namespace Glacirer
             const glm::mat4 view = activeCamera.GetViewMatrix();
             const glm::mat4 proj = activeCamera.GetProjectionMatrix();
 
-            m_MatricesUniformBuffer->Bind();
             glm::mat4 matrices[2] { proj, view };
             m_MatricesUniformBuffer->SetSubData(matrices, sizeof(matrices));
-            m_MatricesUniformBuffer->Unbind();
         }
 
-        void RenderSystem::RenderObjects(const Rendering::MeshComponentRenderSet& meshComponentSet)
+        void RenderSystem::RenderObjects(const Rendering::MeshComponentRenderSet& meshComponentSet, OpaqueMaterialFilter materialFilter)
         {
-            m_InstancedArray->Bind();
-
-            // Foreach unique VAO
+            // Foreach unique geometry buffer VAO
             for(auto& meshMappingPair : meshComponentSet.GetMeshComponents())
             {
                 // Foreach material
                 for(auto& meshComponentPair : meshMappingPair.second)
                 {
                     const std::vector<std::shared_ptr<MeshComponent>>& meshComponents = meshComponentPair.second;
-                    int remainingInstancesToDraw = static_cast<int>(meshComponents.size());
-                    int nextStartMeshIndex = 0;
+                    const Material& material = *meshComponents.front()->GetMaterial();
 
-                    while(remainingInstancesToDraw > 0)
+                    if(materialFilter != OpaqueMaterialFilter::All
+                        && DeferredShadingSystem::IsShadedByGeometryPass(material) != (materialFilter == OpaqueMaterialFilter::GeometryPass))
                     {
-                        const int instancesToDraw = glm::min(remainingInstancesToDraw, MAX_INSTANCED_AMOUNT_PER_CALL);
-                        std::vector<glm::mat4> modelMatrices{};
-                        modelMatrices.reserve(instancesToDraw);
+                        continue;
+                    }
+
+                    m_VisibleInstances.clear();
+
+                    for(const std::shared_ptr<MeshComponent>& meshComponent : meshComponents)
+                    {
+                        assert(meshComponent->IsReadyToDraw());
 
-                        for(int i = 0; i < instancesToDraw; i++)
+                        if(!IsOccluded(*meshComponent))
                         {
-                            assert(meshComponents[nextStartMeshIndex + i]->IsReadyToDraw());
+                            m_VisibleInstances.push_back({&meshComponent->GetMeshForLOD(m_LODBias), meshComponent.get()});
+                        }
+                    }
+
+                    // Components here share material but not mesh, instances of the same mesh (or LOD) have to be adjacent to
+                    // share a draw command. LODs may live in another geometry buffer, grouped so the batch is submitted once per buffer
+                    std::sort(m_VisibleInstances.begin(), m_VisibleInstances.end(), [](const VisibleInstance& a, const VisibleInstance& b)
+                    {
+                        const GeometryBuffer* aBuffer = &a.Mesh->GetGeometryBuffer();
+                        const GeometryBuffer* bBuffer = &b.Mesh->GetGeometryBuffer();
+                        return aBuffer != bBuffer ? aBuffer < bBuffer : a.Mesh < b.Mesh;
+                    });
 
-                            modelMatrices.emplace_back(meshComponents[nextStartMeshIndex + i]->GetOwnerTransform().GetMatrix());
+                    for(const VisibleInstance& visibleInstance : m_VisibleInstances)
+                    {
+                        if(!m_DrawBatch.CanAdd(*visibleInstance.Mesh))
+                        {
+                            m_DrawBatch.Submit(material, m_WorldOverrideShader, *m_InstancedArray);
                         }
 
-                        m_InstancedArray->SetSubData(modelMatrices.data(), instancesToDraw * sizeof(glm::mat4));
-                
-                        m_MeshRenderer.RenderInstanced(
-                            *meshComponents[nextStartMeshIndex]->GetMesh(),
-                            *meshComponents[nextStartMeshIndex]->GetMaterial(),
-                            instancesToDraw,
-                            m_WorldOverrideShader);
-                
-                        remainingInstancesToDraw -= instancesToDraw;
-                        nextStartMeshIndex += instancesToDraw;
+                        m_DrawBatch.Add(*visibleInstance.Mesh, GetInstanceModelMatrix(*visibleInstance.MeshComponent, *visibleInstance.Mesh));
                     }
+
+                    m_DrawBatch.Submit(material, m_WorldOverrideShader, *m_InstancedArray);
+                }
+            }
+        }
+
+        glm::mat4 RenderSystem::GetInstanceModelMatrix(const MeshComponent& meshComponent, const Mesh& mesh)
+        {
+            // Quantized mesh positions are brought back to object space through the instance matrix,
+            // so every shader keeps working with compact vertex formats
+            if(mesh.HasQuantizedPositions())
+            {
+                return meshComponent.GetOwnerTransform().GetMatrix() * mesh.GetDequantizationMatrix();
+            }
+
+            return meshComponent.GetOwnerTransform().GetMatrix();
+        }
+
+        // With depth pre-pass, the lit pass is tested with GL_EQUAL against pre-pass depth
+        // so the expensive fragment shading runs at most once per pixel
+        void RenderSystem::RenderOpaqueObjects()
+        {
+            // Query is only restarted after its previous result was read, so we measure every few frames
+            const bool bShouldMeasureOverdraw = !m_OpaqueOverdrawQuery->IsPending();
+
+            if(!IsDepthPrePassActive())
+            {
+                if(bShouldMeasureOverdraw)
+                {
+                    m_OpaqueOverdrawQuery->Begin();
+                }
+
+                RenderObjects(m_OpaqueMeshComponentSet);
+
+                if(bShouldMeasureOverdraw)
+                {
+                    m_OpaqueOverdrawQuery->End();
                 }
+
+                return;
             }
 
-            m_InstancedArray->Unbind();
+            m_Device.DisableColorWrite();
+            SetOverrideShader(m_DepthPrePassShader, false);
+
+            // Pre-pass is drawn with GL_LESS in the same order, so it passes as many samples as lit pass would without it
+            if(bShouldMeasureOverdraw)
+            {
+                m_OpaqueOverdrawQuery->Begin();
+            }
+
+            RenderObjects(m_OpaqueMeshComponentSet);
+
+            if(bShouldMeasureOverdraw)
+            {
+                m_OpaqueOverdrawQuery->End();
+            }
+
+            SetOverrideShader(nullptr, false);
+            m_Device.EnableColorWrite();
+
+            m_Device.SetDepthFunction(GL_EQUAL);
+            m_Device.DisableDepthWrite();
+
+            RenderObjects(m_OpaqueMeshComponentSet);
+
+            m_Device.EnableDepthWrite();
+            m_Device.SetDepthFunction(GL_LESS);
         }
 
         // Render distant objects first, used to render transparent objects
@@ -362,64 +545,76 @@ namespace Glacirer
                 return;
             }
 
-            m_InstancedArray->Bind();
+            const FrameVector<std::pair<float, Rendering::MeshComponentRenderElement>> sortedObjects = meshComponentSet.GetMeshComponentsSortedByDistance(cameraPosition);
 
-            std::multimap<float, Rendering::MeshComponentRenderElement> sortedObjects = meshComponentSet.GetMeshComponentsSortedByDistance(cameraPosition);
+            const Material* batchMaterial = nullptr;
 
-            auto& previousElement = sortedObjects.rbegin()->second;
-
-            int totalPendingMeshesToRender = 0;
-            std::vector<glm::mat4> modelMatrices{};
-    
             for(auto it = sortedObjects.rbegin(); it != sortedObjects.rend(); ++it)
             {
-                auto& renderElement = it->second;
+                const auto& renderElement = it->second;
 
-                // If we reached max instanced amount per call or this is a different mesh/material
-                // commit the render call with what was pending to render
-                if(totalPendingMeshesToRender > MAX_INSTANCED_AMOUNT_PER_CALL
-                    || renderElement.VaoId != previousElement.VaoId
-                    || renderElement.MaterialId != previousElement.MaterialId)
+                if(IsOccluded(*renderElement.MeshComponent))
                 {
-                    m_InstancedArray->SetSubData(modelMatrices.data(), totalPendingMeshesToRender * sizeof(glm::mat4));
-            
-                    m_MeshRenderer.RenderInstanced(
-                        *previousElement.MeshComponent->GetMesh(),
-                        *previousElement.MeshComponent->GetMaterial(),
-                        totalPendingMeshesToRender,
-                        m_WorldOverrideShader);
-
-                    totalPendingMeshesToRender = 0;
-                    modelMatrices.clear();
+                    continue;
                 }
 
                 assert(renderElement.MeshComponent->IsReadyToDraw());
-                modelMatrices.emplace_back(renderElement.MeshComponent->GetOwnerTransform().GetMatrix());
-        
-                previousElement = renderElement;
-                totalPendingMeshesToRender++;
+
+                const Mesh& lodMesh = renderElement.MeshComponent->GetMeshForLOD(m_LODBias);
+                const Material* material = renderElement.MeshComponent->GetMaterial().get();
+
+                // Different meshes keep their order inside the batch, so only a material change, a different geometry buffer
+                // or reaching max instanced amount per call commits what was pending to render
+                if(batchMaterial && (material != batchMaterial || !m_DrawBatch.CanAdd(lodMesh)))
+                {
+                    m_DrawBatch.Submit(*batchMaterial, m_WorldOverrideShader, *m_InstancedArray);
+                }
+
+                m_DrawBatch.Add(lodMesh, GetInstanceModelMatrix(*renderElement.MeshComponent, lodMesh));
+                batchMaterial = material;
             }
 
             // Make sure to render pending meshes when we get out of loop
-            if(totalPendingMeshesToRender > 0)
+            if(batchMaterial)
             {
-                m_InstancedArray->SetSubData(modelMatrices.data(), totalPendingMeshesToRender * sizeof(glm::mat4));
-            
-                m_MeshRenderer.RenderInstanced(
-                    *previousElement.MeshComponent->GetMesh(),
-                    *previousElement.MeshComponent->GetMaterial(),
-                    totalPendingMeshesToRender,
-                    m_WorldOverrideShader);
+                m_DrawBatch.Submit(*batchMaterial, m_WorldOverrideShader, *m_InstancedArray);
             }
-
-            m_InstancedArray->Unbind();
         }
 
         void RenderSystem::RenderWorld(const CameraComponent& activeCamera)
         {
             m_Device.DisableStencilWrite();
 
-            RenderObjects(m_OpaqueMeshComponentSet);
+            RenderOpaqueObjects();
+            RenderOutlinedObjects(activeCamera);
+            RenderSkybox(activeCamera);
+            RenderObjectsSortedByDistance(m_TransparentMeshComponentSet, activeCamera.GetOwnerPosition());
+        }
+
+        // Opaque objects are rendered once into the G-buffer and lit on a fullscreen pass (see DeferredShadingSystem)
+        void RenderSystem::RenderDeferredGeometry()
+        {
+            m_Device.DisableStencilWrite();
+
+            // Blending would mix G-buffer data (e.g. shininess stored on normal alpha)
+            m_Device.DisableBlend();
+            SetOverrideShader(m_DeferredShadingSystem.GetGeometryShader(), false);
+            RenderObjects(m_OpaqueMeshComponentSet, OpaqueMaterialFilter::GeometryPass);
+            SetOverrideShader(nullptr, false);
+            m_Device.EnableBlend();
+        }
+
+        // Opaque materials with another shader (e.g. unlit), skybox and transparent objects still go through forward path,
+        // on top of the lit image
+        void RenderSystem::RenderWorldDeferred(const CameraComponent& activeCamera)
+        {
+            m_Device.DisableStencilWrite();
+
+            // Tested against the G-buffer depth copied by the lighting pass, so they look the same as on forward path
+            RenderObjects(m_OpaqueMeshComponentSet, OpaqueMaterialFilter::ForwardOnly);
+
+            // Forward shaded on top of the lit image, G-buffer stencil was cleared so only they tag it
+            RenderOutlinedObjects(activeCamera);
             RenderSkybox(activeCamera);
             RenderObjectsSortedByDistance(m_TransparentMeshComponentSet, activeCamera.GetOwnerPosition());
         }
@@ -428,10 +623,15 @@ namespace Glacirer
         {
             std::shared_ptr<Shader> previousOverrideShader = m_WorldOverrideShader;
 
+            // LODs were selected from camera view, shadow maps just pick coarser ones
+            m_LODBias = m_ShadowLODBias;
+
             RenderDirectionalShadowPass();
             RenderPointShadowPass();
             RenderSpotShadowPass();
 
+            m_LODBias = 0;
+
             UpdateCameraMatricesShaderUniforms(activeCamera);
             SetOverrideShader(previousOverrideShader, false);
             m_Device.SetViewportResolution(Screen::GetResolution());
@@ -466,10 +666,8 @@ namespace Glacirer
                 const glm::mat4 view = directionalLight.GetViewMatrix();
                 const glm::mat4 proj = directionalLight.GetProjectionMatrix();
 
-                m_MatricesUniformBuffer->Bind();
                 glm::mat4 matrices[2] { proj, view };
                 m_MatricesUniformBuffer->SetSubData(matrices, sizeof(matrices));
-                m_MatricesUniformBuffer->Unbind();
 
                 RenderWorldForShadowPass(lightPosition);
         
@@ -542,10 +740,8 @@ namespace Glacirer
                 const glm::mat4 view = spotLightComponent.GetViewMatrix();
                 const glm::mat4 proj = spotLightComponent.GetProjectionMatrix(shadowMapResolution);
 
-                m_MatricesUniformBuffer->Bind();
                 glm::mat4 matrices[2] { proj, view };
                 m_MatricesUniformBuffer->SetSubData(matrices, sizeof(matrices));
-                m_MatricesUniformBuffer->Unbind();
 
                 RenderWorldForShadowPass(lightPosition);
         
@@ -618,38 +814,14 @@ namespace Glacirer
                 return;        
             }
 
-            m_Device.SetStencilFunction(GL_ALWAYS, 1.f, 0xFF);
+            // Drawn once like any other object, only tagging their visible pixels on stencil on the way.
+            // SelectionOutlineSystem builds the outline from those tags after the scene is resolved
             m_Device.EnableStencilWrite();
 
             RenderObjects(m_OpaqueOutlinedMeshComponentSet);
             RenderObjectsSortedByDistance(m_TransparentOutlinedMeshComponentSet, activeCamera.GetOwnerPosition());
 
-            m_Device.SetStencilFunction(GL_NOTEQUAL, 1.f, 0xFF);
             m_Device.DisableStencilWrite();
-
-            // On LearnOpenGL tutorial, we disable depth test to draw the outlined version
-            // on top of possible shapes blocking it
-            // the problem is for the floor on TestCore default world, it creates a wierd
-            // effect by drawing the outline color on the cube upon it
-            // m_Device.DisableDepthTest();
-
-            constexpr float outlineGrowthFactor{1.06f};
-            m_OpaqueOutlinedMeshComponentSet.MultiplyAllObjectsScaleBy(outlineGrowthFactor);
-            m_TransparentOutlinedMeshComponentSet.MultiplyAllObjectsScaleBy(outlineGrowthFactor);
-
-            std::shared_ptr<Shader> currentOverrideShader = m_WorldOverrideShader;
-            SetOverrideShader(m_OutlineShader, false);
-
-            RenderObjects(m_OpaqueOutlinedMeshComponentSet);
-            RenderObjects(m_TransparentOutlinedMeshComponentSet);
-
-            m_OpaqueOutlinedMeshComponentSet.DivideAllObjectsScaleBy(outlineGrowthFactor);
-            m_TransparentOutlinedMeshComponentSet.DivideAllObjectsScaleBy(outlineGrowthFactor);
-            SetOverrideShader(currentOverrideShader, false);
-
-            m_Device.EnableStencilWrite();
-            m_Device.SetStencilFunction(GL_ALWAYS, 1.f, 0xFF);
-            // m_Device.EnableDepthTest();
         }
 
         void RenderSystem::CreateInstancedBuffer()
@@ -658,12 +830,10 @@ namespace Glacirer
 
             //Instead of changing this attribute value on shader every new vertex (divisor 0)
             //we want it to change every new instance (divisor 1)
-            layout.PushMat4(1);
+            //Model matrices are affine, only their first three rows are sent (see InstanceTransform.glsl)
+            layout.PushMat3x4(1);
 
-            m_InstancedArray = std::make_unique<InstancedArray>(nullptr,
-                                                                MAX_INSTANCED_AMOUNT_PER_CALL * layout.GetStride(),
-                                                                true,
-                                                                std::move(layout));
+            m_InstancedArray = std::make_unique<InstancedArray>(std::move(layout), m_FrameDataRingBuffer);
         }
 
         void RenderSystem::CreateUniformBuffers()
@@ -671,16 +841,18 @@ namespace Glacirer
             constexpr unsigned int UNIFORM_MATRICES_BINDING_INDEX = 0;
             constexpr unsigned int UNIFORM_CAMERA_BINDING_INDEX = 1;
 
-            m_MatricesUniformBuffer = std::make_unique<Rendering::UniformBuffer>(nullptr,
+            // Rewritten every frame (matrices once per view), so both are streamed instead of updated in place
+            m_MatricesUniformBuffer = std::make_unique<Rendering::UniformBuffer>(
                 2 * sizeof(glm::mat4),
                 UNIFORM_MATRICES_BINDING_INDEX,
                 "Matrices",
-                true);
+                m_FrameDataRingBuffer);
 
-            m_CameraUniformBuffer = std::make_unique<Rendering::UniformBuffer>(nullptr,
-                                                                               2 * sizeof(float),
-                                                                               UNIFORM_CAMERA_BINDING_INDEX,
-                                                                               "Camera");
+            m_CameraUniformBuffer = std::make_unique<Rendering::UniformBuffer>(
+                2 * sizeof(float),
+                UNIFORM_CAMERA_BINDING_INDEX,
+                "Camera",
+                m_FrameDataRingBuffer);
         }
 
         void RenderSystem::SetupUniformsFor(Shader& shader) const
@@ -697,21 +869,40 @@ namespace Glacirer
 
         void RenderSystem::SetupOutlineRendering()
         {
+            // Stencil is only written while drawing outlined objects, everything drawn then passes
             m_Device.EnableStencilTest();
             m_Device.SetStencilOperation(GL_KEEP, GL_KEEP, GL_REPLACE);
+            m_Device.SetStencilFunction(GL_ALWAYS, SelectionOutlineSystem::SELECTION_STENCIL_VALUE, 0xFF);
+        }
 
-            m_OutlineShader = Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/Outline.glsl", "Outline");
+        bool RenderSystem::IsSkyboxActive() const
+        {
+            return m_SkyboxComponent && m_SkyboxComponent->IsReadyToDraw() && bIsSkyboxEnabled;
+        }
 
-            constexpr glm::vec4 OUTLINE_COLOR = glm::vec4{1.f, 0.576f, 0.f, 1.f};
+        bool RenderSystem::IsDepthPrePassActive() const
+        {
+            // Override shaders (e.g. visualizers) can output a different depth, which would fail GL_EQUAL
+            if(m_WorldOverrideShader)
+            {
+                return false;
+            }
 
-            m_OutlineShader->Bind();
-            m_OutlineShader->SetUniform4f("u_OutlineColor", OUTLINE_COLOR);
-            m_OutlineShader->Unbind();
+            switch(m_DepthPrePassMode)
+            {
+                case DepthPrePassMode::Enabled:
+                    return true;
+                case DepthPrePassMode::Automatic:
+                    return bIsAutomaticDepthPrePassEnabled;
+                default:
+                    return false;
+            }
         }
 
-        bool RenderSystem::IsSkyboxActive() const
+        bool RenderSystem::IsDeferredShadingActive() const
         {
-            return m_SkyboxComponent && m_SkyboxComponent->IsReadyToDraw() && bIsSkyboxEnabled;
+            // An override shader (e.g. visualizers) replaces every material, so we keep it on forward path
+            return m_RenderPath == RenderPath::Deferred && !m_WorldOverrideShader;
         }
 
         void RenderSystem::SetupShadowRendering()
@@ -719,5 +910,194 @@ namespace Glacirer
             m_DirectionalDepthShader = Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/AlphaSimpleDepth.glsl", "AlphaSimpleDepth");
             m_OmnidirectionalDepthShader = Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/OmnidirectionalDepth.glsl", "OminidirectionalDepth");
         }
+
+        void RenderSystem::SetupDepthPrePassRendering()
+        {
+            m_DepthPrePassShader = Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/DepthPrePass.glsl", "DepthPrePass");
+            m_OpaqueOverdrawQuery = std::make_unique<SamplesPassedQuery>();
+        }
+
+        void RenderSystem::AddOccluder(const std::shared_ptr<MeshComponent>& meshComponent)
+        {
+            m_OccluderMeshComponents.push_back(meshComponent);
+        }
+
+        void RenderSystem::RemoveOccluder(const std::shared_ptr<MeshComponent>& meshComponent)
+        {
+            auto it = std::find(m_OccluderMeshComponents.begin(), m_OccluderMeshComponents.end(), meshComponent);
+
+            if(it != m_OccluderMeshComponents.end())
+            {
+                m_OccluderMeshComponents.erase(it);
+            }
+        }
+
+        void RenderSystem::UpdateOcclusionCulling(const CameraComponent& activeCamera)
+        {
+            if(!bIsOcclusionCullingEnabled || m_OccluderMeshComponents.empty())
+            {
+                return;
+            }
+
+            m_OcclusionCuller.BeginFrame(activeCamera.GetProjectionMatrix() * activeCamera.GetViewMatrix());
+
+            for(const std::shared_ptr<MeshComponent>& occluder : m_OccluderMeshComponents)
+            {
+                const std::shared_ptr<Mesh>& mesh = occluder->GetMesh();
+                m_OcclusionCuller.RasterizeOccluder(mesh->GetPositions(), mesh->GetIndices(), occluder->GetOwnerTransform().GetMatrix());
+            }
+
+            m_OcclusionCuller.ResolveOccluders();
+
+            // Outlined objects are the ones selected, so we always keep them visible
+            TestOcclusionFor(m_OpaqueMeshComponentSet);
+            TestOcclusionFor(m_TransparentMeshComponentSet);
+
+            std::sort(m_OccludedMeshComponents.begin(), m_OccludedMeshComponents.end());
+        }
+
+        void RenderSystem::TestOcclusionFor(const Rendering::MeshComponentRenderSet& meshComponentSet)
+        {
+            for(auto& meshMappingPair : meshComponentSet.GetMeshComponents())
+            {
+                for(auto& meshComponentPair : meshMappingPair.second)
+                {
+                    for(const std::shared_ptr<MeshComponent>& meshComponent : meshComponentPair.second)
+                    {
+                        if(meshComponent->IsOccluder())
+                        {
+                            continue;
+                        }
+
+                        const Bounds worldBounds = meshComponent->GetMesh()->GetBounds().Transform(meshComponent->GetOwnerTransform().GetMatrix());
+
+                        if(m_OcclusionCuller.IsOccluded(worldBounds))
+                        {
+                            m_OccludedMeshComponents.push_back(meshComponent.get());
+                        }
+                    }
+                }
+            }
+        }
+
+        bool RenderSystem::IsOccluded(const MeshComponent& meshComponent) const
+        {
+            return !m_OccludedMeshComponents.empty() && std::binary_search(m_OccludedMeshComponents.begin(), m_OccludedMeshComponents.end(), &meshComponent);
+        }
+
+        void RenderSystem::UpdateMeshLODs(const CameraComponent& activeCamera)
+        {
+            const glm::mat4 projection = activeCamera.GetProjectionMatrix();
+            const glm::vec3 viewPosition = activeCamera.GetOwnerPosition();
+
+            UpdateMeshLODsFor(m_OpaqueMeshComponentSet, projection, viewPosition);
+            UpdateMeshLODsFor(m_TransparentMeshComponentSet, projection, viewPosition);
+            UpdateMeshLODsFor(m_OpaqueOutlinedMeshComponentSet, projection, viewPosition);
+            UpdateMeshLODsFor(m_TransparentOutlinedMeshComponentSet, projection, viewPosition);
+        }
+
+        void RenderSystem::UpdateMeshLODsFor(const Rendering::MeshComponentRenderSet& meshComponentSet, const glm::mat4& projection, const glm::vec3& viewPosition)
+        {
+            for(auto& meshMappingPair : meshComponentSet.GetMeshComponents())
+            {
+                for(auto& meshComponentPair : meshMappingPair.second)
+                {
+                    const std::vector<std::shared_ptr<MeshComponent>>& meshComponents = meshComponentPair.second;
+
+                    // Meshes without LODs (e.g. primitives) don't need the bounds projection
+                    if(meshComponents.empty() || meshComponents.front()->GetMesh()->GetTotalLODs() <= 1)
+                    {
+                        continue;
+                    }
+
+                    for(const std::shared_ptr<MeshComponent>& meshComponent : meshComponents)
+                    {
+                        meshComponent->UpdateLOD(projection, viewPosition);
+                    }
+                }
+            }
+        }
+
+        void RenderSystem::RequestStreamedTextures(const CameraComponent& activeCamera)
+        {
+            const glm::mat4 projection = activeCamera.GetProjectionMatrix();
+            const glm::mat4 viewProjection = projection * activeCamera.GetViewMatrix();
+            const glm::vec3 viewPosition = activeCamera.GetOwnerPosition();
+            const float viewportHeight = static_cast<float>(m_ViewportResolution.Height);
+
+            RequestStreamedTexturesFor(m_OpaqueMeshComponentSet, projection, viewProjection, viewPosition, viewportHeight);
+            RequestStreamedTexturesFor(m_TransparentMeshComponentSet, projection, viewProjection, viewPosition, viewportHeight);
+            RequestStreamedTexturesFor(m_OpaqueOutlinedMeshComponentSet, projection, viewProjection, viewPosition, viewportHeight);
+            RequestStreamedTexturesFor(m_TransparentOutlinedMeshComponentSet, projection, viewProjection, viewPosition, viewportHeight);
+        }
+
+        void RenderSystem::RequestStreamedTexturesFor(const Rendering::MeshComponentRenderSet& meshComponentSet, const glm::mat4& projection, const glm::mat4& viewProjection, const glm::vec3& viewPosition, float viewportHeight)
+        {
+            Resources::TextureStreamer& textureStreamer = Resources::ResourceManager::GetTextureStreamer();
+
+            for(auto& meshMappingPair : meshComponentSet.GetMeshComponents())
+            {
+                for(auto& meshComponentPair : meshMappingPair.second)
+                {
+                    const std::vector<std::shared_ptr<MeshComponent>>& meshComponents = meshComponentPair.second;
+
+                    if(meshComponents.empty())
+                    {
+                        continue;
+                    }
+
+                    // Components are grouped by material, the closest visible one decides the mips needed.
+                    // Off screen or occluded ones don't request anything, so their mips can be evicted
+                    float maxScreenSize = 0.f;
+                    bool bIsAnyVisible = false;
+
+                    for(const std::shared_ptr<MeshComponent>& meshComponent : meshComponents)
+                    {
+                        if(IsOccluded(*meshComponent)
+                            || !meshComponent->GetMesh()->GetBounds().Transform(meshComponent->GetOwnerTransform().GetMatrix()).IsInsideFrustum(viewProjection))
+                        {
+                            continue;
+                        }
+
+                        maxScreenSize = glm::max(maxScreenSize, meshComponent->GetScreenSize(projection, viewPosition));
+                        bIsAnyVisible = true;
+                    }
+
+                    if(bIsAnyVisible)
+                    {
+                        textureStreamer.RequestMaterialTextures(*meshComponents.front()->GetMaterial(), maxScreenSize * viewportHeight);
+                    }
+                }
+            }
+        }
+
+        void RenderSystem::UpdateOpaqueOverdraw()
+        {
+            unsigned int samplesPassed = 0;
+
+            if(!m_OpaqueOverdrawQuery->TryGetResult(samplesPassed))
+            {
+                return;
+            }
+
+            const Resolution& resolution = m_ViewportResolution;
+            const float totalScreenSamples = static_cast<float>(resolution.Width * resolution.Height * m_TotalMSAASamples);
+
+            if(totalScreenSamples <= 0.f)
+            {
+                return;
+            }
+
+            m_OpaqueOverdraw = static_cast<float>(samplesPassed) / totalScreenSamples;
+
+            if(m_OpaqueOverdraw > DEPTH_PRE_PASS_ENABLE_OVERDRAW)
+            {
+                bIsAutomaticDepthPrePassEnabled = true;
+            }
+            else if(m_OpaqueOverdraw < DEPTH_PRE_PASS_DISABLE_OVERDRAW)
+            {
+                bIsAutomaticDepthPrePassEnabled = false;
+            }
+        }
     }
 }
@@ -0,0 +1,145 @@
+#include "Rendering/RenderTargetPool.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Rendering/FrameBuffer.h"
+#include "Rendering/Texture.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        std::shared_ptr<Framebuffer> RenderTargetPool::Acquire(const RenderTargetDesc& desc)
+        {
+            PooledTarget* bestTarget = nullptr;
+
+            // Smallest free target the request fits in
+            for(PooledTarget& target : m_Targets)
+            {
+                if(!target.bIsInUse && CanServe(target, desc) && (!bestTarget || target.GpuMemory < bestTarget->GpuMemory))
+                {
+                    bestTarget = &target;
+                }
+            }
+
+            if(bestTarget)
+            {
+                bestTarget->bIsInUse = true;
+                bestTarget->LastUsedFrame = m_FrameIndex;
+
+                return bestTarget->Framebuffer;
+            }
+
+            PooledTarget target{};
+            target.Desc = desc;
+            target.Desc.Resolution = Resolution{GetAllocationSize(desc.Resolution.Width), GetAllocationSize(desc.Resolution.Height)};
+
+            FramebufferSettings settings{};
+            settings.Resolution = target.Desc.Resolution;
+            settings.EnableDepthBuffer = desc.bHasDepthStencil;
+            settings.Samples = desc.Samples;
+            settings.ColorInternalFormat = desc.InternalFormat;
+            settings.ColorFormat = desc.Format;
+            settings.ColorType = desc.Type;
+
+            for(unsigned int i = 0; i < desc.TotalAdditionalAttachments; i++)
+            {
+                TextureSettings attachmentSettings{};
+                attachmentSettings.InternalFormat = desc.AdditionalAttachments[i].InternalFormat;
+                attachmentSettings.Format = desc.AdditionalAttachments[i].Format;
+                attachmentSettings.Type = desc.AdditionalAttachments[i].Type;
+                attachmentSettings.MinFilter = GL_NEAREST;
+                attachmentSettings.MagFilter = GL_NEAREST;
+                attachmentSettings.Samples = desc.Samples;
+
+                settings.AdditionalColorAttachments.push_back(attachmentSettings);
+            }
+
+            target.Framebuffer = std::make_shared<Framebuffer>(settings);
+            target.GpuMemory = ComputeGpuMemory(target.Desc);
+            target.LastUsedFrame = m_FrameIndex;
+            target.bIsInUse = true;
+
+            m_GpuMemory += target.GpuMemory;
+            m_Targets.push_back(target);
+
+            return target.Framebuffer;
+        }
+
+        void RenderTargetPool::Release(const std::shared_ptr<Framebuffer>& target)
+        {
+            auto iterator = std::find_if(m_Targets.begin(), m_Targets.end(), [&target](const PooledTarget& pooledTarget)
+            {
+                return pooledTarget.Framebuffer == target;
+            });
+
+            if(iterator == m_Targets.end())
+            {
+                std::cout << "ERROR::RENDER_TARGET_POOL: Releasing a target that doesn't belong to the pool\n";
+                return;
+            }
+
+            iterator->bIsInUse = false;
+            iterator->LastUsedFrame = m_FrameIndex;
+        }
+
+        void RenderTargetPool::Update()
+        {
+            m_FrameIndex++;
+
+            // Framebuffers are only deleted here, long after the commands using them were submitted
+            m_Targets.erase(std::remove_if(m_Targets.begin(), m_Targets.end(), [this](const PooledTarget& target)
+            {
+                if(target.bIsInUse || m_FrameIndex - target.LastUsedFrame <= MAX_UNUSED_FRAMES)
+                {
+                    return false;
+                }
+
+                m_GpuMemory -= target.GpuMemory;
+                return true;
+            }), m_Targets.end());
+        }
+
+        bool RenderTargetPool::CanServe(const PooledTarget& target, const RenderTargetDesc& desc)
+        {
+            const Resolution& allocated = target.Desc.Resolution;
+            const Resolution& requested = desc.Resolution;
+
+            // Compared with what the request would allocate, so tiny targets rounded up to the granularity are still reused
+            return target.Desc.IsCompatibleWith(desc)
+                && requested.Width <= allocated.Width
+                && requested.Height <= allocated.Height
+                && static_cast<float>(GetAllocationSize(requested.Width)) >= static_cast<float>(allocated.Width) * MIN_USED_FRACTION
+                && static_cast<float>(GetAllocationSize(requested.Height)) >= static_cast<float>(allocated.Height) * MIN_USED_FRACTION;
+        }
+
+        unsigned int RenderTargetPool::GetAllocationSize(unsigned int requestedSize)
+        {
+            const unsigned int paddedSize = requestedSize + static_cast<unsigned int>(static_cast<float>(requestedSize) * ALLOCATION_HEADROOM);
+            const unsigned int allocationSize = (paddedSize + ALLOCATION_GRANULARITY - 1) / ALLOCATION_GRANULARITY * ALLOCATION_GRANULARITY;
+
+            return allocationSize > 0 ? allocationSize : ALLOCATION_GRANULARITY;
+        }
+
+        size_t RenderTargetPool::ComputeGpuMemory(const RenderTargetDesc& desc)
+        {
+            const size_t totalSamples = static_cast<size_t>(desc.Resolution.Width) * desc.Resolution.Height * desc.Samples;
+            size_t gpuMemory = totalSamples * Texture::GetBytesPerPixel(desc.InternalFormat);
+
+            for(unsigned int i = 0; i < desc.TotalAdditionalAttachments; i++)
+            {
+                gpuMemory += totalSamples * Texture::GetBytesPerPixel(desc.AdditionalAttachments[i].InternalFormat);
+            }
+
+            // Multisample framebuffers always get a depth/stencil render buffer (see Framebuffer::Create)
+            if(desc.bHasDepthStencil || desc.Samples > 1)
+            {
+                constexpr size_t DEPTH24_STENCIL8_BYTES = 4;
+                gpuMemory += totalSamples * DEPTH24_STENCIL8_BYTES;
+            }
+
+            return gpuMemory;
+        }
+    }
+}
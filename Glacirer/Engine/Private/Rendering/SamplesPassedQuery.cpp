@@ -0,0 +1,56 @@
+#include "Rendering/SamplesPassedQuery.h"
+
+#include <cassert>
+
+#include "Rendering/OpenGLCore.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        SamplesPassedQuery::SamplesPassedQuery()
+        {
+            GLCall(glGenQueries(1, &m_RendererID));
+        }
+
+        SamplesPassedQuery::~SamplesPassedQuery()
+        {
+            GLCall(glDeleteQueries(1, &m_RendererID));
+        }
+
+        void SamplesPassedQuery::Begin()
+        {
+            // A query object can't be restarted while its previous result was not read yet
+            assert(!bIsPending);
+
+            GLCall(glBeginQuery(GL_SAMPLES_PASSED, m_RendererID));
+            bIsPending = true;
+        }
+
+        void SamplesPassedQuery::End() const
+        {
+            GLCall(glEndQuery(GL_SAMPLES_PASSED));
+        }
+
+        bool SamplesPassedQuery::TryGetResult(unsigned int& outSamplesPassed)
+        {
+            if(!bIsPending)
+            {
+                return false;
+            }
+
+            unsigned int bIsResultAvailable = GL_FALSE;
+            GLCall(glGetQueryObjectuiv(m_RendererID, GL_QUERY_RESULT_AVAILABLE, &bIsResultAvailable));
+
+            if(bIsResultAvailable == GL_FALSE)
+            {
+                return false;
+            }
+
+            GLCall(glGetQueryObjectuiv(m_RendererID, GL_QUERY_RESULT, &outSamplesPassed));
+            bIsPending = false;
+
+            return true;
+        }
+    }
+}
@@ -0,0 +1,107 @@
+#include "Rendering/SelectionOutlineSystem.h"
+
+#include "Rendering/Device.h"
+#include "Rendering/FrameBuffer.h"
+#include "Rendering/Material.h"
+#include "Rendering/Primitive.h"
+#include "Resources/ResourceManager.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        SelectionOutlineSystem::SelectionOutlineSystem()
+        {
+            m_ScreenQuad = Primitive::CreateScreenQuad();
+
+            const std::string MASK_SHADER_NAME = "SelectionMask";
+            const std::string OUTLINE_SHADER_NAME = "SelectionOutline";
+            Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/Outline/SelectionMask.glsl", MASK_SHADER_NAME);
+            Resources::ResourceManager::LoadShader(Resources::ResourceManager::RESOURCES_PATH + "Shaders/Outline/SelectionOutline.glsl", OUTLINE_SHADER_NAME);
+
+            m_MaskMaterial = Resources::ResourceManager::CreateMaterial("M_SelectionMask", MASK_SHADER_NAME);
+            m_OutlineMaterial = Resources::ResourceManager::CreateMaterial("M_SelectionOutline", OUTLINE_SHADER_NAME);
+
+            constexpr glm::vec4 OUTLINE_COLOR = glm::vec4{1.f, 0.576f, 0.f, 1.f};
+            constexpr float OUTLINE_WIDTH = 3.f;
+
+            m_OutlineMaterial->SetColor("u_OutlineColor", OUTLINE_COLOR);
+            m_OutlineMaterial->SetFloat("u_OutlineWidth", OUTLINE_WIDTH);
+        }
+
+        void SelectionOutlineSystem::AddPasses(RenderGraph& renderGraph, RenderGraphResource sceneColor, RenderGraphResource resolvedSceneColor)
+        {
+            // Single sampled, the stencil is copied into its own depth/stencil buffer to test the mask against
+            RenderTargetDesc selectionMaskDesc{};
+            selectionMaskDesc.Resolution = renderGraph.GetDesc(resolvedSceneColor).Resolution;
+            selectionMaskDesc.InternalFormat = GL_R8;
+            selectionMaskDesc.Format = GL_RED;
+            selectionMaskDesc.bHasDepthStencil = true;
+
+            const RenderGraphResource selectionMask = renderGraph.CreateTarget("SelectionMask", selectionMaskDesc);
+
+            renderGraph.AddPass("SelectionMask", [this, sceneColor, selectionMask](const RenderGraphContext& context)
+            {
+                RenderMask(context, sceneColor, selectionMask);
+            }).Read(sceneColor).Write(selectionMask);
+
+            renderGraph.AddPass("SelectionOutline", [this, selectionMask, resolvedSceneColor](const RenderGraphContext& context)
+            {
+                RenderOutline(context, selectionMask, resolvedSceneColor);
+            }).Read(selectionMask).Read(resolvedSceneColor).Write(resolvedSceneColor);
+        }
+
+        void SelectionOutlineSystem::RenderMask(const RenderGraphContext& context, RenderGraphResource sceneColor, RenderGraphResource selectionMask) const
+        {
+            const Device& device = context.GetDevice();
+            const Framebuffer* source = context.GetFramebuffer(sceneColor);
+            const Framebuffer* destination = context.GetFramebuffer(selectionMask);
+            const Resolution& resolution = context.GetDesc(selectionMask).Resolution;
+
+            // Multisample stencil ends up as one of its samples per pixel, no need for the mask to be antialiased.
+            // Stencil write mask is kept enabled around the copy, some drivers apply it to blits
+            device.EnableStencilWrite();
+            source->BindAsReadOnly();
+            destination->BindAsWriteOnly();
+            source->BlitDepthStencilBuffer(resolution, resolution);
+            device.DisableStencilWrite();
+
+            context.BindTarget(selectionMask);
+            device.SetClearColor(glm::vec4{0.f});
+            device.ClearColorBuffer();
+
+            // Mask shader only outputs red, blending would weight it by an undefined alpha
+            device.DisableDepthTest();
+            device.DisableBlend();
+            device.SetStencilFunction(GL_EQUAL, SELECTION_STENCIL_VALUE, 0xFF);
+
+            RenderScreenQuad(*m_MaskMaterial, context.GetUVScale(selectionMask));
+
+            device.SetStencilFunction(GL_ALWAYS, SELECTION_STENCIL_VALUE, 0xFF);
+            device.EnableBlend();
+            device.EnableDepthTest();
+        }
+
+        void SelectionOutlineSystem::RenderOutline(const RenderGraphContext& context, RenderGraphResource selectionMask, RenderGraphResource resolvedSceneColor) const
+        {
+            const Device& device = context.GetDevice();
+
+            // Blended over the scene with outline alpha, pixels away from the selection are left untouched
+            context.BindTarget(resolvedSceneColor);
+            device.DisableDepthTest();
+
+            m_OutlineMaterial->SetTexture("u_ScreenTexture", context.GetTexture(selectionMask), 0);
+            RenderScreenQuad(*m_OutlineMaterial, context.GetUVScale(selectionMask));
+
+            device.EnableDepthTest();
+        }
+
+        void SelectionOutlineSystem::RenderScreenQuad(const Material& material, const glm::vec2& sourceUVScale) const
+        {
+            material.Bind();
+            material.SetVec2("u_UVScale", sourceUVScale);
+
+            m_MeshRenderer.Render(*m_ScreenQuad, material);
+        }
+    }
+}
@@ -2,10 +2,53 @@
 
 #include "Rendering/OpenGLCore.h"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
 
+namespace
+{
+    const char* GetStageName(unsigned int type)
+    {
+        switch(type)
+        {
+            case GL_VERTEX_SHADER:
+                return "vertex";
+            case GL_GEOMETRY_SHADER:
+                return "geometry";
+            default:
+                return "fragment";
+        }
+    }
+
+    bool SupportsParallelCompilation()
+    {
+        return GLEW_KHR_parallel_shader_compile || GLEW_ARB_parallel_shader_compile;
+    }
+
+    bool IsSamplerType(GLenum type)
+    {
+        switch(type)
+        {
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_CUBE_SHADOW:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_2D_ARRAY_SHADOW:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+                return true;
+            default:
+                return false;
+        }
+    }
+}
+
 namespace Glacirer
 {
     namespace Rendering
@@ -18,8 +61,20 @@ namespace Glacirer
             m_RendererID = CreateShader(source);
         }
 
+        Shader::Shader(const ShaderBinary& binary, const ShaderProperties& properties)
+            : m_Properties(properties)
+        {
+            GLCall(m_RendererID = glCreateProgram());
+            GLCall(glProgramBinary(m_RendererID, binary.Format, binary.Data.data(), static_cast<GLsizei>(binary.Data.size())));
+        }
+
         Shader::~Shader()
         {
+            for(const unsigned int stage : m_PendingStages)
+            {
+                GLCall(glDeleteShader(stage));
+            }
+
             GLCall(glDeleteProgram(m_RendererID));
 
             // If next shader created uses the same id as the one destroyed and previously bound
@@ -35,6 +90,8 @@ namespace Glacirer
         {
             if(m_LastBoundShaderId != m_RendererID)
             {
+                FinishCompilation();
+
                 GLCall(glUseProgram(m_RendererID));
                 m_LastBoundShaderId = m_RendererID;
             }
@@ -91,6 +148,205 @@ namespace Glacirer
             GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &mat[0][0]));
         }
 
+        bool Shader::IsCompilationComplete() const
+        {
+            if(m_PendingStages.empty() || !SupportsParallelCompilation())
+            {
+                return true;
+            }
+
+            int bIsComplete;
+            GLCall(glGetProgramiv(m_RendererID, GL_COMPLETION_STATUS_KHR, &bIsComplete));
+
+            return bIsComplete == GL_TRUE;
+        }
+
+        bool Shader::IsLinked() const
+        {
+            FinishCompilation();
+
+            int result;
+            GLCall(glGetProgramiv(m_RendererID, GL_LINK_STATUS, &result));
+
+            return result == GL_TRUE;
+        }
+
+        bool Shader::GetBinary(ShaderBinary& outBinary) const
+        {
+            if(!SupportsProgramBinaries() || !IsLinked())
+            {
+                return false;
+            }
+
+            int length;
+            GLCall(glGetProgramiv(m_RendererID, GL_PROGRAM_BINARY_LENGTH, &length));
+
+            if(length <= 0)
+            {
+                return false;
+            }
+
+            GLenum format;
+            outBinary.Data.resize(static_cast<size_t>(length));
+            GLCall(glGetProgramBinary(m_RendererID, length, &length, &format, outBinary.Data.data()));
+
+            outBinary.Format = format;
+            outBinary.Data.resize(static_cast<size_t>(length));
+
+            return true;
+        }
+
+        void Shader::SetVariants(const std::vector<std::string>& keywords, VariantFactory factory)
+        {
+            m_VariantKeywords = keywords;
+            m_VariantFactory = std::move(factory);
+            m_Variants.clear();
+        }
+
+        uint32_t Shader::GetVariantMask(const std::vector<std::string>& enabledKeywords) const
+        {
+            uint32_t variantMask = 0;
+
+            for(size_t i = 0; i < m_VariantKeywords.size(); i++)
+            {
+                if(std::find(enabledKeywords.begin(), enabledKeywords.end(), m_VariantKeywords[i]) != enabledKeywords.end())
+                {
+                    variantMask |= 1u << i;
+                }
+            }
+
+            return variantMask;
+        }
+
+        Shader& Shader::GetVariant(uint32_t variantMask)
+        {
+            if(variantMask == 0 || !m_VariantFactory)
+            {
+                return *this;
+            }
+
+            auto iterator = m_Variants.find(variantMask);
+            if(iterator != m_Variants.end())
+            {
+                return *iterator->second;
+            }
+
+            std::shared_ptr<Shader> variant = m_VariantFactory(variantMask);
+
+            std::string variantName = m_Name;
+            for(size_t i = 0; i < m_VariantKeywords.size(); i++)
+            {
+                if(variantMask & (1u << i))
+                {
+                    variantName += " " + m_VariantKeywords[i];
+                }
+            }
+
+            variant->SetName(variantName);
+            variant->CopyBindingsFrom(*this);
+
+            Shader& variantReference = *variant;
+            m_Variants[variantMask] = std::move(variant);
+
+            return variantReference;
+        }
+
+        bool Shader::SupportsProgramBinaries()
+        {
+            if(!GLEW_ARB_get_program_binary)
+            {
+                return false;
+            }
+
+            // Some drivers expose the extension without any format
+            int totalFormats;
+            GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &totalFormats));
+
+            return totalFormats > 0;
+        }
+
+        void Shader::EnableParallelCompilation()
+        {
+            // 0xFFFFFFFF lets the driver pick the number of threads
+            if(GLEW_KHR_parallel_shader_compile)
+            {
+                GLCall(glMaxShaderCompilerThreadsKHR(0xFFFFFFFF));
+            }
+            else if(GLEW_ARB_parallel_shader_compile)
+            {
+                GLCall(glMaxShaderCompilerThreadsARB(0xFFFFFFFF));
+            }
+        }
+
+        void Shader::CopyBindingsFrom(const Shader& shader)
+        {
+            constexpr int MAX_NAME_LENGTH = 256;
+            char name[MAX_NAME_LENGTH];
+
+            shader.FinishCompilation();
+            FinishCompilation();
+
+            int totalUniformBlocks;
+            GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &totalUniformBlocks));
+
+            for(int blockIndex = 0; blockIndex < totalUniformBlocks; blockIndex++)
+            {
+                GLCall(glGetActiveUniformBlockName(m_RendererID, blockIndex, MAX_NAME_LENGTH, nullptr, name));
+                GLCall(const unsigned int sourceBlockIndex = glGetUniformBlockIndex(shader.m_RendererID, name));
+
+                if(sourceBlockIndex == GL_INVALID_INDEX)
+                {
+                    continue;
+                }
+
+                int binding;
+                GLCall(glGetActiveUniformBlockiv(shader.m_RendererID, sourceBlockIndex, GL_UNIFORM_BLOCK_BINDING, &binding));
+                GLCall(glUniformBlockBinding(m_RendererID, blockIndex, static_cast<unsigned int>(binding)));
+            }
+
+            int totalUniforms;
+            GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &totalUniforms));
+
+            Bind();
+
+            for(int uniformIndex = 0; uniformIndex < totalUniforms; uniformIndex++)
+            {
+                int size;
+                GLenum type;
+                GLCall(glGetActiveUniform(m_RendererID, static_cast<unsigned int>(uniformIndex), MAX_NAME_LENGTH, nullptr, &size, &type, name));
+
+                if(!IsSamplerType(type))
+                {
+                    continue;
+                }
+
+                // Arrays are reported as "name[0]", every element has its own location
+                std::string baseName = name;
+                const size_t arrayStart = baseName.find('[');
+                if(arrayStart != std::string::npos)
+                {
+                    baseName.erase(arrayStart);
+                }
+
+                for(int element = 0; element < size; element++)
+                {
+                    const std::string elementName = size > 1 ? baseName + "[" + std::to_string(element) + "]" : baseName;
+                    GLCall(const int sourceLocation = glGetUniformLocation(shader.m_RendererID, elementName.c_str()));
+
+                    if(sourceLocation == -1)
+                    {
+                        continue;
+                    }
+
+                    int slot;
+                    GLCall(glGetUniformiv(shader.m_RendererID, sourceLocation, &slot));
+                    SetUniform1i(elementName, slot);
+                }
+            }
+
+            Unbind();
+        }
+
         int Shader::GetUniformLocation(const std::string& name) const
         {
             if(m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
@@ -116,61 +372,89 @@ namespace Glacirer
         {
             GLCall(unsigned int program = glCreateProgram());
 
-            unsigned int Vs = CompileShader(GL_VERTEX_SHADER, source.VertexShader);
-            unsigned int Fs = CompileShader(GL_FRAGMENT_SHADER, source.FragmentShader);
-
-            GLCall(glAttachShader(program, Vs));
-            GLCall(glAttachShader(program, Fs));
-    
-            unsigned int Gs = 0;
-            bool bIsUsingGeometryShader = !source.GeometryShader.empty();
+            m_PendingStages.push_back(CompileShader(GL_VERTEX_SHADER, source.VertexShader));
+            m_PendingStages.push_back(CompileShader(GL_FRAGMENT_SHADER, source.FragmentShader));
 
-            if(bIsUsingGeometryShader)
+            if(!source.GeometryShader.empty())
             {
-                Gs = CompileShader(GL_GEOMETRY_SHADER, source.GeometryShader);
-                GLCall(glAttachShader(program, Gs));
+                m_PendingStages.push_back(CompileShader(GL_GEOMETRY_SHADER, source.GeometryShader));
             }
 
-            GLCall(glLinkProgram(program));
-            GLCall(glValidateProgram(program));
-
-            GLCall(glDeleteShader(Vs));
-            GLCall(glDeleteShader(Fs));
+            for(const unsigned int stage : m_PendingStages)
+            {
+                GLCall(glAttachShader(program, stage));
+            }
 
-            if(bIsUsingGeometryShader)
+            if(SupportsProgramBinaries())
             {
-                GLCall(glDeleteShader(Gs));
+                GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
             }
 
+            // Querying any status here would wait for the compile, it is done on first use instead
+            GLCall(glLinkProgram(program));
+
             return program;
         }
 
-        unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
+        void Shader::FinishCompilation() const
         {
-            GLCall(unsigned int id = glCreateShader(type));
-            const char* Src = source.c_str();
+            if(m_PendingStages.empty())
+            {
+                return;
+            }
 
-            GLCall(glShaderSource(id, 1, &Src, nullptr));
-            GLCall(glCompileShader(id));
+            for(const unsigned int stage : m_PendingStages)
+            {
+                int result;
+                GLCall(glGetShaderiv(stage, GL_COMPILE_STATUS, &result));
+
+                if(result == GL_FALSE)
+                {
+                    int length;
+                    GLCall(glGetShaderiv(stage, GL_INFO_LOG_LENGTH, &length));
+                    std::string message(static_cast<size_t>(std::max(length, 1)), '\0');
+                    GLCall(glGetShaderInfoLog(stage, length, &length, &message[0]));
+
+                    int type;
+                    GLCall(glGetShaderiv(stage, GL_SHADER_TYPE, &type));
+
+                    std::cout << "Failed to compile " << GetStageName(static_cast<unsigned int>(type)) << " shader " << m_Name << "!\n";
+                    std::cout << message << "\n";
+                }
+
+                GLCall(glDetachShader(m_RendererID, stage));
+                GLCall(glDeleteShader(stage));
+            }
+
+            m_PendingStages.clear();
 
             int result;
-            GLCall(glGetShaderiv(id, GL_COMPILE_STATUS, &result));
+            GLCall(glGetProgramiv(m_RendererID, GL_LINK_STATUS, &result));
 
             if(result == GL_FALSE)
             {
                 int length;
-                GLCall(glGetShaderiv(id, GL_INFO_LOG_LENGTH, &length));
-                char* message = (char*)alloca(length * sizeof(char));
-                GLCall(glGetShaderInfoLog(id, length, &length, message));
+                GLCall(glGetProgramiv(m_RendererID, GL_INFO_LOG_LENGTH, &length));
+                std::string message(static_cast<size_t>(std::max(length, 1)), '\0');
+                GLCall(glGetProgramInfoLog(m_RendererID, length, &length, &message[0]));
 
-                std::cout << "Failed to compile " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader!\n";
+                std::cout << "Failed to link shader " << m_Name << "!\n";
                 std::cout << message << "\n";
+            }
 
-                GLCall(glDeleteShader(id));
+#if ENABLE_SHADER_DEBUG
+            GLCall(glValidateProgram(m_RendererID));
+#endif
+        }
+
+        unsigned int Shader::CompileShader(unsigned int type, const std::string& source)
+        {
+            GLCall(unsigned int id = glCreateShader(type));
+            const char* Src = source.c_str();
+
+            GLCall(glShaderSource(id, 1, &Src, nullptr));
+            GLCall(glCompileShader(id));
 
-                return 0;
-            }
-    
             return id;
         }
     }
@@ -0,0 +1,374 @@
+#include "Rendering/SoftwareOcclusionCuller.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "AllocationCounter.h"
+#include "FrameArena.h"
+#include "Resources/WorkerPool.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define GLACIRER_OCCLUSION_CULLER_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    float EdgeFunction(const glm::vec3& a, const glm::vec3& b, float x, float y)
+    {
+        return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+    }
+}
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        SoftwareOcclusionCuller::SoftwareOcclusionCuller(unsigned int width, unsigned int height)
+            : m_Resolution(width, height)
+            , m_WorkerPool(std::make_unique<Resources::WorkerPool>())
+        {
+            m_DepthBuffer.resize(static_cast<size_t>(width) * height, 1.f);
+
+            m_TotalTilesX = (static_cast<int>(width) + TILE_WIDTH - 1) / TILE_WIDTH;
+            m_TotalTilesY = (static_cast<int>(height) + TILE_HEIGHT - 1) / TILE_HEIGHT;
+            m_TileTriangles.resize(static_cast<size_t>(m_TotalTilesX) * m_TotalTilesY);
+        }
+
+        // Defined here where WorkerPool is complete
+        SoftwareOcclusionCuller::~SoftwareOcclusionCuller() = default;
+
+        void SoftwareOcclusionCuller::BeginFrame(const glm::mat4& viewProjection)
+        {
+            m_ViewProjection = viewProjection;
+
+            std::fill(m_DepthBuffer.begin(), m_DepthBuffer.end(), 1.f);
+
+            m_Triangles.clear();
+
+            for(std::vector<unsigned int>& tileTriangles : m_TileTriangles)
+            {
+                tileTriangles.clear();
+            }
+
+            bHasUnresolvedOccluders = false;
+
+            m_TotalRasterizedTriangles = 0;
+            m_TotalTested = 0;
+            m_TotalOccluded = 0;
+        }
+
+        void SoftwareOcclusionCuller::RasterizeOccluder(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix)
+        {
+            const glm::mat4 modelViewProjection = m_ViewProjection * modelMatrix;
+
+            FrameVector<glm::vec4> clipPositions{};
+            clipPositions.reserve(positions.size());
+
+            for(const glm::vec3& position : positions)
+            {
+                clipPositions.emplace_back(modelViewProjection * glm::vec4(position, 1.f));
+            }
+
+            for(size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                glm::vec3 a{};
+                glm::vec3 b{};
+                glm::vec3 c{};
+
+                // Triangles crossing near plane are skipped instead of clipped,
+                // occluders just get a little less effective which is still conservative
+                if(!ProjectToScreen(clipPositions[indices[i]], a)
+                    || !ProjectToScreen(clipPositions[indices[i + 1]], b)
+                    || !ProjectToScreen(clipPositions[indices[i + 2]], c))
+                {
+                    continue;
+                }
+
+                BinTriangle(a, b, c);
+            }
+        }
+
+        void SoftwareOcclusionCuller::ResolveOccluders()
+        {
+            if(!bHasUnresolvedOccluders)
+            {
+                return;
+            }
+
+            m_NextTile = 0;
+
+            const unsigned int totalTiles = static_cast<unsigned int>(m_TileTriangles.size());
+            const unsigned int totalJobs = m_Triangles.size() < MIN_TRIANGLES_FOR_WORKERS ? 0 : std::min(m_WorkerPool->GetTotalWorkers(), totalTiles - 1);
+
+            {
+                std::lock_guard<std::mutex> lock(m_JobsMutex);
+                m_TotalRunningJobs = totalJobs;
+            }
+
+            for(unsigned int i = 0; i < totalJobs; i++)
+            {
+                m_WorkerPool->Submit([this]()
+                {
+                    AllocationTagScope tagScope{AllocationTag::Rendering};
+                    RasterizeTiles();
+
+                    // Notified under the lock, the waiting thread may destroy the culler as soon as it can see 0
+                    std::lock_guard<std::mutex> lock(m_JobsMutex);
+                    m_TotalRunningJobs--;
+                    m_JobsCondition.notify_one();
+                });
+            }
+
+            RasterizeTiles();
+
+            // Jobs starting after every tile was taken still touch this culler, so all of them are waited for
+            std::unique_lock<std::mutex> lock(m_JobsMutex);
+            m_JobsCondition.wait(lock, [this]() { return m_TotalRunningJobs == 0; });
+
+            bHasUnresolvedOccluders = false;
+        }
+
+        bool SoftwareOcclusionCuller::IsOccluded(const Bounds& worldBounds)
+        {
+            assert(!bHasUnresolvedOccluders && "ResolveOccluders must run before testing occlusion");
+
+            m_TotalTested++;
+
+            if(!worldBounds.IsValid())
+            {
+                return false;
+            }
+
+            glm::vec2 screenMin{std::numeric_limits<float>::max()};
+            glm::vec2 screenMax{std::numeric_limits<float>::lowest()};
+            float nearestDepth = 1.f;
+
+            for(int corner = 0; corner < 8; corner++)
+            {
+                const glm::vec3 cornerPosition{
+                    corner & 1 ? worldBounds.Max.x : worldBounds.Min.x,
+                    corner & 2 ? worldBounds.Max.y : worldBounds.Min.y,
+                    corner & 4 ? worldBounds.Max.z : worldBounds.Min.z};
+
+                glm::vec3 screenPosition{};
+
+                // Bounds crossing near plane could cover the whole screen, consider it visible
+                if(!ProjectToScreen(m_ViewProjection * glm::vec4(cornerPosition, 1.f), screenPosition))
+                {
+                    return false;
+                }
+
+                screenMin = glm::min(screenMin, glm::vec2(screenPosition));
+                screenMax = glm::max(screenMax, glm::vec2(screenPosition));
+                nearestDepth = glm::min(nearestDepth, screenPosition.z);
+            }
+
+            const int width = static_cast<int>(m_Resolution.Width);
+            const int height = static_cast<int>(m_Resolution.Height);
+
+            // Out of screen bounds are left for GPU to clip
+            if(screenMax.x < 0.f || screenMax.y < 0.f || screenMin.x >= static_cast<float>(width) || screenMin.y >= static_cast<float>(height))
+            {
+                return false;
+            }
+
+            const int minX = std::max(0, static_cast<int>(std::floor(screenMin.x)));
+            const int minY = std::max(0, static_cast<int>(std::floor(screenMin.y)));
+            const int maxX = std::min(width - 1, static_cast<int>(std::ceil(screenMax.x)));
+            const int maxY = std::min(height - 1, static_cast<int>(std::ceil(screenMax.y)));
+
+            // Farthest occluder depth over every pixel the bounds touch, even partially
+            float maxOccluderDepth = 0.f;
+
+            for(int y = minY; y <= maxY; y++)
+            {
+                for(int x = minX; x <= maxX; x++)
+                {
+                    maxOccluderDepth = std::max(maxOccluderDepth, m_DepthBuffer[y * width + x]);
+                }
+            }
+
+            if(maxOccluderDepth >= nearestDepth)
+            {
+                return false;
+            }
+
+            m_TotalOccluded++;
+            return true;
+        }
+
+        bool SoftwareOcclusionCuller::ProjectToScreen(const glm::vec4& clipPosition, glm::vec3& outScreenPosition) const
+        {
+            if(clipPosition.w < MIN_CLIP_W)
+            {
+                return false;
+            }
+
+            const glm::vec3 ndcPosition = glm::vec3(clipPosition) / clipPosition.w;
+
+            // From [-1, 1] to depth buffer pixels and [0, 1] depth
+            outScreenPosition.x = (ndcPosition.x * 0.5f + 0.5f) * static_cast<float>(m_Resolution.Width);
+            outScreenPosition.y = (ndcPosition.y * 0.5f + 0.5f) * static_cast<float>(m_Resolution.Height);
+            outScreenPosition.z = ndcPosition.z * 0.5f + 0.5f;
+
+            return true;
+        }
+
+        void SoftwareOcclusionCuller::BinTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+        {
+            const float area = EdgeFunction(a, b, c.x, c.y);
+
+            if(std::abs(area) < 0.0001f)
+            {
+                return;
+            }
+
+            const int width = static_cast<int>(m_Resolution.Width);
+            const int height = static_cast<int>(m_Resolution.Height);
+
+            ScreenTriangle triangle{};
+            triangle.MinX = std::max(0, static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))));
+            triangle.MinY = std::max(0, static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))));
+            triangle.MaxX = std::min(width - 1, static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))));
+            triangle.MaxY = std::min(height - 1, static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))));
+
+            if(triangle.MinX > triangle.MaxX || triangle.MinY > triangle.MaxY)
+            {
+                return;
+            }
+
+            m_TotalRasterizedTriangles++;
+
+            // Both windings are accepted, occluders are usually not closed meshes (e.g. floor)
+            const float inverseArea = 1.f / area;
+
+            // Each weight is its opposite edge function over the area, e.g. A is EdgeFunction(b, c, x, y) / area
+            triangle.WeightStepX = glm::vec3(b.y - c.y, c.y - a.y, a.y - b.y) * inverseArea;
+            triangle.WeightStepY = glm::vec3(c.x - b.x, a.x - c.x, b.x - a.x) * inverseArea;
+            triangle.WeightOrigin = glm::vec3(
+                -triangle.WeightStepX.x * b.x - triangle.WeightStepY.x * b.y,
+                -triangle.WeightStepX.y * c.x - triangle.WeightStepY.y * c.y,
+                -triangle.WeightStepX.z * a.x - triangle.WeightStepY.z * a.y);
+
+            // Extremes of a linear function over a pixel are at its center plus or minus half the absolute gradient on each axis
+            triangle.WeightPixelExtent = 0.5f * (glm::abs(triangle.WeightStepX) + glm::abs(triangle.WeightStepY));
+
+            // NDC depth is linear in screen space, farthest point of the pixel keeps the test conservative
+            triangle.DepthStepX = glm::dot(triangle.WeightStepX, glm::vec3(a.z, b.z, c.z));
+            triangle.DepthStepY = glm::dot(triangle.WeightStepY, glm::vec3(a.z, b.z, c.z));
+            triangle.DepthOrigin = a.z - triangle.DepthStepX * a.x - triangle.DepthStepY * a.y
+                + 0.5f * (std::abs(triangle.DepthStepX) + std::abs(triangle.DepthStepY));
+
+            const unsigned int triangleIndex = static_cast<unsigned int>(m_Triangles.size());
+            m_Triangles.push_back(triangle);
+
+            for(int tileY = triangle.MinY / TILE_HEIGHT; tileY <= triangle.MaxY / TILE_HEIGHT; tileY++)
+            {
+                for(int tileX = triangle.MinX / TILE_WIDTH; tileX <= triangle.MaxX / TILE_WIDTH; tileX++)
+                {
+                    m_TileTriangles[tileY * m_TotalTilesX + tileX].push_back(triangleIndex);
+                }
+            }
+
+            bHasUnresolvedOccluders = true;
+        }
+
+        void SoftwareOcclusionCuller::RasterizeTiles()
+        {
+            const int totalTiles = m_TotalTilesX * m_TotalTilesY;
+
+            for(int tileIndex = m_NextTile++; tileIndex < totalTiles; tileIndex = m_NextTile++)
+            {
+                RasterizeTile(tileIndex);
+            }
+        }
+
+        void SoftwareOcclusionCuller::RasterizeTile(int tileIndex)
+        {
+            const int minX = (tileIndex % m_TotalTilesX) * TILE_WIDTH;
+            const int minY = (tileIndex / m_TotalTilesX) * TILE_HEIGHT;
+            const int maxX = std::min(minX + TILE_WIDTH, static_cast<int>(m_Resolution.Width)) - 1;
+            const int maxY = std::min(minY + TILE_HEIGHT, static_cast<int>(m_Resolution.Height)) - 1;
+
+            // Tiles don't overlap, so each one owns its part of the depth buffer and needs no locking
+            for(unsigned int triangleIndex : m_TileTriangles[tileIndex])
+            {
+                RasterizeTriangleInTile(m_Triangles[triangleIndex], minX, minY, maxX, maxY);
+            }
+        }
+
+        void SoftwareOcclusionCuller::RasterizeTriangleInTile(const ScreenTriangle& triangle, int minX, int minY, int maxX, int maxY)
+        {
+            const int startX = std::max(minX, triangle.MinX);
+            const int startY = std::max(minY, triangle.MinY);
+            const int endX = std::min(maxX, triangle.MaxX);
+            const int endY = std::min(maxY, triangle.MaxY);
+
+#ifdef GLACIRER_OCCLUSION_CULLER_SSE
+            const __m128 laneOffsets = _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f);
+            const __m128 weightStepXA = _mm_set1_ps(triangle.WeightStepX.x);
+            const __m128 weightStepXB = _mm_set1_ps(triangle.WeightStepX.y);
+            const __m128 weightStepXC = _mm_set1_ps(triangle.WeightStepX.z);
+            const __m128 weightExtentA = _mm_set1_ps(triangle.WeightPixelExtent.x);
+            const __m128 weightExtentB = _mm_set1_ps(triangle.WeightPixelExtent.y);
+            const __m128 weightExtentC = _mm_set1_ps(triangle.WeightPixelExtent.z);
+            const __m128 depthStepX = _mm_set1_ps(triangle.DepthStepX);
+#endif
+
+            for(int y = startY; y <= endY; y++)
+            {
+                const float sampleY = static_cast<float>(y) + 0.5f;
+                const glm::vec3 rowWeights = triangle.WeightOrigin + triangle.WeightStepY * sampleY;
+                const float rowDepth = triangle.DepthOrigin + triangle.DepthStepY * sampleY;
+                float* depthRow = &m_DepthBuffer[static_cast<size_t>(y) * m_Resolution.Width];
+
+                int x = startX;
+
+#ifdef GLACIRER_OCCLUSION_CULLER_SSE
+                const __m128 rowWeightA = _mm_set1_ps(rowWeights.x);
+                const __m128 rowWeightB = _mm_set1_ps(rowWeights.y);
+                const __m128 rowWeightC = _mm_set1_ps(rowWeights.z);
+                const __m128 rowDepthValue = _mm_set1_ps(rowDepth);
+
+                for(; x + 4 <= endX + 1; x += 4)
+                {
+                    const __m128 sampleX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+
+                    const __m128 weightA = _mm_add_ps(rowWeightA, _mm_mul_ps(weightStepXA, sampleX));
+                    const __m128 weightB = _mm_add_ps(rowWeightB, _mm_mul_ps(weightStepXB, sampleX));
+                    const __m128 weightC = _mm_add_ps(rowWeightC, _mm_mul_ps(weightStepXC, sampleX));
+
+                    // Only pixels the triangle fully covers are written, a partially covered one could show what's behind
+                    __m128 mask = _mm_and_ps(_mm_cmpge_ps(weightA, weightExtentA), _mm_and_ps(_mm_cmpge_ps(weightB, weightExtentB), _mm_cmpge_ps(weightC, weightExtentC)));
+
+                    if(_mm_movemask_ps(mask) == 0)
+                    {
+                        continue;
+                    }
+
+                    const __m128 depth = _mm_add_ps(rowDepthValue, _mm_mul_ps(depthStepX, sampleX));
+                    const __m128 bufferDepth = _mm_loadu_ps(depthRow + x);
+                    mask = _mm_and_ps(mask, _mm_cmplt_ps(depth, bufferDepth));
+
+                    _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(mask, depth), _mm_andnot_ps(mask, bufferDepth)));
+                }
+#endif
+
+                // Whole row without SSE, otherwise the pixels left past the last group of 4
+                for(; x <= endX; x++)
+                {
+                    const float sampleX = static_cast<float>(x) + 0.5f;
+                    const glm::vec3 weights = rowWeights + triangle.WeightStepX * sampleX;
+
+                    if(weights.x >= triangle.WeightPixelExtent.x && weights.y >= triangle.WeightPixelExtent.y && weights.z >= triangle.WeightPixelExtent.z)
+                    {
+                        const float depth = rowDepth + triangle.DepthStepX * sampleX;
+                        depthRow[x] = std::min(depthRow[x], depth);
+                    }
+                }
+            }
+        }
+    }
+}
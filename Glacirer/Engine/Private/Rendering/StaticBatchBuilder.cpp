@@ -0,0 +1,131 @@
+#include "Rendering/StaticBatchBuilder.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include <glm/glm.hpp>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        StaticBatchBuilder::StaticBatchBuilder(float chunkSize)
+            : m_ChunkSize(chunkSize)
+        { }
+
+        void StaticBatchBuilder::Add(const Mesh& mesh, const std::shared_ptr<Material>& material, const glm::mat4& modelMatrix)
+        {
+            const glm::vec3 center = mesh.GetBounds().Transform(modelMatrix).GetCenter();
+
+            Source source{};
+            source.Mesh = &mesh;
+            source.Material = material;
+            source.ModelMatrix = modelMatrix;
+            source.Cell = glm::ivec3(glm::floor(center / m_ChunkSize));
+
+            m_Sources.push_back(source);
+        }
+
+        std::vector<StaticBatchChunk> StaticBatchBuilder::Build() const
+        {
+            // Sources that can share a chunk end up next to each other
+            auto getChunkKey = [](const Source& source)
+            {
+                return std::make_tuple(source.Material.get(), GetVertexFormatKey(source.Mesh->GetVertexFormat()), source.Cell.x, source.Cell.y, source.Cell.z);
+            };
+
+            std::vector<const Source*> sortedSources{};
+            sortedSources.reserve(m_Sources.size());
+
+            for(const Source& source : m_Sources)
+            {
+                sortedSources.push_back(&source);
+            }
+
+            std::stable_sort(sortedSources.begin(), sortedSources.end(), [&getChunkKey](const Source* a, const Source* b)
+            {
+                return getChunkKey(*a) < getChunkKey(*b);
+            });
+
+            std::vector<StaticBatchChunk> chunks{};
+            std::vector<Vertex> chunkVertices{};
+            std::vector<unsigned int> chunkIndices{};
+            const Source* chunkFirstSource = nullptr;
+            unsigned int chunkTotalSources = 0;
+
+            for(const Source* source : sortedSources)
+            {
+                const unsigned int totalVertices = source->Mesh->GetGeometryAllocation().TotalVertices;
+
+                if(chunkFirstSource && (getChunkKey(*source) != getChunkKey(*chunkFirstSource) || chunkVertices.size() + totalVertices > MAX_CHUNK_VERTICES))
+                {
+                    chunks.push_back(CreateChunk(chunkVertices, chunkIndices, *chunkFirstSource, chunkTotalSources));
+                    chunkVertices.clear();
+                    chunkIndices.clear();
+                    chunkFirstSource = nullptr;
+                    chunkTotalSources = 0;
+                }
+
+                if(!chunkFirstSource)
+                {
+                    chunkFirstSource = source;
+                }
+
+                const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(source->ModelMatrix)));
+                const unsigned int baseVertex = static_cast<unsigned int>(chunkVertices.size());
+
+                for(Vertex vertex : source->Mesh->ReadVertices())
+                {
+                    vertex.Position = glm::vec3(source->ModelMatrix * glm::vec4(vertex.Position, 1.f));
+
+                    const glm::vec3 normal = normalMatrix * vertex.Normal;
+                    const float normalLength = glm::length(normal);
+                    vertex.Normal = normalLength > 0.f ? normal / normalLength : normal;
+
+                    chunkVertices.push_back(vertex);
+                }
+
+                // Mirroring transforms flip triangles winding, which would get them culled as back faces
+                const bool bIsMirrored = glm::determinant(glm::mat3(source->ModelMatrix)) < 0.f;
+                const std::vector<unsigned int> indices = source->Mesh->ReadIndices();
+
+                for(size_t i = 0; i + 2 < indices.size(); i += 3)
+                {
+                    chunkIndices.push_back(baseVertex + indices[i]);
+                    chunkIndices.push_back(baseVertex + indices[bIsMirrored ? i + 2 : i + 1]);
+                    chunkIndices.push_back(baseVertex + indices[bIsMirrored ? i + 1 : i + 2]);
+                }
+
+                chunkTotalSources++;
+            }
+
+            if(chunkFirstSource)
+            {
+                chunks.push_back(CreateChunk(chunkVertices, chunkIndices, *chunkFirstSource, chunkTotalSources));
+            }
+
+            return chunks;
+        }
+
+        unsigned int StaticBatchBuilder::GetVertexFormatKey(const VertexFormat& vertexFormat)
+        {
+            return (vertexFormat.bQuantizePositions ? 1u : 0u)
+                | (vertexFormat.bPackNormals ? 2u : 0u)
+                | (vertexFormat.bUseHalfFloatTexCoords ? 4u : 0u);
+        }
+
+        StaticBatchChunk StaticBatchBuilder::CreateChunk(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                                         const Source& firstSource, unsigned int totalSourceMeshes)
+        {
+            StaticBatchChunk chunk{};
+            // Quantized positions are relative to the chunk bounds, so precision depends on chunk size instead of each mesh size.
+            // Chunks are only drawn, their sources are the ones queried
+            chunk.Mesh = std::make_shared<Mesh>(vertices, indices, firstSource.Mesh->GetVertexFormat(), false);
+            chunk.Mesh->SetName("StaticBatchChunk");
+            chunk.Material = firstSource.Material;
+            chunk.TotalSourceMeshes = totalSourceMeshes;
+
+            return chunk;
+        }
+    }
+}
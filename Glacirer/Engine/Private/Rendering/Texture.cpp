@@ -12,6 +12,76 @@ namespace Glacirer
             Create(data, settings);
         }
 
+        Texture::Texture(const std::vector<TextureMip>& mips, const TextureSettings& settings)
+        {
+            assert(!mips.empty() && settings.Samples == 1);
+
+            m_Width = mips[0].Width;
+            m_Height = mips[0].Height;
+
+            GLCall(glGenTextures(1, &m_RendererID));
+            GLCall(glBindTexture(m_Target, m_RendererID));
+
+            ApplySamplingSettings(settings);
+
+            // Single and two channel rows aren't 4 bytes aligned
+            GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+            for(unsigned int level = 0; level < static_cast<unsigned int>(mips.size()); level++)
+            {
+                SpecifyLevel(level, mips[level], settings);
+            }
+
+            GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+            // Otherwise the texture is incomplete if the chain doesn't go down to 1x1
+            GLCall(glTexParameteri(m_Target, GL_TEXTURE_MAX_LEVEL, static_cast<int>(mips.size()) - 1));
+
+            ApplyChannelSwizzle(settings);
+
+            GLCall(glBindTexture(m_Target, 0));
+        }
+
+        void Texture::UploadMip(unsigned int level, unsigned int totalMips, const TextureMip& mip, const TextureSettings& settings)
+        {
+            assert(level < totalMips && m_Target == GL_TEXTURE_2D);
+
+            GLCall(glBindTexture(m_Target, m_RendererID));
+
+            if(level == totalMips - 1)
+            {
+                ApplySamplingSettings(settings);
+                ApplyChannelSwizzle(settings);
+                GLCall(glTexParameteri(m_Target, GL_TEXTURE_MAX_LEVEL, static_cast<int>(totalMips) - 1));
+            }
+
+            GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+            SpecifyLevel(level, mip, settings);
+            GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+
+            // Levels below the base one (e.g. the placeholder on level 0) are ignored for sampling and completeness
+            GLCall(glTexParameteri(m_Target, GL_TEXTURE_BASE_LEVEL, static_cast<int>(level)));
+
+            if(level == 0)
+            {
+                m_Width = mip.Width;
+                m_Height = mip.Height;
+                bIsLoaded = true;
+            }
+
+            GLCall(glBindTexture(m_Target, 0));
+        }
+
+        void Texture::ReleaseMip(unsigned int level, const TextureSettings& settings)
+        {
+            assert(m_Target == GL_TEXTURE_2D);
+
+            GLCall(glBindTexture(m_Target, m_RendererID));
+            GLCall(glTexParameteri(m_Target, GL_TEXTURE_BASE_LEVEL, static_cast<int>(level) + 1));
+            SpecifyLevel(level, TextureMip{}, settings);
+            GLCall(glBindTexture(m_Target, 0));
+        }
+
         void Texture::Create(unsigned char* data, const TextureSettings& settings)
         {
             GLCall(glGenTextures(1, &m_RendererID));
@@ -20,34 +90,155 @@ namespace Glacirer
     
             GLCall(glBindTexture(m_Target, m_RendererID));
 
+            const size_t levelSize = static_cast<size_t>(m_Width) * m_Height * GetBytesPerPixel(settings.InternalFormat);
+
             if(settings.Samples > 1)
             {
                 GLCall(glTexImage2DMultisample(m_Target, settings.Samples, settings.InternalFormat, m_Width, m_Height, GL_TRUE));
+                SetLevelSize(0, levelSize * settings.Samples);
             }
             else
             {
-                GLCall(glTexParameteri(m_Target, GL_TEXTURE_MIN_FILTER, settings.MinFilter));
-                GLCall(glTexParameteri(m_Target, GL_TEXTURE_MAG_FILTER, settings.MagFilter));
-                GLCall(glTexParameteri(m_Target, GL_TEXTURE_WRAP_S, settings.WrapS));
-                GLCall(glTexParameteri(m_Target, GL_TEXTURE_WRAP_T, settings.WrapT));
-
-                if(settings.UseBorder)
-                {
-                    GLCall(glTexParameterfv(m_Target, GL_TEXTURE_BORDER_COLOR, &settings.BorderColor.r));
-                }
+                ApplySamplingSettings(settings);
         
                 GLCall(glTexImage2D(m_Target, 0, settings.InternalFormat, m_Width, m_Height, 0, settings.Format, settings.Type, data));
+                SetLevelSize(0, levelSize);
             }
 
             if(settings.GenerateMipmap)
             {
                 assert(settings.Samples == 1);
                 GLCall(glGenerateMipmap(m_Target));
+
+                unsigned int width = m_Width;
+                unsigned int height = m_Height;
+
+                for(unsigned int level = 1; width > 1 || height > 1; level++)
+                {
+                    width = width > 1 ? width / 2 : 1;
+                    height = height > 1 ? height / 2 : 1;
+                    SetLevelSize(level, static_cast<size_t>(width) * height * GetBytesPerPixel(settings.InternalFormat));
+                }
             }
 
             GLCall(glBindTexture(m_Target, 0));
         }
 
+        void Texture::ApplySamplingSettings(const TextureSettings& settings) const
+        {
+            GLCall(glTexParameteri(m_Target, GL_TEXTURE_MIN_FILTER, settings.MinFilter));
+            GLCall(glTexParameteri(m_Target, GL_TEXTURE_MAG_FILTER, settings.MagFilter));
+            GLCall(glTexParameteri(m_Target, GL_TEXTURE_WRAP_S, settings.WrapS));
+            GLCall(glTexParameteri(m_Target, GL_TEXTURE_WRAP_T, settings.WrapT));
+
+            if(settings.UseBorder)
+            {
+                GLCall(glTexParameterfv(m_Target, GL_TEXTURE_BORDER_COLOR, &settings.BorderColor.r));
+            }
+        }
+
+        // Shaders sample masks as rgb, same result they had with greyscale RGB textures
+        void Texture::ApplyChannelSwizzle(const TextureSettings& settings) const
+        {
+            if(settings.Format == GL_RED)
+            {
+                const int swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+                GLCall(glTexParameteriv(m_Target, GL_TEXTURE_SWIZZLE_RGBA, swizzle));
+            }
+        }
+
+        void Texture::SpecifyLevel(unsigned int level, const TextureMip& mip, const TextureSettings& settings)
+        {
+            if(IsCompressedFormat(settings.InternalFormat))
+            {
+                GLCall(glCompressedTexImage2D(m_Target, level, settings.InternalFormat, mip.Width, mip.Height, 0, mip.Size, mip.Data));
+                SetLevelSize(level, mip.Size);
+            }
+            else
+            {
+                GLCall(glTexImage2D(m_Target, level, settings.InternalFormat, mip.Width, mip.Height, 0, settings.Format, settings.Type, mip.Data));
+                SetLevelSize(level, static_cast<size_t>(mip.Width) * mip.Height * GetBytesPerPixel(settings.InternalFormat));
+            }
+        }
+
+        void Texture::SetLevelSize(unsigned int level, size_t size)
+        {
+            if(level >= m_LevelSizes.size())
+            {
+                m_LevelSizes.resize(level + 1, 0);
+            }
+
+            m_LevelSizes[level] = size;
+            m_TrackedMemory.SetSize(GetGpuMemory());
+        }
+
+        size_t Texture::GetGpuMemory() const
+        {
+            size_t gpuMemory = 0;
+            for(const size_t levelSize : m_LevelSizes)
+            {
+                gpuMemory += levelSize;
+            }
+
+            return gpuMemory;
+        }
+
+        unsigned int Texture::GetBytesPerPixel(unsigned int internalFormat)
+        {
+            switch(internalFormat)
+            {
+                case GL_RED:
+                case GL_R8:
+                    return 1;
+                case GL_RG:
+                case GL_RG8:
+                case GL_R16F:
+                    return 2;
+                case GL_RGB16F:
+                case GL_RGBA16F:
+                    return 8;
+                case GL_RGB32F:
+                case GL_RGBA32F:
+                    return 16;
+                default:
+                    return 4;
+            }
+        }
+
+        bool Texture::IsCompressedFormat(unsigned int internalFormat)
+        {
+            switch(internalFormat)
+            {
+                case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+                case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+                case GL_COMPRESSED_RED_RGTC1:
+                case GL_COMPRESSED_RG_RGTC2:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        bool Texture::IsCompressedFormatSupported(unsigned int internalFormat)
+        {
+            switch(internalFormat)
+            {
+                case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+                    return GLEW_EXT_texture_compression_s3tc;
+                case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+                case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+                    return GLEW_EXT_texture_compression_s3tc && GLEW_EXT_texture_sRGB;
+                case GL_COMPRESSED_RED_RGTC1:
+                case GL_COMPRESSED_RG_RGTC2:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
         Texture::~Texture()
         {
             GLCall(glDeleteTextures(1, &m_RendererID));
@@ -0,0 +1,281 @@
+#include "Rendering/TextureCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace
+{
+    constexpr unsigned int PIXELS_PER_BLOCK = 16;
+    constexpr int POWER_ITERATIONS = 8;
+
+    struct PixelBlock
+    {
+        unsigned char Pixels[PIXELS_PER_BLOCK][4];
+    };
+
+    // Pixels outside the texture repeat the last row/column, so they don't pull the endpoints away from the visible ones
+    void ExtractBlock(const unsigned char* rgbaData, const unsigned int width, const unsigned int height, const unsigned int blockX, const unsigned int blockY, PixelBlock& outBlock)
+    {
+        for(unsigned int y = 0; y < 4; y++)
+        {
+            const unsigned int sourceY = std::min(blockY * 4 + y, height - 1);
+
+            for(unsigned int x = 0; x < 4; x++)
+            {
+                const unsigned int sourceX = std::min(blockX * 4 + x, width - 1);
+                const unsigned char* source = rgbaData + (static_cast<size_t>(sourceY) * width + sourceX) * 4;
+
+                std::copy(source, source + 4, outBlock.Pixels[y * 4 + x]);
+            }
+        }
+    }
+
+    uint16_t PackRGB565(const glm::vec3& color)
+    {
+        const glm::vec3 clamped = glm::clamp(color, 0.f, 255.f);
+
+        const uint16_t r = static_cast<uint16_t>(clamped.r * 31.f / 255.f + 0.5f);
+        const uint16_t g = static_cast<uint16_t>(clamped.g * 63.f / 255.f + 0.5f);
+        const uint16_t b = static_cast<uint16_t>(clamped.b * 31.f / 255.f + 0.5f);
+
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    // Same bit replication the hardware decoder uses
+    glm::vec3 UnpackRGB565(const uint16_t color)
+    {
+        const unsigned int r = (color >> 11) & 31;
+        const unsigned int g = (color >> 5) & 63;
+        const unsigned int b = color & 31;
+
+        return glm::vec3{static_cast<float>((r << 3) | (r >> 2)), static_cast<float>((g << 2) | (g >> 4)), static_cast<float>((b << 3) | (b >> 2))};
+    }
+
+    void WriteUInt16(unsigned char* output, const uint16_t value)
+    {
+        output[0] = static_cast<unsigned char>(value & 0xFF);
+        output[1] = static_cast<unsigned char>(value >> 8);
+    }
+
+    // Direction of largest variance of the block colors, by power iteration on the covariance matrix
+    glm::vec3 GetPrincipalAxis(const glm::vec3 (&colors)[PIXELS_PER_BLOCK], const glm::vec3& mean)
+    {
+        glm::mat3 covariance{0.f};
+
+        for(const glm::vec3& color : colors)
+        {
+            const glm::vec3 offset = color - mean;
+            covariance += glm::outerProduct(offset, offset);
+        }
+
+        glm::vec3 axis{1.f, 1.f, 1.f};
+
+        for(int i = 0; i < POWER_ITERATIONS; i++)
+        {
+            axis = covariance * axis;
+
+            const float length = glm::length(axis);
+            if(length <= 0.f)
+            {
+                return glm::vec3{0.f};
+            }
+
+            axis /= length;
+        }
+
+        return axis;
+    }
+
+    // 8 bytes: two RGB565 endpoints and 2 bit indices, always using 4 colors mode (color0 > color1)
+    void CompressColorBlock(const PixelBlock& block, unsigned char* output)
+    {
+        glm::vec3 colors[PIXELS_PER_BLOCK];
+        glm::vec3 mean{0.f};
+
+        for(unsigned int i = 0; i < PIXELS_PER_BLOCK; i++)
+        {
+            colors[i] = glm::vec3{block.Pixels[i][0], block.Pixels[i][1], block.Pixels[i][2]};
+            mean += colors[i];
+        }
+
+        mean /= static_cast<float>(PIXELS_PER_BLOCK);
+
+        const glm::vec3 axis = GetPrincipalAxis(colors, mean);
+
+        float minProjection = 0.f;
+        float maxProjection = 0.f;
+
+        for(const glm::vec3& color : colors)
+        {
+            const float projection = glm::dot(color - mean, axis);
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        uint16_t color0 = PackRGB565(mean + axis * maxProjection);
+        uint16_t color1 = PackRGB565(mean + axis * minProjection);
+
+        if(color0 < color1)
+        {
+            std::swap(color0, color1);
+        }
+
+        WriteUInt16(output, color0);
+        WriteUInt16(output + 2, color1);
+
+        uint32_t indices = 0;
+
+        // Equal endpoints would switch to 3 colors mode, index 0 is the right color either way
+        if(color0 != color1)
+        {
+            const glm::vec3 endpoint0 = UnpackRGB565(color0);
+            const glm::vec3 endpoint1 = UnpackRGB565(color1);
+            const glm::vec3 palette[4] = { endpoint0, endpoint1, (endpoint0 * 2.f + endpoint1) / 3.f, (endpoint0 + endpoint1 * 2.f) / 3.f };
+
+            for(unsigned int i = 0; i < PIXELS_PER_BLOCK; i++)
+            {
+                uint32_t bestIndex = 0;
+                float bestDistance = glm::dot(colors[i] - palette[0], colors[i] - palette[0]);
+
+                for(uint32_t j = 1; j < 4; j++)
+                {
+                    const float distance = glm::dot(colors[i] - palette[j], colors[i] - palette[j]);
+                    if(distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex = j;
+                    }
+                }
+
+                indices |= bestIndex << (i * 2);
+            }
+        }
+
+        output[4] = static_cast<unsigned char>(indices & 0xFF);
+        output[5] = static_cast<unsigned char>((indices >> 8) & 0xFF);
+        output[6] = static_cast<unsigned char>((indices >> 16) & 0xFF);
+        output[7] = static_cast<unsigned char>(indices >> 24);
+    }
+
+    // 8 bytes: two 8 bit endpoints and 3 bit indices, using 8 values mode (value0 > value1)
+    // Shared by BC4/BC5 channels and BC3 alpha
+    void CompressSingleChannelBlock(const PixelBlock& block, const unsigned int channel, unsigned char* output)
+    {
+        unsigned char minValue = 255;
+        unsigned char maxValue = 0;
+
+        for(const auto& pixel : block.Pixels)
+        {
+            minValue = std::min(minValue, pixel[channel]);
+            maxValue = std::max(maxValue, pixel[channel]);
+        }
+
+        output[0] = maxValue;
+        output[1] = minValue;
+
+        uint64_t indices = 0;
+
+        if(maxValue != minValue)
+        {
+            float palette[8];
+            palette[0] = maxValue;
+            palette[1] = minValue;
+
+            for(int i = 2; i < 8; i++)
+            {
+                palette[i] = (static_cast<float>(8 - i) * maxValue + static_cast<float>(i - 1) * minValue) / 7.f;
+            }
+
+            for(unsigned int i = 0; i < PIXELS_PER_BLOCK; i++)
+            {
+                const float value = block.Pixels[i][channel];
+                uint64_t bestIndex = 0;
+                float bestDistance = std::abs(value - palette[0]);
+
+                for(uint64_t j = 1; j < 8; j++)
+                {
+                    const float distance = std::abs(value - palette[j]);
+                    if(distance < bestDistance)
+                    {
+                        bestDistance = distance;
+                        bestIndex = j;
+                    }
+                }
+
+                indices |= bestIndex << (i * 3);
+            }
+        }
+
+        for(int i = 0; i < 6; i++)
+        {
+            output[2 + i] = static_cast<unsigned char>((indices >> (i * 8)) & 0xFF);
+        }
+    }
+}
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        unsigned int TextureCompressor::GetBytesPerBlock(BlockCompression compression)
+        {
+            return compression == BlockCompression::BC1 || compression == BlockCompression::BC4 ? 8 : 16;
+        }
+
+        unsigned int TextureCompressor::GetCompressedSize(BlockCompression compression, unsigned int width, unsigned int height)
+        {
+            const unsigned int totalBlocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            const unsigned int totalBlocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+            return totalBlocksX * totalBlocksY * GetBytesPerBlock(compression);
+        }
+
+        std::vector<unsigned char> TextureCompressor::Compress(const unsigned char* rgbaData, unsigned int width, unsigned int height, BlockCompression compression)
+        {
+            std::vector<unsigned char> compressedData(GetCompressedSize(compression, width, height));
+
+            if(width == 0 || height == 0)
+            {
+                return compressedData;
+            }
+
+            const unsigned int totalBlocksX = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+            const unsigned int totalBlocksY = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+            unsigned char* output = compressedData.data();
+            PixelBlock block{};
+
+            for(unsigned int blockY = 0; blockY < totalBlocksY; blockY++)
+            {
+                for(unsigned int blockX = 0; blockX < totalBlocksX; blockX++)
+                {
+                    ExtractBlock(rgbaData, width, height, blockX, blockY, block);
+
+                    switch(compression)
+                    {
+                        case BlockCompression::BC1:
+                            CompressColorBlock(block, output);
+                            break;
+                        case BlockCompression::BC3:
+                            CompressSingleChannelBlock(block, 3, output);
+                            CompressColorBlock(block, output + 8);
+                            break;
+                        case BlockCompression::BC4:
+                            CompressSingleChannelBlock(block, 0, output);
+                            break;
+                        case BlockCompression::BC5:
+                            CompressSingleChannelBlock(block, 0, output);
+                            CompressSingleChannelBlock(block, 1, output + 8);
+                            break;
+                    }
+
+                    output += GetBytesPerBlock(compression);
+                }
+            }
+
+            return compressedData;
+        }
+    }
+}
@@ -1,8 +1,10 @@
 ﻿#include "Rendering/UniformBuffer.h"
 
+#include <cstring>
 #include <iostream>
 #include <ostream>
 
+#include "Rendering/DynamicRingBuffer.h"
 #include "Rendering/OpenGLCore.h"
 #include "Rendering/Shader.h"
 
@@ -19,6 +21,8 @@ namespace Glacirer
             Bind();
             GLCall(glBufferData(GL_UNIFORM_BUFFER, size, data, bIsDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
             GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, m_BindingIndex, m_RendererID));
+            m_TrackedMemory.SetName(m_Name);
+            m_TrackedMemory.SetSize(size);
 
             // We can also bind the uniform buffer point with range call, this way we could bind parts of a single
             // buffer to different points
@@ -27,8 +31,18 @@ namespace Glacirer
             Unbind();
         }
 
+        UniformBuffer::UniformBuffer(unsigned int size, const unsigned int bindingIndex, const std::string&& name, DynamicRingBuffer& ringBuffer)
+            : m_BindingIndex(bindingIndex), m_Name(name), m_RingBuffer(&ringBuffer), m_StreamedData(size, 0)
+        {
+        }
+
         UniformBuffer::~UniformBuffer()
         {
+            if(m_RingBuffer)
+            {
+                return;
+            }
+
             GLCall(glDeleteBuffers(1, &m_RendererID));
 
             if(IsBound())
@@ -49,8 +63,19 @@ namespace Glacirer
             LastBoundUniformBufferId = 0;
         }
 
-        void UniformBuffer::SetSubData(const void* data, unsigned int size, unsigned int offset) const
+        void UniformBuffer::SetSubData(const void* data, unsigned int size, unsigned int offset)
         {
+            if(m_RingBuffer)
+            {
+                ASSERT(offset + size <= m_StreamedData.size());
+                std::memcpy(m_StreamedData.data() + offset, data, size);
+
+                const unsigned int blockSize = static_cast<unsigned int>(m_StreamedData.size());
+                const DynamicAllocation allocation = m_RingBuffer->Write(m_StreamedData.data(), blockSize, m_RingBuffer->GetUniformOffsetAlignment());
+                GLCall(glBindBufferRange(GL_UNIFORM_BUFFER, m_BindingIndex, allocation.BufferId, allocation.Offset, blockSize));
+                return;
+            }
+
             ASSERT(IsBound());
 
             GLCall(glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data));
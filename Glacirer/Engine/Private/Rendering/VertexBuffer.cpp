@@ -7,11 +7,13 @@ namespace Glacirer
     namespace Rendering
     {
         VertexBuffer::VertexBuffer(const void* data, unsigned int size, bool bIsDynamic)
+            : m_Size(size)
         {
             GLCall(glGenBuffers(1, &m_RendererID));
             GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
 
             GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, bIsDynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW));
+            m_TrackedMemory.SetSize(size);
         }
 
         VertexBuffer::~VertexBuffer()
@@ -45,6 +45,45 @@ namespace Glacirer
             return location + 1;
         }
 
+        unsigned int VertexBufferShortAttribute::CreateAttribute(unsigned int location, unsigned int offset, unsigned int stride)
+        {
+            GLCall(glEnableVertexAttribArray(location)); 
+            GLCall(glVertexAttribPointer(location, Count, GL_SHORT, bIsNormalized ? GL_TRUE : GL_FALSE, stride, (const void*)offset));
+
+            if(Divisor > 0)
+            {
+                GLCall(glVertexAttribDivisor(location, Divisor));
+            }
+
+            return location + 1;
+        }
+
+        unsigned int VertexBufferHalfFloatAttribute::CreateAttribute(unsigned int location, unsigned int offset, unsigned int stride)
+        {
+            GLCall(glEnableVertexAttribArray(location)); 
+            GLCall(glVertexAttribPointer(location, Count, GL_HALF_FLOAT, bIsNormalized ? GL_TRUE : GL_FALSE, stride, (const void*)offset));
+
+            if(Divisor > 0)
+            {
+                GLCall(glVertexAttribDivisor(location, Divisor));
+            }
+
+            return location + 1;
+        }
+
+        unsigned int VertexBufferPackedInt2101010Attribute::CreateAttribute(unsigned int location, unsigned int offset, unsigned int stride)
+        {
+            GLCall(glEnableVertexAttribArray(location)); 
+            GLCall(glVertexAttribPointer(location, Count, GL_INT_2_10_10_10_REV, bIsNormalized ? GL_TRUE : GL_FALSE, stride, (const void*)offset));
+
+            if(Divisor > 0)
+            {
+                GLCall(glVertexAttribDivisor(location, Divisor));
+            }
+
+            return location + 1;
+        }
+
         unsigned int VertexBufferMat4Attribute::CreateAttribute(unsigned int location, unsigned int offset, unsigned int stride)
         {
             // Set attribute pointers for model matrix(4 times vec4)
@@ -71,16 +110,34 @@ namespace Glacirer
             return location + 4;
         }
 
-        unsigned int VertexBufferLayout::CreateAttributes(unsigned int firstAttributeLocation) const
+        unsigned int VertexBufferMat3x4Attribute::CreateAttribute(unsigned int location, unsigned int offset, unsigned int stride)
+        {
+            constexpr unsigned int TOTAL_ROWS = 3;
+
+            for(unsigned int row = 0; row < TOTAL_ROWS; row++)
+            {
+                GLCall(glEnableVertexAttribArray(location + row));
+                GLCall(glVertexAttribPointer(location + row, 4, GL_FLOAT, GL_FALSE, stride, (void*)(offset + row * sizeof(glm::vec4))));
+
+                if(Divisor > 0)
+                {
+                    GLCall(glVertexAttribDivisor(location + row, Divisor));
+                }
+            }
+
+            return location + TOTAL_ROWS;
+        }
+
+        unsigned int VertexBufferLayout::CreateAttributes(unsigned int firstAttributeLocation, unsigned int baseOffset) const
         {
-            unsigned int offset = 0;
+            unsigned int offset = baseOffset;
             unsigned int nextAttributeLocation = firstAttributeLocation;
 
             for (const auto& element : m_Elements)
             {
                 nextAttributeLocation = element->CreateAttribute(nextAttributeLocation, offset, m_Stride);
             
-                offset += element->Count * element->GetSize();
+                offset += element->GetTotalSize();
             }
 
             return nextAttributeLocation;
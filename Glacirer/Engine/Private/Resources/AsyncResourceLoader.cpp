@@ -0,0 +1,337 @@
+#include "Resources/AsyncResourceLoader.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+
+#include "Rendering/Cubemap.h"
+#include "Rendering/ModelData.h"
+#include "Rendering/PixelUnpackBuffer.h"
+#include "Rendering/Texture.h"
+#include "Resources/MeshCache.h"
+#include "Resources/MeshResource.h"
+#include "Resources/TextureCache.h"
+#include "Resources/TextureResource.h"
+#include "Resources/TextureStreamer.h"
+
+namespace
+{
+    using Glacirer::Rendering::PixelUnpackBuffer;
+    using Glacirer::Resources::AsyncResourceLoader;
+
+    class TextureUpload : public AsyncResourceLoader::PendingUpload
+    {
+    public:
+
+        TextureUpload(const std::shared_ptr<Glacirer::Rendering::Texture>& texture, const Glacirer::Rendering::TextureSettings& settings, Glacirer::Resources::TextureStreamer* textureStreamer)
+            : Texture(texture), Settings(settings), Streamer(textureStreamer)
+        { }
+
+        std::shared_ptr<Glacirer::Rendering::Texture> Texture{};
+        Glacirer::Rendering::TextureSettings Settings{};
+        Glacirer::Resources::CookedTexture CookedTexture{};
+        bool bIsCooked{false};
+
+        // Streamed textures only need their cache, the streamer uploads from it
+        Glacirer::Resources::TextureStreamer* Streamer{nullptr};
+        std::string CachePath{};
+        uint64_t SourceHash{0};
+        uint32_t CookKey{0};
+        bool bIsCacheReady{false};
+
+        unsigned int GetNextStepSize() const override
+        {
+            return HasMipsLeft() ? static_cast<unsigned int>(CookedTexture.Mips[m_NextLevel].Data.size()) : 0;
+        }
+
+        bool UploadStep(PixelUnpackBuffer& unpackBuffer) override
+        {
+            if(bIsCacheReady)
+            {
+                if(!Streamer->Register(Texture, CachePath, SourceHash, CookKey, Settings))
+                {
+                    std::cout << "ERROR::TEXTURE_STREAMER: Failed to map " << CachePath << "\n";
+                }
+
+                return true;
+            }
+
+            // Failed loads keep their placeholder
+            if(!HasMipsLeft())
+            {
+                return true;
+            }
+
+            if(m_NextLevel == NOT_STARTED)
+            {
+                m_NextLevel = static_cast<int>(CookedTexture.Mips.size()) - 1;
+                m_UploadSettings = Glacirer::Resources::TextureResource::GetUploadSettings(Settings, CookedTexture);
+            }
+
+            Glacirer::Resources::CookedTextureMip& cookedMip = CookedTexture.Mips[m_NextLevel];
+
+            Glacirer::Rendering::TextureMip mip{};
+            mip.Size = static_cast<unsigned int>(cookedMip.Data.size());
+            mip.Width = cookedMip.Width;
+            mip.Height = cookedMip.Height;
+
+            unpackBuffer.Bind();
+            unpackBuffer.SetData(cookedMip.Data.data(), mip.Size);
+            Texture->UploadMip(static_cast<unsigned int>(m_NextLevel), static_cast<unsigned int>(CookedTexture.Mips.size()), mip, m_UploadSettings);
+            unpackBuffer.Unbind();
+
+            std::vector<unsigned char>().swap(cookedMip.Data);
+
+            return m_NextLevel-- == 0;
+        }
+
+    private:
+
+        constexpr static int NOT_STARTED = -1;
+
+        int m_NextLevel{NOT_STARTED};
+        Glacirer::Rendering::TextureSettings m_UploadSettings{};
+
+        bool HasMipsLeft() const
+        {
+            return bIsCooked && !CookedTexture.Mips.empty() && (m_NextLevel == NOT_STARTED || m_NextLevel >= 0);
+        }
+    };
+
+    class ModelUpload : public AsyncResourceLoader::PendingUpload
+    {
+    public:
+
+        explicit ModelUpload(const std::shared_ptr<Glacirer::Rendering::ModelData>& modelData)
+            : ModelData(modelData)
+        { }
+
+        std::shared_ptr<Glacirer::Rendering::ModelData> ModelData{};
+        std::vector<Glacirer::Resources::CookedMesh> CookedMeshes{};
+
+        unsigned int GetNextStepSize() const override
+        {
+            if(m_NextMesh >= CookedMeshes.size())
+            {
+                return 0;
+            }
+
+            unsigned int totalBytes = 0;
+            for(const Glacirer::Resources::CookedMeshLOD& lod : CookedMeshes[m_NextMesh].LODs)
+            {
+                totalBytes += static_cast<unsigned int>(lod.VertexData.size() + lod.Indices.size() * sizeof(unsigned int));
+            }
+
+            return totalBytes;
+        }
+
+        bool UploadStep(PixelUnpackBuffer&) override
+        {
+            if(m_NextMesh < CookedMeshes.size())
+            {
+                ModelData->AddMesh(Glacirer::Resources::MeshResource::CreateMesh(CookedMeshes[m_NextMesh]));
+                CookedMeshes[m_NextMesh] = {};
+                m_NextMesh++;
+            }
+
+            if(m_NextMesh < CookedMeshes.size())
+            {
+                return false;
+            }
+
+            ModelData->SetIsLoaded(true);
+
+            return true;
+        }
+
+    private:
+
+        size_t m_NextMesh{0};
+    };
+
+    // Sides are decoded by separate jobs, the last one to finish hands the upload to the main thread
+    class CubemapUpload : public AsyncResourceLoader::PendingUpload
+    {
+    public:
+
+        CubemapUpload(const std::shared_ptr<Glacirer::Rendering::Cubemap>& cubemap, const Glacirer::Rendering::TextureSettings& settings)
+            : Cubemap(cubemap), Settings(settings)
+        { }
+
+        std::shared_ptr<Glacirer::Rendering::Cubemap> Cubemap{};
+        Glacirer::Rendering::TextureSettings Settings{};
+        std::array<Glacirer::Resources::DecodedImage, Glacirer::Rendering::Cubemap::TOTAL_SIDES> Sides{};
+        std::atomic<unsigned int> TotalDecodedSides{0};
+
+        unsigned int GetNextStepSize() const override
+        {
+            unsigned int totalBytes = 0;
+            for(const Glacirer::Resources::DecodedImage& side : Sides)
+            {
+                totalBytes += static_cast<unsigned int>(side.Data.size());
+            }
+
+            return totalBytes;
+        }
+
+        // All sides at once, the cubemap is incomplete while their sizes differ
+        bool UploadStep(PixelUnpackBuffer& unpackBuffer) override
+        {
+            const bool bAreAllSidesDecoded = std::none_of(Sides.cbegin(), Sides.cend(), [](const Glacirer::Resources::DecodedImage& side) { return side.Data.empty(); });
+
+            if(!bAreAllSidesDecoded)
+            {
+                return true;
+            }
+
+            unpackBuffer.Bind();
+            Cubemap->Bind();
+
+            for(unsigned int i = 0; i < Glacirer::Rendering::Cubemap::TOTAL_SIDES; i++)
+            {
+                unpackBuffer.SetData(Sides[i].Data.data(), static_cast<unsigned int>(Sides[i].Data.size()));
+                Cubemap->CreateSideTexture(i, nullptr, Sides[i].Width, Sides[i].Height, Settings);
+            }
+
+            Cubemap->Unbind();
+            unpackBuffer.Unbind();
+
+            return true;
+        }
+    };
+}
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        AsyncResourceLoader::AsyncResourceLoader(TextureStreamer& textureStreamer, unsigned int totalWorkers)
+            : m_UnpackBuffer(std::make_unique<Rendering::PixelUnpackBuffer>())
+            , m_TextureStreamer(textureStreamer)
+            , m_WorkerPool(totalWorkers)
+        { }
+
+        AsyncResourceLoader::~AsyncResourceLoader() = default;
+
+        std::shared_ptr<Rendering::Texture> AsyncResourceLoader::LoadTexture(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically)
+        {
+            std::shared_ptr<Rendering::Texture> texture = TextureResource::CreatePlaceholderTexture(settings);
+            texture->SetIsFlippedOnLoad(bFlipVertically);
+
+            TextureStreamer* textureStreamer = settings.bStream ? &m_TextureStreamer : nullptr;
+            TextureUpload* upload = static_cast<TextureUpload*>(AddLoadingUpload(std::make_unique<TextureUpload>(texture, settings, textureStreamer)));
+
+            upload->CachePath = TextureCache::GetCachePath(filePath);
+            upload->CookKey = TextureResource::GetCookKey(settings, bFlipVertically);
+
+            m_WorkerPool.Submit([this, upload, filePath, bFlipVertically]()
+            {
+                upload->bIsCacheReady = upload->Streamer && TextureResource::EnsureTextureCache(filePath, upload->Settings, bFlipVertically, upload->SourceHash);
+
+                if(!upload->bIsCacheReady)
+                {
+                    upload->bIsCooked = TextureResource::CookTextureFromFile(filePath, upload->Settings, bFlipVertically, upload->CookedTexture);
+                }
+
+                m_ReadyUploads.Push(upload);
+            });
+
+            return texture;
+        }
+
+        std::shared_ptr<Rendering::ModelData> AsyncResourceLoader::LoadModel(const std::string& filePath)
+        {
+            std::shared_ptr<Rendering::ModelData> modelData = std::make_shared<Rendering::ModelData>();
+            modelData->SetIsLoaded(false);
+
+            ModelUpload* upload = static_cast<ModelUpload*>(AddLoadingUpload(std::make_unique<ModelUpload>(modelData)));
+
+            m_WorkerPool.Submit([this, upload, filePath]()
+            {
+                MeshResource::ImportModelFromFile(filePath, upload->CookedMeshes);
+                m_ReadyUploads.Push(upload);
+            });
+
+            return modelData;
+        }
+
+        std::shared_ptr<Rendering::Cubemap> AsyncResourceLoader::LoadCubemap(const Rendering::CubemapLoadSettings& loadSettings)
+        {
+            const Rendering::TextureSettings settings = TextureResource::GetCubemapSettings(loadSettings);
+            std::shared_ptr<Rendering::Cubemap> cubemap = std::make_shared<Rendering::Cubemap>(1, 1, settings);
+
+            CubemapUpload* upload = static_cast<CubemapUpload*>(AddLoadingUpload(std::make_unique<CubemapUpload>(cubemap, settings)));
+            const std::array<std::string, Rendering::Cubemap::TOTAL_SIDES> sidePaths = TextureResource::GetCubemapSidePaths(loadSettings);
+
+            for(unsigned int i = 0; i < Rendering::Cubemap::TOTAL_SIDES; i++)
+            {
+                m_WorkerPool.Submit([this, upload, i, sidePath = sidePaths[i]]()
+                {
+                    upload->Sides[i] = TextureResource::DecodeCubemapSide(sidePath);
+
+                    // acq_rel so the last job sees every other side
+                    if(upload->TotalDecodedSides.fetch_add(1, std::memory_order_acq_rel) + 1 == Rendering::Cubemap::TOTAL_SIDES)
+                    {
+                        m_ReadyUploads.Push(upload);
+                    }
+                });
+            }
+
+            return cubemap;
+        }
+
+        void AsyncResourceLoader::ProcessUploads()
+        {
+            PendingUpload* readyUpload = nullptr;
+
+            while(m_ReadyUploads.TryPop(readyUpload))
+            {
+                auto iterator = std::find_if(m_LoadingUploads.begin(), m_LoadingUploads.end(),
+                    [readyUpload](const std::unique_ptr<PendingUpload>& upload) { return upload.get() == readyUpload; });
+                assert(iterator != m_LoadingUploads.end());
+
+                m_PendingUploads.push_back(std::move(*iterator));
+                m_LoadingUploads.erase(iterator);
+            }
+
+            const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+            unsigned int totalUploadedBytes = 0;
+
+            while(!m_PendingUploads.empty())
+            {
+                PendingUpload& upload = *m_PendingUploads.front();
+                const unsigned int stepSize = upload.GetNextStepSize();
+
+                // The first step always runs, otherwise anything bigger than the budget would never load
+                if(totalUploadedBytes > 0 && totalUploadedBytes + stepSize > m_UploadBudget.MaxBytes)
+                {
+                    break;
+                }
+
+                if(upload.UploadStep(*m_UnpackBuffer))
+                {
+                    m_PendingUploads.pop_front();
+                }
+
+                totalUploadedBytes += stepSize;
+
+                const float elapsedMilliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+                if(elapsedMilliseconds >= m_UploadBudget.MaxMilliseconds)
+                {
+                    break;
+                }
+            }
+        }
+
+        AsyncResourceLoader::PendingUpload* AsyncResourceLoader::AddLoadingUpload(std::unique_ptr<PendingUpload> upload)
+        {
+            m_LoadingUploads.push_back(std::move(upload));
+
+            return m_LoadingUploads.back().get();
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#include "Resources/CacheFile.h"
+
+#include "Resources/MappedFile.h"
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        uint64_t CacheFile::HashFile(const std::string& filePath)
+        {
+            MappedFile file{};
+            if(!file.Open(filePath))
+            {
+                return 0;
+            }
+
+            return HashData(file.GetData(), file.GetSize());
+        }
+
+        uint64_t CacheFile::HashData(const void* data, size_t size, uint64_t hash)
+        {
+            constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+            for(size_t i = 0; i < size; i++)
+            {
+                hash ^= bytes[i];
+                hash *= FNV_PRIME;
+            }
+
+            return hash;
+        }
+
+        void CacheFile::WritePadded(std::ostream& file, const void* data, size_t size)
+        {
+            constexpr char PADDING[ALIGNMENT] = {};
+
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            file.write(PADDING, static_cast<std::streamsize>(GetPaddedSize(size) - size));
+        }
+
+        const void* CacheFileReader::ReadPadded(size_t size)
+        {
+            const size_t paddedSize = CacheFile::GetPaddedSize(size);
+
+            if(paddedSize > m_Size - m_Offset)
+            {
+                return nullptr;
+            }
+
+            const void* data = m_Data + m_Offset;
+            m_Offset += paddedSize;
+
+            return data;
+        }
+    }
+}
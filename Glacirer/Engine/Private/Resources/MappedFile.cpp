@@ -0,0 +1,131 @@
+#include "Resources/MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        MappedFile::~MappedFile()
+        {
+            Close();
+        }
+
+#ifdef _WIN32
+        bool MappedFile::Open(const std::string& filePath)
+        {
+            Close();
+
+            HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if(file == INVALID_HANDLE_VALUE)
+            {
+                return false;
+            }
+
+            LARGE_INTEGER fileSize{};
+            // Empty files can't be mapped
+            if(!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+            {
+                CloseHandle(file);
+                return false;
+            }
+
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(mapping == nullptr)
+            {
+                CloseHandle(file);
+                return false;
+            }
+
+            const void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if(data == nullptr)
+            {
+                CloseHandle(mapping);
+                CloseHandle(file);
+                return false;
+            }
+
+            m_FileHandle = file;
+            m_MappingHandle = mapping;
+            m_Data = static_cast<const unsigned char*>(data);
+            m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+            return true;
+        }
+
+        void MappedFile::Close()
+        {
+            if(m_Data)
+            {
+                UnmapViewOfFile(m_Data);
+            }
+
+            if(m_MappingHandle)
+            {
+                CloseHandle(m_MappingHandle);
+            }
+
+            if(m_FileHandle)
+            {
+                CloseHandle(m_FileHandle);
+            }
+
+            m_Data = nullptr;
+            m_Size = 0;
+            m_MappingHandle = nullptr;
+            m_FileHandle = nullptr;
+        }
+#else
+        bool MappedFile::Open(const std::string& filePath)
+        {
+            Close();
+
+            const int file = open(filePath.c_str(), O_RDONLY);
+            if(file < 0)
+            {
+                return false;
+            }
+
+            struct stat fileStatus{};
+            if(fstat(file, &fileStatus) != 0 || fileStatus.st_size == 0)
+            {
+                close(file);
+                return false;
+            }
+
+            void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            // Mapping stays valid after the descriptor is closed
+            close(file);
+
+            if(data == MAP_FAILED)
+            {
+                return false;
+            }
+
+            m_Data = static_cast<const unsigned char*>(data);
+            m_Size = static_cast<size_t>(fileStatus.st_size);
+
+            return true;
+        }
+
+        void MappedFile::Close()
+        {
+            if(m_Data)
+            {
+                munmap(const_cast<unsigned char*>(m_Data), m_Size);
+            }
+
+            m_Data = nullptr;
+            m_Size = 0;
+        }
+#endif
+    }
+}
@@ -0,0 +1,322 @@
+#include "Resources/MeshCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#include "Rendering/ModelData.h"
+#include "Resources/CacheFile.h"
+#include "Resources/MappedFile.h"
+
+namespace
+{
+    constexpr char MESH_CACHE_MAGIC[4] = { 'G', 'M', 'S', 'H' };
+
+    struct MeshCacheHeader
+    {
+        char Magic[4];
+        uint32_t ImporterVersion;
+        uint64_t SourceHash;
+        uint32_t TotalMeshes;
+        uint32_t Reserved;
+    };
+
+    // Followed by the name, padded to alignment
+    struct MeshCacheMeshHeader
+    {
+        uint32_t NameSize;
+        uint32_t TotalLODs;
+    };
+
+    // Followed by the vertex data, the indices and the CPU positions, each padded to alignment
+    struct MeshCacheLODHeader
+    {
+        uint32_t TotalVertices;
+        uint32_t TotalIndices;
+        uint32_t VertexDataSize;
+        uint32_t TotalPositions; // Either 0 or TotalVertices
+        uint8_t bQuantizePositions;
+        uint8_t bPackNormals;
+        uint8_t bUseHalfFloatTexCoords;
+        uint8_t bUsesShortIndices;
+        float BoundsMin[3];
+        float BoundsMax[3];
+    };
+
+    static_assert(sizeof(MeshCacheHeader) == 24, "Mesh cache header layout changed, bump IMPORTER_VERSION");
+    static_assert(sizeof(MeshCacheLODHeader) == 44, "Mesh cache LOD header layout changed, bump IMPORTER_VERSION");
+
+    struct MappedMeshLOD
+    {
+        const MeshCacheLODHeader* Header{nullptr};
+        const void* VertexData{nullptr};
+        const void* IndexData{nullptr};
+        const glm::vec3* Positions{nullptr};
+    };
+
+    struct MappedMesh
+    {
+        std::string Name{};
+        std::vector<MappedMeshLOD> LODs{};
+    };
+
+    Glacirer::Rendering::VertexFormat GetVertexFormat(const MeshCacheLODHeader& header)
+    {
+        Glacirer::Rendering::VertexFormat vertexFormat{};
+        vertexFormat.bQuantizePositions = header.bQuantizePositions != 0;
+        vertexFormat.bPackNormals = header.bPackNormals != 0;
+        vertexFormat.bUseHalfFloatTexCoords = header.bUseHalfFloatTexCoords != 0;
+
+        return vertexFormat;
+    }
+
+    Glacirer::Rendering::Bounds GetBounds(const MeshCacheLODHeader& header)
+    {
+        Glacirer::Rendering::Bounds bounds{};
+        bounds.Min = glm::vec3{header.BoundsMin[0], header.BoundsMin[1], header.BoundsMin[2]};
+        bounds.Max = glm::vec3{header.BoundsMax[0], header.BoundsMax[1], header.BoundsMax[2]};
+
+        return bounds;
+    }
+
+    bool ParseMeshes(Glacirer::Resources::CacheFileReader& reader, const uint32_t totalMeshes, std::vector<MappedMesh>& outMeshes)
+    {
+        outMeshes.resize(totalMeshes);
+
+        for(MappedMesh& mappedMesh : outMeshes)
+        {
+            const MeshCacheMeshHeader* meshHeader = reader.Read<MeshCacheMeshHeader>();
+            if(!meshHeader || meshHeader->TotalLODs == 0)
+            {
+                return false;
+            }
+
+            const char* name = static_cast<const char*>(reader.ReadPadded(meshHeader->NameSize));
+            if(!name)
+            {
+                return false;
+            }
+
+            mappedMesh.Name.assign(name, meshHeader->NameSize);
+            mappedMesh.LODs.resize(meshHeader->TotalLODs);
+
+            for(MappedMeshLOD& mappedLOD : mappedMesh.LODs)
+            {
+                mappedLOD.Header = reader.Read<MeshCacheLODHeader>();
+                if(!mappedLOD.Header)
+                {
+                    return false;
+                }
+
+                const size_t indexSize = mappedLOD.Header->bUsesShortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+                mappedLOD.VertexData = reader.ReadPadded(mappedLOD.Header->VertexDataSize);
+                mappedLOD.IndexData = reader.ReadPadded(static_cast<size_t>(mappedLOD.Header->TotalIndices) * indexSize);
+
+                if(!mappedLOD.VertexData || !mappedLOD.IndexData)
+                {
+                    return false;
+                }
+
+                if(mappedLOD.Header->TotalPositions > 0)
+                {
+                    if(mappedLOD.Header->TotalPositions != mappedLOD.Header->TotalVertices)
+                    {
+                        return false;
+                    }
+
+                    mappedLOD.Positions = static_cast<const glm::vec3*>(reader.ReadPadded(static_cast<size_t>(mappedLOD.Header->TotalPositions) * sizeof(glm::vec3)));
+
+                    if(!mappedLOD.Positions)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+
+        return reader.IsAtEnd();
+    }
+
+    // Validates the whole file before any GPU resource is created, so a corrupted cache never leaves a partial model
+    bool ParseMeshCache(const Glacirer::Resources::MappedFile& file, const std::string& cachePath, const uint64_t sourceHash, std::vector<MappedMesh>& outMeshes)
+    {
+        Glacirer::Resources::CacheFileReader reader(file.GetData(), file.GetSize());
+
+        const MeshCacheHeader* header = reader.Read<MeshCacheHeader>();
+        if(!header
+            || std::memcmp(header->Magic, MESH_CACHE_MAGIC, sizeof(header->Magic)) != 0
+            || header->ImporterVersion != Glacirer::Resources::MeshCache::IMPORTER_VERSION
+            || header->SourceHash != sourceHash)
+        {
+            return false;
+        }
+
+        if(!ParseMeshes(reader, header->TotalMeshes, outMeshes))
+        {
+            std::cout << "ERROR::MESH_CACHE: Corrupted cache file " << cachePath << "\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    std::shared_ptr<Glacirer::Rendering::Mesh> CreateMesh(const MappedMeshLOD& mappedLOD)
+    {
+        const MeshCacheLODHeader& header = *mappedLOD.Header;
+
+        return std::make_shared<Glacirer::Rendering::Mesh>(
+            mappedLOD.VertexData, header.TotalVertices, GetVertexFormat(header), GetBounds(header),
+            mappedLOD.IndexData, header.TotalIndices, header.bUsesShortIndices != 0, mappedLOD.Positions);
+    }
+}
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        std::string MeshCache::GetCachePath(const std::string& sourceFilePath)
+        {
+            return sourceFilePath + ".meshcache";
+        }
+
+        bool MeshCache::Write(const std::string& cachePath, uint64_t sourceHash, const std::vector<CookedMesh>& cookedMeshes)
+        {
+            std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+            if(!file)
+            {
+                return false;
+            }
+
+            MeshCacheHeader header{};
+            std::memcpy(header.Magic, MESH_CACHE_MAGIC, sizeof(header.Magic));
+            header.ImporterVersion = IMPORTER_VERSION;
+            header.SourceHash = sourceHash;
+            header.TotalMeshes = static_cast<uint32_t>(cookedMeshes.size());
+            CacheFile::WritePadded(file, &header, sizeof(header));
+
+            std::vector<uint16_t> shortIndices{};
+
+            for(const CookedMesh& cookedMesh : cookedMeshes)
+            {
+                MeshCacheMeshHeader meshHeader{};
+                meshHeader.NameSize = static_cast<uint32_t>(cookedMesh.Name.size());
+                meshHeader.TotalLODs = static_cast<uint32_t>(cookedMesh.LODs.size());
+                CacheFile::WritePadded(file, &meshHeader, sizeof(meshHeader));
+                CacheFile::WritePadded(file, cookedMesh.Name.data(), cookedMesh.Name.size());
+
+                for(const CookedMeshLOD& cookedLOD : cookedMesh.LODs)
+                {
+                    // Same rule as IndexBuffer, stored narrowed so it is uploaded without conversion
+                    const bool bUsesShortIndices = cookedLOD.TotalVertices <= static_cast<unsigned int>(std::numeric_limits<uint16_t>::max()) + 1;
+
+                    MeshCacheLODHeader lodHeader{};
+                    lodHeader.TotalVertices = cookedLOD.TotalVertices;
+                    lodHeader.TotalIndices = static_cast<uint32_t>(cookedLOD.Indices.size());
+                    lodHeader.VertexDataSize = static_cast<uint32_t>(cookedLOD.VertexData.size());
+                    lodHeader.TotalPositions = static_cast<uint32_t>(cookedLOD.Positions.size());
+                    lodHeader.bQuantizePositions = cookedLOD.VertexFormat.bQuantizePositions;
+                    lodHeader.bPackNormals = cookedLOD.VertexFormat.bPackNormals;
+                    lodHeader.bUseHalfFloatTexCoords = cookedLOD.VertexFormat.bUseHalfFloatTexCoords;
+                    lodHeader.bUsesShortIndices = bUsesShortIndices;
+                    std::memcpy(lodHeader.BoundsMin, &cookedLOD.Bounds.Min.x, sizeof(lodHeader.BoundsMin));
+                    std::memcpy(lodHeader.BoundsMax, &cookedLOD.Bounds.Max.x, sizeof(lodHeader.BoundsMax));
+                    CacheFile::WritePadded(file, &lodHeader, sizeof(lodHeader));
+
+                    CacheFile::WritePadded(file, cookedLOD.VertexData.data(), cookedLOD.VertexData.size());
+
+                    if(bUsesShortIndices)
+                    {
+                        shortIndices.assign(cookedLOD.Indices.begin(), cookedLOD.Indices.end());
+                        CacheFile::WritePadded(file, shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+                    }
+                    else
+                    {
+                        CacheFile::WritePadded(file, cookedLOD.Indices.data(), cookedLOD.Indices.size() * sizeof(uint32_t));
+                    }
+
+                    CacheFile::WritePadded(file, cookedLOD.Positions.data(), cookedLOD.Positions.size() * sizeof(glm::vec3));
+                }
+            }
+
+            return static_cast<bool>(file);
+        }
+
+        bool MeshCache::TryLoad(const std::string& cachePath, uint64_t sourceHash, Rendering::ModelData& outModel)
+        {
+            MappedFile file{};
+            std::vector<MappedMesh> mappedMeshes{};
+
+            if(!file.Open(cachePath) || !ParseMeshCache(file, cachePath, sourceHash, mappedMeshes))
+            {
+                return false;
+            }
+
+            // Buffers are uploaded directly from the mapping, which is released once all meshes are created
+            for(const MappedMesh& mappedMesh : mappedMeshes)
+            {
+                std::shared_ptr<Rendering::Mesh> mesh = CreateMesh(mappedMesh.LODs[0]);
+
+                for(size_t i = 1; i < mappedMesh.LODs.size(); i++)
+                {
+                    mesh->AddLOD(CreateMesh(mappedMesh.LODs[i]));
+                }
+
+                mesh->SetName(mappedMesh.Name);
+                outModel.AddMesh(std::move(mesh));
+            }
+
+            return true;
+        }
+
+        bool MeshCache::TryRead(const std::string& cachePath, uint64_t sourceHash, std::vector<CookedMesh>& outCookedMeshes)
+        {
+            MappedFile file{};
+            std::vector<MappedMesh> mappedMeshes{};
+
+            if(!file.Open(cachePath) || !ParseMeshCache(file, cachePath, sourceHash, mappedMeshes))
+            {
+                return false;
+            }
+
+            outCookedMeshes.resize(mappedMeshes.size());
+
+            for(size_t i = 0; i < mappedMeshes.size(); i++)
+            {
+                outCookedMeshes[i].Name = mappedMeshes[i].Name;
+
+                for(const MappedMeshLOD& mappedLOD : mappedMeshes[i].LODs)
+                {
+                    const MeshCacheLODHeader& header = *mappedLOD.Header;
+                    const unsigned char* vertexData = static_cast<const unsigned char*>(mappedLOD.VertexData);
+
+                    outCookedMeshes[i].LODs.emplace_back();
+                    CookedMeshLOD& cookedLOD = outCookedMeshes[i].LODs.back();
+                    cookedLOD.VertexFormat = GetVertexFormat(header);
+                    cookedLOD.Bounds = GetBounds(header);
+                    cookedLOD.TotalVertices = header.TotalVertices;
+                    cookedLOD.VertexData.assign(vertexData, vertexData + header.VertexDataSize);
+
+                    if(header.bUsesShortIndices)
+                    {
+                        const uint16_t* indices = static_cast<const uint16_t*>(mappedLOD.IndexData);
+                        cookedLOD.Indices.assign(indices, indices + header.TotalIndices);
+                    }
+                    else
+                    {
+                        const uint32_t* indices = static_cast<const uint32_t*>(mappedLOD.IndexData);
+                        cookedLOD.Indices.assign(indices, indices + header.TotalIndices);
+                    }
+
+                    if(mappedLOD.Positions)
+                    {
+                        cookedLOD.Positions.assign(mappedLOD.Positions, mappedLOD.Positions + header.TotalPositions);
+                    }
+                }
+            }
+
+            return true;
+        }
+    }
+}
@@ -3,10 +3,15 @@
 #include <iostream>
 #include <memory>
 #include <assimp/postprocess.h>
+#include <glm/gtc/packing.hpp>
 
 #include "Rendering/Mesh.h"
+#include "Rendering/MeshOptimizer.h"
+#include "Rendering/MeshSimplifier.h"
 #include "Rendering/ModelData.h"
 #include "Rendering/Primitive.h"
+#include "Resources/CacheFile.h"
+#include "Resources/MeshCache.h"
 
 namespace Glacirer
 {
@@ -35,6 +40,46 @@ namespace Glacirer
 
         std::shared_ptr<Rendering::ModelData> MeshResource::LoadModelFromFile(const std::string& filePath)
         {
+            std::shared_ptr<Rendering::ModelData> model = std::make_shared<Rendering::ModelData>();
+
+            // Source hash invalidates the cache when the model file is modified
+            const std::string cachePath = MeshCache::GetCachePath(filePath);
+            const uint64_t sourceHash = CacheFile::HashFile(filePath);
+
+            if(sourceHash != 0 && MeshCache::TryLoad(cachePath, sourceHash, *model))
+            {
+#ifdef _DEBUG
+                std::cout << "Loaded " << filePath << " from mesh cache\n";
+#endif
+                return model;
+            }
+
+            std::vector<CookedMesh> cookedMeshes{};
+            ImportModelFromSource(filePath, sourceHash, cookedMeshes);
+
+            for(const CookedMesh& cookedMesh : cookedMeshes)
+            {
+                model->AddMesh(CreateMesh(cookedMesh));
+            }
+
+            return model;
+        }
+
+        bool MeshResource::ImportModelFromFile(const std::string& filePath, std::vector<CookedMesh>& outCookedMeshes)
+        {
+            const uint64_t sourceHash = CacheFile::HashFile(filePath);
+
+            if(sourceHash != 0 && MeshCache::TryRead(MeshCache::GetCachePath(filePath), sourceHash, outCookedMeshes))
+            {
+                return true;
+            }
+
+            return ImportModelFromSource(filePath, sourceHash, outCookedMeshes);
+        }
+
+        bool MeshResource::ImportModelFromSource(const std::string& filePath, uint64_t sourceHash, std::vector<CookedMesh>& outCookedMeshes)
+        {
+            // Importer instances aren't shared, so imports can run on several threads
             Assimp::Importer importer;
 
             // path
@@ -47,22 +92,27 @@ namespace Glacirer
             if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
             {
                 std::cout << "ERROR::ASSIMP: " << importer.GetErrorString() << "\n";
-                return std::make_shared<Rendering::ModelData>();
+                return false;
             }
 
-            std::shared_ptr<Rendering::ModelData> model = std::make_shared<Rendering::ModelData>();
-
 #ifdef _DEBUG
             std::cout << "Processing scene " << scene->mName.C_Str() << "\n";
 #endif
-    
-            ProcessNode(scene->mRootNode, scene, *model);
 
-            return model;
+            ProcessNode(scene->mRootNode, scene, outCookedMeshes);
+
+            const std::string cachePath = MeshCache::GetCachePath(filePath);
+
+            if(sourceHash != 0 && !MeshCache::Write(cachePath, sourceHash, outCookedMeshes))
+            {
+                std::cout << "ERROR::MESH_CACHE: Failed to write " << cachePath << "\n";
+            }
+
+            return true;
         }
 
         // Recursively process node and children nodes
-        void MeshResource::ProcessNode(aiNode* node, const aiScene* scene, Rendering::ModelData& outModel)
+        void MeshResource::ProcessNode(aiNode* node, const aiScene* scene, std::vector<CookedMesh>& outCookedMeshes)
         {
 #ifdef _DEBUG
             std::cout << "Processing node " << node->mName.C_Str() << "\n";
@@ -74,15 +124,16 @@ namespace Glacirer
                 // Nodes contains just an index of the mesh, scene is the one that holds the meshes data
                 aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
         
-                std::shared_ptr<Rendering::Mesh> processedMesh = ProcessMesh(mesh, scene);
-                processedMesh->SetName(node->mName.C_Str());
-                outModel.AddMesh(std::move(processedMesh));
+                outCookedMeshes.emplace_back();
+                CookedMesh& cookedMesh = outCookedMeshes.back();
+                cookedMesh.Name = node->mName.C_Str();
+                ProcessMesh(mesh, scene, cookedMesh);
             }
 
             // Then do the same for each of its children
             for(unsigned int i = 0; i < node->mNumChildren; i++)
             {
-                ProcessNode(node->mChildren[i], scene, outModel);
+                ProcessNode(node->mChildren[i], scene, outCookedMeshes);
             }
 
             // If we just iterated on scene->mMeshes we would lose the possibility of setting a parent children relationship
@@ -90,7 +141,7 @@ namespace Glacirer
             // this example doesn't use this, but it's nice to keep this approach for that
         }
 
-        std::shared_ptr<Rendering::Mesh> MeshResource::ProcessMesh(aiMesh* mesh, const aiScene* scene)
+        void MeshResource::ProcessMesh(aiMesh* mesh, const aiScene* scene, CookedMesh& outCookedMesh)
         {
 #ifdef _DEBUG           
             std::cout << "Processing mesh " << mesh->mName.C_Str() << "\n";
@@ -147,7 +198,159 @@ namespace Glacirer
                 }
             }
 
-            return std::make_shared<Rendering::Mesh>(vertices, indices);
+            OptimizeMeshData(vertices, indices);
+
+            outCookedMesh.LODs.emplace_back(CookLOD(vertices, indices));
+
+            // Before any quantization, so queries against LOD 0 use the imported positions
+            std::vector<glm::vec3>& positions = outCookedMesh.LODs.back().Positions;
+            positions.reserve(vertices.size());
+
+            for(const Rendering::Vertex& vertex : vertices)
+            {
+                positions.emplace_back(vertex.Position);
+            }
+
+            GenerateLODs(outCookedMesh, vertices, indices);
+        }
+
+        // Encodes the vertices as they will be uploaded, the same data is written to the mesh cache
+        CookedMeshLOD MeshResource::CookLOD(const std::vector<Rendering::Vertex>& vertices, const std::vector<unsigned int>& indices)
+        {
+            CookedMeshLOD cookedLOD{};
+            cookedLOD.VertexFormat = SelectVertexFormat(vertices);
+            cookedLOD.TotalVertices = static_cast<unsigned int>(vertices.size());
+            cookedLOD.Indices = indices;
+
+            for(const Rendering::Vertex& vertex : vertices)
+            {
+                cookedLOD.Bounds.Encapsulate(vertex.Position);
+            }
+
+            cookedLOD.VertexData = Rendering::Mesh::PackVertices(vertices, cookedLOD.VertexFormat, cookedLOD.Bounds);
+
+            return cookedLOD;
+        }
+
+        std::shared_ptr<Rendering::Mesh> MeshResource::CreateMesh(const CookedMesh& cookedMesh)
+        {
+            std::shared_ptr<Rendering::Mesh> mesh{};
+
+            for(const CookedMeshLOD& cookedLOD : cookedMesh.LODs)
+            {
+                // Only LOD 0 has CPU positions, occlusion culling and scene queries don't use the others
+                std::shared_ptr<Rendering::Mesh> lodMesh = std::make_shared<Rendering::Mesh>(
+                    cookedLOD.VertexData.data(), cookedLOD.TotalVertices, cookedLOD.VertexFormat, cookedLOD.Bounds,
+                    cookedLOD.Indices.data(), static_cast<unsigned int>(cookedLOD.Indices.size()), false,
+                    cookedLOD.Positions.empty() ? nullptr : cookedLOD.Positions.data());
+
+                if(mesh)
+                {
+                    mesh->AddLOD(lodMesh);
+                }
+                else
+                {
+                    mesh = std::move(lodMesh);
+                }
+            }
+
+            mesh->SetName(cookedMesh.Name);
+
+            return mesh;
+        }
+
+        // Picks the most compact encoding whose error stays below what is noticeable on screen or on texture sampling
+        Rendering::VertexFormat MeshResource::SelectVertexFormat(const std::vector<Rendering::Vertex>& vertices)
+        {
+            // Positions in world units (meters), only meshes up to ~32m wide fit 16 bits under this error
+            constexpr float MAX_POSITION_QUANTIZATION_ERROR = 0.0005f;
+            // Quarter of a texel on 1024 textures, half floats keep it for texture coordinates in [-1, 1]
+            constexpr float MAX_TEXCOORD_ERROR = 1.f / 4096.f;
+
+            Rendering::VertexFormat vertexFormat{};
+            // 10 bits per component is always below lighting precision we can perceive
+            vertexFormat.bPackNormals = true;
+
+            if(vertices.empty())
+            {
+                return vertexFormat;
+            }
+
+            glm::vec3 minPosition = vertices.front().Position;
+            glm::vec3 maxPosition = vertices.front().Position;
+            float maxTexCoordError = 0.f;
+
+            for(const Rendering::Vertex& vertex : vertices)
+            {
+                minPosition = glm::min(minPosition, vertex.Position);
+                maxPosition = glm::max(maxPosition, vertex.Position);
+
+                const glm::vec2 halfTexCoord = glm::unpackHalf2x16(glm::packHalf2x16(vertex.TexCoord));
+                const glm::vec2 texCoordError = glm::abs(halfTexCoord - vertex.TexCoord);
+                maxTexCoordError = glm::max(maxTexCoordError, glm::max(texCoordError.x, texCoordError.y));
+            }
+
+            const glm::vec3 extents = (maxPosition - minPosition) * 0.5f;
+            const float positionQuantizationStep = glm::max(extents.x, glm::max(extents.y, extents.z)) / 32767.f;
+
+            vertexFormat.bQuantizePositions = positionQuantizationStep <= MAX_POSITION_QUANTIZATION_ERROR;
+            vertexFormat.bUseHalfFloatTexCoords = maxTexCoordError <= MAX_TEXCOORD_ERROR;
+
+            return vertexFormat;
+        }
+
+        // Assimp keeps the authoring order of faces, which is close to random for the post-transform vertex cache
+        void MeshResource::OptimizeMeshData(std::vector<Rendering::Vertex>& vertices, std::vector<unsigned int>& indices)
+        {
+            Rendering::MeshOptimizer::OptimizeVertexCacheAndOverdraw(vertices, indices);
+            Rendering::MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+        }
+
+        // Each LOD halves the triangles of the previous one, the error allowed doubles since
+        // it is only selected once the mesh covers half the screen size (see MeshComponent::UpdateLOD)
+        void MeshResource::GenerateLODs(CookedMesh& cookedMesh, const std::vector<Rendering::Vertex>& vertices, const std::vector<unsigned int>& indices)
+        {
+            constexpr int MAX_GENERATED_LODS = 3;
+            constexpr unsigned int MIN_TRIANGLES_TO_SIMPLIFY = 256;
+            constexpr float LOD1_MAX_RELATIVE_ERROR = 0.01f;
+            // Stop the chain when simplification can't get close to the target without exceeding the error
+            constexpr float MIN_TRIANGLE_REDUCTION = 0.8f;
+
+            std::vector<Rendering::Vertex> lodVertices = vertices;
+            std::vector<unsigned int> lodIndices = indices;
+            float maxRelativeError = LOD1_MAX_RELATIVE_ERROR;
+
+            for(int i = 0; i < MAX_GENERATED_LODS; i++)
+            {
+                const unsigned int totalTriangles = static_cast<unsigned int>(lodIndices.size() / 3);
+
+                if(totalTriangles < MIN_TRIANGLES_TO_SIMPLIFY)
+                {
+                    break;
+                }
+
+                std::vector<Rendering::Vertex> simplifiedVertices{};
+                std::vector<unsigned int> simplifiedIndices{};
+
+                if(!Rendering::MeshSimplifier::Simplify(lodVertices, lodIndices, (totalTriangles / 2) * 3, maxRelativeError, simplifiedVertices, simplifiedIndices))
+                {
+                    break;
+                }
+
+                const unsigned int totalSimplifiedTriangles = static_cast<unsigned int>(simplifiedIndices.size() / 3);
+
+                if(totalSimplifiedTriangles > totalTriangles * MIN_TRIANGLE_REDUCTION)
+                {
+                    break;
+                }
+
+                OptimizeMeshData(simplifiedVertices, simplifiedIndices);
+                cookedMesh.LODs.emplace_back(CookLOD(simplifiedVertices, simplifiedIndices));
+
+                lodVertices = std::move(simplifiedVertices);
+                lodIndices = std::move(simplifiedIndices);
+                maxRelativeError *= 2.f;
+            }
         }
     }
 }
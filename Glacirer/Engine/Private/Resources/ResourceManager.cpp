@@ -1,12 +1,14 @@
 #include "Resources/ResourceManager.h"
 
 #include <memory>
+#include <vector>
 
 #include "Rendering/Cubemap.h"
 #include "Rendering/Material.h"
 #include "Rendering/Shader.h"
 #include "Rendering/Texture.h"
 #include "Resources/MeshResource.h"
+#include "Resources/ShaderCache.h"
 #include "Resources/ShaderResource.h"
 #include "Resources/TextureResource.h"
 
@@ -14,12 +16,9 @@ namespace Glacirer
 {
     namespace Resources
     {
-        std::unordered_map<std::string, std::shared_ptr<Rendering::Shader>> ResourceManager::m_Shaders{};
-        std::unordered_map<std::string, std::shared_ptr<Rendering::Mesh>> ResourceManager::m_Meshes{};
-        std::unordered_map<std::string, std::shared_ptr<Rendering::Material>> ResourceManager::m_Materials{};
-        std::unordered_map<std::string, std::shared_ptr<Rendering::Texture>> ResourceManager::m_Textures{};
-        std::unordered_map<std::string, std::shared_ptr<Rendering::ModelData>> ResourceManager::m_Models{};
-        std::unordered_map<std::string, std::shared_ptr<Rendering::Cubemap>> ResourceManager::m_Cubemaps{};
+        ResourceRegistry ResourceManager::m_Registry{};
+        std::unique_ptr<TextureStreamer> ResourceManager::m_TextureStreamer{};
+        std::unique_ptr<AsyncResourceLoader> ResourceManager::m_AsyncLoader{};
 
         std::string ResourceManager::RESOURCES_PATH = "EngineData/";
 
@@ -34,6 +33,8 @@ namespace Glacirer
 
         void ResourceManager::LoadDefaultResources()
         {
+            GetAsyncLoader();
+
             LoadShader(RESOURCES_PATH + "Shaders/BlinnPhong.glsl", DEFAULT_SHADER_NAME);
             LoadShader(RESOURCES_PATH + "Shaders/Error.glsl", ERROR_SHADER_NAME);
 
@@ -42,65 +43,76 @@ namespace Glacirer
 
             CreateMaterial(MISSING_MATERIAL_NAME, ERROR_SHADER_NAME);
 
-            m_Meshes[DEFAULT_MESH_CUBE_NAME] = MeshResource::LoadCube();
-            m_Meshes[DEFAULT_MESH_QUAD_NAME] = MeshResource::LoadQuad();
-            m_Meshes[DEFAULT_MESH_SPHERE_NAME] = MeshResource::LoadSphere(RESOURCES_PATH + "Primitives/Sphere.fbx");
+            ResourcePool<Rendering::Mesh>& meshes = m_Registry.GetMeshes();
+            meshes.Add(DEFAULT_MESH_CUBE_NAME, MeshResource::LoadCube());
+            meshes.Add(DEFAULT_MESH_QUAD_NAME, MeshResource::LoadQuad());
+            meshes.Add(DEFAULT_MESH_SPHERE_NAME, MeshResource::LoadSphere(RESOURCES_PATH + "Primitives/Sphere.fbx"));
+
+            // Looked up by name at any time, so never evicted even when nothing uses them
+            m_Registry.GetShaders().Retain(m_Registry.GetShaders().Find(DEFAULT_SHADER_NAME));
+            m_Registry.GetShaders().Retain(m_Registry.GetShaders().Find(ERROR_SHADER_NAME));
+            m_Registry.GetMaterials().Retain(m_Registry.GetMaterials().Find(DEFAULT_MATERIAL_NAME));
+            m_Registry.GetMaterials().Retain(m_Registry.GetMaterials().Find(MISSING_MATERIAL_NAME));
+            meshes.Retain(meshes.Find(DEFAULT_MESH_CUBE_NAME));
+            meshes.Retain(meshes.Find(DEFAULT_MESH_QUAD_NAME));
+            meshes.Retain(meshes.Find(DEFAULT_MESH_SPHERE_NAME));
         }
 
         std::shared_ptr<Rendering::Material> ResourceManager::GetDefaultMaterial()
         {
-            return m_Materials[DEFAULT_MATERIAL_NAME];
+            return m_Registry.GetMaterials().Get(DEFAULT_MATERIAL_NAME);
         }
 
         std::shared_ptr<Rendering::Shader> ResourceManager::GetDefaultShader()
         {
-            return m_Shaders[DEFAULT_SHADER_NAME];
+            return m_Registry.GetShaders().Get(DEFAULT_SHADER_NAME);
         }
 
         std::shared_ptr<Rendering::Mesh> ResourceManager::GetDefaultCube()
         {
-            return m_Meshes[DEFAULT_MESH_CUBE_NAME];
+            return m_Registry.GetMeshes().Get(DEFAULT_MESH_CUBE_NAME);
         }
 
         std::shared_ptr<Rendering::Mesh> ResourceManager::GetDefaultQuad()
         {
-            return m_Meshes[DEFAULT_MESH_QUAD_NAME];
+            return m_Registry.GetMeshes().Get(DEFAULT_MESH_QUAD_NAME);
         }
 
         std::shared_ptr<Rendering::Mesh> ResourceManager::GetDefaultSphere()
         {
-            return m_Meshes[DEFAULT_MESH_SPHERE_NAME];
+            return m_Registry.GetMeshes().Get(DEFAULT_MESH_SPHERE_NAME);
         }
 
         std::shared_ptr<Rendering::Shader> ResourceManager::LoadShader(const std::string& vertexShaderPath, const std::string& fragShaderPath, const std::string& name)
         {
-            m_Shaders[name] = ShaderResource::LoadShaderFromFile(vertexShaderPath, fragShaderPath);
-    
-            return m_Shaders[name]; 
+            const std::shared_ptr<Rendering::Shader> shader = ShaderResource::LoadShaderFromFile(vertexShaderPath, fragShaderPath);
+            m_Registry.GetShaders().Add(name, shader);
+
+            return shader;
         }
 
         std::shared_ptr<Rendering::Shader> ResourceManager::LoadShader(const std::string& singleFileShaderPath, const std::string& name)
         {
             const std::shared_ptr<Rendering::Shader> shader = ShaderResource::LoadShaderFromFile(singleFileShaderPath);
             shader->SetName(name);
-            m_Shaders[name] = shader;
+            m_Registry.GetShaders().Add(name, shader);
 
             return shader;
         }
 
         std::shared_ptr<Rendering::Shader> ResourceManager::GetOrLoadShader(const std::string& singleFileShaderPath, const std::string& name)
         {
-            if(m_Shaders.find(name) == m_Shaders.end())
+            if(std::shared_ptr<Rendering::Shader> shader = m_Registry.GetShaders().Get(name))
             {
-                return LoadShader(singleFileShaderPath, name);
+                return shader;
             }
 
-            return m_Shaders[name]; 
+            return LoadShader(singleFileShaderPath, name);
         }
 
         std::shared_ptr<Rendering::Shader> ResourceManager::GetShader(const std::string& name)
         {
-            return m_Shaders[name];
+            return m_Registry.GetShaders().Get(name);
         }
 
         std::shared_ptr<Rendering::Material> ResourceManager::CreateMaterial(const std::string& name)
@@ -116,37 +128,45 @@ namespace Glacirer
         {
             std::shared_ptr<Rendering::Material> material = std::make_shared<Rendering::Material>();
             material->SetId(m_NextMaterialID++);
-            material->SetShader(m_Shaders[shaderName]);
+            material->SetShader(m_Registry.GetShaders().Get(shaderName));
             material->SetName(name);
 
-            m_Materials[name] = material;
+            m_Registry.GetMaterials().Add(name, material);
 
             return material;
         }
 
         std::shared_ptr<Rendering::Material> ResourceManager::GetOrCreateMaterial(const std::string& name, const std::string& shaderName)
         {
-            if(m_Materials.find(name) == m_Materials.end())
+            if(std::shared_ptr<Rendering::Material> material = m_Registry.GetMaterials().Get(name))
             {
-                return CreateMaterial(name, shaderName);
+                return material;
             }
 
-            return m_Materials[name];
+            return CreateMaterial(name, shaderName);
         }
 
         std::shared_ptr<Rendering::Material> ResourceManager::GetMaterial(const std::string& name)
         {
-            return m_Materials[name];
+            return m_Registry.GetMaterials().Get(name);
         }
 
         void ResourceManager::UnloadMaterial(const std::string& name)
         {
-            m_Materials.erase(name);
+            m_Registry.GetMaterials().Remove(name);
         }
 
-        const std::unordered_map<std::string, std::shared_ptr<Rendering::Material>>& ResourceManager::GetAllMaterials()
+        std::vector<std::shared_ptr<Rendering::Material>> ResourceManager::GetAllMaterials()
         {
-            return m_Materials;
+            std::vector<std::shared_ptr<Rendering::Material>> materials{};
+            materials.reserve(m_Registry.GetMaterials().GetTotalResources());
+
+            m_Registry.GetMaterials().ForEach([&materials](const std::string&, const std::shared_ptr<Rendering::Material>& material)
+            {
+                materials.push_back(material);
+            });
+
+            return materials;
         }
 
         unsigned int ResourceManager::GetNextMaterialId()
@@ -156,89 +176,187 @@ namespace Glacirer
 
         std::shared_ptr<Rendering::Texture> ResourceManager::LoadTexture(const std::string& filePath, const std::string& name, const Rendering::TextureSettings& settings, bool bFlipVertically)
         {
-            std::shared_ptr<Rendering::Texture> texture = TextureResource::LoadTextureFromFile(filePath, settings, bFlipVertically);
+            std::shared_ptr<Rendering::Texture> texture = settings.bStream ? TextureResource::LoadStreamedTextureFromFile(filePath, settings, bFlipVertically, GetTextureStreamer()) : nullptr;
+
+            if(!texture)
+            {
+                texture = TextureResource::LoadTextureFromFile(filePath, settings, bFlipVertically);
+            }
+
             texture->SetName(name);
-    
-            m_Textures[name] = texture; 
+
+            m_Registry.GetTextures().Add(name, texture);
 
             return texture;
         }
 
         std::shared_ptr<Rendering::Texture> ResourceManager::GetOrLoadTexture(const std::string& filePath, const std::string& name, const Rendering::TextureSettings& settings, bool bFlipVertically)
         {
-            if(m_Textures.find(name) == m_Textures.end())
+            if(std::shared_ptr<Rendering::Texture> texture = m_Registry.GetTextures().Get(name))
             {
-                return LoadTexture(filePath, name, settings, bFlipVertically);
+                return texture;
             }
 
-            return m_Textures[name];
+            return LoadTexture(filePath, name, settings, bFlipVertically);
         }
 
         std::shared_ptr<Rendering::Texture> ResourceManager::GetTexture(const std::string& name)
         {
-            return m_Textures[name];
+            return m_Registry.GetTextures().Get(name);
         }
 
         std::shared_ptr<Rendering::Cubemap> ResourceManager::LoadCubemap(const Rendering::CubemapLoadSettings& loadSettings, const std::string& name)
         {
-            std::shared_ptr<Rendering::Cubemap> cubemap = TextureResource::LoadCubemapFromFile(loadSettings);
+            std::shared_ptr<Rendering::Cubemap> cubemap = TextureResource::LoadCubemapFromFile(loadSettings, GetAsyncLoader().GetWorkerPool());
             cubemap->SetName(name);
 
-            m_Cubemaps[name] = cubemap;
+            m_Registry.GetCubemaps().Add(name, cubemap);
 
             return cubemap;
         }
 
         std::shared_ptr<Rendering::Cubemap> ResourceManager::GetOrLoadCubemap(const Rendering::CubemapLoadSettings& loadSettings, const std::string& name)
         {
-            if(m_Cubemaps.find(name) == m_Cubemaps.end())
+            if(std::shared_ptr<Rendering::Cubemap> cubemap = m_Registry.GetCubemaps().Get(name))
             {
-                return LoadCubemap(loadSettings, name);
+                return cubemap;
             }
 
-            return m_Cubemaps[name];
+            return LoadCubemap(loadSettings, name);
         }
 
         std::shared_ptr<Rendering::Cubemap> ResourceManager::GetCubemap(const std::string& name)
         {
-            return m_Cubemaps[name];
+            return m_Registry.GetCubemaps().Get(name);
+        }
+
+        std::shared_ptr<Rendering::Texture> ResourceManager::LoadTextureAsync(const std::string& filePath, const std::string& name, const Rendering::TextureSettings& settings, bool bFlipVertically)
+        {
+            std::shared_ptr<Rendering::Texture> texture = GetAsyncLoader().LoadTexture(filePath, settings, bFlipVertically);
+            texture->SetName(name);
+
+            m_Registry.GetTextures().Add(name, texture);
+
+            return texture;
+        }
+
+        std::shared_ptr<Rendering::Cubemap> ResourceManager::LoadCubemapAsync(const Rendering::CubemapLoadSettings& loadSettings, const std::string& name)
+        {
+            std::shared_ptr<Rendering::Cubemap> cubemap = GetAsyncLoader().LoadCubemap(loadSettings);
+            cubemap->SetName(name);
+
+            m_Registry.GetCubemaps().Add(name, cubemap);
+
+            return cubemap;
+        }
+
+        std::shared_ptr<Rendering::ModelData> ResourceManager::LoadModelAsync(const std::string& filePath, const std::string& name)
+        {
+            const std::shared_ptr<Rendering::ModelData> modelData = GetAsyncLoader().LoadModel(filePath);
+            m_Registry.GetModels().Add(name, modelData);
+
+            return modelData;
+        }
+
+        void ResourceManager::ProcessAsyncLoads()
+        {
+            if(m_AsyncLoader)
+            {
+                m_AsyncLoader->ProcessUploads();
+            }
+        }
+
+        void ResourceManager::SetAsyncUploadBudget(const AsyncUploadBudget& budget)
+        {
+            GetAsyncLoader().SetUploadBudget(budget);
+        }
+
+        AsyncUploadBudget ResourceManager::GetAsyncUploadBudget()
+        {
+            return GetAsyncLoader().GetUploadBudget();
+        }
+
+        unsigned int ResourceManager::GetTotalPendingAsyncLoads()
+        {
+            return m_AsyncLoader ? m_AsyncLoader->GetTotalPendingLoads() : 0;
+        }
+
+        void ResourceManager::UpdateTextureStreaming()
+        {
+            if(m_TextureStreamer)
+            {
+                m_TextureStreamer->Update();
+            }
+        }
+
+        TextureStreamer& ResourceManager::GetTextureStreamer()
+        {
+            if(!m_TextureStreamer)
+            {
+                m_TextureStreamer = std::make_unique<TextureStreamer>();
+            }
+
+            return *m_TextureStreamer;
+        }
+
+        // Released by UnloadAll, recreated with a new texture streamer by the next load (e.g. when loading another scene)
+        AsyncResourceLoader& ResourceManager::GetAsyncLoader()
+        {
+            if(!m_AsyncLoader)
+            {
+                m_AsyncLoader = std::make_unique<AsyncResourceLoader>(GetTextureStreamer());
+            }
+
+            return *m_AsyncLoader;
         }
 
         std::shared_ptr<Rendering::Mesh> ResourceManager::GetMesh(const std::string& name)
         {
-            return m_Meshes[name];
+            return m_Registry.GetMeshes().Get(name);
         }
 
         std::shared_ptr<Rendering::ModelData> ResourceManager::LoadModel(const std::string& filePath, const std::string& name)
         {
-            m_Models[name] = MeshResource::LoadModelFromFile(filePath);
+            const std::shared_ptr<Rendering::ModelData> modelData = MeshResource::LoadModelFromFile(filePath);
+            m_Registry.GetModels().Add(name, modelData);
 
-            return m_Models[name];
+            return modelData;
         }
 
         std::shared_ptr<Rendering::ModelData> ResourceManager::GetOrLoadModel(const std::string& filePath, const std::string& name)
         {
-            if(m_Models.find(name) == m_Models.end())
+            if(std::shared_ptr<Rendering::ModelData> modelData = m_Registry.GetModels().Get(name))
             {
-                return LoadModel(filePath, name);
+                return modelData;
             }
 
-            return m_Models[name];
+            return LoadModel(filePath, name);
         }
 
         std::shared_ptr<Rendering::ModelData> ResourceManager::GetModel(const std::string& name)
         {
-            return m_Models[name];
+            return m_Registry.GetModels().Get(name);
+        }
+
+        void ResourceManager::UpdateResources()
+        {
+            m_Registry.Update();
+            ShaderCache::WriteCompiledShaders();
+        }
+
+        ResourceRegistry& ResourceManager::GetRegistry()
+        {
+            return m_Registry;
         }
 
         void ResourceManager::UnloadAll()
         {
-            m_Shaders.clear();
-            m_Meshes.clear();
-            m_Materials.clear();
-            m_Textures.clear();
-            m_Models.clear();
-            m_Cubemaps.clear();
+            // Pending loads hold references to resources below and workers may still be writing into them.
+            // Loader goes first, it keeps a reference to the texture streamer
+            m_AsyncLoader.reset();
+            m_TextureStreamer.reset();
+
+            m_Registry.Clear();
 
             m_NextMaterialID = 0;
         }
@@ -0,0 +1,48 @@
+#include "Resources/ResourceMemory.h"
+
+#include "Rendering/Cubemap.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/ModelData.h"
+#include "Rendering/Texture.h"
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        ResourceMemory GetResourceMemory(const Rendering::Cubemap& cubemap)
+        {
+            return ResourceMemory{0, cubemap.GetGpuMemory()};
+        }
+
+        ResourceMemory GetResourceMemory(const Rendering::Material&)
+        {
+            return ResourceMemory{};
+        }
+
+        ResourceMemory GetResourceMemory(const Rendering::Mesh& mesh)
+        {
+            return ResourceMemory{mesh.GetCpuMemory(), mesh.GetGpuMemory()};
+        }
+
+        ResourceMemory GetResourceMemory(const Rendering::ModelData& modelData)
+        {
+            ResourceMemory memory{};
+            for(const std::shared_ptr<Rendering::Mesh>& mesh : modelData.GetMeshes())
+            {
+                memory += GetResourceMemory(*mesh);
+            }
+
+            return memory;
+        }
+
+        ResourceMemory GetResourceMemory(const Rendering::Shader&)
+        {
+            return ResourceMemory{};
+        }
+
+        ResourceMemory GetResourceMemory(const Rendering::Texture& texture)
+        {
+            return ResourceMemory{0, texture.GetGpuMemory()};
+        }
+    }
+}
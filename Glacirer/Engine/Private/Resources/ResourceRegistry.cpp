@@ -0,0 +1,41 @@
+#include "Resources/ResourceRegistry.h"
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        void ResourceRegistry::Update()
+        {
+            m_Materials.Update();
+            m_Models.Update();
+            m_Meshes.Update();
+            m_Textures.Update();
+            m_Cubemaps.Update();
+            m_Shaders.Update();
+        }
+
+        void ResourceRegistry::Clear()
+        {
+            // Materials and models reference the rest
+            m_Materials.Clear();
+            m_Models.Clear();
+            m_Meshes.Clear();
+            m_Textures.Clear();
+            m_Cubemaps.Clear();
+            m_Shaders.Clear();
+        }
+
+        ResourceMemory ResourceRegistry::GetTotalMemory() const
+        {
+            ResourceMemory memory{};
+            memory += m_Shaders.GetTotalMemory();
+            memory += m_Meshes.GetTotalMemory();
+            memory += m_Materials.GetTotalMemory();
+            memory += m_Textures.GetTotalMemory();
+            memory += m_Models.GetTotalMemory();
+            memory += m_Cubemaps.GetTotalMemory();
+
+            return memory;
+        }
+    }
+}
@@ -0,0 +1,205 @@
+#include "Resources/ShaderCache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#include "Rendering/OpenGLCore.h"
+#include "Rendering/Shader.h"
+#include "Resources/CacheFile.h"
+#include "Resources/MappedFile.h"
+
+namespace
+{
+    constexpr char SHADER_CACHE_MAGIC[4] = { 'G', 'P', 'R', 'G' };
+
+    // Followed by the binary
+    struct ShaderCacheHeader
+    {
+        char Magic[4];
+        uint32_t CacheVersion;
+        uint64_t CacheKey;
+        uint32_t BinaryFormat;
+        uint32_t BinarySize;
+    };
+
+    static_assert(sizeof(ShaderCacheHeader) == 24, "Shader cache header layout changed, bump CACHE_VERSION");
+
+    uint64_t HashString(const std::string& string, uint64_t hash)
+    {
+        // Size first so moving text between stages changes the key
+        const uint64_t size = string.size();
+        hash = Glacirer::Resources::CacheFile::HashData(&size, sizeof(size), hash);
+
+        return Glacirer::Resources::CacheFile::HashData(string.data(), string.size(), hash);
+    }
+
+    uint64_t HashGLString(GLenum name, uint64_t hash)
+    {
+        const char* value = reinterpret_cast<const char*>(glGetString(name));
+
+        return HashString(value ? value : "", hash);
+    }
+
+    // Parent directory has to exist, succeeds if the directory already does
+    bool MakeDirectory(const std::string& directoryPath)
+    {
+#ifdef _WIN32
+        return _mkdir(directoryPath.c_str()) == 0 || errno == EEXIST;
+#else
+        return mkdir(directoryPath.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+    }
+}
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        const std::string ShaderCache::CACHE_DIRECTORY = "Intermediate/ShaderCache/";
+        std::vector<ShaderCache::PendingWrite> ShaderCache::m_PendingWrites{};
+        uint64_t ShaderCache::m_DriverHash{0};
+
+        void ShaderCache::Initialize()
+        {
+            uint64_t hash = CacheFile::HASH_SEED;
+            hash = HashGLString(GL_VENDOR, hash);
+            hash = HashGLString(GL_RENDERER, hash);
+            m_DriverHash = HashGLString(GL_VERSION, hash);
+
+            if(!MakeDirectory("Intermediate") || !MakeDirectory(CACHE_DIRECTORY))
+            {
+                std::cout << "ERROR::SHADER_CACHE: Failed to create " << CACHE_DIRECTORY << "\n";
+            }
+        }
+
+        // Source path is flattened into the file name, so shaders with the same name in different directories don't collide
+        std::string ShaderCache::GetCachePath(const std::string& sourceFilePath, uint32_t variantMask)
+        {
+            std::string fileName = sourceFilePath;
+            std::replace(fileName.begin(), fileName.end(), '/', '_');
+            std::replace(fileName.begin(), fileName.end(), '\\', '_');
+            std::replace(fileName.begin(), fileName.end(), ':', '_');
+
+            std::ostringstream cachePath;
+            cachePath << CACHE_DIRECTORY << fileName;
+
+            if(variantMask != 0)
+            {
+                cachePath << "." << std::hex << variantMask;
+            }
+
+            cachePath << ".progcache";
+
+            return cachePath.str();
+        }
+
+        uint64_t ShaderCache::GetCacheKey(const Rendering::ShaderSource& source)
+        {
+            assert(m_DriverHash != 0 && "ShaderCache::Initialize has to be called first");
+
+            uint64_t hash = m_DriverHash;
+            hash = HashString(source.VertexShader, hash);
+            hash = HashString(source.FragmentShader, hash);
+            hash = HashString(source.GeometryShader, hash);
+
+            return hash;
+        }
+
+        bool ShaderCache::Write(const std::string& cachePath, uint64_t cacheKey, const Rendering::ShaderBinary& binary)
+        {
+            std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+            if(!file)
+            {
+                return false;
+            }
+
+            ShaderCacheHeader header{};
+            std::memcpy(header.Magic, SHADER_CACHE_MAGIC, sizeof(header.Magic));
+            header.CacheVersion = CACHE_VERSION;
+            header.CacheKey = cacheKey;
+            header.BinaryFormat = binary.Format;
+            header.BinarySize = static_cast<uint32_t>(binary.Data.size());
+            CacheFile::WritePadded(file, &header, sizeof(header));
+            CacheFile::WritePadded(file, binary.Data.data(), binary.Data.size());
+
+            return static_cast<bool>(file);
+        }
+
+        bool ShaderCache::TryRead(const std::string& cachePath, uint64_t cacheKey, Rendering::ShaderBinary& outBinary)
+        {
+            MappedFile file{};
+            if(!file.Open(cachePath))
+            {
+                return false;
+            }
+
+            CacheFileReader reader(file.GetData(), file.GetSize());
+
+            const ShaderCacheHeader* header = reader.Read<ShaderCacheHeader>();
+            if(!header
+                || std::memcmp(header->Magic, SHADER_CACHE_MAGIC, sizeof(header->Magic)) != 0
+                || header->CacheVersion != CACHE_VERSION
+                || header->CacheKey != cacheKey)
+            {
+                return false;
+            }
+
+            const unsigned char* data = static_cast<const unsigned char*>(reader.ReadPadded(header->BinarySize));
+            if(!data || header->BinarySize == 0 || !reader.IsAtEnd())
+            {
+                std::cout << "ERROR::SHADER_CACHE: Corrupted cache file " << cachePath << "\n";
+                return false;
+            }
+
+            outBinary.Format = header->BinaryFormat;
+            outBinary.Data.assign(data, data + header->BinarySize);
+
+            return true;
+        }
+
+        void ShaderCache::QueueWrite(const std::shared_ptr<Rendering::Shader>& shader, const std::string& cachePath, uint64_t cacheKey)
+        {
+            m_PendingWrites.push_back(PendingWrite{shader, cachePath, cacheKey});
+        }
+
+        void ShaderCache::WriteCompiledShaders()
+        {
+            auto iterator = std::remove_if(m_PendingWrites.begin(), m_PendingWrites.end(), [](const PendingWrite& pendingWrite)
+            {
+                const std::shared_ptr<Rendering::Shader> shader = pendingWrite.Shader.lock();
+
+                if(!shader)
+                {
+                    return true;
+                }
+
+                if(!shader->IsCompilationComplete())
+                {
+                    return false;
+                }
+
+                // Failed shaders aren't cached so their errors show up again on the next run
+                Rendering::ShaderBinary binary{};
+                if(shader->GetBinary(binary))
+                {
+                    Write(pendingWrite.CachePath, pendingWrite.CacheKey, binary);
+                }
+
+                return true;
+            });
+
+            m_PendingWrites.erase(iterator, m_PendingWrites.end());
+        }
+    }
+}
@@ -0,0 +1,421 @@
+#include "Resources/ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_set>
+
+#include "Rendering/RenderingConstants.h"
+
+namespace
+{
+    constexpr unsigned int MAX_INCLUDE_DEPTH = 16;
+    constexpr int NO_STAGE = -1;
+
+    enum class TokenType : uint8_t
+    {
+        Identifier,
+        Number,
+        String,
+        Symbol,
+        End
+    };
+
+    struct Token
+    {
+        TokenType Type{TokenType::End};
+        std::string Text{};
+    };
+
+    // Splits one line into GLSL tokens, skipping comments. Block comments can span lines,
+    // so whether one is open is kept by the caller between lines
+    class LineTokenizer
+    {
+    public:
+
+        LineTokenizer(const std::string& line, bool& bIsInBlockComment)
+            : m_Line(line), bIsInBlockComment(bIsInBlockComment)
+        { }
+
+        Token Next()
+        {
+            SkipWhitespaceAndComments();
+
+            if(m_Position >= m_Line.size())
+            {
+                return Token{};
+            }
+
+            const size_t start = m_Position;
+            const char character = m_Line[m_Position];
+
+            if(IsIdentifierCharacter(character) && !std::isdigit(static_cast<unsigned char>(character)))
+            {
+                while(m_Position < m_Line.size() && IsIdentifierCharacter(m_Line[m_Position]))
+                {
+                    m_Position++;
+                }
+
+                return Token{TokenType::Identifier, m_Line.substr(start, m_Position - start)};
+            }
+
+            if(std::isdigit(static_cast<unsigned char>(character)))
+            {
+                while(m_Position < m_Line.size() && (IsIdentifierCharacter(m_Line[m_Position]) || m_Line[m_Position] == '.'))
+                {
+                    m_Position++;
+                }
+
+                return Token{TokenType::Number, m_Line.substr(start, m_Position - start)};
+            }
+
+            if(character == '"')
+            {
+                const size_t end = std::min(m_Line.find('"', start + 1), m_Line.size());
+                m_Position = std::min(end + 1, m_Line.size());
+
+                return Token{TokenType::String, m_Line.substr(start + 1, end - start - 1)};
+            }
+
+            m_Position++;
+
+            return Token{TokenType::Symbol, std::string(1, character)};
+        }
+
+        // Reads the rest of the line so a block comment opened on it is tracked
+        void SkipToEnd()
+        {
+            while(Next().Type != TokenType::End)
+            { }
+        }
+
+    private:
+
+        const std::string& m_Line;
+        bool& bIsInBlockComment;
+        size_t m_Position{0};
+
+        void SkipWhitespaceAndComments()
+        {
+            while(m_Position < m_Line.size())
+            {
+                if(bIsInBlockComment)
+                {
+                    const size_t end = m_Line.find("*/", m_Position);
+                    if(end == std::string::npos)
+                    {
+                        m_Position = m_Line.size();
+                        return;
+                    }
+
+                    m_Position = end + 2;
+                    bIsInBlockComment = false;
+                }
+                else if(std::isspace(static_cast<unsigned char>(m_Line[m_Position])))
+                {
+                    m_Position++;
+                }
+                else if(m_Line.compare(m_Position, 2, "//") == 0)
+                {
+                    m_Position = m_Line.size();
+                }
+                else if(m_Line.compare(m_Position, 2, "/*") == 0)
+                {
+                    m_Position += 2;
+                    bIsInBlockComment = true;
+                }
+                else
+                {
+                    return;
+                }
+            }
+        }
+
+        static bool IsIdentifierCharacter(char character)
+        {
+            return std::isalnum(static_cast<unsigned char>(character)) || character == '_';
+        }
+    };
+
+    struct PreprocessContext
+    {
+        Glacirer::Resources::PreprocessedShader& Shader;
+        int Stage{NO_STAGE};
+        std::unordered_set<std::string> IncludedFiles[Glacirer::Resources::TOTAL_SHADER_STAGES]{};
+    };
+
+    std::string GetDirectory(const std::string& filePath)
+    {
+        const size_t separator = filePath.find_last_of("/\\");
+
+        return separator == std::string::npos ? std::string{} : filePath.substr(0, separator + 1);
+    }
+
+    void AddUnique(std::vector<std::string>& names, std::string&& name)
+    {
+        if(std::find(names.begin(), names.end(), name) == names.end())
+        {
+            names.push_back(std::move(name));
+        }
+    }
+
+    // "uniform <type> <name>;", other declarations (arrays, blocks) aren't material properties
+    void ParseUniform(LineTokenizer& tokenizer, Glacirer::Rendering::ShaderProperties& properties)
+    {
+        Token type = tokenizer.Next();
+        Token name = tokenizer.Next();
+        const Token end = tokenizer.Next();
+
+        if(type.Type != TokenType::Identifier || name.Type != TokenType::Identifier || end.Text != ";")
+        {
+            return;
+        }
+
+        if(type.Text == "sampler2D")
+        {
+            AddUnique(properties.Textures, std::move(name.Text));
+        }
+        else if(type.Text == "vec4")
+        {
+            AddUnique(properties.Colors, std::move(name.Text));
+        }
+        else if(type.Text == "int" && name.Text != "u_RenderingMode")
+        {
+            AddUnique(properties.Integers, std::move(name.Text));
+        }
+        else if(type.Text == "float")
+        {
+            AddUnique(properties.Floats, std::move(name.Text));
+        }
+    }
+
+    bool ParseStage(const Token& stageName, int& outStage)
+    {
+        if(stageName.Text == "vertex")
+        {
+            outStage = static_cast<int>(Glacirer::Resources::ShaderStage::Vertex);
+        }
+        else if(stageName.Text == "fragment")
+        {
+            outStage = static_cast<int>(Glacirer::Resources::ShaderStage::Fragment);
+        }
+        else if(stageName.Text == "geometry")
+        {
+            outStage = static_cast<int>(Glacirer::Resources::ShaderStage::Geometry);
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ProcessFile(PreprocessContext& context, const std::string& filePath, unsigned int depth);
+
+    // Returns false on errors, bOutKeepLine is false for directives consumed by the preprocessor
+    bool ProcessDirective(PreprocessContext& context, LineTokenizer& tokenizer, const std::string& filePath, unsigned int depth, bool& bOutKeepLine)
+    {
+        const Token directive = tokenizer.Next();
+
+        if(directive.Text == "shader")
+        {
+            bOutKeepLine = false;
+
+            if(!ParseStage(tokenizer.Next(), context.Stage))
+            {
+                std::cout << "ERROR::SHADER_PREPROCESSOR: Unknown stage after #shader in " << filePath << "\n";
+                return false;
+            }
+        }
+        else if(directive.Text == "include")
+        {
+            bOutKeepLine = false;
+
+            const Token includedFile = tokenizer.Next();
+
+            if(includedFile.Type != TokenType::String || context.Stage == NO_STAGE)
+            {
+                std::cout << "ERROR::SHADER_PREPROCESSOR: #include needs a quoted path inside a stage in " << filePath << "\n";
+                return false;
+            }
+
+            if(depth >= MAX_INCLUDE_DEPTH)
+            {
+                std::cout << "ERROR::SHADER_PREPROCESSOR: Includes nested too deep in " << filePath << "\n";
+                return false;
+            }
+
+            const std::string includedFilePath = GetDirectory(filePath) + includedFile.Text;
+
+            if(context.IncludedFiles[context.Stage].insert(includedFilePath).second)
+            {
+                const int includingStage = context.Stage;
+
+                if(!ProcessFile(context, includedFilePath, depth + 1))
+                {
+                    return false;
+                }
+
+                context.Stage = includingStage;
+            }
+        }
+        else if(directive.Text == "pragma")
+        {
+            const Token pragma = tokenizer.Next();
+
+            if(pragma.Text == "variant")
+            {
+                bOutKeepLine = false;
+
+                Token keyword = tokenizer.Next();
+                std::vector<std::string>& keywords = context.Shader.VariantKeywords;
+
+                if(keyword.Type != TokenType::Identifier)
+                {
+                    std::cout << "ERROR::SHADER_PREPROCESSOR: Missing keyword after #pragma variant in " << filePath << "\n";
+                    return false;
+                }
+
+                if(std::find(keywords.begin(), keywords.end(), keyword.Text) == keywords.end())
+                {
+                    if(keywords.size() >= Glacirer::Resources::ShaderPreprocessor::MAX_VARIANT_KEYWORDS)
+                    {
+                        std::cout << "ERROR::SHADER_PREPROCESSOR: Too many variant keywords in " << filePath << "\n";
+                        return false;
+                    }
+
+                    keywords.push_back(std::move(keyword.Text));
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool ProcessFile(PreprocessContext& context, const std::string& filePath, unsigned int depth)
+    {
+        std::ifstream file(filePath);
+
+        if(!file)
+        {
+            std::cout << "ERROR::SHADER_PREPROCESSOR: Failed to open " << filePath << "\n";
+            return false;
+        }
+
+        std::string line;
+        bool bIsInBlockComment = false;
+
+        while(std::getline(file, line))
+        {
+            LineTokenizer tokenizer(line, bIsInBlockComment);
+            const Token firstToken = tokenizer.Next();
+            bool bKeepLine = true;
+
+            if(firstToken.Text == "#")
+            {
+                if(!ProcessDirective(context, tokenizer, filePath, depth, bKeepLine))
+                {
+                    return false;
+                }
+            }
+            else if(firstToken.Text == "uniform")
+            {
+                ParseUniform(tokenizer, context.Shader.Properties);
+            }
+
+            tokenizer.SkipToEnd();
+
+            // Lines before the first stage of a single file shader are dropped
+            if(bKeepLine && context.Stage != NO_STAGE)
+            {
+                std::string& stageSource = context.Shader.Stages[context.Stage];
+                stageSource += line;
+                stageSource += "\n";
+            }
+        }
+
+        return true;
+    }
+
+    std::string GetEngineDefines()
+    {
+        std::ostringstream defines;
+        defines << "#define MAX_SKYBOXES " << Glacirer::Rendering::MAX_SKYBOXES << "\n";
+        defines << "#define MAX_DIRECTIONAL_LIGHTS " << Glacirer::Rendering::MAX_DIRECTIONAL_LIGHTS << "\n";
+        defines << "#define MAX_POINT_LIGHTS " << Glacirer::Rendering::MAX_POINT_LIGHTS << "\n";
+        defines << "#define MAX_SPOT_LIGHTS " << Glacirer::Rendering::MAX_SPOT_LIGHTS << "\n";
+
+        return defines.str();
+    }
+
+    // #version has to stay the first directive
+    std::string InsertAfterVersion(const std::string& stageSource, const std::string& defines)
+    {
+        if(stageSource.empty())
+        {
+            return stageSource;
+        }
+
+        const size_t version = stageSource.find("#version");
+        if(version == std::string::npos)
+        {
+            return defines + stageSource;
+        }
+
+        const size_t lineEnd = stageSource.find('\n', version);
+        if(lineEnd == std::string::npos)
+        {
+            return stageSource + "\n" + defines;
+        }
+
+        std::string source = stageSource;
+        source.insert(lineEnd + 1, defines);
+
+        return source;
+    }
+}
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        bool ShaderPreprocessor::PreprocessFile(const std::string& filePath, PreprocessedShader& outShader)
+        {
+            PreprocessContext context{outShader};
+
+            return ProcessFile(context, filePath, 0);
+        }
+
+        bool ShaderPreprocessor::PreprocessStageFile(const std::string& filePath, ShaderStage stage, PreprocessedShader& outShader)
+        {
+            PreprocessContext context{outShader};
+            context.Stage = static_cast<int>(stage);
+
+            return ProcessFile(context, filePath, 0);
+        }
+
+        Rendering::ShaderSource ShaderPreprocessor::GetVariantSource(const PreprocessedShader& shader, uint32_t variantMask)
+        {
+            std::string defines = GetEngineDefines();
+
+            for(size_t i = 0; i < shader.VariantKeywords.size(); i++)
+            {
+                if(variantMask & (1u << i))
+                {
+                    defines += "#define " + shader.VariantKeywords[i] + "\n";
+                }
+            }
+
+            Rendering::ShaderSource source{};
+            source.VertexShader = InsertAfterVersion(shader.Stages[static_cast<int>(ShaderStage::Vertex)], defines);
+            source.FragmentShader = InsertAfterVersion(shader.Stages[static_cast<int>(ShaderStage::Fragment)], defines);
+            source.GeometryShader = InsertAfterVersion(shader.Stages[static_cast<int>(ShaderStage::Geometry)], defines);
+            source.Properties = shader.Properties;
+
+            return source;
+        }
+    }
+}
@@ -1,11 +1,10 @@
 #include "Resources/ShaderResource.h"
 
-#include <fstream>
 #include <iostream>
-#include <regex>
-#include <sstream>
 
 #include "Rendering/Shader.h"
+#include "Resources/ShaderCache.h"
+#include "Resources/ShaderPreprocessor.h"
 
 namespace Glacirer
 {
@@ -13,104 +12,71 @@ namespace Glacirer
     {
         std::shared_ptr<Rendering::Shader> ShaderResource::LoadShaderFromFile(const std::string& vertexShaderPath, const std::string& fragShaderPath)
         {
-            Rendering::ShaderSource source{};
+            PreprocessedShader preprocessedShader{};
 
-            try
+            if(!ShaderPreprocessor::PreprocessStageFile(vertexShaderPath, ShaderStage::Vertex, preprocessedShader)
+                || !ShaderPreprocessor::PreprocessStageFile(fragShaderPath, ShaderStage::Fragment, preprocessedShader))
             {
-                std::ifstream vertexShaderFile{vertexShaderPath};
-                std::ifstream fragShaderFile{fragShaderPath};
-
-                std::stringstream vertexStream;
-                std::stringstream fragStream;
+                std::cout << "ERROR::SHADER: Failed to read shader files " << vertexShaderPath << " | " << fragShaderPath << "\n";
+            }
 
-                vertexStream << vertexShaderFile.rdbuf();
-                fragStream << fragShaderFile.rdbuf();
+            return CreateShaderWithVariants(std::move(preprocessedShader), vertexShaderPath);
+        }
 
-                vertexShaderFile.close();
-                fragShaderFile.close();
+        std::shared_ptr<Rendering::Shader> ShaderResource::LoadShaderFromFile(const std::string& singleFileShaderPath)
+        {
+            PreprocessedShader preprocessedShader{};
 
-                source.VertexShader = vertexStream.str();
-                source.FragmentShader = fragStream.str();
-            }
-            catch (const std::exception& e)
+            if(!ShaderPreprocessor::PreprocessFile(singleFileShaderPath, preprocessedShader))
             {
-                std::cout << "ERROR::SHADER: Failed to read shader files" << vertexShaderPath << " | " << fragShaderPath;
+                std::cout << "ERROR::SHADER: Failed to read shader file " << singleFileShaderPath << "\n";
             }
 
-            return std::make_shared<Rendering::Shader>(source);
+            return CreateShaderWithVariants(std::move(preprocessedShader), singleFileShaderPath);
         }
 
-        std::shared_ptr<Rendering::Shader> ShaderResource::LoadShaderFromFile(const std::string& singleFileShaderPath)
+        std::shared_ptr<Rendering::Shader> ShaderResource::CreateShaderWithVariants(PreprocessedShader&& preprocessedShader, const std::string& sourceFilePath)
         {
-            Rendering::ShaderSource source{};
-            std::regex uniformRegex(R"(uniform\s+(\w+)\s+(\w+);)");
+            // Kept alive by the factory, variants are built from it on demand
+            const std::shared_ptr<const PreprocessedShader> sharedPreprocessedShader = std::make_shared<const PreprocessedShader>(std::move(preprocessedShader));
 
-            std::ifstream Stream(singleFileShaderPath);
+            std::shared_ptr<Rendering::Shader> shader = CreateShader(ShaderPreprocessor::GetVariantSource(*sharedPreprocessedShader, 0), ShaderCache::GetCachePath(sourceFilePath));
 
-            enum class EShaderType
+            if(!sharedPreprocessedShader->VariantKeywords.empty())
             {
-                None = -1,
-                Vertex = 0,
-                Fragment = 1,
-                Geometry = 2
-            };
+                shader->SetVariants(sharedPreprocessedShader->VariantKeywords, [sharedPreprocessedShader, sourceFilePath](uint32_t variantMask)
+                {
+                    return CreateShader(ShaderPreprocessor::GetVariantSource(*sharedPreprocessedShader, variantMask), ShaderCache::GetCachePath(sourceFilePath, variantMask));
+                });
+            }
 
-            std::string line;
-            std::stringstream ss[3]; // Vertex shader [0], Fragment [1] and Geometry [2]
-            EShaderType type = EShaderType::None;
+            return shader;
+        }
 
-            while(getline(Stream, line))
+        std::shared_ptr<Rendering::Shader> ShaderResource::CreateShader(const Rendering::ShaderSource& source, const std::string& cachePath)
+        {
+            if(!Rendering::Shader::SupportsProgramBinaries())
             {
-                if(line.find(SHADER_TYPE_KEYWORD) != std::string::npos)
-                {
-                    if(line.find(VERTEX_SHADER_KEYWORD) != std::string::npos)
-                    {
-                        type = EShaderType::Vertex;
-                    }
-                    else if(line.find(FRAGMENT_SHADER_KEYWORD) != std::string::npos)
-                    {
-                        type = EShaderType::Fragment;
-                    }
-                    else if(line.find(GEOMETRY_SHADER_KEYWORD) != std::string::npos)
-                    {
-                        type = EShaderType::Geometry;
-                    }
-                }
-                else
+                return std::make_shared<Rendering::Shader>(source);
+            }
+
+            const uint64_t cacheKey = ShaderCache::GetCacheKey(source);
+
+            Rendering::ShaderBinary binary{};
+            if(ShaderCache::TryRead(cachePath, cacheKey, binary))
+            {
+                std::shared_ptr<Rendering::Shader> shader = std::make_shared<Rendering::Shader>(binary, source.Properties);
+
+                if(shader->IsLinked())
                 {
-                    std::smatch match;
-                    if(std::regex_match(line, match, uniformRegex))
-                    {
-                        std::string uniformType = match[1].str();
-                        std::string uniformName = match[2].str();
-
-                        if (uniformType == "sampler2D")
-                        {
-                            source.Properties.AddTexture(std::move(uniformName));
-                        }
-                        else if(uniformType == "vec4")
-                        {
-                            source.Properties.AddColor(std::move(uniformName));
-                        }
-                        else if(uniformType == "int" && uniformName != "u_RenderingMode")
-                        {
-                            source.Properties.AddInt(std::move(uniformName));
-                        }
-                        else if(uniformType == "float")
-                        {
-                            source.Properties.AddFloat(std::move(uniformName));
-                        }
-                    }
-                    
-                    ss[static_cast<int>(type)] << line << "\n";
+                    return shader;
                 }
             }
 
-            source.VertexShader = ss[0].str();
-            source.FragmentShader = ss[1].str();
-            source.GeometryShader = ss[2].str();
-    
-            return std::make_shared<Rendering::Shader>(source);
+            std::shared_ptr<Rendering::Shader> shader = std::make_shared<Rendering::Shader>(source);
+            ShaderCache::QueueWrite(shader, cachePath, cacheKey);
+
+            return shader;
         }
     }
 }
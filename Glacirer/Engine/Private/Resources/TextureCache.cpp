@@ -0,0 +1,208 @@
+#include "Resources/TextureCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Rendering/Texture.h"
+#include "Resources/CacheFile.h"
+#include "Resources/MappedFile.h"
+
+namespace
+{
+    constexpr char TEXTURE_CACHE_MAGIC[4] = { 'G', 'T', 'E', 'X' };
+
+    struct TextureCacheHeader
+    {
+        char Magic[4];
+        uint32_t CookerVersion;
+        uint64_t SourceHash;
+        uint32_t CookKey;
+        uint32_t InternalFormat;
+        uint32_t Format;
+        uint32_t Type;
+        uint32_t TotalMips;
+        uint32_t Reserved;
+    };
+
+    // Followed by the mip data, padded to alignment
+    struct TextureCacheMipHeader
+    {
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t DataSize;
+    };
+
+    static_assert(sizeof(TextureCacheHeader) == 40, "Texture cache header layout changed, bump COOKER_VERSION");
+    static_assert(sizeof(TextureCacheMipHeader) == 12, "Texture cache mip header layout changed, bump COOKER_VERSION");
+
+    // Header if the cache is valid for this source and usable on the current GPU, outMips point into the mapping
+    const TextureCacheHeader* ParseTextureCache(
+        const Glacirer::Resources::MappedFile& file,
+        const std::string& cachePath,
+        const uint64_t sourceHash,
+        const uint32_t cookKey,
+        std::vector<Glacirer::Rendering::TextureMip>& outMips)
+    {
+        Glacirer::Resources::CacheFileReader reader(file.GetData(), file.GetSize());
+
+        const TextureCacheHeader* header = reader.Read<TextureCacheHeader>();
+        if(!header
+            || std::memcmp(header->Magic, TEXTURE_CACHE_MAGIC, sizeof(header->Magic)) != 0
+            || header->CookerVersion != Glacirer::Resources::TextureCache::COOKER_VERSION
+            || header->SourceHash != sourceHash
+            || header->CookKey != cookKey)
+        {
+            return nullptr;
+        }
+
+        // Cooked on a GPU with S3TC support, needs to be cooked again uncompressed
+        if(Glacirer::Rendering::Texture::IsCompressedFormat(header->InternalFormat) && !Glacirer::Rendering::Texture::IsCompressedFormatSupported(header->InternalFormat))
+        {
+            return nullptr;
+        }
+
+        outMips.resize(header->TotalMips);
+
+        for(Glacirer::Rendering::TextureMip& mip : outMips)
+        {
+            const TextureCacheMipHeader* mipHeader = reader.Read<TextureCacheMipHeader>();
+            const void* data = mipHeader ? reader.ReadPadded(mipHeader->DataSize) : nullptr;
+
+            if(!data)
+            {
+                std::cout << "ERROR::TEXTURE_CACHE: Corrupted cache file " << cachePath << "\n";
+                return nullptr;
+            }
+
+            mip.Data = data;
+            mip.Size = mipHeader->DataSize;
+            mip.Width = mipHeader->Width;
+            mip.Height = mipHeader->Height;
+        }
+
+        if(outMips.empty() || !reader.IsAtEnd())
+        {
+            std::cout << "ERROR::TEXTURE_CACHE: Corrupted cache file " << cachePath << "\n";
+            return nullptr;
+        }
+
+        return header;
+    }
+}
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        std::string TextureCache::GetCachePath(const std::string& sourceFilePath)
+        {
+            return sourceFilePath + ".texcache";
+        }
+
+        bool TextureCache::Write(const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, const CookedTexture& cookedTexture)
+        {
+            std::ofstream file(cachePath, std::ios::binary | std::ios::trunc);
+            if(!file)
+            {
+                return false;
+            }
+
+            TextureCacheHeader header{};
+            std::memcpy(header.Magic, TEXTURE_CACHE_MAGIC, sizeof(header.Magic));
+            header.CookerVersion = COOKER_VERSION;
+            header.SourceHash = sourceHash;
+            header.CookKey = cookKey;
+            header.InternalFormat = cookedTexture.InternalFormat;
+            header.Format = cookedTexture.Format;
+            header.Type = cookedTexture.Type;
+            header.TotalMips = static_cast<uint32_t>(cookedTexture.Mips.size());
+            CacheFile::WritePadded(file, &header, sizeof(header));
+
+            for(const CookedTextureMip& mip : cookedTexture.Mips)
+            {
+                TextureCacheMipHeader mipHeader{};
+                mipHeader.Width = mip.Width;
+                mipHeader.Height = mip.Height;
+                mipHeader.DataSize = static_cast<uint32_t>(mip.Data.size());
+                CacheFile::WritePadded(file, &mipHeader, sizeof(mipHeader));
+                CacheFile::WritePadded(file, mip.Data.data(), mip.Data.size());
+            }
+
+            return static_cast<bool>(file);
+        }
+
+        std::shared_ptr<Rendering::Texture> TextureCache::TryLoad(const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, const Rendering::TextureSettings& settings)
+        {
+            MappedFile file{};
+            if(!file.Open(cachePath))
+            {
+                return nullptr;
+            }
+
+            std::vector<Rendering::TextureMip> mips{};
+            const TextureCacheHeader* header = ParseTextureCache(file, cachePath, sourceHash, cookKey, mips);
+
+            if(!header)
+            {
+                return nullptr;
+            }
+
+            Rendering::TextureSettings cookedSettings = settings;
+            cookedSettings.InternalFormat = header->InternalFormat;
+            cookedSettings.Format = header->Format;
+            cookedSettings.Type = header->Type;
+
+            return std::make_shared<Rendering::Texture>(mips, cookedSettings);
+        }
+
+        bool TextureCache::TryRead(const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, CookedTexture& outCookedTexture)
+        {
+            MappedFile file{};
+            if(!file.Open(cachePath))
+            {
+                return false;
+            }
+
+            std::vector<Rendering::TextureMip> mips{};
+            const TextureCacheHeader* header = ParseTextureCache(file, cachePath, sourceHash, cookKey, mips);
+
+            if(!header)
+            {
+                return false;
+            }
+
+            outCookedTexture.InternalFormat = header->InternalFormat;
+            outCookedTexture.Format = header->Format;
+            outCookedTexture.Type = header->Type;
+            outCookedTexture.Mips.resize(mips.size());
+
+            for(size_t i = 0; i < mips.size(); i++)
+            {
+                const unsigned char* data = static_cast<const unsigned char*>(mips[i].Data);
+
+                outCookedTexture.Mips[i].Width = mips[i].Width;
+                outCookedTexture.Mips[i].Height = mips[i].Height;
+                outCookedTexture.Mips[i].Data.assign(data, data + mips[i].Size);
+            }
+
+            return true;
+        }
+
+        bool TextureCache::TryMap(const MappedFile& file, const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, CookedTexture& outFormat, std::vector<Rendering::TextureMip>& outMips)
+        {
+            const TextureCacheHeader* header = ParseTextureCache(file, cachePath, sourceHash, cookKey, outMips);
+
+            if(!header)
+            {
+                return false;
+            }
+
+            outFormat.InternalFormat = header->InternalFormat;
+            outFormat.Format = header->Format;
+            outFormat.Type = header->Type;
+
+            return true;
+        }
+    }
+}
@@ -1,9 +1,206 @@
 #include "Resources/TextureResource.h"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <future>
+#include <iostream>
 #include <stb_image/stb_image.h>
+#include <glm/glm.hpp>
 
 #include "Rendering/Cubemap.h"
+#include "Rendering/TextureCompressor.h"
+#include "Resources/CacheFile.h"
+#include "Resources/MappedFile.h"
+#include "Resources/TextureCache.h"
+#include "Resources/TextureStreamer.h"
+#include "Resources/WorkerPool.h"
+
+namespace
+{
+    struct CookedFormat
+    {
+        unsigned int InternalFormat{GL_RGBA8};
+        unsigned int Format{GL_RGBA};
+        unsigned int TotalChannels{4}; // Stored per pixel when uncompressed
+        bool bIsCompressed{false};
+        Glacirer::Rendering::BlockCompression Compression{Glacirer::Rendering::BlockCompression::BC1};
+    };
+
+    CookedFormat SelectCookedFormat(const Glacirer::Rendering::TextureSettings& settings, const bool bUseAlpha)
+    {
+        using Glacirer::Rendering::BlockCompression;
+
+        CookedFormat cookedFormat{};
+        unsigned int compressedFormat = 0;
+
+        switch(settings.Usage)
+        {
+            case Glacirer::Rendering::TextureUsage::Mask:
+                cookedFormat.InternalFormat = GL_R8;
+                cookedFormat.Format = GL_RED;
+                cookedFormat.TotalChannels = 1;
+                cookedFormat.Compression = BlockCompression::BC4;
+                compressedFormat = GL_COMPRESSED_RED_RGTC1;
+                break;
+            case Glacirer::Rendering::TextureUsage::Normal:
+                cookedFormat.InternalFormat = GL_RG8;
+                cookedFormat.Format = GL_RG;
+                cookedFormat.TotalChannels = 2;
+                cookedFormat.Compression = BlockCompression::BC5;
+                compressedFormat = GL_COMPRESSED_RG_RGTC2;
+                break;
+            default:
+                // Alpha is still uploaded (and ignored) without it, keeps rows 4 bytes aligned
+                if(bUseAlpha)
+                {
+                    cookedFormat.InternalFormat = settings.bIsSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+                    cookedFormat.Compression = BlockCompression::BC3;
+                    compressedFormat = settings.bIsSRGB ? GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+                }
+                else
+                {
+                    cookedFormat.InternalFormat = settings.bIsSRGB ? GL_SRGB8 : GL_RGB8;
+                    cookedFormat.Compression = BlockCompression::BC1;
+                    compressedFormat = settings.bIsSRGB ? GL_COMPRESSED_SRGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+                }
+                break;
+        }
+
+        if(settings.bCompress && Glacirer::Rendering::Texture::IsCompressedFormatSupported(compressedFormat))
+        {
+            cookedFormat.InternalFormat = compressedFormat;
+            cookedFormat.bIsCompressed = true;
+        }
+
+        return cookedFormat;
+    }
+
+    const std::array<float, 256>& GetSRGBToLinearTable()
+    {
+        static const std::array<float, 256> table = []()
+        {
+            std::array<float, 256> values{};
+
+            for(int i = 0; i < 256; i++)
+            {
+                const float value = static_cast<float>(i) / 255.f;
+                values[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+            }
+
+            return values;
+        }();
+
+        return table;
+    }
+
+    unsigned char LinearToSRGB(const float value)
+    {
+        const float srgbValue = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+        return static_cast<unsigned char>(glm::clamp(srgbValue, 0.f, 1.f) * 255.f + 0.5f);
+    }
+
+    unsigned char ToUnorm8(const float value)
+    {
+        return static_cast<unsigned char>(glm::clamp(value, 0.f, 255.f) + 0.5f);
+    }
+
+    // 2x2 box filter, sRGB colors are averaged in linear space (otherwise mips get darker) and normals are renormalized
+    std::vector<unsigned char> DownsampleRGBA(
+        const std::vector<unsigned char>& source,
+        const unsigned int width,
+        const unsigned int height,
+        const Glacirer::Rendering::TextureSettings& settings)
+    {
+        const unsigned int downsampledWidth = std::max(1u, width / 2);
+        const unsigned int downsampledHeight = std::max(1u, height / 2);
+        const bool bIsSRGBColor = settings.Usage == Glacirer::Rendering::TextureUsage::Color && settings.bIsSRGB;
+        const bool bIsNormalMap = settings.Usage == Glacirer::Rendering::TextureUsage::Normal;
+        const std::array<float, 256>& srgbToLinear = GetSRGBToLinearTable();
+
+        std::vector<unsigned char> downsampled(static_cast<size_t>(downsampledWidth) * downsampledHeight * 4);
+
+        for(unsigned int y = 0; y < downsampledHeight; y++)
+        {
+            for(unsigned int x = 0; x < downsampledWidth; x++)
+            {
+                const unsigned int sourceXs[2] = { std::min(x * 2, width - 1), std::min(x * 2 + 1, width - 1) };
+                const unsigned int sourceYs[2] = { std::min(y * 2, height - 1), std::min(y * 2 + 1, height - 1) };
+
+                glm::vec4 sum{0.f};
+
+                for(const unsigned int sourceY : sourceYs)
+                {
+                    for(const unsigned int sourceX : sourceXs)
+                    {
+                        const unsigned char* pixel = &source[(static_cast<size_t>(sourceY) * width + sourceX) * 4];
+
+                        if(bIsSRGBColor)
+                        {
+                            sum += glm::vec4{srgbToLinear[pixel[0]], srgbToLinear[pixel[1]], srgbToLinear[pixel[2]], pixel[3]};
+                        }
+                        else
+                        {
+                            sum += glm::vec4{pixel[0], pixel[1], pixel[2], pixel[3]};
+                        }
+                    }
+                }
+
+                const glm::vec4 average = sum * 0.25f;
+                unsigned char* output = &downsampled[(static_cast<size_t>(y) * downsampledWidth + x) * 4];
+
+                if(bIsSRGBColor)
+                {
+                    output[0] = LinearToSRGB(average.r);
+                    output[1] = LinearToSRGB(average.g);
+                    output[2] = LinearToSRGB(average.b);
+                }
+                else if(bIsNormalMap)
+                {
+                    glm::vec3 normal = glm::vec3(average) / 127.5f - 1.f;
+                    const float length = glm::length(normal);
+                    normal = length > 0.f ? normal / length : glm::vec3{0.f, 0.f, 1.f};
+
+                    output[0] = ToUnorm8((normal.x + 1.f) * 127.5f);
+                    output[1] = ToUnorm8((normal.y + 1.f) * 127.5f);
+                    output[2] = ToUnorm8((normal.z + 1.f) * 127.5f);
+                }
+                else
+                {
+                    output[0] = ToUnorm8(average.r);
+                    output[1] = ToUnorm8(average.g);
+                    output[2] = ToUnorm8(average.b);
+                }
+
+                output[3] = ToUnorm8(average.a);
+            }
+        }
+
+        return downsampled;
+    }
+
+    std::vector<unsigned char> ExtractChannels(const std::vector<unsigned char>& rgbaData, const unsigned int totalChannels)
+    {
+        if(totalChannels == 4)
+        {
+            return rgbaData;
+        }
+
+        const size_t totalPixels = rgbaData.size() / 4;
+        std::vector<unsigned char> channelsData(totalPixels * totalChannels);
+
+        for(size_t i = 0; i < totalPixels; i++)
+        {
+            for(unsigned int channel = 0; channel < totalChannels; channel++)
+            {
+                channelsData[i * totalChannels + channel] = rgbaData[i * 4 + channel];
+            }
+        }
+
+        return channelsData;
+    }
+}
 
 namespace Glacirer
 {
@@ -11,48 +208,190 @@ namespace Glacirer
     {
         std::shared_ptr<Rendering::Texture> TextureResource::LoadTextureFromFile(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically)
         {
-            stbi_set_flip_vertically_on_load(bFlipVertically);
+            const uint64_t sourceHash = CacheFile::HashFile(filePath);
 
-            int desiredChannels = 0;
-            if(!settings.bAutoDesiredChannels)
+            if(sourceHash != 0)
             {
-                desiredChannels = settings.UseAlpha ? 4 : 3;   
+                const std::string cachePath = TextureCache::GetCachePath(filePath);
+
+                if(std::shared_ptr<Rendering::Texture> cachedTexture = TextureCache::TryLoad(cachePath, sourceHash, GetCookKey(settings, bFlipVertically), GetSamplingSettings(settings)))
+                {
+                    cachedTexture->SetIsFlippedOnLoad(bFlipVertically);
+                    return cachedTexture;
+                }
             }
 
-            int width;
-            int height;
-            int channels;
+            CookedTexture cookedTexture{};
+            std::shared_ptr<Rendering::Texture> texture{};
+
+            if(CookTextureFromSource(filePath, settings, bFlipVertically, sourceHash, cookedTexture))
+            {
+                texture = CreateTexture(cookedTexture, settings);
+            }
+            else
+            {
+                texture = std::make_shared<Rendering::Texture>(nullptr, 0, 0, GetSamplingSettings(settings));
+            }
 
-            unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, desiredChannels);
+            texture->SetIsFlippedOnLoad(bFlipVertically);
 
-            Rendering::TextureSettings appliedSettings = settings;
+            return texture;
+        }
 
-            if(settings.bAutoDesiredChannels)
+        std::shared_ptr<Rendering::Texture> TextureResource::LoadStreamedTextureFromFile(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, TextureStreamer& textureStreamer)
+        {
+            uint64_t sourceHash = 0;
+
+            if(!EnsureTextureCache(filePath, settings, bFlipVertically, sourceHash))
+            {
+                return nullptr;
+            }
+
+            std::shared_ptr<Rendering::Texture> texture = CreatePlaceholderTexture(settings);
+
+            if(!textureStreamer.Register(texture, TextureCache::GetCachePath(filePath), sourceHash, GetCookKey(settings, bFlipVertically), settings))
             {
-                appliedSettings.UseAlpha = channels > 3;
-                appliedSettings.UpdateFormats();
+                return nullptr;
             }
-            
-            std::shared_ptr<Rendering::Texture> texture = std::make_shared<Rendering::Texture>(data, width, height, appliedSettings);
+
             texture->SetIsFlippedOnLoad(bFlipVertically);
-    
-            if(data)
+
+            return texture;
+        }
+
+        bool TextureResource::CookTextureFromFile(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, CookedTexture& outCookedTexture)
+        {
+            const uint64_t sourceHash = CacheFile::HashFile(filePath);
+
+            if(sourceHash != 0 && TextureCache::TryRead(TextureCache::GetCachePath(filePath), sourceHash, GetCookKey(settings, bFlipVertically), outCookedTexture))
+            {
+                return true;
+            }
+
+            return CookTextureFromSource(filePath, settings, bFlipVertically, sourceHash, outCookedTexture);
+        }
+
+        Rendering::TextureSettings TextureResource::GetUploadSettings(const Rendering::TextureSettings& settings, const CookedTexture& cookedTexture)
+        {
+            Rendering::TextureSettings uploadSettings = GetSamplingSettings(settings);
+            uploadSettings.InternalFormat = cookedTexture.InternalFormat;
+            uploadSettings.Format = cookedTexture.Format;
+            uploadSettings.Type = cookedTexture.Type;
+
+            return uploadSettings;
+        }
+
+        bool TextureResource::EnsureTextureCache(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, uint64_t& outSourceHash)
+        {
+            outSourceHash = CacheFile::HashFile(filePath);
+
+            if(outSourceHash == 0)
             {
-                stbi_image_free(data);
+                return false;
             }
 
+            const std::string cachePath = TextureCache::GetCachePath(filePath);
+            const uint32_t cookKey = GetCookKey(settings, bFlipVertically);
+
+            CookedTexture cachedFormat{};
+            std::vector<Rendering::TextureMip> cachedMips{};
+            MappedFile cacheFile{};
+
+            if(cacheFile.Open(cachePath) && TextureCache::TryMap(cacheFile, cachePath, outSourceHash, cookKey, cachedFormat, cachedMips))
+            {
+                return true;
+            }
+
+            cacheFile.Close();
+
+            CookedTexture cookedTexture{};
+            if(!CookTextureFromSource(filePath, settings, bFlipVertically, outSourceHash, cookedTexture))
+            {
+                return false;
+            }
+
+            // Writing the cache may have failed
+            return cacheFile.Open(cachePath) && TextureCache::TryMap(cacheFile, cachePath, outSourceHash, cookKey, cachedFormat, cachedMips);
+        }
+
+        std::shared_ptr<Rendering::Texture> TextureResource::CreatePlaceholderTexture(const Rendering::TextureSettings& settings)
+        {
+            unsigned char pixel[4]{128, 128, 128, 255};
+
+            if(settings.Usage == Rendering::TextureUsage::Normal)
+            {
+                pixel[2] = 255;
+            }
+            else if(settings.Usage == Rendering::TextureUsage::Mask)
+            {
+                pixel[0] = pixel[1] = pixel[2] = 255;
+            }
+
+            std::shared_ptr<Rendering::Texture> texture = std::make_shared<Rendering::Texture>(pixel, 1, 1, Rendering::TextureSettings{true, settings.bIsSRGB});
+            texture->SetIsLoaded(false);
+
             return texture;
         }
 
-        std::shared_ptr<Rendering::Cubemap> TextureResource::LoadCubemapFromFile(const Rendering::CubemapLoadSettings& loadSettings)
+        std::shared_ptr<Rendering::Cubemap> TextureResource::LoadCubemapFromFile(const Rendering::CubemapLoadSettings& loadSettings, WorkerPool& workerPool)
         {
-            stbi_set_flip_vertically_on_load(false);
-    
-            int width;
-            int height;
+            const std::array<std::string, Rendering::Cubemap::TOTAL_SIDES> sidePaths = GetCubemapSidePaths(loadSettings);
+            std::array<std::future<DecodedImage>, Rendering::Cubemap::TOTAL_SIDES> decodedSides{};
+
+            for(unsigned int i = 0; i < Rendering::Cubemap::TOTAL_SIDES; i++)
+            {
+                decodedSides[i] = workerPool.SubmitWithFuture([sidePath = sidePaths[i]]() { return DecodeCubemapSide(sidePath); });
+            }
+
+            const Rendering::TextureSettings textureSettings = GetCubemapSettings(loadSettings);
+
+            std::shared_ptr<Rendering::Cubemap> cubemap = std::make_shared<Rendering::Cubemap>(0, 0, textureSettings, false);
+            cubemap->Bind();
+
+            // Uploads each side as soon as it is decoded, while the others keep decoding
+            for(unsigned int i = 0; i < Rendering::Cubemap::TOTAL_SIDES; i++)
+            {
+                const DecodedImage side = decodedSides[i].get();
+                assert(!side.Data.empty());
+
+                cubemap->CreateSideTexture(i, side.Data.data(), side.Width, side.Height, textureSettings);
+            }
+
+            cubemap->Unbind();
+
+            return cubemap;
+        }
+
+        DecodedImage TextureResource::DecodeCubemapSide(const std::string& filePath)
+        {
+            stbi_set_flip_vertically_on_load_thread(false);
+
+            DecodedImage image{};
             int channels;
 
-            std::string sides[Rendering::Cubemap::TOTAL_SIDES]
+            // Cubemap sides are uploaded as RGB (see GetCubemapSettings)
+            unsigned char* data = stbi_load(filePath.c_str(), &image.Width, &image.Height, &channels, 3);
+
+            if(!data)
+            {
+                std::cout << "ERROR::TEXTURE: Failed to load " << filePath << "\n";
+                return image;
+            }
+
+            image.Data.assign(data, data + static_cast<size_t>(image.Width) * image.Height * 3);
+            stbi_image_free(data);
+
+            return image;
+        }
+
+        Rendering::TextureSettings TextureResource::GetCubemapSettings(const Rendering::CubemapLoadSettings& loadSettings)
+        {
+            return Rendering::TextureSettings{false, loadSettings.bIsSRGB};
+        }
+
+        std::array<std::string, Rendering::Cubemap::TOTAL_SIDES> TextureResource::GetCubemapSidePaths(const Rendering::CubemapLoadSettings& loadSettings)
+        {
+            return
             {
                 loadSettings.RightTextureFilePath,
                 loadSettings.LeftTextureFilePath,
@@ -61,25 +400,123 @@ namespace Glacirer
                 loadSettings.FrontTextureFilePath,
                 loadSettings.BackTextureFilePath
             };
+        }
+
+        bool TextureResource::CookTextureFromSource(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, uint64_t sourceHash, CookedTexture& outCookedTexture)
+        {
+            // Per thread flag, cooks may run on several workers at once
+            stbi_set_flip_vertically_on_load_thread(bFlipVertically);
 
-            Rendering::TextureSettings textureSettings{false, loadSettings.bIsSRGB};
+            int width;
+            int height;
+            int channels;
 
-            std::shared_ptr<Rendering::Cubemap> cubemap = std::make_shared<Rendering::Cubemap>(0, 0, textureSettings, false);
-            cubemap->Bind();
+            // Always expanded to RGBA so every cook step works on the same layout
+            unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &channels, 4);
 
-            for (unsigned int i = 0; i < Rendering::Cubemap::TOTAL_SIDES; i++)
+            if(!data)
             {
-                unsigned char* textureData = stbi_load(sides[i].c_str(), &width, &height, &channels, 0);
-                assert(textureData);
+                std::cout << "ERROR::TEXTURE: Failed to load " << filePath << "\n";
+                return false;
+            }
+
+            const bool bUseAlpha = settings.bAutoDesiredChannels ? channels > 3 : settings.UseAlpha;
+            outCookedTexture = CookTexture(data, width, height, settings, bUseAlpha);
+
+            stbi_image_free(data);
 
-                cubemap->CreateSideTexture(i, textureData, width, height, textureSettings);
+            const std::string cachePath = TextureCache::GetCachePath(filePath);
 
-                stbi_image_free(textureData);
+            if(sourceHash != 0 && !TextureCache::Write(cachePath, sourceHash, GetCookKey(settings, bFlipVertically), outCookedTexture))
+            {
+                std::cout << "ERROR::TEXTURE_CACHE: Failed to write " << cachePath << "\n";
             }
 
-            cubemap->Unbind();
+            return true;
+        }
 
-            return cubemap;
+        CookedTexture TextureResource::CookTexture(const unsigned char* rgbaData, unsigned int width, unsigned int height, const Rendering::TextureSettings& settings, bool bUseAlpha)
+        {
+            const CookedFormat cookedFormat = SelectCookedFormat(settings, bUseAlpha);
+
+            CookedTexture cookedTexture{};
+            cookedTexture.InternalFormat = cookedFormat.InternalFormat;
+            cookedTexture.Format = cookedFormat.Format;
+            cookedTexture.Type = GL_UNSIGNED_BYTE;
+
+            std::vector<unsigned char> levelData(rgbaData, rgbaData + static_cast<size_t>(width) * height * 4);
+            unsigned int levelWidth = width;
+            unsigned int levelHeight = height;
+
+            while(true)
+            {
+                cookedTexture.Mips.emplace_back();
+                CookedTextureMip& mip = cookedTexture.Mips.back();
+                mip.Width = levelWidth;
+                mip.Height = levelHeight;
+                mip.Data = cookedFormat.bIsCompressed
+                    ? Rendering::TextureCompressor::Compress(levelData.data(), levelWidth, levelHeight, cookedFormat.Compression)
+                    : ExtractChannels(levelData, cookedFormat.TotalChannels);
+
+                if(levelWidth == 1 && levelHeight == 1)
+                {
+                    break;
+                }
+
+                levelData = DownsampleRGBA(levelData, levelWidth, levelHeight, settings);
+                levelWidth = std::max(1u, levelWidth / 2);
+                levelHeight = std::max(1u, levelHeight / 2);
+            }
+
+            return cookedTexture;
+        }
+
+        std::shared_ptr<Rendering::Texture> TextureResource::CreateTexture(const CookedTexture& cookedTexture, const Rendering::TextureSettings& settings)
+        {
+            std::vector<Rendering::TextureMip> mips{};
+            mips.reserve(cookedTexture.Mips.size());
+
+            for(const CookedTextureMip& cookedMip : cookedTexture.Mips)
+            {
+                mips.emplace_back();
+                Rendering::TextureMip& mip = mips.back();
+                mip.Data = cookedMip.Data.data();
+                mip.Size = static_cast<unsigned int>(cookedMip.Data.size());
+                mip.Width = cookedMip.Width;
+                mip.Height = cookedMip.Height;
+            }
+
+            return std::make_shared<Rendering::Texture>(mips, GetUploadSettings(settings, cookedTexture));
+        }
+
+        Rendering::TextureSettings TextureResource::GetSamplingSettings(const Rendering::TextureSettings& settings)
+        {
+            Rendering::TextureSettings samplingSettings = settings;
+            samplingSettings.GenerateMipmap = false;
+
+            // Full mip chain is always cooked
+            if(samplingSettings.MinFilter == GL_LINEAR)
+            {
+                samplingSettings.MinFilter = GL_LINEAR_MIPMAP_LINEAR;
+            }
+
+            return samplingSettings;
+        }
+
+        // Every setting that changes the cooked data, sampling parameters are applied on load
+        uint32_t TextureResource::GetCookKey(const Rendering::TextureSettings& settings, bool bFlipVertically)
+        {
+            // Compressed formats available depend on the GPU, alpha doesn't change whether the color one is (same extension)
+            const bool bIsCompressed = SelectCookedFormat(settings, settings.UseAlpha).bIsCompressed;
+
+            uint32_t cookKey = static_cast<uint32_t>(settings.Usage);
+            cookKey |= static_cast<uint32_t>(bIsCompressed) << 2;
+            cookKey |= static_cast<uint32_t>(settings.bIsSRGB) << 3;
+            cookKey |= static_cast<uint32_t>(settings.UseAlpha) << 4;
+            cookKey |= static_cast<uint32_t>(settings.bAutoDesiredChannels) << 5;
+            cookKey |= static_cast<uint32_t>(bFlipVertically) << 6;
+
+            return cookKey;
         }
     }
 }
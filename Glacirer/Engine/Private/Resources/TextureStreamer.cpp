@@ -0,0 +1,259 @@
+#include "Resources/TextureStreamer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Rendering/Material.h"
+#include "Resources/TextureCache.h"
+#include "Resources/TextureResource.h"
+
+namespace
+{
+    constexpr unsigned int NOT_REQUESTED = std::numeric_limits<unsigned int>::max();
+}
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        TextureStreamer::TextureStreamer(const TextureStreamingSettings& settings)
+            : m_Settings(settings)
+        { }
+
+        bool TextureStreamer::Register(const std::shared_ptr<Rendering::Texture>& texture, const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, const Rendering::TextureSettings& settings)
+        {
+            std::unique_ptr<StreamedTexture> streamedTexture = std::make_unique<StreamedTexture>();
+
+            CookedTexture cookedFormat{};
+            if(!streamedTexture->CacheFile.Open(cachePath) || !TextureCache::TryMap(streamedTexture->CacheFile, cachePath, sourceHash, cookKey, cookedFormat, streamedTexture->Mips))
+            {
+                return false;
+            }
+
+            const std::vector<Rendering::TextureMip>& mips = streamedTexture->Mips;
+            const unsigned int totalMips = static_cast<unsigned int>(mips.size());
+
+            unsigned int tailLevel = totalMips - 1;
+            while(tailLevel > 0 && std::max(mips[tailLevel - 1].Width, mips[tailLevel - 1].Height) <= m_Settings.MinResidentSize)
+            {
+                tailLevel--;
+            }
+
+            streamedTexture->Texture = texture;
+            streamedTexture->UploadSettings = TextureResource::GetUploadSettings(settings, cookedFormat);
+            streamedTexture->TailLevel = tailLevel;
+            streamedTexture->ResidentLevel = tailLevel;
+            streamedTexture->RequestedLevel = NOT_REQUESTED;
+            streamedTexture->WantedLevel = tailLevel;
+
+            for(unsigned int level = totalMips; level-- > tailLevel;)
+            {
+                texture->UploadMip(level, totalMips, mips[level], streamedTexture->UploadSettings);
+            }
+
+            texture->SetIsLoaded(true);
+
+            // Address reused by a new texture before the expired one was removed
+            auto iterator = m_Textures.find(texture.get());
+            if(iterator != m_Textures.end())
+            {
+                m_ResidentBytes -= GetResidentSize(*iterator->second);
+            }
+
+            m_ResidentBytes += GetResidentSize(*streamedTexture);
+            m_Textures[texture.get()] = std::move(streamedTexture);
+
+            return true;
+        }
+
+        void TextureStreamer::RequestMaterialTextures(const Rendering::Material& material, float screenHeightPixels)
+        {
+            for(const auto& texturePropertyPair : material.GetAllTextureProperties())
+            {
+                auto iterator = m_Textures.find(texturePropertyPair.second.Texture.get());
+
+                if(iterator == m_Textures.end() || iterator->second->Texture.expired())
+                {
+                    continue;
+                }
+
+                StreamedTexture& streamedTexture = *iterator->second;
+                const Rendering::TextureMip& topMip = streamedTexture.Mips.front();
+
+                // Texels per screen pixel, the mip where it drops to 1 is the one sampled
+                const float texelsPerPixel = static_cast<float>(std::max(topMip.Width, topMip.Height)) / std::max(screenHeightPixels, 1.f);
+                const unsigned int level = texelsPerPixel > 1.f ? static_cast<unsigned int>(std::floor(std::log2(texelsPerPixel))) : 0;
+
+                streamedTexture.RequestedLevel = std::min({streamedTexture.RequestedLevel, level, streamedTexture.TailLevel});
+            }
+        }
+
+        void TextureStreamer::Update()
+        {
+            RemoveExpiredTextures();
+
+            std::vector<StreamedTexture*> texturesToStreamIn{};
+
+            for(auto& texturePair : m_Textures)
+            {
+                StreamedTexture& streamedTexture = *texturePair.second;
+
+                if(streamedTexture.RequestedLevel != NOT_REQUESTED)
+                {
+                    streamedTexture.WantedLevel = streamedTexture.RequestedLevel;
+                    streamedTexture.LastNeededFrame = m_CurrentFrame;
+                    streamedTexture.RequestedLevel = NOT_REQUESTED;
+                }
+
+                if(streamedTexture.LastNeededFrame == m_CurrentFrame && streamedTexture.ResidentLevel > streamedTexture.WantedLevel)
+                {
+                    texturesToStreamIn.push_back(&streamedTexture);
+                }
+            }
+
+            // Blurriest textures first
+            std::sort(texturesToStreamIn.begin(), texturesToStreamIn.end(), [](const StreamedTexture* a, const StreamedTexture* b)
+            {
+                return a->ResidentLevel - a->WantedLevel > b->ResidentLevel - b->WantedLevel;
+            });
+
+            unsigned int totalUploadedBytes = 0;
+            bool bCanStreamIn = true;
+
+            // One mip per texture and pass, so every texture gets sharper at the same pace
+            while(bCanStreamIn && !texturesToStreamIn.empty())
+            {
+                for(auto iterator = texturesToStreamIn.begin(); bCanStreamIn && iterator != texturesToStreamIn.end();)
+                {
+                    StreamedTexture& streamedTexture = **iterator;
+                    const unsigned int mipSize = streamedTexture.Mips[streamedTexture.ResidentLevel - 1].Size;
+
+                    if(totalUploadedBytes > 0 && totalUploadedBytes + mipSize > m_Settings.MaxUploadBytesPerFrame)
+                    {
+                        bCanStreamIn = false;
+                        break;
+                    }
+
+                    while(m_ResidentBytes + mipSize > m_Settings.BudgetBytes)
+                    {
+                        StreamedTexture* evictedTexture = FindEvictionCandidate(&streamedTexture);
+
+                        if(!evictedTexture)
+                        {
+                            break;
+                        }
+
+                        Evict(*evictedTexture, *evictedTexture->Texture.lock());
+                    }
+
+                    // Nothing less needed left to evict
+                    if(m_ResidentBytes + mipSize > m_Settings.BudgetBytes)
+                    {
+                        bCanStreamIn = false;
+                        break;
+                    }
+
+                    StreamIn(streamedTexture, *streamedTexture.Texture.lock());
+                    totalUploadedBytes += mipSize;
+
+                    iterator = streamedTexture.ResidentLevel > streamedTexture.WantedLevel ? iterator + 1 : texturesToStreamIn.erase(iterator);
+                }
+            }
+
+            // Budget may have been lowered
+            while(m_ResidentBytes > m_Settings.BudgetBytes)
+            {
+                StreamedTexture* evictedTexture = FindEvictionCandidate(nullptr);
+
+                if(!evictedTexture)
+                {
+                    break;
+                }
+
+                Evict(*evictedTexture, *evictedTexture->Texture.lock());
+            }
+
+            m_CurrentFrame++;
+        }
+
+        void TextureStreamer::StreamIn(StreamedTexture& streamedTexture, Rendering::Texture& texture)
+        {
+            const unsigned int level = streamedTexture.ResidentLevel - 1;
+
+            texture.UploadMip(level, static_cast<unsigned int>(streamedTexture.Mips.size()), streamedTexture.Mips[level], streamedTexture.UploadSettings);
+
+            streamedTexture.ResidentLevel = level;
+            m_ResidentBytes += streamedTexture.Mips[level].Size;
+        }
+
+        void TextureStreamer::Evict(StreamedTexture& streamedTexture, Rendering::Texture& texture)
+        {
+            const unsigned int level = streamedTexture.ResidentLevel;
+
+            texture.ReleaseMip(level, streamedTexture.UploadSettings);
+
+            streamedTexture.ResidentLevel = level + 1;
+            m_ResidentBytes -= streamedTexture.Mips[level].Size;
+        }
+
+        TextureStreamer::StreamedTexture* TextureStreamer::FindEvictionCandidate(const StreamedTexture* excludedTexture)
+        {
+            StreamedTexture* candidate = nullptr;
+
+            for(auto& texturePair : m_Textures)
+            {
+                StreamedTexture& streamedTexture = *texturePair.second;
+
+                if(&streamedTexture == excludedTexture || streamedTexture.ResidentLevel >= GetEvictionFloor(streamedTexture))
+                {
+                    continue;
+                }
+
+                // Same age, the biggest mip frees the most memory
+                if(!candidate
+                    || streamedTexture.LastNeededFrame < candidate->LastNeededFrame
+                    || (streamedTexture.LastNeededFrame == candidate->LastNeededFrame
+                        && streamedTexture.Mips[streamedTexture.ResidentLevel].Size > candidate->Mips[candidate->ResidentLevel].Size))
+                {
+                    candidate = &streamedTexture;
+                }
+            }
+
+            return candidate;
+        }
+
+        unsigned int TextureStreamer::GetEvictionFloor(const StreamedTexture& streamedTexture) const
+        {
+            // Mips drawn this frame are kept, anything not drawn can go down to the always resident ones
+            return streamedTexture.LastNeededFrame == m_CurrentFrame ? streamedTexture.WantedLevel : streamedTexture.TailLevel;
+        }
+
+        void TextureStreamer::RemoveExpiredTextures()
+        {
+            for(auto iterator = m_Textures.begin(); iterator != m_Textures.end();)
+            {
+                if(iterator->second->Texture.expired())
+                {
+                    m_ResidentBytes -= GetResidentSize(*iterator->second);
+                    iterator = m_Textures.erase(iterator);
+                }
+                else
+                {
+                    ++iterator;
+                }
+            }
+        }
+
+        size_t TextureStreamer::GetResidentSize(const StreamedTexture& streamedTexture)
+        {
+            size_t residentSize = 0;
+            for(size_t level = streamedTexture.ResidentLevel; level < streamedTexture.Mips.size(); level++)
+            {
+                residentSize += streamedTexture.Mips[level].Size;
+            }
+
+            return residentSize;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#include "Resources/WorkerPool.h"
+
+#include "AllocationCounter.h"
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        WorkerPool::WorkerPool(unsigned int totalWorkers)
+        {
+            if(totalWorkers == 0)
+            {
+                // hardware_concurrency returns 0 when it can't be known
+                const unsigned int totalHardwareThreads = std::thread::hardware_concurrency();
+                totalWorkers = totalHardwareThreads > 1 ? totalHardwareThreads - 1 : 1;
+            }
+
+            m_Workers.reserve(totalWorkers);
+
+            for(unsigned int i = 0; i < totalWorkers; i++)
+            {
+                m_Workers.emplace_back(&WorkerPool::RunWorker, this);
+            }
+        }
+
+        WorkerPool::~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_JobsMutex);
+                bIsStopping = true;
+                m_Jobs.clear();
+            }
+
+            m_JobsCondition.notify_all();
+
+            for(std::thread& worker : m_Workers)
+            {
+                worker.join();
+            }
+        }
+
+        void WorkerPool::Submit(std::function<void()> job)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_JobsMutex);
+                m_Jobs.push_back(std::move(job));
+            }
+
+            m_JobsCondition.notify_one();
+        }
+
+        void WorkerPool::RunWorker()
+        {
+            // Jobs needing another tag (e.g. occlusion rasterization) open their own scope
+            AllocationTagScope tagScope{AllocationTag::Resources};
+
+            while(true)
+            {
+                std::function<void()> job{};
+
+                {
+                    std::unique_lock<std::mutex> lock(m_JobsMutex);
+                    m_JobsCondition.wait(lock, [this]() { return bIsStopping || !m_Jobs.empty(); });
+
+                    if(bIsStopping)
+                    {
+                        return;
+                    }
+
+                    job = std::move(m_Jobs.front());
+                    m_Jobs.pop_front();
+                }
+
+                job();
+            }
+        }
+    }
+}
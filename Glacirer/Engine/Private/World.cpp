@@ -3,6 +3,8 @@
 #include "GameObject/GameObject.h"
 #include "Basics/Components/MeshComponent.h"
 #include "Basics/Components/CameraComponent.h"
+#include "Rendering/Material.h"
+#include "Rendering/Mesh.h"
 
 namespace Glacirer
 {
@@ -21,7 +23,16 @@ namespace Glacirer
             gameObject->Destroy();
         }
 
+        if(m_StaticBatchObject)
+        {
+            m_StaticBatchObject->Destroy();
+            m_StaticBatchObject.reset();
+        }
+
+        m_StaticBatchedMeshComponents.clear();
+
         m_RenderSystem.reset();
+        m_SceneQuerySystem.Clear();
         m_GameObjects.clear();
     }
 
@@ -29,6 +40,9 @@ namespace Glacirer
     {
         UpdateGameObjects(deltaTime);
         DestroyPendingGameObjects();
+        UpdateStaticBatches();
+
+        m_SceneQuerySystem.MarkTransformsOutdated();
     }
 
     void World::UpdateGameObjects(float deltaTime)
@@ -55,14 +69,59 @@ namespace Glacirer
         }
     }
 
+    void World::UpdateStaticBatches()
+    {
+        if(m_StaticBatchedMeshComponents.empty())
+        {
+            return;
+        }
+
+        for(const auto& staticBatchedMeshComponent : m_StaticBatchedMeshComponents)
+        {
+            if(bAreStaticBatchesDirty)
+            {
+                break;
+            }
+
+            const std::shared_ptr<MeshComponent> meshComponent = staticBatchedMeshComponent.first.lock();
+            bAreStaticBatchesDirty = !meshComponent || meshComponent->GetOwnerTransform().GetVersion() != staticBatchedMeshComponent.second;
+        }
+
+        if(bAreStaticBatchesDirty)
+        {
+            BuildStaticBatches(m_StaticBatchChunkSize);
+        }
+    }
+
     void World::AddMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent)
     {
-        m_RenderSystem->AddMeshComponent(meshComponent);
+        if(!meshComponent->IsStaticBatched())
+        {
+            m_RenderSystem->AddMeshComponent(meshComponent);
+        }
+
+        if(meshComponent->IsQueryable())
+        {
+            m_SceneQuerySystem.AddMeshComponent(meshComponent);
+        }
     }
 
     void World::RemoveMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent)
     {
-        m_RenderSystem->RemoveMeshComponent(meshComponent);
+        if(!meshComponent->IsStaticBatched())
+        {
+            m_RenderSystem->RemoveMeshComponent(meshComponent);
+        }
+        else
+        {
+            // Its geometry is still in a chunk
+            bAreStaticBatchesDirty = true;
+        }
+
+        if(meshComponent->IsQueryable())
+        {
+            m_SceneQuerySystem.RemoveMeshComponent(meshComponent);
+        }
     }
 
     void World::RemoveMeshComponentsUsing(const std::shared_ptr<Rendering::Material>& material)
@@ -72,12 +131,20 @@ namespace Glacirer
 
     void World::AddOutlinedMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent)
     {
+        // Outlined components are drawn on their own, rebuilt batches leave them out
+        if(meshComponent->IsStaticBatched())
+        {
+            bAreStaticBatchesDirty = true;
+        }
+
         m_RenderSystem->AddOutlinedMeshComponent(meshComponent);
+        m_SceneQuerySystem.AddMeshComponent(meshComponent);
     }
 
     void World::RemoveOutlinedMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent)
     {
         m_RenderSystem->RemoveOutlinedMeshComponent(meshComponent);
+        m_SceneQuerySystem.RemoveMeshComponent(meshComponent);
     }
 
     void World::SetActiveCamera(const std::shared_ptr<CameraComponent>& camera)
@@ -135,6 +202,104 @@ namespace Glacirer
         m_RenderSystem->RemoveSkyboxComponent(skyboxComponent);
     }
 
+    void World::BuildStaticBatches(float chunkSize)
+    {
+        ClearStaticBatches();
+
+        m_StaticBatchChunkSize = chunkSize;
+        Rendering::StaticBatchBuilder staticBatchBuilder{chunkSize};
+
+        for(const std::shared_ptr<GameObject>& gameObject : m_GameObjects)
+        {
+            if(!gameObject->IsStatic() || gameObject->IsPendingDestroy())
+            {
+                continue;
+            }
+
+            for(const std::shared_ptr<Component>& component : gameObject->GetComponents())
+            {
+                std::shared_ptr<MeshComponent> meshComponent = std::dynamic_pointer_cast<MeshComponent>(component);
+
+                if(!meshComponent || !CanBeStaticBatched(*meshComponent))
+                {
+                    continue;
+                }
+
+                staticBatchBuilder.Add(*meshComponent->GetMesh(), meshComponent->GetMaterial(), gameObject->GetTransform().GetMatrix());
+
+                meshComponent->SetIsStaticBatched(true);
+                m_StaticBatchedMeshComponents.emplace_back(meshComponent, gameObject->GetTransform().GetVersion());
+            }
+        }
+
+        if(staticBatchBuilder.IsEmpty())
+        {
+            return;
+        }
+
+        m_StaticBatchObject = std::make_shared<GameObject>(*this);
+        m_StaticBatchObject->Initialize();
+        m_StaticBatchObject->SetName("StaticBatch");
+        m_StaticBatchObject->SetMobility(Mobility::Static);
+
+        for(const Rendering::StaticBatchChunk& chunk : staticBatchBuilder.Build())
+        {
+            std::shared_ptr<MeshComponent> chunkMeshComponent = m_StaticBatchObject->AddComponent<MeshComponent>().lock();
+
+            // Set before the mesh, so chunks never get into scene queries
+            chunkMeshComponent->SetIsQueryable(false);
+            chunkMeshComponent->SetMesh(chunk.Mesh);
+            chunkMeshComponent->SetMaterial(chunk.Material);
+        }
+    }
+
+    void World::ClearStaticBatches()
+    {
+        if(m_StaticBatchObject)
+        {
+            m_StaticBatchObject->Destroy();
+            m_StaticBatchObject.reset();
+        }
+
+        // Components destroyed since the build are already gone from the world
+        for(const auto& staticBatchedMeshComponent : m_StaticBatchedMeshComponents)
+        {
+            if(std::shared_ptr<MeshComponent> meshComponent = staticBatchedMeshComponent.first.lock())
+            {
+                meshComponent->SetIsStaticBatched(false);
+            }
+        }
+
+        m_StaticBatchedMeshComponents.clear();
+        // Un-batching the sources above re-adds them one by one, nothing is left to rebuild
+        bAreStaticBatchesDirty = false;
+    }
+
+    bool World::CanBeStaticBatched(const MeshComponent& meshComponent)
+    {
+        // Outlined and occluder components keep being drawn on their own, sorted materials can't be merged
+        return meshComponent.IsReadyToDraw()
+            && !meshComponent.IsOutlined()
+            && !meshComponent.IsOccluder()
+            && !meshComponent.GetMesh()->HasCustomLayout()
+            && meshComponent.GetMaterial()->GetRenderingMode() == Rendering::MaterialRenderingMode::Opaque;
+    }
+
+    bool World::Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Physics::RaycastHit& outHit)
+    {
+        return m_SceneQuerySystem.Raycast(origin, direction, maxDistance, outHit);
+    }
+
+    void World::OverlapSphere(const glm::vec3& center, float radius, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents)
+    {
+        m_SceneQuerySystem.OverlapSphere(center, radius, outMeshComponents);
+    }
+
+    void World::OverlapBox(const glm::vec3& center, const glm::vec3& halfExtents, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents)
+    {
+        m_SceneQuerySystem.OverlapBox(center, halfExtents, outMeshComponents);
+    }
+
     void World::InitializeGameObject(const std::shared_ptr<GameObject>& gameObject) const
     {
         gameObject->Initialize();
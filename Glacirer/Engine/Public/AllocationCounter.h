@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "EngineAPI.h"
+
+namespace Glacirer
+{
+    // Subsystem heap allocations made inside an AllocationTagScope are attributed to
+    enum class AllocationTag : uint8_t
+    {
+        Untagged,
+        World,
+        Rendering,
+        Resources,
+        SceneQueries,
+        Count
+    };
+
+    struct AllocationTagStats
+    {
+        size_t LiveBytes{0};
+        size_t PeakBytes{0};
+        size_t LiveAllocations{0};
+    };
+
+    // Tags the heap allocations of the current thread for as long as it lives, scopes nest and restore the previous tag
+    class ENGINE_API AllocationTagScope
+    {
+    public:
+
+        explicit AllocationTagScope(AllocationTag tag);
+        ~AllocationTagScope();
+        AllocationTagScope(const AllocationTagScope&) = delete;
+        AllocationTagScope& operator=(const AllocationTagScope&) = delete;
+
+    private:
+
+        AllocationTag m_PreviousTag;
+    };
+
+    // Counts global operator new calls made by engine code in debug builds, so Engine can check a warm frame doesn't
+    // allocate. Counted per thread, loader threads don't show up on the main thread. Always 0 in release builds
+    class ENGINE_API AllocationCounter
+    {
+    public:
+
+        static size_t GetTotalAllocationsOnCurrentThread();
+
+        static const char* GetTagName(AllocationTag tag);
+        // Tagged allocations still alive and the most there ever were, untagged ones aren't recorded.
+        // Blocks of engine code freed by another module (e.g. the editor) are still counted as alive
+        static AllocationTagStats GetTagStats(AllocationTag tag);
+        // Tags are kept in the block subtype of the MSVC debug heap, so they are only recorded by debug builds using it
+        static bool IsTaggingSupported();
+    };
+}
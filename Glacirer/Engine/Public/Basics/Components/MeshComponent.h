@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameObject/Component.h"
+#include <glm/fwd.hpp>
 
 namespace Glacirer
 {
@@ -21,12 +22,28 @@ namespace Glacirer
         void SetMesh(const std::shared_ptr<Rendering::Mesh>& mesh);
         void SetMaterial(const std::shared_ptr<Rendering::Material>& material);
         void SetIsOutlined(const bool bOutlined);
+        // Occluders are rasterized by software occlusion culling to hide objects behind them (e.g. floor, large walls)
+        void SetIsOccluder(const bool bOccluder);
+        // Drawn as part of a static batch chunk instead of on its own, still found by scene queries
+        void SetIsStaticBatched(const bool bStaticBatched);
+        // Not queryable components are ignored by raycasts and overlaps (e.g. static batch chunks, whose sources are queried instead)
+        void SetIsQueryable(const bool bQueryable);
+        // Selects mesh LOD from the screen height covered by mesh bounding sphere for the given view
+        void UpdateLOD(const glm::mat4& projection, const glm::vec3& viewPosition);
+        // Bounding sphere diameter projected on screen, as a fraction of the viewport height
+        float GetScreenSize(const glm::mat4& projection, const glm::vec3& viewPosition) const;
     
         bool IsReadyToDraw() const { return m_Mesh != nullptr && m_Material != nullptr; }
         const std::shared_ptr<Rendering::Mesh>& GetMesh() const { return m_Mesh; }
         const std::shared_ptr<Rendering::Material>& GetMaterial() const { return m_Material; }
         std::shared_ptr<Rendering::Shader> GetShader() const;
         bool IsOutlined() const { return bIsOutlined; }
+        bool IsOccluder() const { return bIsOccluder; }
+        bool IsStaticBatched() const { return bIsStaticBatched; }
+        bool IsQueryable() const { return bIsQueryable; }
+        int GetLOD() const { return m_LOD; }
+        // Bias picks a coarser LOD than the selected one (e.g. for shadow passes), clamped to the last LOD
+        const Rendering::Mesh& GetMeshForLOD(int lodBias = 0) const;
 
     private:
 
@@ -34,6 +51,10 @@ namespace Glacirer
         std::shared_ptr<Rendering::Material> m_Material;
         bool bIsAddedToWorld{false};
         bool bIsOutlined{false};
+        bool bIsOccluder{false};
+        bool bIsStaticBatched{false};
+        bool bIsQueryable{true};
+        int m_LOD{0};
 
         void AddToWorld();
         void RemoveFromWorld();
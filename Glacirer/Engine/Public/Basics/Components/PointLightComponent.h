@@ -1,5 +1,5 @@
 #pragma once
-#include <vector>
+#include <array>
 
 #include "GameObject/Component.h"
 #include "Rendering/Light.h"
@@ -34,7 +34,8 @@ namespace Glacirer
         float GetIntensity() const { return m_Intensity; }
 
         glm::mat4 GetProjectionMatrix(const Rendering::Resolution& shadowResolution) const;
-        std::vector<glm::mat4> GetViewProjectionMatrices(const Rendering::Resolution& shadowResolution) const;
+        // One per cubemap side (right, left, top, bottom, near and far)
+        std::array<glm::mat4, 6> GetViewProjectionMatrices(const Rendering::Resolution& shadowResolution) const;
 
         void SetCastShadowEnabled(const bool enable) { bCastShadow = enable; }
         bool IsCastShadowEnabled() const { return bCastShadow; }
@@ -3,6 +3,14 @@
 
 namespace Glacirer
 {
+    // Resolution an effect is computed at, relative to the screen
+    enum class PostProcessingResolution : uint8_t
+    {
+        Full,
+        Half,
+        Quarter
+    };
+
     class ENGINE_API PostProcessingComponent : INHERIT_FROM_COMPONENT(PostProcessingComponent)
     {
         GENERATE_COMPONENT_BODY(PostProcessingComponent)
@@ -18,6 +26,7 @@ namespace Glacirer
         void SetSharpen(const bool bEnabled);
         void SetBlur(const bool bEnabled);
         void SetEdgeDetection(const bool bEnabled);
+        void SetBlurResolution(const PostProcessingResolution blurResolution);
 
         float GetGammaValue() const { return m_GammaValue; }
         bool IsColorInversionEnabled() const { return bIsColorInversionEnabled; }
@@ -25,6 +34,7 @@ namespace Glacirer
         bool IsSharpenEnabled() const { return bIsSharpenEnabled; }
         bool IsBlurEnabled() const { return  bIsBlurEnabled; }
         bool IsEdgeDetectionEnabled() const { return bIsEdgeDetectionEnabled; }
+        PostProcessingResolution GetBlurResolution() const { return m_BlurResolution; }
 
         void SetDirty(const bool bDirty) { bIsDirty = bDirty; }
         bool IsDirty() const { return bIsDirty; }
@@ -37,6 +47,8 @@ namespace Glacirer
         bool bIsSharpenEnabled{false};
         bool bIsBlurEnabled{false};
         bool bIsEdgeDetectionEnabled{false};
+        // Blurring hides the lower resolution, so by default it runs on a quarter of the pixels
+        PostProcessingResolution m_BlurResolution{PostProcessingResolution::Half};
 
         bool bIsDirty{true};
     };
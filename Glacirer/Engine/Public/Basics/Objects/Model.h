@@ -7,14 +7,28 @@ namespace Glacirer
     {
         class ModelData;
         class Material;
+        class Mesh;
     }
 
+    class MeshComponent;
+
     class ENGINE_API Model : public GameObject
     {
         GENERATE_OBJECT_BODY(Model)
     
     public:
 
+        // Models still loading show the default cube until their meshes are uploaded
         void Setup(const std::shared_ptr<Rendering::ModelData>& modelData, const std::shared_ptr<Rendering::Material>& material);
+        void Update(float deltaTime) override;
+
+    private:
+
+        std::shared_ptr<Rendering::ModelData> m_PendingModelData{};
+        std::shared_ptr<Rendering::Material> m_PendingMaterial{};
+        std::weak_ptr<MeshComponent> m_PlaceholderComponent{};
+
+        std::weak_ptr<MeshComponent> AddMeshComponent(const std::shared_ptr<Rendering::Mesh>& mesh, const std::shared_ptr<Rendering::Material>& material);
+        void ReplacePlaceholder();
     };
 }
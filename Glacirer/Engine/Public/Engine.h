@@ -32,14 +32,19 @@ namespace Glacirer
     private:
 
         static constexpr int DEFAULT_MSAA_TOTAL_SAMPLES = 4;
+        // Frames rendered before debug builds start reporting heap allocations made by Update and Render
+        static constexpr unsigned int ALLOCATION_CHECK_WARM_UP_FRAMES = 120;
 
         GLFWwindow* m_Window{nullptr};
         std::unique_ptr<World> m_World{};
         std::shared_ptr<Rendering::RenderSystem> m_RenderSystem{};
         bool bIsInitialized{false};
         float m_LastFrameTime{0.f};
+        unsigned int m_TotalFrames{0};
+        size_t m_TotalFrameAllocations{0};
 
         bool CreateWindow(const char* windowTitle);
         bool InitializeGlew() const;
+        void CheckFrameAllocations();
     };
 }
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "EngineAPI.h"
+#include "MemoryTracker.h"
+
+namespace Glacirer
+{
+    // Linear allocator for data that doesn't outlive the frame: allocating only moves an offset forward and nothing is
+    // freed on its own, the whole arena is reset at the start of the next frame instead. Each thread has its own arena,
+    // the main thread one is reset by Engine::Update (other threads have to reset theirs).
+    // Allocations that don't fit get their own block, the next reset grows the arena so they fit from then on
+    class ENGINE_API FrameArena
+    {
+    public:
+
+        constexpr static size_t DEFAULT_CAPACITY = 1 << 20;
+
+        explicit FrameArena(size_t capacity = DEFAULT_CAPACITY);
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        static FrameArena& GetForCurrentThread();
+
+        // Alignment has to be a power of two
+        void* Allocate(size_t size, size_t alignment);
+        // Everything allocated before is invalid afterwards, containers using the arena can't be kept across it
+        void Reset();
+
+        size_t GetCapacity() const { return m_Capacity; }
+        size_t GetUsedSize() const { return m_Offset + m_OverflowSize; }
+        size_t GetPeakUsedSize() const { return m_PeakUsedSize; }
+
+    private:
+
+        std::unique_ptr<unsigned char[]> m_Block{};
+        std::vector<std::unique_ptr<unsigned char[]>> m_OverflowBlocks{};
+        size_t m_Capacity{0};
+        size_t m_Offset{0};
+        size_t m_OverflowSize{0};
+        size_t m_PeakUsedSize{0};
+        TrackedMemory m_TrackedMemory{MemoryCategory::FrameArenas}; // Capacity, overflow blocks only live for a frame
+    };
+
+    // STL allocator taking its memory from a frame arena, deallocating does nothing
+    template <typename T>
+    class FrameArenaAllocator
+    {
+    public:
+
+        using value_type = T;
+
+        FrameArenaAllocator()
+            : m_Arena(&FrameArena::GetForCurrentThread())
+        { }
+
+        explicit FrameArenaAllocator(FrameArena& arena)
+            : m_Arena(&arena)
+        { }
+
+        template <typename TOther>
+        FrameArenaAllocator(const FrameArenaAllocator<TOther>& other)
+            : m_Arena(other.GetArena())
+        { }
+
+        T* allocate(size_t count) { return static_cast<T*>(m_Arena->Allocate(count * sizeof(T), alignof(T))); }
+        void deallocate(T*, size_t) { }
+
+        FrameArena* GetArena() const { return m_Arena; }
+
+    private:
+
+        FrameArena* m_Arena;
+    };
+
+    template <typename T, typename TOther>
+    bool operator==(const FrameArenaAllocator<T>& lhs, const FrameArenaAllocator<TOther>& rhs) { return lhs.GetArena() == rhs.GetArena(); }
+
+    template <typename T, typename TOther>
+    bool operator!=(const FrameArenaAllocator<T>& lhs, const FrameArenaAllocator<TOther>& rhs) { return !(lhs == rhs); }
+
+    // Vector living until the end of the frame, meant for locals (a member would keep pointing at memory reused next frame)
+    template <typename T>
+    using FrameVector = std::vector<T, FrameArenaAllocator<T>>;
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,6 +17,12 @@ namespace Glacirer
 {
     class World;
 
+    enum class Mobility : uint8_t
+    {
+        Movable,
+        Static // Not expected to move or change once the level is loaded, its meshes can be merged into static batches
+    };
+
     class ENGINE_API GameObject
     {
     public:
@@ -34,6 +41,10 @@ namespace Glacirer
         std::string GetName() const { return m_Name; }
         void SetName(const std::string& name) { m_Name = name; }
         unsigned int GetId() const { return m_Id; }
+        // Only read when static batches are built, see World::BuildStaticBatches
+        void SetMobility(Mobility mobility) { m_Mobility = mobility; }
+        Mobility GetMobility() const { return m_Mobility; }
+        bool IsStatic() const { return m_Mobility == Mobility::Static; }
 
         glm::vec3 GetPosition() const { return m_Transform.GetPosition(); }
         glm::vec3 GetRotation() const { return m_Transform.GetRotation(); }
@@ -42,7 +53,7 @@ namespace Glacirer
 
         bool IsPendingDestroy() const { return b_IsPendingDestroy; }
         World& GetWorld() const { return m_World; }
-        std::vector<std::shared_ptr<Component>> GetComponents() const { return m_Components; }
+        const std::vector<std::shared_ptr<Component>>& GetComponents() const { return m_Components; }
         void RemoveComponent(const std::shared_ptr<Component>& component);
 
         // Only accepts components based on the Component class
@@ -89,5 +100,6 @@ namespace Glacirer
         World& m_World;
         std::string m_Name{};
         unsigned int m_Id{0};
+        Mobility m_Mobility{Mobility::Movable};
     };
 }
@@ -1,9 +1,12 @@
 #pragma once
 #include "EngineAPI.h"
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace Glacirer
 {
+    // Rotation is kept as a quaternion along with its basis vectors, so direction getters are plain reads
+    // and the matrix is built straight from the basis when something changed
     class ENGINE_API Transform
     {
     public:
@@ -15,23 +18,35 @@ namespace Glacirer
 
         void SetPosition(const glm::vec3& position);
         void SetRotation(const glm::vec3& eulerRotation);
+        void SetRotation(const glm::quat& rotation);
         void SetScale(const glm::vec3& scale);
         void SetPositionRotationScale(const glm::vec3& position, const glm::vec3& eulerRotation, const glm::vec3& scale);
 
         glm::vec3 GetPosition() const { return m_Position; }
-        glm::vec3 GetRotation() const { return m_Rotation; }
+        // Euler angles in degrees as they were set, or taken from the quaternion if it was set directly
+        glm::vec3 GetRotation() const { return m_EulerRotation; }
+        const glm::quat& GetRotationQuaternion() const { return m_Rotation; }
         glm::vec3 GetScale() const { return m_Scale; }
-        glm::vec3 GetForwardVector() const;
-        glm::vec3 GetRightVector() const;
-        glm::vec3 GetUpVector() const;
-        glm::mat4 GetMatrix() const;
+        glm::vec3 GetForwardVector() const { return -m_RotationBasis[2]; }
+        glm::vec3 GetRightVector() const { return m_RotationBasis[0]; }
+        glm::vec3 GetUpVector() const { return m_RotationBasis[1]; }
+        const glm::mat4& GetMatrix() const;
+        // Changes on every set, lets caches of data derived from the transform (e.g. world bounds) tell it moved
+        unsigned int GetVersion() const { return m_Version; }
 
     private:
 
         glm::vec3 m_Position{0.f};
-        glm::vec3 m_Rotation{0.f};
+        glm::vec3 m_EulerRotation{0.f};
+        glm::quat m_Rotation{1.f, 0.f, 0.f, 0.f};
+        // Local right, up and backward axes in world space
+        glm::mat3 m_RotationBasis{1.f};
         glm::vec3 m_Scale{1.f};
         mutable glm::mat4 m_CachedMatrix{};
         mutable bool bIsDirty{true};
+        unsigned int m_Version{0};
+
+        void UpdateRotationBasis();
+        void MarkChanged();
     };
 }
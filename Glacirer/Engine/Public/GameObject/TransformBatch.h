@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <ostream>
+
+#include "EngineAPI.h"
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace Glacirer
+{
+    // Composes translate * rotate * scale matrices of many transforms at once, for systems gathering thousands of them
+    // (e.g. scene query refits). Rotations are expected normalized, as Transform keeps them
+    class ENGINE_API TransformBatch
+    {
+    public:
+
+        // Four transforms at a time with SSE, the remainder (and everything on targets without it) goes through ComposeScalar
+        static void Compose(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* outMatrices, size_t count);
+        // One transform at a time, same math as Transform::GetMatrix
+        static void ComposeScalar(const glm::vec3* positions, const glm::quat* rotations, const glm::vec3* scales, glm::mat4* outMatrices, size_t count);
+
+        // Times glm translate, rotate and scale multiplies against both paths on random transforms and prints the results
+        static void Benchmark(std::ostream& stream, size_t totalTransforms = 10000, unsigned int totalIterations = 100);
+    };
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "EngineAPI.h"
+
+namespace Glacirer
+{
+    // What a tracked block of memory is used for, GPU categories come first
+    enum class MemoryCategory : uint8_t
+    {
+        Textures,
+        Cubemaps,
+        RenderTargets,
+        ShadowMaps,
+        VertexBuffers,
+        IndexBuffers,
+        GeometryBuffers,
+        UniformBuffers,
+        RingBuffers,
+        MeshData,
+        SceneQueries,
+        FrameArenas,
+        Count
+    };
+
+    struct MemoryCategoryStats
+    {
+        size_t LiveBytes{0};
+        size_t PeakBytes{0};
+        unsigned int TotalResources{0};
+    };
+
+    struct MemoryResourceInfo
+    {
+        std::string Name{};
+        MemoryCategory Category{MemoryCategory::Textures};
+        size_t Bytes{0};
+    };
+
+    // Bytes held by a single resource, registered for as long as it lives. Owners keep one as a member and update it
+    // whenever their storage is (re)specified, their destructor takes the bytes out of the totals
+    class ENGINE_API TrackedMemory
+    {
+    public:
+
+        explicit TrackedMemory(MemoryCategory category);
+        ~TrackedMemory();
+        TrackedMemory(const TrackedMemory&) = delete;
+        TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+        void SetSize(size_t bytes);
+        // Moves the bytes to another category, e.g. textures created as framebuffer attachments
+        void SetCategory(MemoryCategory category);
+        void SetName(const std::string& name);
+
+        size_t GetSize() const { return m_Size; }
+        MemoryCategory GetCategory() const { return m_Category; }
+        const std::string& GetName() const { return m_Name; }
+
+    private:
+
+        friend class MemoryTracker;
+
+        std::string m_Name{};
+        size_t m_Size{0};
+        MemoryCategory m_Category;
+    };
+
+    // Live and peak bytes per category of every tracked resource, to answer how much GPU memory a level uses
+    // and to size budgets (e.g. texture streaming or shadow maps). Nothing is queried from the driver,
+    // GPU sizes are the ones requested when specifying storage (drivers may pad or compress them).
+    // CPU categories only cover the large engine owned buffers, heap allocations per subsystem are recorded
+    // by AllocationCounter tags in debug builds (reported by Dump too)
+    class ENGINE_API MemoryTracker
+    {
+    public:
+
+        constexpr static size_t DEFAULT_DUMP_RESOURCES = 32;
+
+        static const char* GetCategoryName(MemoryCategory category);
+        static bool IsGpuCategory(MemoryCategory category);
+
+        static MemoryCategoryStats GetCategoryStats(MemoryCategory category);
+        static size_t GetLiveGpuBytes();
+        static size_t GetPeakGpuBytes();
+        // Sum of the tracked CPU categories, not the heap usage of the process
+        static size_t GetLiveCpuBytes();
+        static size_t GetPeakCpuBytes();
+        // Largest resources first, at most maxResources of them
+        static std::vector<MemoryResourceInfo> GetLargestResources(size_t maxResources);
+
+        // Plain text report of the totals, tagged heap allocations and largest resources, usable without the editor (e.g. to a log or std::cout)
+        static void Dump(std::ostream& stream, size_t maxResources = DEFAULT_DUMP_RESOURCES);
+
+    private:
+
+        friend class TrackedMemory;
+
+        // Resources can be created and destroyed on loading threads, all of these lock
+        static void Register(TrackedMemory& trackedMemory);
+        static void Unregister(TrackedMemory& trackedMemory);
+        static void Update(TrackedMemory& trackedMemory, MemoryCategory category, size_t bytes);
+        static void Rename(TrackedMemory& trackedMemory, const std::string& name);
+    };
+}
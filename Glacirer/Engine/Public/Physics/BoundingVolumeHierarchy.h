@@ -0,0 +1,163 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include "Rendering/Bounds.h"
+
+namespace Glacirer
+{
+    namespace Physics
+    {
+        // Binary tree of bounding boxes over primitives given by their bounds (objects, triangles...), primitives themselves
+        // are only referred to by index. Nodes live in a flat array, children of a node are next to each other and
+        // always placed after their parent, so the tree can be refit bottom-up by walking the array backwards
+        class BoundingVolumeHierarchy
+        {
+        public:
+
+            struct Node
+            {
+                Rendering::Bounds Bounds{};
+                // Inner node: index of its first child, the second one follows it. Leaf: first of its primitive indices
+                uint32_t FirstIndex{0};
+                uint32_t TotalPrimitives{0};
+
+                bool IsLeaf() const { return TotalPrimitives > 0; }
+            };
+
+            // Splits at the median of primitive centers along the widest axis until leaves hold up to maxLeafPrimitives
+            void Build(const std::vector<Rendering::Bounds>& primitiveBounds, uint32_t maxLeafPrimitives);
+            // Updates node bounds to moved primitives keeping the tree layout, tree quality degrades the more they move
+            void Refit(const std::vector<Rendering::Bounds>& primitiveBounds);
+            void Clear();
+
+            bool IsEmpty() const { return m_Nodes.empty(); }
+            const std::vector<Node>& GetNodes() const { return m_Nodes; }
+            // Leaves refer to ranges of this, in tree order
+            const std::vector<uint32_t>& GetPrimitiveIndices() const { return m_PrimitiveIndices; }
+            size_t GetCpuMemory() const { return m_Nodes.capacity() * sizeof(Node) + m_PrimitiveIndices.capacity() * sizeof(uint32_t); }
+
+            // Distance along the ray where it enters the box (0 if it starts inside), false if it misses it before maxDistance
+            static bool IntersectRay(const Rendering::Bounds& bounds, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& outDistance);
+
+            // Visits leaves whose bounds overlap the query, nodeTest(const Bounds&) decides on each node.
+            // leafVisitor(const Node&) returns false to stop the traversal
+            template <typename TNodeTest, typename TLeafVisitor>
+            void Query(TNodeTest&& nodeTest, TLeafVisitor&& leafVisitor) const
+            {
+                if(m_Nodes.empty())
+                {
+                    return;
+                }
+
+                uint32_t stack[MAX_DEPTH];
+                uint32_t stackSize = 0;
+                stack[stackSize++] = 0;
+
+                while(stackSize > 0)
+                {
+                    const Node& node = m_Nodes[stack[--stackSize]];
+
+                    if(!nodeTest(node.Bounds))
+                    {
+                        continue;
+                    }
+
+                    if(node.IsLeaf())
+                    {
+                        if(!leafVisitor(node))
+                        {
+                            return;
+                        }
+
+                        continue;
+                    }
+
+                    stack[stackSize++] = node.FirstIndex;
+                    stack[stackSize++] = node.FirstIndex + 1;
+                }
+            }
+
+            // Visits leaves the ray goes through, nearest child first. leafVisitor(const Node&) tests the leaf primitives
+            // and lowers maxDistance to the closest hit found, so farther nodes get skipped
+            template <typename TLeafVisitor>
+            void Raycast(const glm::vec3& origin, const glm::vec3& direction, float& maxDistance, TLeafVisitor&& leafVisitor) const
+            {
+                if(m_Nodes.empty())
+                {
+                    return;
+                }
+
+                const glm::vec3 inverseDirection = 1.f / direction;
+
+                float rootDistance;
+                if(!IntersectRay(m_Nodes[0].Bounds, origin, inverseDirection, maxDistance, rootDistance))
+                {
+                    return;
+                }
+
+                struct StackEntry
+                {
+                    uint32_t NodeIndex;
+                    float Distance;
+                };
+
+                StackEntry stack[MAX_DEPTH];
+                uint32_t stackSize = 0;
+                stack[stackSize++] = StackEntry{0, rootDistance};
+
+                while(stackSize > 0)
+                {
+                    const StackEntry entry = stack[--stackSize];
+
+                    // A closer hit may have been found since the node was pushed
+                    if(entry.Distance > maxDistance)
+                    {
+                        continue;
+                    }
+
+                    const Node& node = m_Nodes[entry.NodeIndex];
+
+                    if(node.IsLeaf())
+                    {
+                        leafVisitor(node);
+                        continue;
+                    }
+
+                    float firstDistance;
+                    float secondDistance;
+                    const bool bHitsFirst = IntersectRay(m_Nodes[node.FirstIndex].Bounds, origin, inverseDirection, maxDistance, firstDistance);
+                    const bool bHitsSecond = IntersectRay(m_Nodes[node.FirstIndex + 1].Bounds, origin, inverseDirection, maxDistance, secondDistance);
+
+                    // Farther child pushed first so the nearer one is popped next
+                    if(bHitsFirst && bHitsSecond)
+                    {
+                        const bool bIsFirstNearer = firstDistance <= secondDistance;
+                        stack[stackSize++] = bIsFirstNearer ? StackEntry{node.FirstIndex + 1, secondDistance} : StackEntry{node.FirstIndex, firstDistance};
+                        stack[stackSize++] = bIsFirstNearer ? StackEntry{node.FirstIndex, firstDistance} : StackEntry{node.FirstIndex + 1, secondDistance};
+                    }
+                    else if(bHitsFirst)
+                    {
+                        stack[stackSize++] = StackEntry{node.FirstIndex, firstDistance};
+                    }
+                    else if(bHitsSecond)
+                    {
+                        stack[stackSize++] = StackEntry{node.FirstIndex + 1, secondDistance};
+                    }
+                }
+            }
+
+        private:
+
+            // Median splits keep the depth around log2 of primitive count, enough for any 32 bit count
+            constexpr static uint32_t MAX_DEPTH = 64;
+
+            std::vector<Node> m_Nodes{};
+            std::vector<uint32_t> m_PrimitiveIndices{};
+
+            void BuildNode(uint32_t nodeIndex, uint32_t firstPrimitive, uint32_t totalPrimitives, uint32_t maxLeafPrimitives,
+                const std::vector<Rendering::Bounds>& primitiveBounds, const std::vector<glm::vec3>& primitiveCenters);
+        };
+    }
+}
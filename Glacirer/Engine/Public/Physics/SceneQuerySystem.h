@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "BoundingVolumeHierarchy.h"
+#include "MemoryTracker.h"
+
+namespace Glacirer
+{
+    class MeshComponent;
+
+    namespace Physics
+    {
+        struct RaycastHit
+        {
+            std::shared_ptr<Glacirer::MeshComponent> MeshComponent{};
+            float Distance{0.f};
+            glm::vec3 Point{0.f};
+            glm::vec3 Normal{0.f};
+            unsigned int TriangleIndex{0};
+        };
+
+        // Ray and overlap queries against the triangles of mesh components in the world, no GPU involved.
+        // A BVH over component world bounds finds the candidates, then the triangle BVH of their mesh (built the first time
+        // the mesh is queried) is tested. Moved components refit the tree lazily on the next query, components
+        // added since the last build are tested one by one until enough changes pile up to rebuild it
+        class SceneQuerySystem
+        {
+        public:
+
+            constexpr static uint32_t MAX_LEAF_COMPONENTS = 4;
+            // Components added or removed since the tree was built before the next query rebuilds it
+            constexpr static uint32_t MAX_PENDING_CHANGES = 64;
+
+            void AddMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent);
+            void RemoveMeshComponent(const std::shared_ptr<MeshComponent>& meshComponent);
+            void Clear();
+            // Transforms may have changed, checked on the next query
+            void MarkTransformsOutdated() { bAreTransformsOutdated = true; }
+
+            // Closest hit along the ray up to maxDistance, triangles are hit from either side
+            bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RaycastHit& outHit);
+            // Components with triangles inside the shape are appended to outMeshComponents
+            void OverlapSphere(const glm::vec3& center, float radius, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents);
+            void OverlapBox(const glm::vec3& center, const glm::vec3& halfExtents, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents);
+
+            unsigned int GetTotalMeshComponents() const { return static_cast<unsigned int>(m_EntryIndices.size()); }
+            size_t GetCpuMemory() const;
+
+        private:
+
+            struct Entry
+            {
+                // Null once removed, the entry stays in the tree until the next build
+                std::shared_ptr<Glacirer::MeshComponent> MeshComponent{};
+                glm::mat4 Matrix{1.f};
+                unsigned int TransformVersion{0};
+                bool bIsBoundsOutdated{true};
+            };
+
+            std::vector<Entry> m_Entries{};
+            // Bounds of each entry in world space, kept apart from entries for the tree refit
+            std::vector<Rendering::Bounds> m_EntryBounds{};
+            std::unordered_map<const MeshComponent*, uint32_t> m_EntryIndices{};
+            BoundingVolumeHierarchy m_BVH{};
+            // Entries before this index are in the tree
+            uint32_t m_TotalIndexedEntries{0};
+            uint32_t m_TotalRemovedEntries{0};
+            bool bAreTransformsOutdated{false};
+            // Scratch for the moved entries of a refresh, kept so refits don't allocate
+            std::vector<uint32_t> m_MovedEntryIndices{};
+            std::vector<glm::vec3> m_MovedPositions{};
+            std::vector<glm::quat> m_MovedRotations{};
+            std::vector<glm::vec3> m_MovedScales{};
+            std::vector<glm::mat4> m_MovedMatrices{};
+            // Refreshed whenever entries are added or the tree is built
+            TrackedMemory m_TrackedMemory{MemoryCategory::SceneQueries};
+
+            void Refresh();
+            void Rebuild();
+            // Recomputes bounds of entries from firstEntryIndex on whose transform changed, true if any of them is in the tree
+            bool UpdateEntryBounds(uint32_t firstEntryIndex);
+
+            // Calls entryVisitor(Entry&) on live entries whose bounds pass boundsTest, from the tree and unindexed ones
+            template <typename TBoundsTest, typename TEntryVisitor>
+            void QueryEntries(TBoundsTest&& boundsTest, TEntryVisitor&& entryVisitor);
+        };
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include "BoundingVolumeHierarchy.h"
+
+namespace Glacirer
+{
+    namespace Physics
+    {
+        struct RayTriangleHit
+        {
+            // In units of the ray direction length
+            float Distance{0.f};
+            unsigned int TriangleIndex{0};
+            // Barycentric coordinates of the hit point, relative to the triangle second and third vertices
+            glm::vec2 Barycentrics{0.f};
+            // Not normalized, facing the side vertices are counter-clockwise from
+            glm::vec3 Normal{0.f};
+        };
+
+        // Triangles of a mesh in object space, grouped by four in structure of arrays packets (one per BVH leaf)
+        // so a ray is tested against a whole leaf at once with SSE
+        class TriangleBVH
+        {
+        public:
+
+            constexpr static uint32_t PACKET_SIZE = 4;
+
+            TriangleBVH(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices);
+
+            // Closest triangle, from either side, hit before maxDistance. Direction doesn't have to be normalized
+            bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayTriangleHit& outHit) const;
+            // Whether any triangle, once transformed by modelMatrix, overlaps the world space shape
+            bool OverlapsSphere(const glm::mat4& modelMatrix, const glm::vec3& center, float radius) const;
+            bool OverlapsBox(const glm::mat4& modelMatrix, const Rendering::Bounds& box) const;
+
+            unsigned int GetTotalTriangles() const { return m_TotalTriangles; }
+            size_t GetCpuMemory() const;
+
+        private:
+
+            // First vertex and the two edges starting at it, unused lanes have null edges and can't be hit
+            struct TrianglePacket
+            {
+                float Vertex0[3][PACKET_SIZE];
+                float Edge1[3][PACKET_SIZE];
+                float Edge2[3][PACKET_SIZE];
+                uint32_t Triangles[PACKET_SIZE];
+                uint32_t TotalTriangles;
+            };
+
+            BoundingVolumeHierarchy m_BVH{};
+            std::vector<TrianglePacket> m_Packets{};
+            // Packet of each leaf node, indexed like BVH nodes
+            std::vector<uint32_t> m_NodePackets{};
+            unsigned int m_TotalTriangles{0};
+
+            static bool IntersectPacket(const TrianglePacket& packet, const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayTriangleHit& outHit);
+            static void GetTriangle(const TrianglePacket& packet, uint32_t lane, const glm::mat4& modelMatrix, glm::vec3 outVertices[3]);
+
+            template <typename TNodeTest, typename TTriangleTest>
+            bool AnyTriangle(const glm::mat4& modelMatrix, TNodeTest&& nodeTest, TTriangleTest&& triangleTest) const;
+        };
+    }
+}
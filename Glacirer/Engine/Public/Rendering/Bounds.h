@@ -0,0 +1,69 @@
+#pragma once
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        // Axis aligned bounding box
+        struct Bounds
+        {
+            glm::vec3 Min{std::numeric_limits<float>::max()};
+            glm::vec3 Max{std::numeric_limits<float>::lowest()};
+
+            bool IsValid() const { return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z; }
+            glm::vec3 GetCenter() const { return (Min + Max) * 0.5f; }
+            glm::vec3 GetExtents() const { return (Max - Min) * 0.5f; }
+
+            void Encapsulate(const glm::vec3& point)
+            {
+                Min = glm::min(Min, point);
+                Max = glm::max(Max, point);
+            }
+
+            void Encapsulate(const Bounds& other)
+            {
+                Min = glm::min(Min, other.Min);
+                Max = glm::max(Max, other.Max);
+            }
+
+            // Bounds enclosing this box after transformation, using absolute matrix to avoid transforming all 8 corners
+            Bounds Transform(const glm::mat4& matrix) const
+            {
+                const glm::vec3 center = glm::vec3(matrix * glm::vec4(GetCenter(), 1.f));
+                const glm::mat3 absoluteMatrix{glm::abs(glm::vec3(matrix[0])), glm::abs(glm::vec3(matrix[1])), glm::abs(glm::vec3(matrix[2]))};
+                const glm::vec3 extents = absoluteMatrix * GetExtents();
+
+                Bounds transformed{};
+                transformed.Min = center - extents;
+                transformed.Max = center + extents;
+
+                return transformed;
+            }
+
+            // Conservative, only false when all corners are outside the same clip plane
+            bool IsInsideFrustum(const glm::mat4& viewProjection) const
+            {
+                glm::bvec3 bAllBelowMin{true};
+                glm::bvec3 bAllAboveMax{true};
+
+                for(int corner = 0; corner < 8; corner++)
+                {
+                    const glm::vec4 clipPosition = viewProjection * glm::vec4(
+                        corner & 1 ? Max.x : Min.x,
+                        corner & 2 ? Max.y : Min.y,
+                        corner & 4 ? Max.z : Min.z,
+                        1.f);
+
+                    const glm::vec3 position{clipPosition};
+                    bAllBelowMin = bAllBelowMin && glm::lessThan(position, glm::vec3(-clipPosition.w));
+                    bAllAboveMax = bAllAboveMax && glm::greaterThan(position, glm::vec3(clipPosition.w));
+                }
+
+                return !glm::any(bAllBelowMin) && !glm::any(bAllAboveMax);
+            }
+        };
+    }
+}
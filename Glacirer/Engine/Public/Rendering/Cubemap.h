@@ -1,6 +1,10 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <string>
 
+#include "MemoryTracker.h"
+
 namespace Glacirer
 {
     namespace Rendering
@@ -38,13 +42,17 @@ namespace Glacirer
                 const TextureSettings& settings);
 
             unsigned int GetRendererId() const { return m_RendererId; }
-            void SetName(const std::string& name) { m_Name = name; }
+            void SetName(const std::string& name) { m_Name = name; m_TrackedMemory.SetName(name); }
             std::string GetName() const { return m_Name; }
+            size_t GetGpuMemory() const;
+            void SetMemoryCategory(MemoryCategory category) { m_TrackedMemory.SetCategory(category); }
 
         private:
 
             unsigned int m_RendererId{0};
             std::string m_Name{};
+            std::array<size_t, TOTAL_SIDES> m_SideSizes{};
+            TrackedMemory m_TrackedMemory{MemoryCategory::Cubemaps};
         };
     }
 }
@@ -0,0 +1,46 @@
+#pragma once
+#include <memory>
+
+#include "MeshRenderer.h"
+#include "RenderGraph.h"
+#include "Resolution.h"
+#include <glm/vec4.hpp>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Mesh;
+        class Shader;
+
+        // Opaque geometry is rendered once into a G-buffer (albedo, position, normal/shininess, specular)
+        // and lighting is accumulated on a single fullscreen pass, so shading cost no longer scales with overdraw.
+        // G-buffer and lighting targets are transient render graph targets, only pooled while deferred path is in use
+        class DeferredShadingSystem
+        {
+        public:
+
+            DeferredShadingSystem();
+
+            // Main color attachment holds albedo, additional ones are position, normal (w = shininess) and specular
+            static RenderTargetDesc GetGBufferDesc(const Resolution& resolution);
+            // Not multisampled, receives G-buffer depth/stencil so forward passes (skybox, transparents, outline) can run on top
+            static RenderTargetDesc GetLightingDesc(const Resolution& resolution);
+
+            // Geometry pass outputs Blinn-Phong inputs, materials using any other shader have to be forward shaded
+            static bool IsShadedByGeometryPass(const Material& material);
+            void RenderLightingPass(const RenderGraphContext& context, RenderGraphResource gBuffer, RenderGraphResource lighting, const glm::vec4& clearColor) const;
+
+            const std::shared_ptr<Shader>& GetGeometryShader() const { return m_GeometryShader; }
+            const std::shared_ptr<Shader>& GetLightingShader() const { return m_LightingShader; }
+
+        private:
+
+            std::shared_ptr<Mesh> m_ScreenQuad{};
+            MeshRenderer m_MeshRenderer{};
+            std::shared_ptr<Shader> m_GeometryShader{};
+            std::shared_ptr<Shader> m_LightingShader{};
+            std::shared_ptr<Material> m_LightingMaterial{};
+        };
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "EngineAPI.h"
 #include "Resolution.h"
+#include <glm/vec4.hpp>
 
 namespace Glacirer
 {
@@ -11,12 +12,17 @@ namespace Glacirer
         public:
 
             void SetViewportResolution(const Resolution& resolution) const;
+            void SetClearColor(const glm::vec4& clearColor) const;
             void Clear() const;
+            // Keeps depth and stencil, e.g. when they were copied from another framebuffer
+            void ClearColorBuffer() const;
             void EnableDepthTest() const;
             void DisableDepthTest() const;
             void EnableDepthWrite() const;
             void DisableDepthWrite() const;
             void SetDepthFunction(const unsigned int function) const;
+            void EnableColorWrite() const;
+            void DisableColorWrite() const;
             void EnableStencilTest() const;
             void DisableStencilTest() const;
             void EnableStencilWrite() const;
@@ -0,0 +1,69 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <glm/mat3x4.hpp>
+#include <glm/mat4x4.hpp>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class DynamicRingBuffer;
+        class GeometryBuffer;
+        class InstancedArray;
+        class Material;
+        class Mesh;
+        class Shader;
+        struct DynamicAllocation;
+
+        // Command layout read by glMultiDrawElementsIndirect
+        struct DrawElementsIndirectCommand
+        {
+            unsigned int TotalIndices;
+            unsigned int TotalInstances;
+            unsigned int FirstIndex;
+            int BaseVertex;
+            unsigned int BaseInstance;
+        };
+
+        // Instances of any meshes living in the same geometry buffer, drawn with the same material. Each run of instances
+        // of a mesh becomes a draw command and the whole batch is submitted at once with glMultiDrawElementsIndirect
+        // (GL 4.3 or ARB_multi_draw_indirect), falling back to one glDrawElementsInstancedBaseVertex per command.
+        // Commands are drawn in the order they were added, so sorted draws can be batched too.
+        // Instance matrices (their first three rows) and commands are streamed through the frame ring buffer
+        class DrawBatch
+        {
+        public:
+
+            DrawBatch(unsigned int maxInstances, DynamicRingBuffer& ringBuffer);
+            DrawBatch(const DrawBatch&) = delete;
+            DrawBatch& operator=(const DrawBatch&) = delete;
+
+            static bool IsMultiDrawIndirectSupported();
+
+            // If not, the batch has to be submitted before adding the mesh
+            bool CanAdd(const Mesh& mesh) const;
+            void Add(const Mesh& mesh, const glm::mat4& instanceMatrix);
+            // Instance matrices go through the instanced array attributes, the batch is empty afterwards
+            void Submit(const Material& material, const std::shared_ptr<Shader>& overrideShader, InstancedArray& instancedArray);
+
+            bool IsEmpty() const { return m_Commands.empty(); }
+
+        private:
+
+            DynamicRingBuffer& m_RingBuffer;
+            std::vector<DrawElementsIndirectCommand> m_Commands{};
+            // Transposed, so each column holds a row of the instance matrix
+            std::vector<glm::mat3x4> m_InstanceRows{};
+            const GeometryBuffer* m_GeometryBuffer{nullptr};
+            const Mesh* m_LastMesh{nullptr};
+            unsigned int m_MaxInstances{0};
+            bool bUsesMultiDrawIndirect{false};
+
+            void Clear();
+            void DrawMultiIndirect() const;
+            void DrawEachCommand(InstancedArray& instancedArray, const DynamicAllocation& instances) const;
+        };
+    }
+}
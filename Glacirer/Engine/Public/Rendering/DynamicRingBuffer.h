@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+#include "MemoryTracker.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        // Where data written this frame ended up, to bind with glBindBufferRange or as attribute offset
+        struct DynamicAllocation
+        {
+            unsigned int BufferId{0};
+            unsigned int Offset{0};
+        };
+
+        // Buffer for data rewritten every frame (instance matrices, camera and light uniforms), split in one region per
+        // frame in flight. Each write takes the next free bytes of the current frame region and is never overwritten until
+        // the GPU signals the fence of that frame, so writing never waits for draws still reading earlier data.
+        // Persistently mapped when GL 4.4 or ARB_buffer_storage is available, otherwise each write maps its range
+        // unsynchronized (fences already guarantee it's not in use). Orphaning isn't used as a fallback since it would
+        // also discard uniform ranges bound earlier in the frame.
+        // A frame writing more than its region grows the buffer, the old one is deleted once the GPU is done with it
+        class DynamicRingBuffer
+        {
+        public:
+
+            constexpr static unsigned int FRAMES_IN_FLIGHT = 3;
+
+            explicit DynamicRingBuffer(unsigned int frameCapacity);
+            ~DynamicRingBuffer();
+            DynamicRingBuffer(const DynamicRingBuffer&) = delete;
+            DynamicRingBuffer& operator=(const DynamicRingBuffer&) = delete;
+
+            static bool IsPersistentMappingSupported();
+
+            // Waits, if needed, until the GPU is done with the region this frame is going to write
+            void BeginFrame();
+            void EndFrame();
+
+            // Data is only valid until the end of the frame, the returned buffer may change if the ring grows
+            DynamicAllocation Write(const void* data, unsigned int size, unsigned int alignment);
+
+            unsigned int GetRendererID() const { return m_RendererID; }
+            unsigned int GetFrameCapacity() const { return m_FrameCapacity; }
+            // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, offsets of uniform ranges have to be multiple of it
+            unsigned int GetUniformOffsetAlignment() const { return m_UniformOffsetAlignment; }
+            size_t GetGpuMemory() const { return static_cast<size_t>(m_FrameCapacity) * FRAMES_IN_FLIGHT; }
+
+        private:
+
+            // Buffer replaced while growing, kept alive until the frame that last used it is done on GPU
+            struct RetiredBuffer
+            {
+                unsigned int RendererID{0};
+                void* Fence{nullptr}; // GLsync, null until its last frame ends
+            };
+
+            unsigned int m_RendererID{0};
+            unsigned int m_FrameCapacity{0};
+            unsigned int m_UniformOffsetAlignment{256};
+            unsigned char* m_MappedData{nullptr}; // Whole buffer, only if persistently mapped
+            void* m_FrameFences[FRAMES_IN_FLIGHT]{}; // GLsync of the last frame that wrote each region
+            unsigned int m_FrameIndex{0};
+            unsigned int m_FrameOffset{0}; // Next free byte, relative to current frame region
+            std::vector<RetiredBuffer> m_RetiredBuffers{};
+            bool bIsPersistentlyMapped{false};
+            TrackedMemory m_TrackedMemory{MemoryCategory::RingBuffers};
+
+            void CreateBuffer();
+            void Grow(unsigned int minFrameCapacity);
+            static void WaitFence(void*& fence);
+            void DeleteFinishedRetiredBuffers();
+        };
+    }
+}
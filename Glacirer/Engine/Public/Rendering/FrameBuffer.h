@@ -20,6 +20,9 @@ namespace Glacirer
             bool UseDepthCubemap{false};
             std::vector<TextureSettings> AdditionalColorAttachments{};
             unsigned int Samples{1};
+            unsigned int ColorInternalFormat{GL_RGB};
+            unsigned int ColorFormat{GL_RGB};
+            unsigned int ColorType{GL_UNSIGNED_BYTE};
         };
 
         class Framebuffer
@@ -53,6 +56,10 @@ namespace Glacirer
             glm::vec4 GetClearColor() const { return m_ClearColor; }
 
             void ResolveMultisampleImage(const Rendering::Resolution& destinationResolution) const;
+            // Copies only the bottom left sourceRegion, for framebuffers rendered through a smaller viewport
+            void ResolveMultisampleImage(const Rendering::Resolution& sourceRegion, const Rendering::Resolution& destinationRegion) const;
+            void BlitDepthStencilBuffer(const Rendering::Resolution& destinationResolution) const;
+            void BlitDepthStencilBuffer(const Rendering::Resolution& sourceRegion, const Rendering::Resolution& destinationRegion) const;
 
         private:
     
@@ -64,6 +71,7 @@ namespace Glacirer
             std::vector<std::shared_ptr<Texture>> m_AdditionalColorTextures{};
             glm::vec4 m_ClearColor{0.f, 0.f, 0.f, 1.f};
             Rendering::Resolution m_Resolution{};
+            TrackedMemory m_RenderBufferMemory{MemoryCategory::RenderTargets};
 
             void Create(const FramebufferSettings& settings);
             void CreateColorAttachments(const FramebufferSettings& settings);
@@ -72,6 +80,8 @@ namespace Glacirer
             void CreateDepthMap2DAttachment(const FramebufferSettings& settings);
             void CreateDepthMapCubemapAttachment(const FramebufferSettings& settings);
             void CreateRenderBuffer(const unsigned int samples);
+            // Attachments are counted as render targets, or shadow maps for depth only framebuffers
+            void TrackAttachmentMemory(const FramebufferSettings& settings) const;
         };
     }
 }
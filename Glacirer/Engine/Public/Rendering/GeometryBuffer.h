@@ -0,0 +1,78 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include "MemoryTracker.h"
+#include "RangeAllocator.h"
+#include "VertexArray.h"
+#include "VertexBufferLayout.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        // Where a mesh lives inside a geometry buffer, in vertices and indices (not bytes)
+        struct GeometryAllocation
+        {
+            unsigned int BaseVertex{0};
+            unsigned int TotalVertices{0};
+            unsigned int FirstIndex{0};
+            unsigned int TotalIndices{0};
+        };
+
+        // Vertices and indices of many meshes with the same vertex layout, sub-allocated from a single vertex and index buffer
+        // behind a single VAO. Indices are stored relative to the mesh first vertex (drawn with a base vertex),
+        // so 16 bit indices work for any mesh under 65536 vertices no matter where it's placed.
+        // Buffers grow by copying their content into larger ones, meshes keep their allocation
+        class GeometryBuffer
+        {
+        public:
+
+            constexpr static unsigned int MAX_SHORT_INDEX_VERTICES = 65536;
+
+            GeometryBuffer(VertexBufferLayout&& layout, bool bUsesShortIndices, unsigned int vertexCapacity, unsigned int indexCapacity);
+            ~GeometryBuffer();
+            GeometryBuffer(const GeometryBuffer&) = delete;
+            GeometryBuffer& operator=(const GeometryBuffer&) = delete;
+
+            // Buffer shared by meshes created with the same layout key (which has to identify the layout) and index size.
+            // Layout is only used if the buffer doesn't exist yet, it's released once no mesh uses it
+            static std::shared_ptr<GeometryBuffer> GetShared(unsigned int layoutKey, bool bUsesShortIndices, VertexBufferLayout&& layout);
+
+            // Vertex data has to match the buffer layout, indices go from 0 to totalVertices
+            GeometryAllocation Allocate(const void* verticesData, unsigned int totalVertices, const std::vector<unsigned int>& indices);
+            void Free(const GeometryAllocation& allocation);
+            // Copies the allocation vertices back from GPU, stalls until pending uploads are done (meant for load time)
+            void ReadVertices(const GeometryAllocation& allocation, void* outVerticesData) const;
+            // Same as ReadVertices, indices are widened to 32 bits and still relative to the mesh first vertex
+            void ReadIndices(const GeometryAllocation& allocation, std::vector<unsigned int>& outIndices) const;
+
+            void Bind() const { m_VAO->Bind(); }
+            VertexArray& GetVertexArray() const { return *m_VAO; }
+            // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, to be used on draw calls
+            unsigned int GetIndexType() const;
+            unsigned int GetIndexSize() const { return bUsesShortIndices ? 2 : 4; }
+            unsigned int GetVertexStride() const { return m_Layout.GetStride(); }
+            size_t GetGpuMemory() const;
+
+        private:
+
+            constexpr static unsigned int GROWTH_FACTOR = 2;
+
+            std::unique_ptr<VertexArray> m_VAO{};
+            VertexBufferLayout m_Layout{};
+            unsigned int m_VertexBufferId{0};
+            unsigned int m_IndexBufferId{0};
+            RangeAllocator m_VertexAllocator;
+            RangeAllocator m_IndexAllocator;
+            bool bUsesShortIndices{false};
+            TrackedMemory m_TrackedMemory{MemoryCategory::GeometryBuffers};
+
+            unsigned int AllocateVertices(unsigned int totalVertices);
+            unsigned int AllocateIndices(unsigned int totalIndices);
+            // Replaces the buffer by a larger one holding the same data, returns the new buffer id
+            static unsigned int GrowBuffer(unsigned int bufferId, unsigned int size, unsigned int newSize);
+            void SetupVertexArray() const;
+        };
+    }
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "MemoryTracker.h"
 
 namespace Glacirer
 {
@@ -9,12 +10,17 @@ namespace Glacirer
         public:
 
             IndexBuffer(const unsigned int* Data, unsigned int Count);
+            IndexBuffer(const unsigned short* Data, unsigned int Count);
             ~IndexBuffer();
 
             void Bind() const;
             void Unbind() const;
 
             unsigned int GetCount() const { return m_Count; }
+            // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, to be used on draw calls
+            unsigned int GetIndexType() const;
+            bool UsesShortIndices() const { return bUsesShortIndices; }
+            unsigned int GetSize() const { return m_Count * (bUsesShortIndices ? 2 : 4); }
 
         private:
 
@@ -22,6 +28,8 @@ namespace Glacirer
     
             unsigned int m_RendererID{0};
             unsigned int m_Count;
+            bool bUsesShortIndices{false};
+            TrackedMemory m_TrackedMemory{MemoryCategory::IndexBuffers};
         };
     }
 }
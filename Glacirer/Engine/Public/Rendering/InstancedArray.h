@@ -1,6 +1,5 @@
 #pragma once
-#include <memory>
-#include "VertexBuffer.h"
+#include "DynamicRingBuffer.h"
 #include "VertexBufferLayout.h"
 
 namespace Glacirer
@@ -9,21 +8,24 @@ namespace Glacirer
     {
         class VertexArray;
 
+        // Per instance attributes streamed through the frame ring buffer. Instance data has no fixed place,
+        // so the instanced attributes of a VAO are pointed at each upload before drawing
         class InstancedArray
         {
         public:
 
-            InstancedArray(const void* data, unsigned int size, bool bIsDynamic, VertexBufferLayout&& layout);
+            InstancedArray(VertexBufferLayout&& layout, DynamicRingBuffer& ringBuffer);
 
             void SetupInstancedAttributesFor(VertexArray& vertexArray);
-            void SetSubData(const void* data, unsigned int size) const;
-    
-            void Bind() const;
-            void Unbind() const;
-    
+            DynamicAllocation Upload(const void* data, unsigned int size) const;
+            // Vertex array has to be bound, firstInstance is counted from the start of the upload
+            void BindAttributesTo(VertexArray& vertexArray, const DynamicAllocation& allocation, unsigned int firstInstance = 0);
+
+            unsigned int GetStride() const { return m_Layout.GetStride(); }
+
         private:
 
-            std::unique_ptr<VertexBuffer> m_VBO{};
+            DynamicRingBuffer& m_RingBuffer;
             VertexBufferLayout m_Layout{};
         };
     }
@@ -19,6 +19,7 @@ namespace Glacirer
 
     namespace Rendering
     {
+        class DynamicRingBuffer;
         class Shader;
     
         struct AmbientLightShaderData
@@ -111,7 +112,7 @@ namespace Glacirer
         {
         public:
 
-            LightingSystem();
+            explicit LightingSystem(DynamicRingBuffer& ringBuffer);
             void Shutdown();
         
             void AddDirectionalLight(const std::shared_ptr<DirectionalLightComponent>& directionalLightComponent);
@@ -178,7 +179,7 @@ namespace Glacirer
             void UpdatePointShadowMapUniformBuffers();
             void UpdateSpotShadowMapUniformBuffers();
 
-            void CreateUniformBuffers();
+            void CreateUniformBuffers(DynamicRingBuffer& ringBuffer);
             void BindShadowMapTextures();
             void UnbindShadowMapTextures();
             void CreateShadowMaps();
@@ -43,10 +43,14 @@ namespace Glacirer
             void SetTexture(const std::string& name, const std::shared_ptr<Texture>& texture, unsigned int slot);
             void SetCubemap(const std::string& name, const std::shared_ptr<Cubemap>& cubemap, unsigned int slot);
             void SetMat4(const std::string& name, const glm::mat4& matrix) const;
+            // Like SetMat4, set straight on the bound shader instead of stored as a property
+            void SetVec2(const std::string& name, const glm::vec2& value) const;
             void SetBool(const std::string& name, const bool value);
             void SetFloat(const std::string& name, const float value);
             void SetInt(const std::string& name, const int value);
             void SetRenderingMode(MaterialRenderingMode renderingMode);
+            // Shader variant without shadow sampling when false
+            void SetReceivesShadows(bool bReceivesShadows);
             void Bind() const;
             void Bind(Shader& shader) const;
             void Unbind() const;
@@ -59,6 +63,7 @@ namespace Glacirer
             void SetName(const std::string& name) { m_Name = name; }
             std::string GetName() const { return m_Name; }
             MaterialRenderingMode GetRenderingMode() const { return m_RenderingMode; }
+            bool ReceivesShadows() const { return bReceivesShadows; }
             const std::map<std::string, glm::vec4>& GetAllColorProperties() const { return m_ColorProperties; }
             const std::map<std::string, MaterialTextureProperty>& GetAllTextureProperties() const { return m_TextureProperties; }
             const std::map<std::string, bool>& GetAllBoolProperties() const { return m_BoolProperties; }
@@ -67,8 +72,15 @@ namespace Glacirer
 
         private:
 
+            // Shader variant keywords selected from the material state, see GetVariantShader
+            static constexpr const char* NO_SPECULAR_MAP_KEYWORD = "NO_SPECULAR_MAP";
+            static constexpr const char* NO_REFLECTION_KEYWORD = "NO_REFLECTION";
+            static constexpr const char* NO_SHADOWS_KEYWORD = "NO_SHADOWS";
+
             unsigned int m_Id{0};
             std::shared_ptr<Shader> m_Shader{};
+            // Resolved on the next bind after a property it depends on changes
+            mutable Shader* m_VariantShader{nullptr};
             std::map<std::string, glm::vec4> m_ColorProperties{};
             std::map<std::string, MaterialTextureProperty> m_TextureProperties{};
             std::map<std::string, bool> m_BoolProperties{};
@@ -77,9 +89,12 @@ namespace Glacirer
             std::map<std::string, int> m_IntProperties{};
     
             MaterialRenderingMode m_RenderingMode{MaterialRenderingMode::Opaque};
+            bool bReceivesShadows{true};
             std::string m_Name{};
 
             void PopulateValuesFrom(const ShaderProperties& shaderProperties);
+            // Lean variant of m_Shader for the features this material actually uses
+            Shader& GetVariantShader() const;
         };
     }
 }
@@ -3,18 +3,22 @@
 #include <string>
 #include <vector>
 
+#include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
-#include "IndexBuffer.h"
-#include "VertexArray.h"
-#include "VertexBuffer.h"
+#include "Bounds.h"
+#include "GeometryBuffer.h"
+#include "MemoryTracker.h"
 
 namespace Glacirer
 {
-    namespace Rendering
+    namespace Physics
     {
-        class VertexBufferLayout;
+        class TriangleBVH;
+    }
 
+    namespace Rendering
+    {
         struct Vertex
         {
             glm::vec3 Position;
@@ -22,24 +26,90 @@ namespace Glacirer
             glm::vec2 TexCoord;
         };
 
+        // GPU encoding of Vertex attributes, default is full precision floats (32 bytes per vertex)
+        struct VertexFormat
+        {
+            bool bQuantizePositions{false}; // 16 bits normalized inside mesh bounds, dequantized by the model matrix
+            bool bPackNormals{false}; // 10 bits per component
+            bool bUseHalfFloatTexCoords{false};
+        };
+
         class Mesh
         {
         public:
 
-            Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices);
-            Mesh(const void* verticesData, unsigned int verticesSize, const VertexBufferLayout& layout, const std::vector<unsigned int>& indices);
+            // Meshes only ever drawn (e.g. static batch chunks, coarser LODs) don't keep CPU geometry, see GetPositions
+            Mesh(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const VertexFormat& vertexFormat = VertexFormat{},
+                 bool bKeepCpuGeometry = true);
+            // Any layout (position expected first as 3 floats), gets a geometry buffer of its own instead of a shared one.
+            // Only drawn (screen quad, sky cube), no CPU geometry is kept
+            Mesh(const void* verticesData, unsigned int verticesSize, VertexBufferLayout&& layout, const std::vector<unsigned int>& indices);
+            // Vertices already encoded with PackVertices (e.g. mapped from mesh cache), bounds must be the ones used to encode them.
+            // CPU geometry is only kept when the import precision positions (totalVertices of them) are given
+            Mesh(const void* packedVerticesData, unsigned int totalVertices, const VertexFormat& vertexFormat, const Bounds& bounds,
+                 const void* indicesData, unsigned int totalIndices, bool bUsesShortIndices, const glm::vec3* cpuPositions);
+            ~Mesh();
 
-            VertexArray& GetVertexArray() const { return *m_VAO; }
-            IndexBuffer& GetIndexBuffer() const { return *m_IBO; }
-            void SetName(const std::string& name) { m_Name = name; }
+            static std::vector<unsigned char> PackVertices(const std::vector<Vertex>& vertices, const VertexFormat& vertexFormat, const Bounds& bounds);
+            // Decoded back from the geometry buffer, only for meshes using the Vertex layout (see HasCustomLayout)
+            std::vector<Vertex> ReadVertices() const;
+            std::vector<unsigned int> ReadIndices() const;
+
+            // Shared with every mesh on the same geometry buffer
+            VertexArray& GetVertexArray() const { return m_GeometryBuffer->GetVertexArray(); }
+            const GeometryBuffer& GetGeometryBuffer() const { return *m_GeometryBuffer; }
+            const GeometryAllocation& GetGeometryAllocation() const { return m_GeometryAllocation; }
+            void SetName(const std::string& name) { m_Name = name; m_CpuMemory.SetName(name); }
             std::string GetName() const { return m_Name; }
+            const Bounds& GetBounds() const { return m_Bounds; }
+            // CPU copy of geometry for occlusion culling and scene queries, taken from the data the mesh was created with.
+            // Empty on meshes created without it, never read back from the GPU
+            const std::vector<glm::vec3>& GetPositions() const { return m_Positions; }
+            const std::vector<unsigned int>& GetIndices() const { return m_Indices; }
+            const VertexFormat& GetVertexFormat() const { return m_VertexFormat; }
+            // Created from raw vertex data with its own layout instead of Vertex
+            bool HasCustomLayout() const { return bHasCustomLayout; }
+            // Built from the CPU copy of geometry the first time it's needed (only this LOD), for ray and overlap queries
+            const Physics::TriangleBVH& GetTriangleBVH() const;
+            // Quantized positions are relative to mesh bounds, this has to be applied before the object model matrix
+            bool HasQuantizedPositions() const { return bHasQuantizedPositions; }
+            const glm::mat4& GetDequantizationMatrix() const { return m_DequantizationMatrix; }
+
+            // LOD 0 is this mesh, coarser levels are added in order (e.g. generated on import)
+            void AddLOD(const std::shared_ptr<Mesh>& lodMesh) { m_LODs.push_back(lodMesh); }
+            int GetTotalLODs() const { return 1 + static_cast<int>(m_LODs.size()); }
+            const Mesh& GetLOD(int lodIndex) const { return lodIndex <= 0 ? *this : *m_LODs[lodIndex - 1]; }
+
+            // Including every LOD
+            size_t GetGpuMemory() const;
+            size_t GetCpuMemory() const;
 
         private:
 
-            std::unique_ptr<VertexArray> m_VAO{};
-            std::unique_ptr<VertexBuffer> m_VBO{};
-            std::unique_ptr<IndexBuffer> m_IBO{};
+            std::shared_ptr<GeometryBuffer> m_GeometryBuffer{};
+            GeometryAllocation m_GeometryAllocation{};
             std::string m_Name{};
+            Bounds m_Bounds{};
+            VertexFormat m_VertexFormat{};
+            bool bHasQuantizedPositions{false};
+            bool bHasCustomLayout{false};
+            glm::mat4 m_DequantizationMatrix{1.f};
+
+            // Only for meshes used by CPU side queries (software occlusion culling, triangle BVH), see GetPositions
+            std::vector<glm::vec3> m_Positions{};
+            std::vector<unsigned int> m_Indices{};
+            mutable std::unique_ptr<Physics::TriangleBVH> m_TriangleBVH{};
+            mutable TrackedMemory m_CpuMemory{MemoryCategory::MeshData}; // This mesh only, each LOD tracks its own
+
+            std::vector<std::shared_ptr<Mesh>> m_LODs{};
+
+            void SetupVertexLayout(VertexBufferLayout& outLayout);
+            // Into the geometry buffer shared by meshes with the same vertex format
+            void UploadToSharedGeometryBuffer(const void* packedVerticesData, unsigned int totalVertices, const std::vector<unsigned int>& indices, VertexBufferLayout&& layout);
+            void DecodePositions(const void* packedVerticesData, unsigned int totalVertices, unsigned int stride, std::vector<glm::vec3>& outPositions) const;
+            void UpdateTrackedCpuMemory() const;
+            static bool CanQuantizePositions(const VertexFormat& vertexFormat, const Bounds& bounds);
+            static float GetQuantizationScale(const Bounds& bounds);
         };
     }
 }
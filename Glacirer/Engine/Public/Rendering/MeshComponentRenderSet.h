@@ -4,6 +4,7 @@
 #include <vector>
 
 #include <glm/vec3.hpp>
+#include "FrameArena.h"
 
 namespace Glacirer
 {
@@ -29,9 +30,8 @@ namespace Glacirer
             void Remove(const std::shared_ptr<MeshComponent>& meshComponent);
             std::vector<std::shared_ptr<MeshComponent>> GetAllMeshComponentsUsing(const std::shared_ptr<Material>& material);
             void OverrideAllObjectsScale(const glm::vec3& scaleToAdd);
-            void MultiplyAllObjectsScaleBy(const float factor);
-            void DivideAllObjectsScaleBy(const float factor);
-            std::multimap<float, MeshComponentRenderElement> GetMeshComponentsSortedByDistance(const glm::vec3& cameraPosition) const;
+            // Closest first, the list is allocated on the frame arena
+            FrameVector<std::pair<float, MeshComponentRenderElement>> GetMeshComponentsSortedByDistance(const glm::vec3& cameraPosition) const;
             void Clear();
 
             const std::map<unsigned int, std::map<unsigned int, std::vector<std::shared_ptr<MeshComponent>>>>& GetMeshComponents() const { return m_MeshComponents; }
@@ -39,7 +39,7 @@ namespace Glacirer
 
         private:
 
-            std::map<unsigned int, std::map<unsigned int, std::vector<std::shared_ptr<MeshComponent>>>> m_MeshComponents{}; // keyed by VAO and material ID
+            std::map<unsigned int, std::map<unsigned int, std::vector<std::shared_ptr<MeshComponent>>>> m_MeshComponents{}; // keyed by geometry buffer VAO (shared by many meshes) and material ID
             unsigned int m_TotalMeshComponents{0};
         };
     }
@@ -0,0 +1,39 @@
+#pragma once
+#include <vector>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        struct Vertex;
+
+        struct VertexCacheStatistics
+        {
+            float ACMR{0.f}; // Average cache miss ratio, vertex shader invocations per triangle (0.5 is the ideal for large grids, 3 is worst)
+            float ATVR{0.f}; // Average transformed vertex ratio, vertex shader invocations per vertex (1 is ideal)
+        };
+
+        // CPU only mesh reordering done at import, doesn't change the rendered result
+        class MeshOptimizer
+        {
+        public:
+
+            // Same order of magnitude as post-transform caches on current GPUs
+            constexpr static unsigned int DEFAULT_CACHE_SIZE = 16;
+            // Higher splits into more (smaller) clusters, trading vertex cache efficiency for overdraw
+            constexpr static float DEFAULT_ACMR_THRESHOLD = 1.05f;
+
+            // Tipsify (Sander et al. 2007): triangles are emitted fanning around vertices still in cache, then split into
+            // clusters wherever their ACMR stays under acmrThreshold (lambda) times the one of the unsplit order.
+            // Clusters are sorted so outward facing ones are drawn first and occlude the rest
+            static void OptimizeVertexCacheAndOverdraw(const std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+                                                       unsigned int cacheSize = DEFAULT_CACHE_SIZE, float acmrThreshold = DEFAULT_ACMR_THRESHOLD);
+
+            // Reorders vertices by first use on the index buffer (and drops unused ones), so vertex fetch reads memory sequentially
+            static void OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+            // Simulates a FIFO post-transform cache
+            static VertexCacheStatistics AnalyzeVertexCache(const std::vector<unsigned int>& indices, unsigned int totalVertices, unsigned int cacheSize = DEFAULT_CACHE_SIZE);
+        };
+    }
+}
@@ -1,5 +1,4 @@
 #pragma once
-#include <memory>
 
 namespace Glacirer
 {
@@ -8,7 +7,6 @@ namespace Glacirer
 
     namespace Rendering
     {
-        class Shader;
         class Material;
         class Mesh;
 
@@ -18,7 +16,10 @@ namespace Glacirer
     
             void Render(const Mesh& mesh, const Transform& transform, const Material& material) const;
             void Render(const Mesh& mesh, const Material& material) const;
-            void RenderInstanced(const Mesh& mesh, const Material& material, int amount, const std::shared_ptr<Shader>& overrideShader) const;
+
+        private:
+
+            void Draw(const Mesh& mesh) const;
         };
     }
 }
@@ -0,0 +1,30 @@
+#pragma once
+#include <vector>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        struct Vertex;
+
+        // Quadric error metric simplification (Garland & Heckbert) using half-edge collapses:
+        // a vertex is always moved onto one of its neighbours, so the remaining vertices keep their own
+        // normal and texture coordinate. Vertices sharing a position (normal/UV seams) collapse together and
+        // collapses that would tear or stretch those attributes are penalized
+        class MeshSimplifier
+        {
+        public:
+
+            // Stops when the index count reaches the target or the next collapse would move the surface
+            // further than maxRelativeError (fraction of the mesh bounding box diagonal)
+            // Returns false if no triangle could be removed
+            static bool Simplify(
+                const std::vector<Vertex>& vertices,
+                const std::vector<unsigned int>& indices,
+                unsigned int targetTotalIndices,
+                float maxRelativeError,
+                std::vector<Vertex>& outVertices,
+                std::vector<unsigned int>& outIndices);
+        };
+    }
+}
@@ -15,9 +15,14 @@ namespace Glacirer
             void AddMesh(const std::shared_ptr<Mesh>&& mesh) { m_Meshes.emplace_back(mesh); }
             const std::vector<std::shared_ptr<Mesh>>& GetMeshes() const { return m_Meshes; }
 
+            // Async loaded models stay empty until all their meshes are uploaded
+            void SetIsLoaded(bool bLoaded) { bIsLoaded = bLoaded; }
+            bool IsLoaded() const { return bIsLoaded; }
+
         private:
 
             std::vector<std::shared_ptr<Mesh>> m_Meshes{};
+            bool bIsLoaded{true};
         };
     }
 }
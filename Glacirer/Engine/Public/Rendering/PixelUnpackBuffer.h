@@ -0,0 +1,25 @@
+#pragma once
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        // Staging buffer for texture uploads: data is copied into driver memory and transferred to the texture
+        // asynchronously, so glTexImage2D doesn't stall on it. While bound, texture data pointers are offsets in this buffer
+        class PixelUnpackBuffer
+        {
+        public:
+            PixelUnpackBuffer();
+            ~PixelUnpackBuffer();
+
+            void Bind() const;
+            void Unbind() const;
+            // Orphans the previous storage (it may still be in use by a pending transfer) and copies data into a new one, buffer must be bound
+            void SetData(const void* data, unsigned int size) const;
+
+        private:
+
+            unsigned int m_RendererID{0};
+        };
+    }
+}
@@ -1,36 +1,64 @@
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "MeshRenderer.h"
+#include "RenderGraph.h"
 
 namespace Glacirer
 {
     class PostProcessingComponent;
+    enum class PostProcessingResolution : uint8_t;
 
     namespace Rendering
     {
         class Mesh;
-        class Framebuffer;
+        class Texture;
 
+        // Effects run as a chain of fullscreen render graph passes, each one sampling the output of the previous pass
+        // and writing into a transient target, so only enabled effects cost anything and same sized targets ping-pong.
+        // The chain always ends with the composite pass (gamma correction and per pixel color effects)
         class PostProcessingSystem
         {
         public:
 
             PostProcessingSystem();
-    
-            void SetFramebuffer(const Framebuffer& framebuffer) const;
+
             void SetPostProcessingComponent(const std::shared_ptr<PostProcessingComponent>& postProcessingComponent);
             void RemovePostProcessingComponent(const std::shared_ptr<PostProcessingComponent>& postProcessingComponent);
-            void RenderToScreen();
+            // source is the resolved scene color, the composite pass writes into output
+            void AddPasses(RenderGraph& renderGraph, RenderGraphResource source, RenderGraphResource output);
+
+            // Effect passes currently added before the composite one
+            unsigned int GetTotalActivePasses() const { return static_cast<unsigned int>(m_Passes.size()); }
 
         private:
 
+            struct PostProcessingPass
+            {
+                const char* Name{nullptr};
+                std::shared_ptr<Rendering::Material> Material{};
+                PostProcessingResolution Scale{}; // Full
+                // Gaussian blur runs once per axis with the same material
+                bool bIsHorizontal{false};
+            };
+
             std::shared_ptr<Mesh> m_ScreenQuad{};
             MeshRenderer m_MeshRenderer{};
-            std::shared_ptr<Material> m_PostProcessingMaterial{};
+            std::shared_ptr<Material> m_CompositeMaterial{};
+            std::shared_ptr<Material> m_SharpenMaterial{};
+            std::shared_ptr<Material> m_DownsampleMaterial{};
+            std::shared_ptr<Material> m_BlurMaterial{};
+            std::shared_ptr<Material> m_EdgeDetectionMaterial{};
             std::shared_ptr<PostProcessingComponent> m_PostProcessingComponent{};
+            std::vector<PostProcessingPass> m_Passes{};
 
             void UpdatePostProcessingMaterial();
+            // Rebuilt whenever the component changes
+            void UpdatePasses();
+            void RenderPass(const PostProcessingPass& pass, const std::shared_ptr<Texture>& source, const glm::vec2& sourceUVScale) const;
+            void RenderScreenQuad(const Material& material, const glm::vec2& sourceUVScale) const;
         };
     }
 }
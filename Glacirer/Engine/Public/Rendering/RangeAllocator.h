@@ -0,0 +1,34 @@
+#pragma once
+#include <map>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        // Hands out ranges of a linear space (e.g. elements of a GPU buffer) on a first fit basis,
+        // freed ranges are merged back with free neighbours so the space doesn't end up fragmented in small pieces
+        class RangeAllocator
+        {
+        public:
+
+            constexpr static unsigned int INVALID_OFFSET = ~0u;
+
+            explicit RangeAllocator(unsigned int capacity);
+
+            // INVALID_OFFSET if no free range is large enough
+            unsigned int Allocate(unsigned int size);
+            void Free(unsigned int offset, unsigned int size);
+            // Adds space at the end, e.g. after the buffer behind it grew
+            void Grow(unsigned int capacity);
+
+            unsigned int GetCapacity() const { return m_Capacity; }
+            unsigned int GetUsedSize() const { return m_UsedSize; }
+
+        private:
+
+            std::map<unsigned int, unsigned int> m_FreeRanges{}; // size keyed by offset
+            unsigned int m_Capacity{0};
+            unsigned int m_UsedSize{0};
+        };
+    }
+}
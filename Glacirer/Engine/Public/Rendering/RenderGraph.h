@@ -0,0 +1,168 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "RenderTargetPool.h"
+#include <glm/vec2.hpp>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Device;
+        class Framebuffer;
+        class RenderGraph;
+        class Texture;
+
+        // Resource declared on the graph of the current frame
+        struct RenderGraphResource
+        {
+            constexpr static uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+            uint32_t Index{INVALID_INDEX};
+
+            bool IsValid() const { return Index != INVALID_INDEX; }
+        };
+
+        // Handed to passes while they execute, resolves graph resources to what backs them this frame
+        class RenderGraphContext
+        {
+        public:
+
+            RenderGraphContext(const RenderGraph& graph, const Device& device);
+
+            // nullptr for the backbuffer and external resources
+            const Framebuffer* GetFramebuffer(RenderGraphResource resource) const;
+            std::shared_ptr<Texture> GetTexture(RenderGraphResource resource) const;
+            const RenderTargetDesc& GetDesc(RenderGraphResource resource) const;
+            // Binds the resource framebuffer (default one for the backbuffer) and sets the viewport to its resolution,
+            // pooled framebuffers can be larger, so only the bottom left region of the size declared is rendered
+            void BindTarget(RenderGraphResource resource) const;
+            // Fraction of the resource texture holding its content, what UVs sampling it are scaled by
+            glm::vec2 GetUVScale(RenderGraphResource resource) const;
+            const Device& GetDevice() const { return m_Device; }
+
+        private:
+
+            const RenderGraph& m_Graph;
+            const Device& m_Device;
+        };
+
+        using RenderGraphExecuteFunction = std::function<void(const RenderGraphContext&)>;
+
+        // Declares what the pass just added reads and writes
+        class RenderGraphPassBuilder
+        {
+        public:
+
+            RenderGraphPassBuilder& Read(RenderGraphResource resource);
+            RenderGraphPassBuilder& Write(RenderGraphResource resource);
+            // Never culled, for passes whose work isn't visible through the resources they write
+            RenderGraphPassBuilder& SetSideEffect();
+
+        private:
+
+            friend class RenderGraph;
+
+            RenderGraphPassBuilder(RenderGraph& graph, uint32_t passIndex);
+
+            RenderGraph& m_Graph;
+            uint32_t m_PassIndex;
+        };
+
+        // Frame graph rebuilt every frame: passes declare the resources they read and write, then Compile
+        //  - orders passes so every read happens after the writes declared before it (declaration order already is one),
+        //  - culls passes whose writes never reach an output (or a pass with side effects),
+        //  - computes the lifetime of transient targets, which are only backed by a pooled framebuffer
+        //    from their first to their last use, so targets with non overlapping lifetimes share the same one
+        // Passes and resources of the previous frame are recycled, names are only pointed at (e.g. string literals),
+        // so rebuilding the same graph every frame doesn't allocate
+        class RenderGraph
+        {
+        public:
+
+            RenderGraph() = default;
+            RenderGraph(const RenderGraph&) = delete;
+            RenderGraph& operator=(const RenderGraph&) = delete;
+
+            // Allocated from the render target pool only if a pass that isn't culled uses it
+            RenderGraphResource CreateTarget(const char* name, const RenderTargetDesc& desc);
+            // Framebuffer owned outside the graph, it must outlive the frame
+            RenderGraphResource ImportTarget(const char* name, const Framebuffer& framebuffer);
+            RenderGraphResource ImportBackbuffer(const Resolution& resolution);
+            // Data without a framebuffer the graph can bind (e.g. shadow maps), only used to order and cull passes
+            RenderGraphResource ImportExternal(const char* name);
+            // Passes writing into outputs are the roots culling starts from
+            void MarkAsOutput(RenderGraphResource resource);
+
+            RenderGraphPassBuilder AddPass(const char* name, RenderGraphExecuteFunction execute);
+
+            // Returns false (and nothing executes) if a pass reads a transient target nobody wrote before
+            bool Compile();
+            void Execute(const Device& device, RenderTargetPool& renderTargetPool);
+            void Reset();
+
+            const RenderTargetDesc& GetDesc(RenderGraphResource resource) const { return m_Resources[resource.Index].Desc; }
+            unsigned int GetTotalPasses() const { return static_cast<unsigned int>(m_Passes.size()); }
+            unsigned int GetTotalCulledPasses() const { return static_cast<unsigned int>(m_Passes.size() - m_ExecutionOrder.size()); }
+            // Transient targets alive at the same time at most, the framebuffers the graph needs from the pool
+            unsigned int GetPeakTransientTargets() const { return m_PeakTransientTargets; }
+
+        private:
+
+            friend class RenderGraphContext;
+            friend class RenderGraphPassBuilder;
+
+            enum class ResourceType : uint8_t
+            {
+                Transient,
+                Imported,
+                Backbuffer,
+                External
+            };
+
+            struct Resource
+            {
+                const char* Name{nullptr};
+                ResourceType Type{ResourceType::Transient};
+                RenderTargetDesc Desc{};
+                const Framebuffer* ImportedFramebuffer{nullptr};
+                std::shared_ptr<Framebuffer> TransientFramebuffer{};
+                std::vector<uint32_t> Writers{};
+                unsigned int RefCount{0};
+                bool bIsOutput{false};
+            };
+
+            struct Pass
+            {
+                const char* Name{nullptr};
+                RenderGraphExecuteFunction Execute{};
+                std::vector<uint32_t> Reads{};
+                std::vector<uint32_t> Writes{};
+                bool bHasSideEffect{false};
+                bool bIsCulled{false};
+                unsigned int RefCount{0};
+                // Transient targets whose lifetime starts or ends on this pass
+                std::vector<uint32_t> TargetsToAcquire{};
+                std::vector<uint32_t> TargetsToRelease{};
+            };
+
+            std::vector<Resource> m_Resources{};
+            std::vector<Pass> m_Passes{};
+            // Cleared on reset but keeping the capacity of their lists, handed back by the next frame
+            std::vector<Resource> m_RecycledResources{};
+            std::vector<Pass> m_RecycledPasses{};
+            std::vector<uint32_t> m_ExecutionOrder{};
+            unsigned int m_PeakTransientTargets{0};
+            bool bIsCompiled{false};
+
+            RenderGraphResource AddResource(const char* name, ResourceType type);
+            bool IsReadOnlyBy(const Pass& pass, uint32_t resourceIndex) const;
+            void CullPasses();
+            bool ValidateReads() const;
+            void ComputeTargetLifetimes();
+        };
+    }
+}
@@ -1,12 +1,21 @@
 #pragma once
 #include <memory>
+#include <vector>
 
 #include "EngineAPI.h"
+#include "DeferredShadingSystem.h"
 #include "Device.h"
+#include "DrawBatch.h"
+#include "DynamicRingBuffer.h"
 #include "MeshRenderer.h"
 #include "InstancedArray.h"
 #include "LightingSystem.h"
 #include "PostProcessingSystem.h"
+#include "RenderGraph.h"
+#include "RenderTargetPool.h"
+#include "SamplesPassedQuery.h"
+#include "SelectionOutlineSystem.h"
+#include "SoftwareOcclusionCuller.h"
 #include "Basics/Components/DirectionalLightComponent.h"
 #include "FrameBuffer.h"
 #include "MeshComponentRenderSet.h"
@@ -25,8 +34,31 @@ namespace Glacirer
     namespace Rendering
     {
         class Cubemap;
+        class Mesh;
         class Shader;
 
+        // Deferred path is not multisampled, MSAA only applies to the forward one
+        enum class RenderPath : uint8_t
+        {
+            Forward,
+            Deferred
+        };
+
+        // Opaque materials drawn by a pass, deferred path only writes default shader ones to the G-buffer
+        enum class OpaqueMaterialFilter : uint8_t
+        {
+            All,
+            GeometryPass,
+            ForwardOnly
+        };
+
+        enum class DepthPrePassMode : uint8_t
+        {
+            Disabled,
+            Enabled,
+            Automatic // Enabled only while measured opaque overdraw is high
+        };
+
         class ENGINE_API RenderSystem
         {
         public:
@@ -57,22 +89,56 @@ namespace Glacirer
 
             void SetAmbientLightColor(const glm::vec3& ambientLightColor) { m_LightingSystem.SetAmbientLightColor(ambientLightColor); }
             glm::vec3 GetAmbientLightColor() const { return m_LightingSystem.GetAmbientLightColor(); }
-            void SetClearColor(const glm::vec4& clearColor) const { m_MultisampleFramebuffer->SetClearColor(clearColor); }
-            glm::vec4 GetClearColor() const { return m_MultisampleFramebuffer->GetClearColor(); }
+            void SetClearColor(const glm::vec4& clearColor) { m_ClearColor = clearColor; }
+            glm::vec4 GetClearColor() const { return m_ClearColor; }
             void SetOverrideShader(const std::shared_ptr<Shader>& overrideShader, bool bSetupUniforms = true);
             Rendering::Device& GetDevice() { return m_Device; }
             void ToggleSkybox(bool bEnable) { bIsSkyboxEnabled = bEnable; }
+            // G-buffer is only requested while deferred path is in use, the pool deletes it a few frames after switching back
+            void SetRenderPath(RenderPath renderPath) { m_RenderPath = renderPath; }
+            RenderPath GetRenderPath() const { return m_RenderPath; }
+            void SetDepthPrePassMode(DepthPrePassMode depthPrePassMode) { m_DepthPrePassMode = depthPrePassMode; }
+            DepthPrePassMode GetDepthPrePassMode() const { return m_DepthPrePassMode; }
+            bool IsDepthPrePassActive() const;
+            float GetOpaqueOverdraw() const { return m_OpaqueOverdraw; }
+            void ToggleOcclusionCulling(bool bEnable) { bIsOcclusionCullingEnabled = bEnable; }
+            bool IsOcclusionCullingEnabled() const { return bIsOcclusionCullingEnabled; }
+            const SoftwareOcclusionCuller& GetOcclusionCuller() const { return m_OcclusionCuller; }
+            void SetShadowLODBias(int shadowLODBias) { m_ShadowLODBias = shadowLODBias; }
+            int GetShadowLODBias() const { return m_ShadowLODBias; }
+            // Graph of the last rendered frame
+            const RenderGraph& GetRenderGraph() const { return m_RenderGraph; }
+            const RenderTargetPool& GetRenderTargetPool() const { return m_RenderTargetPool; }
 
         private:
 
+            struct VisibleInstance
+            {
+                const Rendering::Mesh* Mesh;
+                const Glacirer::MeshComponent* MeshComponent;
+            };
+
             constexpr static int MAX_INSTANCED_AMOUNT_PER_CALL = 10000;
+            // Fits a full instanced batch plus light and camera uniforms of every view, grows if a frame needs more
+            constexpr static unsigned int FRAME_DATA_CAPACITY = 4 * 1024 * 1024;
             constexpr static int SKYBOX_CUBEMAP_SLOT = 0;
+            // Hysteresis so automatic depth pre-pass doesn't keep toggling around a single threshold
+            constexpr static float DEPTH_PRE_PASS_ENABLE_OVERDRAW = 1.5f;
+            constexpr static float DEPTH_PRE_PASS_DISABLE_OVERDRAW = 1.2f;
 
+            DynamicRingBuffer m_FrameDataRingBuffer{FRAME_DATA_CAPACITY}; // Instance matrices and per view uniforms
             MeshRenderer m_MeshRenderer{};
-            LightingSystem m_LightingSystem{};
+            LightingSystem m_LightingSystem{m_FrameDataRingBuffer};
+            RenderTargetPool m_RenderTargetPool{};
+            RenderGraph m_RenderGraph{};
             PostProcessingSystem m_PostProcessingSystem{};
+            SelectionOutlineSystem m_SelectionOutlineSystem{};
+            DeferredShadingSystem m_DeferredShadingSystem{};
             Rendering::Device m_Device{};
             unsigned int m_TotalMSAASamples{1};
+            Resolution m_ViewportResolution{};
+            glm::vec4 m_ClearColor{0.1f, 0.1f, 0.1f, 1.f};
+            RenderPath m_RenderPath{RenderPath::Forward};
 
             Rendering::MeshComponentRenderSet m_OpaqueMeshComponentSet{};
             Rendering::MeshComponentRenderSet m_TransparentMeshComponentSet{};
@@ -84,24 +150,42 @@ namespace Glacirer
             std::unique_ptr<Rendering::UniformBuffer> m_CameraUniformBuffer{};
 
             std::unique_ptr<InstancedArray> m_InstancedArray{};
-            std::unique_ptr<Framebuffer> m_MultisampleFramebuffer{};
-            std::unique_ptr<Framebuffer> m_IntermediateFramebuffer{};
-    
-            std::shared_ptr<Shader> m_OutlineShader{};
+            DrawBatch m_DrawBatch{MAX_INSTANCED_AMOUNT_PER_CALL, m_FrameDataRingBuffer};
+            std::vector<VisibleInstance> m_VisibleInstances{}; // Reused by every render set group, to avoid allocating each draw
+
             std::shared_ptr<SkyboxComponent> m_SkyboxComponent{};
             bool bIsSkyboxEnabled{true};
 
             std::shared_ptr<Shader> m_DirectionalDepthShader{};
             std::shared_ptr<Shader> m_OmnidirectionalDepthShader{};
 
+            std::shared_ptr<Shader> m_DepthPrePassShader{};
+            std::unique_ptr<SamplesPassedQuery> m_OpaqueOverdrawQuery{};
+            DepthPrePassMode m_DepthPrePassMode{DepthPrePassMode::Automatic};
+            bool bIsAutomaticDepthPrePassEnabled{false};
+            float m_OpaqueOverdraw{0.f}; // Average opaque fragments shaded per screen sample
+
+            SoftwareOcclusionCuller m_OcclusionCuller{};
+            std::vector<std::shared_ptr<MeshComponent>> m_OccluderMeshComponents{};
+            std::vector<const MeshComponent*> m_OccludedMeshComponents{}; // Only filled during camera passes, sorted to be searched
+            bool bIsOcclusionCullingEnabled{false};
+
+            int m_ShadowLODBias{1}; // Shadow maps are low resolution, coarser meshes are rarely noticeable on them
+            int m_LODBias{0}; // Added to every mesh component selected LOD while rendering current pass
+
+            static glm::mat4 GetInstanceModelMatrix(const MeshComponent& meshComponent, const Mesh& mesh);
             Rendering::MeshComponentRenderSet& GetComponentRenderSetFor(const std::shared_ptr<MeshComponent>& meshComponent);
             Rendering::MeshComponentRenderSet& GetOutlinedComponentRenderSetFor(const std::shared_ptr<MeshComponent>& meshComponent);
             void UpdateGlobalShaderUniforms(const CameraComponent& activeCamera);
             void UpdateCameraMatricesShaderUniforms(const CameraComponent& activeCamera);
-            void RenderObjects(const Rendering::MeshComponentRenderSet& meshComponentSet);
+            void RenderObjects(const Rendering::MeshComponentRenderSet& meshComponentSet, OpaqueMaterialFilter materialFilter = OpaqueMaterialFilter::All);
+            void RenderOpaqueObjects();
             void RenderObjectsSortedByDistance(const Rendering::MeshComponentRenderSet& meshComponentSet, const glm::vec3& cameraPosition);
             void RenderSkybox(const CameraComponent& activeCamera);
             void RenderWorld(const CameraComponent& activeCamera);
+            void RenderDeferredGeometry();
+            void RenderWorldDeferred(const CameraComponent& activeCamera);
+            void BuildRenderGraph(const CameraComponent& activeCamera);
             void RenderShadowPass(const CameraComponent& activeCamera);
             void RenderDirectionalShadowPass();
             void RenderPointShadowPass();
@@ -113,7 +197,19 @@ namespace Glacirer
             void SetupUniformsFor(Shader& shader) const;
             void SetupOutlineRendering();
             bool IsSkyboxActive() const;
+            bool IsDeferredShadingActive() const;
             void SetupShadowRendering();
+            void SetupDepthPrePassRendering();
+            void UpdateOpaqueOverdraw();
+            void AddOccluder(const std::shared_ptr<MeshComponent>& meshComponent);
+            void RemoveOccluder(const std::shared_ptr<MeshComponent>& meshComponent);
+            void UpdateOcclusionCulling(const CameraComponent& activeCamera);
+            void TestOcclusionFor(const Rendering::MeshComponentRenderSet& meshComponentSet);
+            bool IsOccluded(const MeshComponent& meshComponent) const;
+            void UpdateMeshLODs(const CameraComponent& activeCamera);
+            void UpdateMeshLODsFor(const Rendering::MeshComponentRenderSet& meshComponentSet, const glm::mat4& projection, const glm::vec3& viewPosition);
+            void RequestStreamedTextures(const CameraComponent& activeCamera);
+            void RequestStreamedTexturesFor(const Rendering::MeshComponentRenderSet& meshComponentSet, const glm::mat4& projection, const glm::mat4& viewProjection, const glm::vec3& viewPosition, float viewportHeight);
         };
     }
 }
@@ -0,0 +1,110 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "OpenGLCore.h"
+#include "Resolution.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Framebuffer;
+
+        // Extra color attachment of a multiple render target (e.g. G-buffer), shares resolution and samples with the main one
+        struct RenderTargetAttachmentDesc
+        {
+            unsigned int InternalFormat{GL_RGB};
+            unsigned int Format{GL_RGB};
+            unsigned int Type{GL_UNSIGNED_BYTE};
+
+            bool operator==(const RenderTargetAttachmentDesc& other) const
+            {
+                return InternalFormat == other.InternalFormat && Format == other.Format && Type == other.Type;
+            }
+        };
+
+        // Color target passes render into, Resolution is the region they use (the framebuffer backing it may be larger)
+        struct RenderTargetDesc
+        {
+            constexpr static unsigned int MAX_ADDITIONAL_ATTACHMENTS = 3;
+
+            Rendering::Resolution Resolution{};
+            unsigned int InternalFormat{GL_RGB};
+            unsigned int Format{GL_RGB};
+            unsigned int Type{GL_UNSIGNED_BYTE};
+            unsigned int Samples{1};
+            // Depth/stencil render buffer, for targets geometry is drawn into
+            bool bHasDepthStencil{false};
+            // Fixed size, descs are declared on a graph rebuilt every frame. Sampled with nearest filtering
+            std::array<RenderTargetAttachmentDesc, MAX_ADDITIONAL_ATTACHMENTS> AdditionalAttachments{};
+            unsigned int TotalAdditionalAttachments{0};
+
+            // Whether a target allocated for other can back this one, resolution aside
+            bool IsCompatibleWith(const RenderTargetDesc& other) const
+            {
+                return InternalFormat == other.InternalFormat
+                    && Format == other.Format
+                    && Type == other.Type
+                    && Samples == other.Samples
+                    && bHasDepthStencil == other.bHasDepthStencil
+                    && TotalAdditionalAttachments == other.TotalAdditionalAttachments
+                    && std::equal(AdditionalAttachments.begin(), AdditionalAttachments.begin() + TotalAdditionalAttachments, other.AdditionalAttachments.begin());
+            }
+        };
+
+        // Reuses framebuffers between passes and frames instead of allocating them per use.
+        // A target acquired is exclusive to its user until released back to the pool.
+        //
+        // Targets are allocated with some headroom and rounded up, then reused for any request they fit in
+        // as long as it doesn't waste too much of them, so resizing a window only reallocates once in a while
+        // (users render into the requested region through the viewport). Released targets aren't deleted,
+        // Update deletes the ones no request has needed for a few frames
+        class RenderTargetPool
+        {
+        public:
+
+            constexpr static unsigned int ALLOCATION_GRANULARITY = 64;
+            // Extra size allocated on each axis on top of the request, room for the window to grow into
+            constexpr static float ALLOCATION_HEADROOM = 0.125f;
+            // A request whose own allocation would be below this fraction of a target on either axis gets a tighter one instead
+            constexpr static float MIN_USED_FRACTION = 0.7f;
+            constexpr static uint64_t MAX_UNUSED_FRAMES = 60;
+
+            RenderTargetPool() = default;
+            RenderTargetPool(const RenderTargetPool&) = delete;
+            RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+            std::shared_ptr<Framebuffer> Acquire(const RenderTargetDesc& desc);
+            void Release(const std::shared_ptr<Framebuffer>& target);
+            // Once per frame, deletes targets left unused for MAX_UNUSED_FRAMES
+            void Update();
+
+            unsigned int GetTotalTargets() const { return static_cast<unsigned int>(m_Targets.size()); }
+            // Estimate of the video memory held by pooled targets, in use or not
+            size_t GetGpuMemory() const { return m_GpuMemory; }
+
+        private:
+
+            struct PooledTarget
+            {
+                RenderTargetDesc Desc{}; // Resolution is the allocated one
+                std::shared_ptr<Rendering::Framebuffer> Framebuffer{};
+                size_t GpuMemory{0};
+                uint64_t LastUsedFrame{0};
+                bool bIsInUse{false};
+            };
+
+            std::vector<PooledTarget> m_Targets{};
+            uint64_t m_FrameIndex{0};
+            size_t m_GpuMemory{0};
+
+            static bool CanServe(const PooledTarget& target, const RenderTargetDesc& desc);
+            static unsigned int GetAllocationSize(unsigned int requestedSize);
+            static size_t ComputeGpuMemory(const RenderTargetDesc& desc);
+        };
+    }
+}
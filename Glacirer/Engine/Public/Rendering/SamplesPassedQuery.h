@@ -0,0 +1,28 @@
+#pragma once
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        // Counts how many samples passed depth/stencil tests between Begin and End
+        // Result is read asynchronously so it never stalls the pipeline waiting for GPU
+        class SamplesPassedQuery
+        {
+        public:
+
+            SamplesPassedQuery();
+            ~SamplesPassedQuery();
+
+            void Begin();
+            void End() const;
+            bool TryGetResult(unsigned int& outSamplesPassed);
+
+            bool IsPending() const { return bIsPending; }
+
+        private:
+
+            unsigned int m_RendererID{0};
+            bool bIsPending{false};
+        };
+    }
+}
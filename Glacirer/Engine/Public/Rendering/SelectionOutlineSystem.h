@@ -0,0 +1,39 @@
+#pragma once
+#include <memory>
+
+#include "MeshRenderer.h"
+#include "RenderGraph.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Mesh;
+
+        // Outline of selected (outlined) objects done in screen space. They tag their pixels on the stencil buffer
+        // while drawn on the scene pass, the stencil is turned into a selection mask and the outline is drawn
+        // wherever a dilation of that mask grows, so its cost doesn't depend on what (or how much) is selected
+        class SelectionOutlineSystem
+        {
+        public:
+
+            constexpr static int SELECTION_STENCIL_VALUE = 1;
+
+            SelectionOutlineSystem();
+
+            // sceneColor has selected objects tagged on its stencil buffer, the outline is blended on top of resolvedSceneColor
+            void AddPasses(RenderGraph& renderGraph, RenderGraphResource sceneColor, RenderGraphResource resolvedSceneColor);
+
+        private:
+
+            std::shared_ptr<Mesh> m_ScreenQuad{};
+            MeshRenderer m_MeshRenderer{};
+            std::shared_ptr<Material> m_MaskMaterial{};
+            std::shared_ptr<Material> m_OutlineMaterial{};
+
+            void RenderMask(const RenderGraphContext& context, RenderGraphResource sceneColor, RenderGraphResource selectionMask) const;
+            void RenderOutline(const RenderGraphContext& context, RenderGraphResource selectionMask, RenderGraphResource resolvedSceneColor) const;
+            void RenderScreenQuad(const Material& material, const glm::vec2& sourceUVScale) const;
+        };
+    }
+}
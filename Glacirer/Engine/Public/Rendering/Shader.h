@@ -1,6 +1,10 @@
 #pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <glm/glm.hpp>
 
@@ -32,11 +36,25 @@ namespace Glacirer
             ShaderProperties Properties{};
         };
 
+        // Linked program as the driver stores it, only loadable by the same GPU and driver version
+        struct ShaderBinary
+        {
+            unsigned int Format{0};
+            std::vector<unsigned char> Data{};
+        };
+
         class Shader
         {
         public:
 
+            // Builds the program of a variant from the same sources with other keywords defined
+            using VariantFactory = std::function<std::shared_ptr<Shader>(uint32_t variantMask)>;
+
+            // Compile and link are only issued, so the driver can work on several shaders at once.
+            // Their result is checked the first time the shader is bound
             Shader(const ShaderSource& source);
+            // Drivers reject binaries from other versions, check IsLinked and compile from source if it fails
+            Shader(const ShaderBinary& binary, const ShaderProperties& properties);
             ~Shader();
 
             void Bind() const;
@@ -58,6 +76,25 @@ namespace Glacirer
             std::string GetName() const { return m_Name; }
             const ShaderProperties& GetProperties() const { return m_Properties; }
 
+            // Doesn't wait for the driver. Always true when it can't compile in the background
+            bool IsCompilationComplete() const;
+            // Waits for compilation to finish
+            bool IsLinked() const;
+            bool GetBinary(ShaderBinary& outBinary) const;
+
+            // Keywords declared by the shader sources, bit i of a variant mask enables keywords[i]
+            void SetVariants(const std::vector<std::string>& keywords, VariantFactory factory);
+            const std::vector<std::string>& GetVariantKeywords() const { return m_VariantKeywords; }
+            // Keywords the shader doesn't declare are ignored
+            uint32_t GetVariantMask(const std::vector<std::string>& enabledKeywords) const;
+            // Mask 0 is this shader. Others are compiled the first time they are requested and take
+            // the uniform block bindings and sampler slots already set up on this one
+            Shader& GetVariant(uint32_t variantMask);
+
+            static bool SupportsProgramBinaries();
+            // Lets the driver compile on its own threads (KHR_parallel_shader_compile), once GL is initialized
+            static void EnableParallelCompilation();
+
         private:
 
             static unsigned int m_LastBoundShaderId;
@@ -66,9 +103,16 @@ namespace Glacirer
             mutable std::unordered_map<std::string, int> m_UniformLocationCache{};
             std::string m_Name{};
             ShaderProperties m_Properties{};
+            // Stages still attached to the program until compilation is checked
+            mutable std::vector<unsigned int> m_PendingStages{};
+            std::vector<std::string> m_VariantKeywords{};
+            VariantFactory m_VariantFactory{};
+            std::unordered_map<uint32_t, std::shared_ptr<Shader>> m_Variants{};
 
             unsigned int CreateShader(const ShaderSource& source);
             unsigned int CompileShader(unsigned int type, const std::string& source);
+            void FinishCompilation() const;
+            void CopyBindingsFrom(const Shader& shader);
             int GetUniformLocation(const std::string& name) const;
         };
     }
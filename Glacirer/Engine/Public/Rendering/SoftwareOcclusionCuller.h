@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "EngineAPI.h"
+#include "Bounds.h"
+#include "Resolution.h"
+#include <glm/glm.hpp>
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        class WorkerPool;
+    }
+
+    namespace Rendering
+    {
+        // Rasterizes designated occluders into a small CPU depth buffer and tests occludee bounds against it
+        // Doesn't use any OpenGL call, so it can also run headless
+        class ENGINE_API SoftwareOcclusionCuller
+        {
+        public:
+
+            SoftwareOcclusionCuller(unsigned int width = DEFAULT_WIDTH, unsigned int height = DEFAULT_HEIGHT);
+            ~SoftwareOcclusionCuller();
+
+            void BeginFrame(const glm::mat4& viewProjection);
+            // Only projects the triangles and bins them into screen tiles, the depth buffer is written by ResolveOccluders
+            void RasterizeOccluder(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices, const glm::mat4& modelMatrix);
+            // Rasterizes every binned triangle, tiles are split between the calling thread and the worker pool
+            void ResolveOccluders();
+            bool IsOccluded(const Bounds& worldBounds);
+
+            Resolution GetResolution() const { return m_Resolution; }
+            const std::vector<float>& GetDepthBuffer() const { return m_DepthBuffer; }
+            unsigned int GetTotalRasterizedTriangles() const { return m_TotalRasterizedTriangles; }
+            unsigned int GetTotalTested() const { return m_TotalTested; }
+            unsigned int GetTotalOccluded() const { return m_TotalOccluded; }
+
+        private:
+
+            constexpr static unsigned int DEFAULT_WIDTH = 256;
+            constexpr static unsigned int DEFAULT_HEIGHT = 128;
+            constexpr static float MIN_CLIP_W = 0.0001f;
+            // Multiple of 4, SSE tests one row of 4 pixels at a time
+            constexpr static int TILE_WIDTH = 32;
+            constexpr static int TILE_HEIGHT = 32;
+            // Fewer triangles than this are cheaper to rasterize than to wake workers for
+            constexpr static size_t MIN_TRIANGLES_FOR_WORKERS = 64;
+
+            // Weights and depth are linear in screen space, kept as origin plus steps so tiles can evaluate any pixel
+            struct ScreenTriangle
+            {
+                glm::vec3 WeightOrigin{};
+                glm::vec3 WeightStepX{};
+                glm::vec3 WeightStepY{};
+                glm::vec3 WeightPixelExtent{};
+                float DepthOrigin{};
+                float DepthStepX{};
+                float DepthStepY{};
+                int MinX{};
+                int MinY{};
+                int MaxX{};
+                int MaxY{};
+            };
+
+            Resolution m_Resolution{};
+            std::vector<float> m_DepthBuffer{}; // [0, 1] range, 1 is far plane
+            glm::mat4 m_ViewProjection{1.f};
+            unsigned int m_TotalRasterizedTriangles{0};
+            unsigned int m_TotalTested{0};
+            unsigned int m_TotalOccluded{0};
+
+            // Cleared every frame but keep their capacity
+            std::vector<ScreenTriangle> m_Triangles{};
+            std::vector<std::vector<unsigned int>> m_TileTriangles{};
+            int m_TotalTilesX{0};
+            int m_TotalTilesY{0};
+            bool bHasUnresolvedOccluders{false};
+
+            std::unique_ptr<Resources::WorkerPool> m_WorkerPool;
+            std::atomic<int> m_NextTile{0};
+            unsigned int m_TotalRunningJobs{0};
+            std::mutex m_JobsMutex{};
+            std::condition_variable m_JobsCondition{};
+
+            bool ProjectToScreen(const glm::vec4& clipPosition, glm::vec3& outScreenPosition) const;
+            void BinTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c);
+            // Takes tiles until none are left, run by the calling thread and every worker job
+            void RasterizeTiles();
+            void RasterizeTile(int tileIndex);
+            void RasterizeTriangleInTile(const ScreenTriangle& triangle, int minX, int minY, int maxX, int maxY);
+        };
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include "Mesh.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Material;
+
+        struct StaticBatchChunk
+        {
+            std::shared_ptr<Rendering::Mesh> Mesh{}; // In world space, its bounds are the chunk ones
+            std::shared_ptr<Rendering::Material> Material{};
+            unsigned int TotalSourceMeshes{0};
+        };
+
+        // Pre-transforms meshes that never move and merges the ones sharing material and vertex format into a few
+        // world space meshes, so each chunk is a single draw without per instance transform.
+        // Meshes are split in chunks by the cell of a world grid their bounds center falls in, keeping chunks
+        // compact enough to be culled on their own. Only LOD 0 is merged
+        class StaticBatchBuilder
+        {
+        public:
+
+            constexpr static float DEFAULT_CHUNK_SIZE = 32.f;
+            // Chunks split once they'd go past 16 bit indices, unless a single mesh is already larger
+            constexpr static unsigned int MAX_CHUNK_VERTICES = GeometryBuffer::MAX_SHORT_INDEX_VERTICES;
+
+            explicit StaticBatchBuilder(float chunkSize = DEFAULT_CHUNK_SIZE);
+
+            // Mesh has to use the Vertex layout
+            void Add(const Mesh& mesh, const std::shared_ptr<Material>& material, const glm::mat4& modelMatrix);
+            // Reads vertices back from GPU, meant to run once at level load
+            std::vector<StaticBatchChunk> Build() const;
+
+            bool IsEmpty() const { return m_Sources.empty(); }
+
+        private:
+
+            struct Source
+            {
+                const Rendering::Mesh* Mesh;
+                std::shared_ptr<Rendering::Material> Material;
+                glm::mat4 ModelMatrix;
+                glm::ivec3 Cell;
+            };
+
+            float m_ChunkSize{DEFAULT_CHUNK_SIZE};
+            std::vector<Source> m_Sources{};
+
+            static unsigned int GetVertexFormatKey(const VertexFormat& vertexFormat);
+            static StaticBatchChunk CreateChunk(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices,
+                                                const Source& firstSource, unsigned int totalSourceMeshes);
+        };
+    }
+}
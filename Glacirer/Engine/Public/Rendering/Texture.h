@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <vector>
+#include "MemoryTracker.h"
 #include "OpenGLCore.h"
 #include "TextureSettings.h"
 
@@ -7,11 +9,29 @@ namespace Glacirer
 {
     namespace Rendering
     {
+        // Level of a prebuilt mip chain, data is compressed if the texture internal format is
+        struct TextureMip
+        {
+            const void* Data{nullptr};
+            unsigned int Size{0};
+            unsigned int Width{0};
+            unsigned int Height{0};
+        };
+
         class Texture
         {
         public:
 
             Texture(unsigned char* data, unsigned int width, unsigned int height, const TextureSettings& settings);
+            // Uploads every level as is (mip 0 first), settings.GenerateMipmap is ignored
+            Texture(const std::vector<TextureMip>& mips, const TextureSettings& settings);
+
+            // Replaces the texture content level by level, starting from the smallest one. Only levels uploaded so far are sampled,
+            // so it keeps showing its previous content (e.g. a placeholder) until the first one arrives
+            // mip.Data is an offset while a PixelUnpackBuffer is bound
+            void UploadMip(unsigned int level, unsigned int totalMips, const TextureMip& mip, const TextureSettings& settings);
+            // Frees the current base level (respecified as empty) so sampling falls back to the next one, used by texture streaming
+            void ReleaseMip(unsigned int level, const TextureSettings& settings);
             ~Texture();
 
             void Bind(unsigned int slot = 0) const;
@@ -20,14 +40,31 @@ namespace Glacirer
             unsigned int GetWidth() const { return m_Width; }
             unsigned int GetHeight() const { return m_Height; }
             unsigned int GetRendererID() const { return m_RendererID; }
-            void SetName(const std::string& name) { m_Name = name; }
+            void SetName(const std::string& name) { m_Name = name; m_TrackedMemory.SetName(name); }
             std::string GetName() const { return m_Name; }
             void SetIsFlippedOnLoad(const bool bFlipped) { bIsFlippedOnLoad = bFlipped; }
             bool IsFlippedOnLoad() const { return bIsFlippedOnLoad; }
+            // False while its content is still being loaded in background
+            void SetIsLoaded(const bool bLoaded) { bIsLoaded = bLoaded; }
+            bool IsLoaded() const { return bIsLoaded; }
+            // Sum of the levels currently specified (evicted streaming mips don't count)
+            size_t GetGpuMemory() const;
+            // Textures are counted as Textures unless their owner knows better (e.g. framebuffer attachments)
+            void SetMemoryCategory(MemoryCategory category) { m_TrackedMemory.SetCategory(category); }
+
+            static bool IsCompressedFormat(unsigned int internalFormat);
+            // S3TC (BC1-BC3) is an extension on OpenGL 3.3, RGTC (BC4-BC5) is core
+            static bool IsCompressedFormatSupported(unsigned int internalFormat);
+            // Uncompressed formats only, estimate of the driver storage (3 channel formats are usually padded to 4)
+            static unsigned int GetBytesPerPixel(unsigned int internalFormat);
 
         private:
 
             void Create(unsigned char* data, const TextureSettings& settings);
+            void ApplySamplingSettings(const TextureSettings& settings) const;
+            void ApplyChannelSwizzle(const TextureSettings& settings) const;
+            void SpecifyLevel(unsigned int level, const TextureMip& mip, const TextureSettings& settings);
+            void SetLevelSize(unsigned int level, size_t size);
 
             unsigned int m_RendererID{0};
             unsigned int m_Width{0};
@@ -35,6 +72,9 @@ namespace Glacirer
             unsigned int m_Target{GL_TEXTURE_2D};
             std::string m_Name{};
             bool bIsFlippedOnLoad{true};
+            bool bIsLoaded{true};
+            std::vector<size_t> m_LevelSizes{};
+            TrackedMemory m_TrackedMemory{MemoryCategory::Textures};
         };
     }
 }
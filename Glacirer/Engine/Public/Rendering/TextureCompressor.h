@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        enum class BlockCompression
+        {
+            BC1, // RGB, 4 bits per pixel
+            BC3, // RGBA, BC1 color plus interpolated alpha, 8 bits per pixel
+            BC4, // Single channel (red), 4 bits per pixel
+            BC5  // Two channels (red, green), 8 bits per pixel
+        };
+
+        // CPU block compression done when cooking textures, works on 4x4 blocks (edges are clamped for sizes not multiple of 4)
+        class TextureCompressor
+        {
+        public:
+
+            constexpr static unsigned int BLOCK_SIZE = 4;
+
+            static unsigned int GetBytesPerBlock(BlockCompression compression);
+            static unsigned int GetCompressedSize(BlockCompression compression, unsigned int width, unsigned int height);
+
+            // Input is tightly packed RGBA8, BC4 only reads red and BC5 red and green
+            // Endpoints are picked along the principal axis of each block colors, which is close to optimal for smooth gradients
+            static std::vector<unsigned char> Compress(const unsigned char* rgbaData, unsigned int width, unsigned int height, BlockCompression compression);
+        };
+    }
+}
@@ -9,6 +9,14 @@ namespace Glacirer
 {
     namespace Rendering
     {
+        // What the texture stores, decides the cooked format of textures loaded from file
+        enum class TextureUsage
+        {
+            Color,  // RGB(A), BC1 or BC3 when compressed
+            Mask,   // Single channel (e.g. specular), always linear, sampled as greyscale, BC4 when compressed
+            Normal  // Tangent space X and Y (Z has to be reconstructed on shader), BC5 when compressed
+        };
+
         struct ENGINE_API TextureSettings
         {
             unsigned int InternalFormat{GL_SRGB};
@@ -26,6 +34,12 @@ namespace Glacirer
             bool UseAlpha{false};
             bool bIsSRGB{true};
             bool bAutoDesiredChannels{true};
+            TextureUsage Usage{TextureUsage::Color};
+            // Opt in per texture, block compression is lossy (and falls back to uncompressed if the GPU lacks the format)
+            bool bCompress{false};
+            // Textures loaded from file only keep the mips they are drawn at resident (see TextureStreamer).
+            // Opt in per texture, mips are only requested for materials of visible objects
+            bool bStream{false};
 
             TextureSettings() = default;
             TextureSettings(bool bUseAlpha, bool bInIsSRGB = true);
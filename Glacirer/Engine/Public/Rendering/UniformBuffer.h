@@ -1,22 +1,29 @@
 ﻿#pragma once
 #include <string>
+#include <vector>
+
+#include "MemoryTracker.h"
 
 namespace Glacirer
 {
     namespace Rendering
     {
+        class DynamicRingBuffer;
         class Shader;
 
         class UniformBuffer
         {
         public:
             UniformBuffer(const void* data, unsigned int size, const unsigned int bindingIndex, const std::string&& name, const bool bIsDynamic = false);
+            // Streamed: each SetSubData writes the whole block to a new range of the ring buffer and binds that range,
+            // so it has to be set again every frame it's used. No Bind needed before SetSubData
+            UniformBuffer(unsigned int size, const unsigned int bindingIndex, const std::string&& name, DynamicRingBuffer& ringBuffer);
             ~UniformBuffer();
 
             void Bind() const;
             void Unbind() const;
             bool IsBound() const { return LastBoundUniformBufferId == m_RendererID; }
-            void SetSubData(const void* data, unsigned int size, unsigned int offset = 0) const;
+            void SetSubData(const void* data, unsigned int size, unsigned int offset = 0);
             void SetBindingIndexFor(const Shader& shader) const;
 
         private:
@@ -26,6 +33,9 @@ namespace Glacirer
             unsigned int m_RendererID{0};
             unsigned int m_BindingIndex{0};
             std::string m_Name;
+            DynamicRingBuffer* m_RingBuffer{nullptr};
+            std::vector<unsigned char> m_StreamedData{}; // Last content of a streamed block, partial updates keep the rest
+            TrackedMemory m_TrackedMemory{MemoryCategory::UniformBuffers}; // Streamed blocks live in the ring buffer, they stay empty
         };
     }
 }
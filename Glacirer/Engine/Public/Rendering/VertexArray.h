@@ -22,6 +22,8 @@ namespace Glacirer
             void SetNextAttributeLocation(unsigned int nextAttributeLocation) { m_NextAttributeLocation = nextAttributeLocation; }
             void SetIsInstancedRenderingConfigured(bool bIsPrepared) { bIsInstancedRenderingConfigured = bIsPrepared; }
             bool IsInstancedRenderingConfigured() const { return bIsInstancedRenderingConfigured; }
+            unsigned int GetFirstInstancedAttributeLocation() const { return m_FirstInstancedAttributeLocation; }
+            void SetFirstInstancedAttributeLocation(unsigned int location) { m_FirstInstancedAttributeLocation = location; }
 
         private:
 
@@ -29,6 +31,7 @@ namespace Glacirer
 
             unsigned int m_RendererID;
             unsigned int m_NextAttributeLocation{0};
+            unsigned int m_FirstInstancedAttributeLocation{0};
             bool bIsInstancedRenderingConfigured{false};
         };
     }
@@ -1,4 +1,5 @@
 #pragma once
+#include "MemoryTracker.h"
 
 namespace Glacirer
 {
@@ -14,9 +15,13 @@ namespace Glacirer
             void Unbind() const;
             void SetSubData(const void* data, unsigned int size) const;
 
+            unsigned int GetSize() const { return m_Size; }
+
         private:
 
             unsigned int m_RendererID{0};
+            unsigned int m_Size{0};
+            TrackedMemory m_TrackedMemory{MemoryCategory::VertexBuffers};
         };
     }
 }
@@ -19,6 +19,8 @@ namespace Glacirer
 
             virtual unsigned int CreateAttribute(unsigned int location, unsigned int offset, unsigned int stride) = 0;
             virtual unsigned int GetSize() const = 0;
+            // Bytes used by the whole attribute on each vertex
+            virtual unsigned int GetTotalSize() const { return Count * GetSize(); }
 
             unsigned int Count{0};
             bool bIsNormalized{false};
@@ -55,6 +57,38 @@ namespace Glacirer
             unsigned int GetSize() const override { return 1; }
         };
 
+        struct VertexBufferShortAttribute : public VertexBufferAttribute
+        {
+            VertexBufferShortAttribute(unsigned int count, bool isNormalized, unsigned int divisor)
+                : VertexBufferAttribute(count, isNormalized, divisor)
+            { }
+
+            unsigned int CreateAttribute(unsigned location, unsigned int offset, unsigned int stride) override;
+            unsigned int GetSize() const override { return 2; }
+        };
+
+        struct VertexBufferHalfFloatAttribute : public VertexBufferAttribute
+        {
+            VertexBufferHalfFloatAttribute(unsigned int count, unsigned int divisor)
+                : VertexBufferAttribute(count, false, divisor)
+            { }
+
+            unsigned int CreateAttribute(unsigned location, unsigned int offset, unsigned int stride) override;
+            unsigned int GetSize() const override { return 2; }
+        };
+
+        // Four signed normalized components packed on a single 32 bits value (10, 10, 10 and 2 bits), used for normals
+        struct VertexBufferPackedInt2101010Attribute : public VertexBufferAttribute
+        {
+            VertexBufferPackedInt2101010Attribute(unsigned int divisor)
+                : VertexBufferAttribute(4, true, divisor)
+            { }
+
+            unsigned int CreateAttribute(unsigned location, unsigned int offset, unsigned int stride) override;
+            unsigned int GetSize() const override { return 4; }
+            unsigned int GetTotalSize() const override { return 4; }
+        };
+
         struct VertexBufferMat4Attribute : public VertexBufferAttribute
         {
             VertexBufferMat4Attribute(unsigned int count, bool isNormalized, unsigned int divisor)
@@ -65,11 +99,23 @@ namespace Glacirer
             unsigned int GetSize() const override { return sizeof(glm::mat4); }
         };
 
+        // Three rows of an affine matrix, the last one (0, 0, 0, 1) is left out. Read as a mat3x4 attribute
+        struct VertexBufferMat3x4Attribute : public VertexBufferAttribute
+        {
+            VertexBufferMat3x4Attribute(unsigned int divisor)
+                : VertexBufferAttribute(1, false, divisor)
+            { }
+
+            unsigned int CreateAttribute(unsigned location, unsigned int offset, unsigned int stride) override;
+            unsigned int GetSize() const override { return sizeof(glm::mat3x4); }
+        };
+
         class VertexBufferLayout
         {
         public:
 
-            unsigned int CreateAttributes(unsigned int firstAttributeLocation = 0) const;
+            // Offsets are relative to baseOffset bytes into the bound buffer
+            unsigned int CreateAttributes(unsigned int firstAttributeLocation = 0, unsigned int baseOffset = 0) const;
 
             void PushFloat(unsigned int count, unsigned int divisor = 0)
             {
@@ -95,6 +141,30 @@ namespace Glacirer
                 m_Elements.emplace_back(std::move(unsignedByteAttribute));
             }
 
+            void PushShort(unsigned int count, bool bIsNormalized, unsigned int divisor = 0)
+            {
+                auto shortAttribute = std::make_unique<Rendering::VertexBufferShortAttribute>(count, bIsNormalized, divisor);
+                m_Stride += shortAttribute->GetTotalSize();
+
+                m_Elements.emplace_back(std::move(shortAttribute));
+            }
+
+            void PushHalfFloat(unsigned int count, unsigned int divisor = 0)
+            {
+                auto halfFloatAttribute = std::make_unique<Rendering::VertexBufferHalfFloatAttribute>(count, divisor);
+                m_Stride += halfFloatAttribute->GetTotalSize();
+
+                m_Elements.emplace_back(std::move(halfFloatAttribute));
+            }
+
+            void PushPackedInt2101010(unsigned int divisor = 0)
+            {
+                auto packedAttribute = std::make_unique<Rendering::VertexBufferPackedInt2101010Attribute>(divisor);
+                m_Stride += packedAttribute->GetTotalSize();
+
+                m_Elements.emplace_back(std::move(packedAttribute));
+            }
+
             void PushMat4(unsigned int divisor = 0)
             {
                 auto mat4Attribute = std::make_unique<Rendering::VertexBufferMat4Attribute>(1, false, divisor);
@@ -103,6 +173,14 @@ namespace Glacirer
                 m_Elements.emplace_back(std::move(mat4Attribute));
             }
 
+            void PushMat3x4(unsigned int divisor = 0)
+            {
+                auto mat3x4Attribute = std::make_unique<Rendering::VertexBufferMat3x4Attribute>(divisor);
+                m_Stride += mat3x4Attribute->GetSize();
+
+                m_Elements.emplace_back(std::move(mat3x4Attribute));
+            }
+
             unsigned int GetStride() const { return m_Stride; }
 
         private:
@@ -0,0 +1,92 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Resources/LockFreeQueue.h"
+#include "Resources/WorkerPool.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        struct CubemapLoadSettings;
+        struct TextureSettings;
+        class Cubemap;
+        class ModelData;
+        class PixelUnpackBuffer;
+        class Texture;
+    }
+
+    namespace Resources
+    {
+        class TextureStreamer;
+
+        // GPU work allowed per frame, at least one upload step runs every frame whatever its size
+        struct AsyncUploadBudget
+        {
+            float MaxMilliseconds{2.f};
+            unsigned int MaxBytes{16u * 1024u * 1024u};
+        };
+
+        // Decodes and cooks resources on worker threads and uploads them on the main thread a piece at a time
+        // (one texture mip, one mesh or one cubemap per step) within the frame budget.
+        // Load calls return right away with a placeholder that is filled in place once its data arrives
+        class AsyncResourceLoader
+        {
+        public:
+
+            // Upload step of a loaded resource, pushed by workers once the CPU side is done
+            class PendingUpload
+            {
+            public:
+                virtual ~PendingUpload() = default;
+
+                // Bytes the next step sends to the GPU
+                virtual unsigned int GetNextStepSize() const = 0;
+                // Returns true once the resource is complete
+                virtual bool UploadStep(Rendering::PixelUnpackBuffer& unpackBuffer) = 0;
+            };
+
+            explicit AsyncResourceLoader(TextureStreamer& textureStreamer, unsigned int totalWorkers = 0);
+            ~AsyncResourceLoader();
+
+            AsyncResourceLoader(const AsyncResourceLoader&) = delete;
+            AsyncResourceLoader& operator=(const AsyncResourceLoader&) = delete;
+
+            // Texture::IsLoaded stays false until its last mip is uploaded (or its smallest ones, if settings.bStream). A neutral 1x1 texture is shown meanwhile
+            // (grey, flat normal or white mask depending on settings.Usage), and forever if the file can't be loaded
+            std::shared_ptr<Rendering::Texture> LoadTexture(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically = true);
+            // ModelData stays empty with IsLoaded false until every mesh is uploaded (see Model::Setup)
+            std::shared_ptr<Rendering::ModelData> LoadModel(const std::string& filePath);
+            // Sides are decoded in parallel, the cubemap is black until all of them are uploaded together
+            std::shared_ptr<Rendering::Cubemap> LoadCubemap(const Rendering::CubemapLoadSettings& loadSettings);
+
+            // Main thread, once per frame
+            void ProcessUploads();
+
+            void SetUploadBudget(const AsyncUploadBudget& budget) { m_UploadBudget = budget; }
+            const AsyncUploadBudget& GetUploadBudget() const { return m_UploadBudget; }
+            // Loads still decoding or waiting for their upload
+            unsigned int GetTotalPendingLoads() const { return static_cast<unsigned int>(m_LoadingUploads.size() + m_PendingUploads.size()); }
+            WorkerPool& GetWorkerPool() { return m_WorkerPool; }
+
+        private:
+
+            // Owned by the main thread while workers prepare them, workers only get raw pointers
+            // so the GL objects they reference are never released on a worker thread
+            std::vector<std::unique_ptr<PendingUpload>> m_LoadingUploads{};
+            LockFreeQueue<PendingUpload*> m_ReadyUploads{};
+            std::deque<std::unique_ptr<PendingUpload>> m_PendingUploads{};
+            std::unique_ptr<Rendering::PixelUnpackBuffer> m_UnpackBuffer{};
+            AsyncUploadBudget m_UploadBudget{};
+            TextureStreamer& m_TextureStreamer;
+
+            PendingUpload* AddLoadingUpload(std::unique_ptr<PendingUpload> upload);
+
+            // Declared last so workers are joined before the queue they push into is destroyed
+            WorkerPool m_WorkerPool;
+        };
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        // Helpers shared by the cooked resource caches: source hashing and blobs padded so they can be read in place from a mapping
+        class CacheFile
+        {
+        public:
+
+            constexpr static size_t ALIGNMENT = 4;
+
+            constexpr static uint64_t HASH_SEED = 14695981039346656037ull;
+
+            // FNV-1a of the file contents, 0 if it can't be read
+            static uint64_t HashFile(const std::string& filePath);
+            // Pass the previous result as hash to combine several blocks
+            static uint64_t HashData(const void* data, size_t size, uint64_t hash = HASH_SEED);
+
+            static size_t GetPaddedSize(size_t size) { return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+            static void WritePadded(std::ostream& file, const void* data, size_t size);
+        };
+
+        // Bounds checked cursor over a mapped cache file, every read returns nullptr once the data runs out
+        class CacheFileReader
+        {
+        public:
+
+            CacheFileReader(const unsigned char* data, size_t size) : m_Data(data), m_Size(size) {}
+
+            template<typename T>
+            const T* Read()
+            {
+                return static_cast<const T*>(ReadPadded(sizeof(T)));
+            }
+
+            const void* ReadPadded(size_t size);
+            bool IsAtEnd() const { return m_Offset == m_Size; }
+
+        private:
+
+            const unsigned char* m_Data;
+            size_t m_Size;
+            size_t m_Offset{0};
+        };
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        // Unbounded multiple producers / single consumer queue (Vyukov): producers only swap the head pointer,
+        // so workers never wait on each other or on the consumer
+        template<typename T>
+        class LockFreeQueue
+        {
+        public:
+
+            LockFreeQueue()
+            {
+                Node* stub = new Node{};
+                m_Head.store(stub, std::memory_order_relaxed);
+                m_Tail = stub;
+            }
+
+            ~LockFreeQueue()
+            {
+                T value{};
+                while(TryPop(value)) {}
+
+                delete m_Tail;
+            }
+
+            LockFreeQueue(const LockFreeQueue&) = delete;
+            LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+            // Any thread
+            void Push(T value)
+            {
+                Node* node = new Node{};
+                node->Value = std::move(value);
+
+                Node* previousHead = m_Head.exchange(node, std::memory_order_acq_rel);
+                previousHead->Next.store(node, std::memory_order_release);
+            }
+
+            // Consumer thread only, an element being pushed concurrently may not be visible yet
+            bool TryPop(T& outValue)
+            {
+                Node* next = m_Tail->Next.load(std::memory_order_acquire);
+
+                if(!next)
+                {
+                    return false;
+                }
+
+                outValue = std::move(next->Value);
+
+                delete m_Tail;
+                m_Tail = next;
+
+                return true;
+            }
+
+        private:
+
+            struct Node
+            {
+                std::atomic<Node*> Next{nullptr};
+                T Value{};
+            };
+
+            std::atomic<Node*> m_Head{nullptr};
+            // Already consumed node, its Next is the oldest element
+            Node* m_Tail{nullptr};
+        };
+    }
+}
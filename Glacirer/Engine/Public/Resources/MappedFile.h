@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        // Read only view of a whole file mapped in memory, pages are only loaded when accessed
+        class MappedFile
+        {
+        public:
+
+            MappedFile() = default;
+            ~MappedFile();
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            bool Open(const std::string& filePath);
+            void Close();
+
+            bool IsOpen() const { return m_Data != nullptr; }
+            const unsigned char* GetData() const { return m_Data; }
+            size_t GetSize() const { return m_Size; }
+
+        private:
+
+            const unsigned char* m_Data{nullptr};
+            size_t m_Size{0};
+
+#ifdef _WIN32
+            void* m_FileHandle{nullptr};
+            void* m_MappingHandle{nullptr};
+#endif
+        };
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Rendering/Mesh.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class ModelData;
+    }
+
+    namespace Resources
+    {
+        struct CookedMeshLOD
+        {
+            Rendering::VertexFormat VertexFormat{};
+            Rendering::Bounds Bounds{}; // Used to encode quantized positions
+            unsigned int TotalVertices{0};
+            std::vector<unsigned char> VertexData{}; // Already in GPU layout (see Mesh::PackVertices)
+            std::vector<unsigned int> Indices{};
+            // Import precision positions, LOD 0 only. Kept on CPU for occlusion culling and scene queries
+            std::vector<glm::vec3> Positions{};
+        };
+
+        // Import result of a single mesh, LOD 0 first
+        struct CookedMesh
+        {
+            std::string Name{};
+            std::vector<CookedMeshLOD> LODs{};
+        };
+
+        // Imported models stored next to their source file in the layout the GPU consumes, so later loads
+        // map the file and upload buffers straight from it instead of going through Assimp and the import steps
+        class MeshCache
+        {
+        public:
+
+            // Bump whenever import output (optimization, LODs, vertex formats) or the file layout changes
+            constexpr static uint32_t IMPORTER_VERSION = 2;
+
+            static std::string GetCachePath(const std::string& sourceFilePath);
+
+            static bool Write(const std::string& cachePath, uint64_t sourceHash, const std::vector<CookedMesh>& cookedMeshes);
+            // Fails without touching outModel if the cache is missing, stale (other source hash or importer version) or corrupted
+            static bool TryLoad(const std::string& cachePath, uint64_t sourceHash, Rendering::ModelData& outModel);
+            // Same checks without creating meshes (no GL calls), data is copied out of the mapping
+            static bool TryRead(const std::string& cachePath, uint64_t sourceHash, std::vector<CookedMesh>& outCookedMeshes);
+        };
+    }
+}
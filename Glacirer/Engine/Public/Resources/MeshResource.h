@@ -1,6 +1,8 @@
 #pragma once
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 
@@ -10,10 +12,15 @@ namespace Glacirer
     {
         class ModelData;
         class Mesh;
+        struct Vertex;
+        struct VertexFormat;
     }
 
     namespace Resources
     {
+        struct CookedMesh;
+        struct CookedMeshLOD;
+
         class MeshResource
         {
         public:
@@ -22,11 +29,20 @@ namespace Glacirer
             static std::shared_ptr<Rendering::Mesh> LoadQuad();
             static std::shared_ptr<Rendering::Mesh> LoadSphere(const std::string& filePath);
             static std::shared_ptr<Rendering::ModelData> LoadModelFromFile(const std::string& filePath);
-                                              
+            // CPU only part of loading (no GL calls, safe on worker threads): reads the mesh cache or imports and cooks the file
+            static bool ImportModelFromFile(const std::string& filePath, std::vector<CookedMesh>& outCookedMeshes);
+            static std::shared_ptr<Rendering::Mesh> CreateMesh(const CookedMesh& cookedMesh);
+
         private:
 
-            static void ProcessNode(aiNode* node, const aiScene* scene, Rendering::ModelData& outModel);
-            static std::shared_ptr<Rendering::Mesh> ProcessMesh(aiMesh* mesh, const aiScene* scene);
+            static bool ImportModelFromSource(const std::string& filePath, uint64_t sourceHash, std::vector<CookedMesh>& outCookedMeshes);
+
+            static void ProcessNode(aiNode* node, const aiScene* scene, std::vector<CookedMesh>& outCookedMeshes);
+            static void ProcessMesh(aiMesh* mesh, const aiScene* scene, CookedMesh& outCookedMesh);
+            static CookedMeshLOD CookLOD(const std::vector<Rendering::Vertex>& vertices, const std::vector<unsigned int>& indices);
+            static Rendering::VertexFormat SelectVertexFormat(const std::vector<Rendering::Vertex>& vertices);
+            static void OptimizeMeshData(std::vector<Rendering::Vertex>& vertices, std::vector<unsigned int>& indices);
+            static void GenerateLODs(CookedMesh& cookedMesh, const std::vector<Rendering::Vertex>& vertices, const std::vector<unsigned int>& indices);
         };
     }
 }
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        // Slot index in a ResourcePool plus the generation of the resource it was created for,
+        // so a handle to a removed resource stays invalid even after its slot is reused
+        template<typename T>
+        struct ResourceHandle
+        {
+            constexpr static uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+            uint32_t Index{INVALID_INDEX};
+            uint32_t Generation{0};
+
+            bool IsValid() const { return Index != INVALID_INDEX; }
+
+            bool operator==(const ResourceHandle& other) const { return Index == other.Index && Generation == other.Generation; }
+            bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
+        };
+    }
+}
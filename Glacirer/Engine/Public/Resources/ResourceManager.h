@@ -1,10 +1,13 @@
 #pragma once
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "EngineAPI.h"
 #include "Rendering/TextureSettings.h"
+#include "Resources/AsyncResourceLoader.h"
+#include "Resources/ResourceRegistry.h"
+#include "Resources/TextureStreamer.h"
 
 namespace Glacirer
 {
@@ -45,9 +48,10 @@ namespace Glacirer
             static std::shared_ptr<Rendering::Material> GetOrCreateMaterial(const std::string& name, const std::string& shaderName);
             static std::shared_ptr<Rendering::Material> GetMaterial(const std::string& name);
             static void UnloadMaterial(const std::string& name);
-            static const std::unordered_map<std::string, std::shared_ptr<Rendering::Material>>& GetAllMaterials();
+            static std::vector<std::shared_ptr<Rendering::Material>> GetAllMaterials();
             static unsigned int GetNextMaterialId();
 
+            // Streamed if settings.bStream (see TextureStreamer)
             static std::shared_ptr<Rendering::Texture> LoadTexture(const std::string& filePath, const std::string& name, const Rendering::TextureSettings& settings, bool bFlipVertically = true);
             static std::shared_ptr<Rendering::Texture> GetOrLoadTexture(const std::string& filePath, const std::string& name, const Rendering::TextureSettings& settings, bool bFlipVertically = true);
             static std::shared_ptr<Rendering::Texture> GetTexture(const std::string& name);
@@ -55,11 +59,29 @@ namespace Glacirer
             static std::shared_ptr<Rendering::Cubemap> GetOrLoadCubemap(const Rendering::CubemapLoadSettings& loadSettings, const std::string& name);
             static std::shared_ptr<Rendering::Cubemap> GetCubemap(const std::string& name);
 
+            // Return placeholders right away (registered under name like sync loads), see AsyncResourceLoader
+            static std::shared_ptr<Rendering::Texture> LoadTextureAsync(const std::string& filePath, const std::string& name, const Rendering::TextureSettings& settings, bool bFlipVertically = true);
+            static std::shared_ptr<Rendering::Cubemap> LoadCubemapAsync(const Rendering::CubemapLoadSettings& loadSettings, const std::string& name);
+            static std::shared_ptr<Rendering::ModelData> LoadModelAsync(const std::string& filePath, const std::string& name);
+            // Uploads finished async loads within the upload budget, called once per frame by the engine
+            static void ProcessAsyncLoads();
+            static void SetAsyncUploadBudget(const AsyncUploadBudget& budget);
+            static AsyncUploadBudget GetAsyncUploadBudget();
+            static unsigned int GetTotalPendingAsyncLoads();
+            // Streams texture mips in and out from what was rendered last frame, called once per frame by the engine
+            static void UpdateTextureStreaming();
+            static TextureStreamer& GetTextureStreamer();
+
             static std::shared_ptr<Rendering::Mesh> GetMesh(const std::string& name);
             static std::shared_ptr<Rendering::ModelData> LoadModel(const std::string& filePath, const std::string& name);
             static std::shared_ptr<Rendering::ModelData> GetOrLoadModel(const std::string& filePath, const std::string& name);
             static std::shared_ptr<Rendering::ModelData> GetModel(const std::string& name);
     
+            // Evicts unused resources from pools over budget and caches newly compiled shaders, called once per frame by the engine
+            static void UpdateResources();
+            // Pools behind the functions above, for handles, budgets and memory stats
+            static ResourceRegistry& GetRegistry();
+
             static void UnloadAll();
 
         private:
@@ -71,15 +93,14 @@ namespace Glacirer
             static std::string DEFAULT_MESH_QUAD_NAME;
             static std::string DEFAULT_MESH_SPHERE_NAME;
 
-            static std::unordered_map<std::string, std::shared_ptr<Rendering::Shader>> m_Shaders;
-            static std::unordered_map<std::string, std::shared_ptr<Rendering::Mesh>> m_Meshes;
-            static std::unordered_map<std::string, std::shared_ptr<Rendering::Material>> m_Materials;
-            static std::unordered_map<std::string, std::shared_ptr<Rendering::Texture>> m_Textures;
-            static std::unordered_map<std::string, std::shared_ptr<Rendering::ModelData>> m_Models;
-            static std::unordered_map<std::string, std::shared_ptr<Rendering::Cubemap>> m_Cubemaps;
+            static ResourceRegistry m_Registry;
+            static std::unique_ptr<TextureStreamer> m_TextureStreamer;
+            static std::unique_ptr<AsyncResourceLoader> m_AsyncLoader;
     
             static unsigned int m_NextMaterialID;
 
+            static AsyncResourceLoader& GetAsyncLoader();
+
             ResourceManager() = default;
         };
     }
@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Cubemap;
+        class Material;
+        class Mesh;
+        class ModelData;
+        class Shader;
+        class Texture;
+    }
+
+    namespace Resources
+    {
+        struct ResourceMemory
+        {
+            size_t CpuBytes{0};
+            size_t GpuBytes{0};
+
+            size_t GetTotalBytes() const { return CpuBytes + GpuBytes; }
+
+            ResourceMemory& operator+=(const ResourceMemory& other)
+            {
+                CpuBytes += other.CpuBytes;
+                GpuBytes += other.GpuBytes;
+                return *this;
+            }
+        };
+
+        // Bytes owned by each resource type, used by ResourcePool accounting. Shaders and materials are negligible
+        ResourceMemory GetResourceMemory(const Rendering::Cubemap& cubemap);
+        ResourceMemory GetResourceMemory(const Rendering::Material& material);
+        ResourceMemory GetResourceMemory(const Rendering::Mesh& mesh);
+        ResourceMemory GetResourceMemory(const Rendering::ModelData& modelData);
+        ResourceMemory GetResourceMemory(const Rendering::Shader& shader);
+        ResourceMemory GetResourceMemory(const Rendering::Texture& texture);
+    }
+}
@@ -0,0 +1,263 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Resources/ResourceHandle.h"
+#include "Resources/ResourceMemory.h"
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        // Named resources of one type addressed by generational handles.
+        // A resource is in use while it has explicit references (Retain/Release) or is shared outside the pool
+        // (e.g. a material holding a texture). Unused ones are kept, ordered by the time they stopped being used,
+        // and the least recently used are evicted whenever the pool memory goes over budget
+        template<typename T>
+        class ResourcePool
+        {
+        public:
+
+            constexpr static size_t UNLIMITED_BUDGET = std::numeric_limits<size_t>::max();
+
+            ResourcePool() = default;
+            ResourcePool(const ResourcePool&) = delete;
+            ResourcePool& operator=(const ResourcePool&) = delete;
+
+            // Replaces (and invalidates handles to) any resource with the same name
+            ResourceHandle<T> Add(const std::string& name, const std::shared_ptr<T>& resource)
+            {
+                Remove(Find(name));
+
+                uint32_t index;
+                if(!m_FreeSlots.empty())
+                {
+                    index = m_FreeSlots.back();
+                    m_FreeSlots.pop_back();
+                }
+                else
+                {
+                    index = static_cast<uint32_t>(m_Slots.size());
+                    m_Slots.emplace_back();
+                }
+
+                Slot& slot = m_Slots[index];
+                slot.Resource = resource;
+                slot.Name = name;
+                slot.RefCount = 0;
+                slot.Memory = GetResourceMemory(*resource);
+                slot.LastUsedFrame = m_CurrentFrame;
+                slot.bIsUnused = false;
+
+                m_TotalMemory += slot.Memory;
+                m_SlotsByName[name] = index;
+
+                return ResourceHandle<T>{index, slot.Generation};
+            }
+
+            // Invalid handle if there is no resource with that name
+            ResourceHandle<T> Find(const std::string& name) const
+            {
+                auto iterator = m_SlotsByName.find(name);
+
+                if(iterator == m_SlotsByName.end())
+                {
+                    return ResourceHandle<T>{};
+                }
+
+                return ResourceHandle<T>{iterator->second, m_Slots[iterator->second].Generation};
+            }
+
+            // nullptr if the handle is invalid or its resource was removed or evicted
+            std::shared_ptr<T> Get(ResourceHandle<T> handle) const
+            {
+                const Slot* slot = GetSlot(handle);
+                return slot ? slot->Resource : nullptr;
+            }
+
+            std::shared_ptr<T> Get(const std::string& name) const { return Get(Find(name)); }
+            bool Contains(const std::string& name) const { return m_SlotsByName.find(name) != m_SlotsByName.end(); }
+            bool IsValid(ResourceHandle<T> handle) const { return GetSlot(handle) != nullptr; }
+
+            // Resources with explicit references are never evicted, even if nothing else shares them
+            void Retain(ResourceHandle<T> handle)
+            {
+                if(Slot* slot = GetSlot(handle))
+                {
+                    slot->RefCount++;
+                }
+            }
+
+            void Release(ResourceHandle<T> handle)
+            {
+                Slot* slot = GetSlot(handle);
+
+                if(slot && slot->RefCount > 0)
+                {
+                    slot->RefCount--;
+                }
+            }
+
+            // Explicit references plus owners sharing the resource outside the pool
+            unsigned int GetRefCount(ResourceHandle<T> handle) const
+            {
+                const Slot* slot = GetSlot(handle);
+                return slot ? slot->RefCount + static_cast<unsigned int>(slot->Resource.use_count() - 1) : 0;
+            }
+
+            ResourceMemory GetMemory(ResourceHandle<T> handle) const
+            {
+                const Slot* slot = GetSlot(handle);
+                return slot ? slot->Memory : ResourceMemory{};
+            }
+
+            void Remove(ResourceHandle<T> handle)
+            {
+                if(GetSlot(handle))
+                {
+                    FreeSlot(handle.Index);
+                }
+            }
+
+            void Remove(const std::string& name) { Remove(Find(name)); }
+
+            void Clear()
+            {
+                m_Slots.clear();
+                m_FreeSlots.clear();
+                m_SlotsByName.clear();
+                m_UnusedSlots.clear();
+                m_TotalMemory = ResourceMemory{};
+            }
+
+            // Once per frame: refreshes memory (resources like streamed textures change size) and unused tracking,
+            // then evicts unused resources while over budget
+            void Update()
+            {
+                m_CurrentFrame++;
+                m_TotalMemory = ResourceMemory{};
+
+                for(uint32_t index = 0; index < static_cast<uint32_t>(m_Slots.size()); index++)
+                {
+                    Slot& slot = m_Slots[index];
+
+                    if(!slot.Resource)
+                    {
+                        continue;
+                    }
+
+                    slot.Memory = GetResourceMemory(*slot.Resource);
+                    m_TotalMemory += slot.Memory;
+
+                    const bool bIsUsed = slot.RefCount > 0 || slot.Resource.use_count() > 1;
+
+                    if(bIsUsed)
+                    {
+                        slot.LastUsedFrame = m_CurrentFrame;
+
+                        if(slot.bIsUnused)
+                        {
+                            m_UnusedSlots.erase(slot.UnusedIterator);
+                            slot.bIsUnused = false;
+                        }
+                    }
+                    else if(!slot.bIsUnused)
+                    {
+                        slot.UnusedIterator = m_UnusedSlots.insert(m_UnusedSlots.end(), index);
+                        slot.bIsUnused = true;
+                    }
+                }
+
+                while(m_TotalMemory.GetTotalBytes() > m_BudgetBytes && !m_UnusedSlots.empty())
+                {
+                    FreeSlot(m_UnusedSlots.front());
+                }
+            }
+
+            // Only unused resources are evicted, the pool can stay over budget if everything is in use
+            void SetBudget(size_t budgetBytes) { m_BudgetBytes = budgetBytes; }
+            size_t GetBudget() const { return m_BudgetBytes; }
+            const ResourceMemory& GetTotalMemory() const { return m_TotalMemory; }
+            unsigned int GetTotalResources() const { return static_cast<unsigned int>(m_SlotsByName.size()); }
+            unsigned int GetTotalUnusedResources() const { return static_cast<unsigned int>(m_UnusedSlots.size()); }
+
+            // function(name, resource), resources mustn't be added or removed meanwhile
+            template<typename TFunction>
+            void ForEach(TFunction&& function) const
+            {
+                for(const Slot& slot : m_Slots)
+                {
+                    if(slot.Resource)
+                    {
+                        function(slot.Name, slot.Resource);
+                    }
+                }
+            }
+
+        private:
+
+            struct Slot
+            {
+                std::shared_ptr<T> Resource{};
+                std::string Name{};
+                uint32_t Generation{0};
+                unsigned int RefCount{0};
+                ResourceMemory Memory{};
+                uint64_t LastUsedFrame{0};
+                bool bIsUnused{false};
+                std::list<uint32_t>::iterator UnusedIterator{};
+            };
+
+            std::vector<Slot> m_Slots{};
+            std::vector<uint32_t> m_FreeSlots{};
+            std::unordered_map<std::string, uint32_t> m_SlotsByName{};
+            std::list<uint32_t> m_UnusedSlots{}; // Least recently used first
+            ResourceMemory m_TotalMemory{};
+            size_t m_BudgetBytes{UNLIMITED_BUDGET};
+            uint64_t m_CurrentFrame{0};
+
+            Slot* GetSlot(ResourceHandle<T> handle)
+            {
+                return const_cast<Slot*>(static_cast<const ResourcePool*>(this)->GetSlot(handle));
+            }
+
+            const Slot* GetSlot(ResourceHandle<T> handle) const
+            {
+                if(handle.Index >= m_Slots.size())
+                {
+                    return nullptr;
+                }
+
+                const Slot& slot = m_Slots[handle.Index];
+                return slot.Resource && slot.Generation == handle.Generation ? &slot : nullptr;
+            }
+
+            void FreeSlot(uint32_t index)
+            {
+                Slot& slot = m_Slots[index];
+
+                if(slot.bIsUnused)
+                {
+                    m_UnusedSlots.erase(slot.UnusedIterator);
+                    slot.bIsUnused = false;
+                }
+
+                m_TotalMemory.CpuBytes -= slot.Memory.CpuBytes;
+                m_TotalMemory.GpuBytes -= slot.Memory.GpuBytes;
+                m_SlotsByName.erase(slot.Name);
+
+                slot.Resource.reset();
+                slot.Name.clear();
+                slot.Memory = ResourceMemory{};
+                slot.Generation++;
+
+                m_FreeSlots.push_back(index);
+            }
+        };
+    }
+}
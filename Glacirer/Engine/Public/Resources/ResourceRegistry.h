@@ -0,0 +1,55 @@
+#pragma once
+#include "EngineAPI.h"
+#include "Rendering/Cubemap.h"
+#include "Rendering/Material.h"
+#include "Rendering/Mesh.h"
+#include "Rendering/ModelData.h"
+#include "Rendering/Shader.h"
+#include "Rendering/Texture.h"
+#include "Resources/ResourcePool.h"
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        // One pool per resource type, each with its own budget. ResourceManager owns the default one,
+        // more can be created for resources with their own lifetime (e.g. a level)
+        class ENGINE_API ResourceRegistry
+        {
+        public:
+
+            ResourceRegistry() = default;
+            ResourceRegistry(const ResourceRegistry&) = delete;
+            ResourceRegistry& operator=(const ResourceRegistry&) = delete;
+
+            ResourcePool<Rendering::Shader>& GetShaders() { return m_Shaders; }
+            ResourcePool<Rendering::Mesh>& GetMeshes() { return m_Meshes; }
+            ResourcePool<Rendering::Material>& GetMaterials() { return m_Materials; }
+            ResourcePool<Rendering::Texture>& GetTextures() { return m_Textures; }
+            ResourcePool<Rendering::ModelData>& GetModels() { return m_Models; }
+            ResourcePool<Rendering::Cubemap>& GetCubemaps() { return m_Cubemaps; }
+
+            const ResourcePool<Rendering::Shader>& GetShaders() const { return m_Shaders; }
+            const ResourcePool<Rendering::Mesh>& GetMeshes() const { return m_Meshes; }
+            const ResourcePool<Rendering::Material>& GetMaterials() const { return m_Materials; }
+            const ResourcePool<Rendering::Texture>& GetTextures() const { return m_Textures; }
+            const ResourcePool<Rendering::ModelData>& GetModels() const { return m_Models; }
+            const ResourcePool<Rendering::Cubemap>& GetCubemaps() const { return m_Cubemaps; }
+
+            // Once per frame. Materials go first so the textures and shaders only they used are unused right away
+            void Update();
+            void Clear();
+
+            ResourceMemory GetTotalMemory() const;
+
+        private:
+
+            ResourcePool<Rendering::Shader> m_Shaders{};
+            ResourcePool<Rendering::Mesh> m_Meshes{};
+            ResourcePool<Rendering::Material> m_Materials{};
+            ResourcePool<Rendering::Texture> m_Textures{};
+            ResourcePool<Rendering::ModelData> m_Models{};
+            ResourcePool<Rendering::Cubemap> m_Cubemaps{};
+        };
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Shader;
+        struct ShaderBinary;
+        struct ShaderSource;
+    }
+
+    namespace Resources
+    {
+        // Linked program binaries stored under an intermediate directory, they are per machine and never shipped with the sources.
+        // The key covers the final sources and the driver, so editing a shader or updating the driver just misses the cache
+        class ShaderCache
+        {
+        public:
+
+            // Bump whenever the file layout changes
+            constexpr static uint32_t CACHE_VERSION = 1;
+
+            // Needs a current GL context for the driver strings, which are hashed once here. Also creates the cache directory
+            static void Initialize();
+
+            // Every variant of a shader has its own file
+            static std::string GetCachePath(const std::string& sourceFilePath, uint32_t variantMask = 0);
+            static uint64_t GetCacheKey(const Rendering::ShaderSource& source);
+
+            static bool Write(const std::string& cachePath, uint64_t cacheKey, const Rendering::ShaderBinary& binary);
+            // Fails if the cache is missing, stale or corrupted
+            static bool TryRead(const std::string& cachePath, uint64_t cacheKey, Rendering::ShaderBinary& outBinary);
+
+            // The binary of a shader compiled from source only exists once the driver is done with it,
+            // it is written by WriteCompiledShaders on a later frame instead of waiting here
+            static void QueueWrite(const std::shared_ptr<Rendering::Shader>& shader, const std::string& cachePath, uint64_t cacheKey);
+            // Main thread, once per frame
+            static void WriteCompiledShaders();
+
+        private:
+
+            struct PendingWrite
+            {
+                std::weak_ptr<Rendering::Shader> Shader{};
+                std::string CachePath{};
+                uint64_t CacheKey{0};
+            };
+
+            static const std::string CACHE_DIRECTORY;
+
+            static std::vector<PendingWrite> m_PendingWrites;
+            static uint64_t m_DriverHash;
+        };
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Rendering/Shader.h"
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        enum class ShaderStage : uint8_t
+        {
+            Vertex,
+            Fragment,
+            Geometry
+        };
+
+        constexpr unsigned int TOTAL_SHADER_STAGES = 3;
+
+        // Shader with its includes expanded, still shared by all of its variants
+        struct PreprocessedShader
+        {
+            std::array<std::string, TOTAL_SHADER_STAGES> Stages{};
+            Rendering::ShaderProperties Properties{};
+            // Bit i of a variant mask defines VariantKeywords[i]
+            std::vector<std::string> VariantKeywords{};
+        };
+
+        // Line based preprocessor run before handing sources to the driver. It understands:
+        //  #shader vertex|fragment|geometry   starts a stage (single file shaders)
+        //  #include "path"                   relative to the including file, each file is included once per stage
+        //  #pragma variant KEYWORD            declares a feature keyword, defined only in the variants enabling it
+        // and collects material properties from "uniform <type> <name>;" declarations.
+        // Everything else, including #define and #ifdef, is left to the GLSL compiler
+        class ShaderPreprocessor
+        {
+        public:
+
+            constexpr static unsigned int MAX_VARIANT_KEYWORDS = 32;
+
+            static bool PreprocessFile(const std::string& filePath, PreprocessedShader& outShader);
+            // Whole file goes to stage, for shaders split in one file per stage
+            static bool PreprocessStageFile(const std::string& filePath, ShaderStage stage, PreprocessedShader& outShader);
+
+            // Engine constants (see RenderingConstants.h) and the keywords enabled by variantMask
+            // are defined right after the #version line of every stage
+            static Rendering::ShaderSource GetVariantSource(const PreprocessedShader& shader, uint32_t variantMask);
+        };
+    }
+}
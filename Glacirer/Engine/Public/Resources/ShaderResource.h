@@ -7,23 +7,26 @@ namespace Glacirer
     namespace Rendering
     {
         class Shader;
+        struct ShaderSource;
     }
     
     namespace Resources
     {
+        struct PreprocessedShader;
+
         class ShaderResource
         {
         public:
 
+            // Sources go through ShaderPreprocessor. Both load the program binary cached by a previous run
+            // when it still matches (see ShaderCache), variants included
             static std::shared_ptr<Rendering::Shader> LoadShaderFromFile(const std::string& vertexShaderPath, const std::string& fragShaderPath);
             static std::shared_ptr<Rendering::Shader> LoadShaderFromFile(const std::string& singleFileShaderPath);
 
         private:
 
-            static constexpr const char* SHADER_TYPE_KEYWORD = "#shader";
-            static constexpr const char* VERTEX_SHADER_KEYWORD = "vertex";
-            static constexpr const char* FRAGMENT_SHADER_KEYWORD = "fragment";
-            static constexpr const char* GEOMETRY_SHADER_KEYWORD = "geometry";
+            static std::shared_ptr<Rendering::Shader> CreateShaderWithVariants(PreprocessedShader&& preprocessedShader, const std::string& sourceFilePath);
+            static std::shared_ptr<Rendering::Shader> CreateShader(const Rendering::ShaderSource& source, const std::string& cachePath);
         };
     }
 }
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Texture;
+        struct TextureMip;
+        struct TextureSettings;
+    }
+
+    namespace Resources
+    {
+        class MappedFile;
+
+        struct CookedTextureMip
+        {
+            unsigned int Width{0};
+            unsigned int Height{0};
+            std::vector<unsigned char> Data{};
+        };
+
+        // Full mip chain in its final GPU format (block compressed or tightly packed channels)
+        struct CookedTexture
+        {
+            unsigned int InternalFormat{0};
+            unsigned int Format{0};
+            unsigned int Type{0};
+            std::vector<CookedTextureMip> Mips{};
+        };
+
+        // KTX like container stored next to the source image, loads map it and upload every mip straight from the mapping
+        class TextureCache
+        {
+        public:
+
+            // Bump whenever cooked output (mip filtering, compression) or the file layout changes
+            constexpr static uint32_t COOKER_VERSION = 1;
+
+            static std::string GetCachePath(const std::string& sourceFilePath);
+
+            // cookKey identifies the settings the texture was cooked with, a different one is treated as stale
+            static bool Write(const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, const CookedTexture& cookedTexture);
+            // nullptr if the cache is missing, stale, corrupted or its format isn't supported by the current GPU
+            // Formats are taken from the cache, sampling parameters from settings
+            static std::shared_ptr<Rendering::Texture> TryLoad(const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, const Rendering::TextureSettings& settings);
+            // Same checks without creating the texture (no GL calls), data is copied out of the mapping
+            static bool TryRead(const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, CookedTexture& outCookedTexture);
+            // Same checks on a file the caller keeps mapped, only formats are written to outFormat and outMips point into the mapping
+            static bool TryMap(const MappedFile& file, const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, CookedTexture& outFormat, std::vector<Rendering::TextureMip>& outMips);
+        };
+    }
+}
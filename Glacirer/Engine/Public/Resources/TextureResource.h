@@ -1,7 +1,11 @@
 #pragma once
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "Rendering/Cubemap.h"
 #include "Rendering/Texture.h"
 
 namespace Glacirer
@@ -9,18 +13,56 @@ namespace Glacirer
     namespace Rendering
     {
         struct CubemapLoadSettings;
-        class Cubemap;
-        class Texture;
     }
 
     namespace Resources
     {
+        struct CookedTexture;
+        class TextureStreamer;
+        class WorkerPool;
+
+        // 8 bit per channel image straight from the decoder
+        struct DecodedImage
+        {
+            std::vector<unsigned char> Data{};
+            int Width{0};
+            int Height{0};
+        };
+
         class TextureResource
         {
         public:
 
+            // Cooked on first load (full mip chain, compressed depending on settings.Usage and bCompress) and cached next to the file
             static std::shared_ptr<Rendering::Texture> LoadTextureFromFile(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically = true);
-            static std::shared_ptr<Rendering::Cubemap> LoadCubemapFromFile(const Rendering::CubemapLoadSettings& loadSettings);
+            // Only the smallest mips are uploaded, textureStreamer streams the rest when needed. nullptr if the texture cache can't be used
+            static std::shared_ptr<Rendering::Texture> LoadStreamedTextureFromFile(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, TextureStreamer& textureStreamer);
+
+            // Sides are decoded in parallel on workerPool and uploaded in order as they finish
+            static std::shared_ptr<Rendering::Cubemap> LoadCubemapFromFile(const Rendering::CubemapLoadSettings& loadSettings, WorkerPool& workerPool);
+
+            // No GL calls, safe to call from worker threads. Reads the texture cache or cooks (and caches) the source image
+            static bool CookTextureFromFile(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, CookedTexture& outCookedTexture);
+            static Rendering::TextureSettings GetUploadSettings(const Rendering::TextureSettings& settings, const CookedTexture& cookedTexture);
+            // No GL calls, cooks the texture if its cache is missing or stale. False if there is no usable cache afterwards (e.g. read only folder)
+            static bool EnsureTextureCache(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, uint64_t& outSourceHash);
+            // Stored in the cache to detect textures cooked with other settings
+            static uint32_t GetCookKey(const Rendering::TextureSettings& settings, bool bFlipVertically);
+            // Neutral 1x1 texture (grey, flat normal or white mask depending on settings.Usage) shown while the real one loads, IsLoaded is false
+            static std::shared_ptr<Rendering::Texture> CreatePlaceholderTexture(const Rendering::TextureSettings& settings);
+
+            // No GL calls, safe to call from worker threads. Data is empty if the file couldn't be decoded
+            static DecodedImage DecodeCubemapSide(const std::string& filePath);
+            static Rendering::TextureSettings GetCubemapSettings(const Rendering::CubemapLoadSettings& loadSettings);
+            static std::array<std::string, Rendering::Cubemap::TOTAL_SIDES> GetCubemapSidePaths(const Rendering::CubemapLoadSettings& loadSettings);
+
+        private:
+
+            static bool CookTextureFromSource(const std::string& filePath, const Rendering::TextureSettings& settings, bool bFlipVertically, uint64_t sourceHash, CookedTexture& outCookedTexture);
+
+            static CookedTexture CookTexture(const unsigned char* rgbaData, unsigned int width, unsigned int height, const Rendering::TextureSettings& settings, bool bUseAlpha);
+            static std::shared_ptr<Rendering::Texture> CreateTexture(const CookedTexture& cookedTexture, const Rendering::TextureSettings& settings);
+            static Rendering::TextureSettings GetSamplingSettings(const Rendering::TextureSettings& settings);
         };
     }
 }
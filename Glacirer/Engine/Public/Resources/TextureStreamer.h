@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Rendering/Texture.h"
+#include "Resources/MappedFile.h"
+
+namespace Glacirer
+{
+    namespace Rendering
+    {
+        class Material;
+    }
+
+    namespace Resources
+    {
+        struct TextureStreamingSettings
+        {
+            // Memory used by streamed mips above it evicts the least recently needed ones
+            size_t BudgetBytes{256u * 1024u * 1024u};
+            // At least one mip is streamed in per frame whatever its size
+            unsigned int MaxUploadBytesPerFrame{8u * 1024u * 1024u};
+            // Mips up to this size are uploaded when the texture is registered and never evicted
+            unsigned int MinResidentSize{64};
+        };
+
+        // Keeps only the mips textures are drawn at resident. Mip data is read from the texture cache, which stays mapped
+        // while the texture lives, so evicted mips can be streamed in again without decoding the source image.
+        // Needed mips come from the screen size of the objects using each material (see RenderSystem), assuming
+        // their UVs cover the texture once
+        class TextureStreamer
+        {
+        public:
+
+            explicit TextureStreamer(const TextureStreamingSettings& settings = {});
+
+            // Uploads the always resident mips into texture (e.g. a placeholder), false if the cache can't be mapped
+            bool Register(const std::shared_ptr<Rendering::Texture>& texture, const std::string& cachePath, uint64_t sourceHash, uint32_t cookKey, const Rendering::TextureSettings& settings);
+
+            // Called while rendering, screenHeightPixels is the height covered by an object using material
+            void RequestMaterialTextures(const Rendering::Material& material, float screenHeightPixels);
+            // Main thread, once per frame after rendering: streams needed mips in and evicts others to stay within budget
+            void Update();
+
+            void SetSettings(const TextureStreamingSettings& settings) { m_Settings = settings; }
+            const TextureStreamingSettings& GetSettings() const { return m_Settings; }
+            size_t GetResidentBytes() const { return m_ResidentBytes; }
+            unsigned int GetTotalStreamedTextures() const { return static_cast<unsigned int>(m_Textures.size()); }
+
+        private:
+
+            struct StreamedTexture
+            {
+                std::weak_ptr<Rendering::Texture> Texture{};
+                MappedFile CacheFile{};
+                std::vector<Rendering::TextureMip> Mips{}; // Point into CacheFile
+                Rendering::TextureSettings UploadSettings{};
+                unsigned int TailLevel{0}; // First always resident level
+                unsigned int ResidentLevel{0}; // Highest resolution level uploaded
+                unsigned int RequestedLevel{0}; // Highest resolution level requested this frame
+                unsigned int WantedLevel{0}; // Last requested level
+                uint64_t LastNeededFrame{0};
+            };
+
+            TextureStreamingSettings m_Settings{};
+            std::unordered_map<const Rendering::Texture*, std::unique_ptr<StreamedTexture>> m_Textures{};
+            size_t m_ResidentBytes{0};
+            uint64_t m_CurrentFrame{1};
+
+            void StreamIn(StreamedTexture& streamedTexture, Rendering::Texture& texture);
+            void Evict(StreamedTexture& streamedTexture, Rendering::Texture& texture);
+            // Least recently needed texture with a mip above what it needs, nullptr if there is none
+            StreamedTexture* FindEvictionCandidate(const StreamedTexture* excludedTexture);
+            unsigned int GetEvictionFloor(const StreamedTexture& streamedTexture) const;
+            void RemoveExpiredTextures();
+            static size_t GetResidentSize(const StreamedTexture& streamedTexture);
+        };
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Glacirer
+{
+    namespace Resources
+    {
+        // Background threads for CPU side work (decoding, importing, cooking, occlusion rasterization), jobs must not make GL calls
+        class WorkerPool
+        {
+        public:
+
+            // 0 uses every hardware thread except the main one
+            explicit WorkerPool(unsigned int totalWorkers = 0);
+            // Jobs not started yet are dropped, running ones are waited for
+            ~WorkerPool();
+
+            WorkerPool(const WorkerPool&) = delete;
+            WorkerPool& operator=(const WorkerPool&) = delete;
+
+            void Submit(std::function<void()> job);
+
+            template<typename TFunction>
+            std::future<decltype(std::declval<TFunction>()())> SubmitWithFuture(TFunction&& function)
+            {
+                using TResult = decltype(std::declval<TFunction>()());
+
+                // std::function needs a copyable callable
+                std::shared_ptr<std::packaged_task<TResult()>> task = std::make_shared<std::packaged_task<TResult()>>(std::forward<TFunction>(function));
+                std::future<TResult> future = task->get_future();
+
+                Submit([task]() { (*task)(); });
+
+                return future;
+            }
+
+            unsigned int GetTotalWorkers() const { return static_cast<unsigned int>(m_Workers.size()); }
+
+        private:
+
+            std::vector<std::thread> m_Workers{};
+            std::deque<std::function<void()>> m_Jobs{};
+            std::mutex m_JobsMutex{};
+            std::condition_variable m_JobsCondition{};
+            bool bIsStopping{false};
+
+            void RunWorker();
+        };
+    }
+}
@@ -1,8 +1,11 @@
 #pragma once
 #include <memory>
 #include <vector>
+#include <utility>
 #include <glm/vec3.hpp>
+#include "Physics/SceneQuerySystem.h"
 #include "Rendering/RenderSystem.h"
+#include "Rendering/StaticBatchBuilder.h"
 #include "EngineAPI.h"
 
 namespace Glacirer
@@ -40,6 +43,18 @@ namespace Glacirer
         void SetSkyboxComponent(const std::shared_ptr<SkyboxComponent>& skyboxComponent);
         void RemoveSkyboxComponent(const std::shared_ptr<SkyboxComponent>& skyboxComponent);
 
+        // Merges mesh components of static game objects sharing an opaque material into world space chunks, drawn instead
+        // of them. Meant to run once the level is loaded, batches are rebuilt on the next update once a batched component
+        // moves, gets outlined or is destroyed
+        void BuildStaticBatches(float chunkSize = Rendering::StaticBatchBuilder::DEFAULT_CHUNK_SIZE);
+        void ClearStaticBatches();
+        void MarkStaticBatchesDirty() { bAreStaticBatchesDirty = true; }
+
+        // Queries against mesh component triangles, see Physics::SceneQuerySystem
+        bool Raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, Physics::RaycastHit& outHit);
+        void OverlapSphere(const glm::vec3& center, float radius, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents);
+        void OverlapBox(const glm::vec3& center, const glm::vec3& halfExtents, std::vector<std::shared_ptr<MeshComponent>>& outMeshComponents);
+
         unsigned int GenerateUniqueId() { return m_LastUsedId++; }
         std::vector<std::shared_ptr<GameObject>>& GetAllGameObjects() { return m_GameObjects; }
         std::shared_ptr<GameObject> GetGameObjectAt(const int index) const { return m_GameObjects[index]; }
@@ -74,10 +89,19 @@ namespace Glacirer
         void InitializeGameObject(const std::shared_ptr<GameObject>& gameObject, const glm::vec3& position, const glm::vec3& eulerRotation, const glm::vec3& scale) const;
         void UpdateGameObjects(float deltaTime);
         void DestroyPendingGameObjects();
+        void UpdateStaticBatches();
+        static bool CanBeStaticBatched(const MeshComponent& meshComponent);
     
         std::vector<std::shared_ptr<GameObject>> m_GameObjects{};
         std::shared_ptr<Rendering::RenderSystem> m_RenderSystem{};
+        Physics::SceneQuerySystem m_SceneQuerySystem{};
         std::shared_ptr<CameraComponent> m_ActiveCamera{};
+        // Owns the chunk mesh components, not part of the game objects list so it's never updated or shown
+        std::shared_ptr<GameObject> m_StaticBatchObject{};
+        // Transform version each component was batched with, to tell when it moved
+        std::vector<std::pair<std::weak_ptr<MeshComponent>, unsigned int>> m_StaticBatchedMeshComponents{};
+        float m_StaticBatchChunkSize{Rendering::StaticBatchBuilder::DEFAULT_CHUNK_SIZE};
+        bool bAreStaticBatchesDirty{false};
         unsigned int m_LastUsedId{0};
     };
 }
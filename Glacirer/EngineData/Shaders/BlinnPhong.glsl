@@ -1,21 +1,28 @@
+// Selected by Material from its state, each keyword strips the matching feature from the variant
+#pragma variant NO_SPECULAR_MAP
+#pragma variant NO_REFLECTION
+#pragma variant NO_SHADOWS
+
 #shader vertex
 #version 330 core
 
 layout(location = 0) in vec4 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in mat4 a_InstanceModelMatrix;    
+#include "Include/InstanceTransform.glsl"
 
-#define MAX_DIRECTIONAL_LIGHTS 3
-#define MAX_SPOT_LIGHTS 20
+// Depth pre-pass renders opaque objects with GL_EQUAL, so every opaque shader must output the exact same depth
+invariant gl_Position;
 
 out VS_OUT
 {
     vec2 TexCoord;
     vec3 Normal;
     vec3 FragPosition;
+#ifndef NO_SHADOWS
     vec4 FragPosDirectionalLightSpace[MAX_DIRECTIONAL_LIGHTS];
     vec4 FragPosSpotLightSpace[MAX_SPOT_LIGHTS];
+#endif
 } vsOut;
 
 layout (std140) uniform Matrices
@@ -39,8 +46,9 @@ layout (std140) uniform SpotLightShadowMapMatrices
 
 void main()
 {
-    vsOut.FragPosition = vec3(a_InstanceModelMatrix * a_Position);
+    vsOut.FragPosition = GetInstanceWorldPosition(a_Position);
 
+#ifndef NO_SHADOWS
     vec4 fragPosition = vec4(vsOut.FragPosition, 1.f);
     for(int i = 0; i < MAX_DIRECTIONAL_LIGHTS; i++)
     {
@@ -51,116 +59,43 @@ void main()
     {
         vsOut.FragPosSpotLightSpace[i] = spotLightViewProjectionMatrices[i] * fragPosition;
     }
+#endif
     
     vsOut.TexCoord = a_TexCoord;
     
-    // Normal attribute is on local space, we need to convert it to world by using the model matrix
-    // But since normal is a direction, it doesn't make sense to translate it, so we cut it by casting to a mat3
-    // We also need to take care of non-uniform scale so it doesn't mess with the actual direction, hence the transpose of inverse    
-    vsOut.Normal = mat3(transpose(inverse(a_InstanceModelMatrix))) * a_Normal;
+    // Normal attribute is on local space, it's a direction so only rotation and scale apply.
+    // Non-uniform scale is undone on the normal so it stays perpendicular to the surface
+    vsOut.Normal = GetInstanceWorldNormal(a_Normal);
 
     // Set pointSize when rendering with GL_POINTS
     //gl_PointSize = gl_Position.z;
 
-    gl_Position = projection * view * vec4(vsOut.FragPosition, 1.f);
+    gl_Position = projection * view * vec4(GetInstanceWorldPosition(a_Position), 1.f);
 
 }
 
 #shader fragment
 #version 330 core
 
-struct DirectionalLight
-{
-    float intensity;
-    float bias;
-    float normalBias;
-    int CastShadow;
-    vec3 direction;
-    vec3 diffuse;
-    vec3 specular;    
-};
-
-struct PointLight
-{
-    vec3 position;
-    float constant;
-    float linear;
-    float quadratic;
-
-    int CastShadow;
-    
-    vec3 diffuse;
-    vec3 specular;
-    
-    float intensity;
-};
-
-struct SpotLight
-{
-    vec3 position;
-    int CastShadow;
-    vec3 direction;
-    float cutoff;
-    float outerCutoff;
-    float constant;
-    float linear;
-    float quadratic;
-    
-    vec3 diffuse;
-    vec3 specular;
-    
-    float intensity;
-};
-
-struct AmbientLight
-{
-    vec3 color;
-};
+#include "Include/Lighting.glsl"
 
 layout(location = 0) out vec4 o_Color;
 
-#define MAX_DIRECTIONAL_LIGHTS 3
-#define MAX_POINT_LIGHTS 20
-#define MAX_SPOT_LIGHTS 20
-
 in VS_OUT
 {
     vec2 TexCoord;
     vec3 Normal;
     vec3 FragPosition;
+#ifndef NO_SHADOWS
     vec4 FragPosDirectionalLightSpace[MAX_DIRECTIONAL_LIGHTS];
     vec4 FragPosSpotLightSpace[MAX_SPOT_LIGHTS];
+#endif
 } inFrag;
 
 const int OPAQUE = 0;
 const int ALPHA_CUTOUT = 1;
 const int TRANSPARENT = 2;
 
-layout (std140) uniform LightingGeneral
-{
-    vec3 viewPosition;
-    float shadowBias;
-    AmbientLight ambientLight;
-    int totalDirectionalLights;
-    int totalPointLights;
-    int totalSpotLights;
-};
-
-layout (std140) uniform LightingDirectionals
-{
-    DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
-};
-
-layout (std140) uniform LightingPoints
-{
-    PointLight pointLights[MAX_POINT_LIGHTS];
-};
-
-layout (std140) uniform LightingSpots
-{
-   SpotLight spotLights[MAX_SPOT_LIGHTS];
-};
-
 layout (std140) uniform Camera
 {
     float nearPlane;
@@ -183,6 +118,7 @@ uniform int u_MaterialShininess;
 
 vec3 ComputeReflection(vec3 normal, vec3 viewDir);
 vec3 ComputeRefraction(vec3 normal, vec3 viewDir);
+vec3 ComputeSpecular(vec3 lightSpecular, vec3 normal, vec3 lightDir, vec3 viewDir);
 vec3 ComputeDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 baseColor, float shadow);
 vec3 ComputePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 baseColor, float shadow);
 vec3 ComputeSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 baseColor, float shadow);
@@ -204,7 +140,9 @@ void main()
     vec3 viewDir = normalize(viewPosition - inFrag.FragPosition);
 
     vec3 baseColor = diffuseTextureColor.rgb + u_Color.rgb;
+#ifndef NO_REFLECTION
     baseColor += ComputeReflection(normal, viewDir);
+#endif
     
     vec3 result = ComputeAmbientLight(baseColor);
     
@@ -212,6 +150,7 @@ void main()
     {
         float shadow = 0.f;
 
+#ifndef NO_SHADOWS
         if(directionalLights[i].CastShadow == 1)
         {
             shadow = ComputeDirectionalShadow(
@@ -222,6 +161,7 @@ void main()
                 directionalLights[i].normalBias,
                 u_DirectionalLightShadowMaps[i]);
         }
+#endif
 
         result += ComputeDirectionalLight(directionalLights[i], normal, viewDir, baseColor, shadow);
     }
@@ -230,10 +170,12 @@ void main()
     {
         float shadow = 0.f;
         
+#ifndef NO_SHADOWS
         if(pointLights[i].CastShadow == 1)
         {
             shadow = ComputePointShadow(inFrag.FragPosition, pointLights[i].position, u_PointLightShadowMaps[i]);
         }
+#endif
 
         result += ComputePointLight(pointLights[i], normal, inFrag.FragPosition, viewDir, baseColor, shadow);
     }
@@ -242,10 +184,12 @@ void main()
     {
         float shadow = 0.f;
         
+#ifndef NO_SHADOWS
         if(spotLights[i].CastShadow == 1)
         {
             shadow = ComputeSpotShadow(inFrag.FragPosSpotLightSpace[i], u_SpotLightShadowMaps[i]);
         }
+#endif
 
         result += ComputeSpotLight(spotLights[i], normal, inFrag.FragPosition, viewDir, baseColor, shadow);
     }
@@ -289,12 +233,7 @@ vec3 ComputeDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir,
     float diffuseValue = max(dot(normal, lightDir), 0.f);
     vec3 diffuse = light.diffuse * diffuseValue * baseColor;
     
-    // Specular
-    // For blinn approach, instead of doing dot product between reflection and viewDir
-    // we do between normal and halfwayDir    
-    vec3 halfwayDir = normalize(lightDir + viewDir);
-    float specularValue = pow(max(dot(normal, halfwayDir), 0.f), u_MaterialShininess);
-    vec3 specular = light.specular * specularValue * vec3(texture(u_Specular, inFrag.TexCoord));
+    vec3 specular = ComputeSpecular(light.specular, normal, lightDir, viewDir);
     
     return (1.f - shadow) * ((diffuse + specular) * light.intensity);
 }
@@ -317,9 +256,7 @@ vec3 ComputePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir
     diffuse *= attenuation;
     
     // Specular
-    vec3 halfwayDir = normalize(lightDir + viewDir);
-    float specularValue = pow(max(dot(normal, halfwayDir), 0), u_MaterialShininess);
-    vec3 specular = light.specular * specularValue * vec3(texture(u_Specular, inFrag.TexCoord));
+    vec3 specular = ComputeSpecular(light.specular, normal, lightDir, viewDir);
     specular *= attenuation;
     
     return (1.f - shadow) * ((diffuse + specular) * light.intensity);
@@ -350,14 +287,26 @@ vec3 ComputeSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir,
     diffuse *= intensity;
     
     // Specular
-    vec3 halfwayDir = normalize(lightDir + viewDir);
-    float specularValue = pow(max(dot(normal, halfwayDir), 0), u_MaterialShininess);
-    vec3 specular = light.specular * specularValue * vec3(texture(u_Specular, inFrag.TexCoord));
+    vec3 specular = ComputeSpecular(light.specular, normal, lightDir, viewDir);
     specular *= intensity;
     
     return (1.f - shadow) * ((diffuse + specular) * light.intensity);
 }
 
+vec3 ComputeSpecular(vec3 lightSpecular, vec3 normal, vec3 lightDir, vec3 viewDir)
+{
+#ifdef NO_SPECULAR_MAP
+    return vec3(0.f);
+#else
+    // For blinn approach, instead of doing dot product between reflection and viewDir
+    // we do between normal and halfwayDir
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float specularValue = pow(max(dot(normal, halfwayDir), 0.f), u_MaterialShininess);
+
+    return lightSpecular * specularValue * vec3(texture(u_Specular, inFrag.TexCoord));
+#endif
+}
+
 vec3 ComputeAmbientLight(vec3 baseColor)
 {
     return baseColor * ambientLight.color;
@@ -4,7 +4,10 @@
 layout(location = 0) in vec4 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in mat4 a_InstanceModelMatrix;    
+#include "Include/InstanceTransform.glsl"
+
+// Keep depth identical to the pre-pass one (tested with GL_EQUAL)
+invariant gl_Position;
 
 out vec2 v_TexCoord;
 
@@ -16,7 +19,7 @@ layout (std140) uniform Matrices
 
 void main()
 {
-    gl_Position = projection * view * a_InstanceModelMatrix * a_Position; // Instancing approach
+    gl_Position = projection * view * vec4(GetInstanceWorldPosition(a_Position), 1.f); // Instancing approach
     // gl_Position = u_Proj * u_View * u_Model * a_Position; // Uniform approach
     
     v_TexCoord = a_TexCoord;
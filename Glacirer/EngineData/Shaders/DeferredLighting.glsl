@@ -0,0 +1,312 @@
+#shader vertex
+#version 330 core
+
+// G-buffer comes from the render target pool, UVs are scaled to the region rendered into
+#include "Include/ScreenQuad.glsl"
+
+#shader fragment
+#version 330 core
+
+#include "Include/Lighting.glsl"
+
+layout(location = 0) out vec4 o_Color;
+
+in vec2 v_UV;
+
+layout (std140) uniform DirectionalLightShadowMapMatrices
+{
+    mat4 directionalLightViewProjectionMatrices[MAX_DIRECTIONAL_LIGHTS];
+};
+
+layout (std140) uniform SpotLightShadowMapMatrices
+{
+    mat4 spotLightViewProjectionMatrices[MAX_SPOT_LIGHTS];
+};
+
+layout (std140) uniform Camera
+{
+    float nearPlane;
+    float farPlane;
+};
+
+// Global Environment
+uniform sampler2D u_DirectionalLightShadowMaps[MAX_DIRECTIONAL_LIGHTS];
+uniform samplerCube u_PointLightShadowMaps[MAX_POINT_LIGHTS];
+uniform sampler2D u_SpotLightShadowMaps[MAX_SPOT_LIGHTS];
+
+// G-buffer
+uniform sampler2D u_GAlbedo;
+uniform sampler2D u_GPosition;
+uniform sampler2D u_GNormal;
+uniform sampler2D u_GSpecular;
+
+vec3 ComputeDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 baseColor, vec3 specularColor, float shininess, float shadow);
+vec3 ComputePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 baseColor, vec3 specularColor, float shininess, float shadow);
+vec3 ComputeSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 baseColor, vec3 specularColor, float shininess, float shadow);
+vec3 ComputeAmbientLight(vec3 baseColor);
+float ComputeDirectionalShadow(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, float bias, float normalBias, sampler2D shadowMap);
+float ComputePointShadow(vec3 fragPos, vec3 lightPosition, samplerCube shadowMap);
+float ComputeSpotShadow(vec4 fragPosLightSpace, sampler2D shadowMap);
+
+void main()
+{
+    vec4 positionSample = texture(u_GPosition, v_UV);
+
+    // Nothing was written on G-buffer for this pixel, keep the framebuffer clear color
+    if(positionSample.a == 0.f)
+    {
+        discard;
+    }
+
+    vec4 normalSample = texture(u_GNormal, v_UV);
+
+    vec3 fragPosition = positionSample.xyz;
+    vec3 normal = normalize(normalSample.xyz);
+    float shininess = normalSample.w;
+    vec3 baseColor = texture(u_GAlbedo, v_UV).rgb;
+    vec3 specularColor = texture(u_GSpecular, v_UV).rgb;
+    vec3 viewDir = normalize(viewPosition - fragPosition);
+    vec4 worldPosition = vec4(fragPosition, 1.f);
+
+    vec3 result = ComputeAmbientLight(baseColor);
+    
+    for(int i = 0; i < totalDirectionalLights; i++)
+    {
+        float shadow = 0.f;
+
+        if(directionalLights[i].CastShadow == 1)
+        {
+            shadow = ComputeDirectionalShadow(
+                directionalLightViewProjectionMatrices[i] * worldPosition,
+                normal,
+                directionalLights[i].direction,
+                directionalLights[i].bias,
+                directionalLights[i].normalBias,
+                u_DirectionalLightShadowMaps[i]);
+        }
+
+        result += ComputeDirectionalLight(directionalLights[i], normal, viewDir, baseColor, specularColor, shininess, shadow);
+    }
+    
+    for(int i = 0; i < totalPointLights; i++)
+    {
+        float shadow = 0.f;
+        
+        if(pointLights[i].CastShadow == 1)
+        {
+            shadow = ComputePointShadow(fragPosition, pointLights[i].position, u_PointLightShadowMaps[i]);
+        }
+
+        result += ComputePointLight(pointLights[i], normal, fragPosition, viewDir, baseColor, specularColor, shininess, shadow);
+    }
+    
+    for(int i = 0; i < totalSpotLights; i++)
+    {
+        float shadow = 0.f;
+        
+        if(spotLights[i].CastShadow == 1)
+        {
+            shadow = ComputeSpotShadow(spotLightViewProjectionMatrices[i] * worldPosition, u_SpotLightShadowMaps[i]);
+        }
+
+        result += ComputeSpotLight(spotLights[i], normal, fragPosition, viewDir, baseColor, specularColor, shininess, shadow);
+    }
+
+    o_Color = vec4(result, 1.f);
+}
+
+vec3 ComputeDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 baseColor, vec3 specularColor, float shininess, float shadow)
+{
+    // Diffuse
+    vec3 lightDir = normalize(-light.direction);
+    float diffuseValue = max(dot(normal, lightDir), 0.f);
+    vec3 diffuse = light.diffuse * diffuseValue * baseColor;
+    
+    // Specular
+    // For blinn approach, instead of doing dot product between reflection and viewDir
+    // we do between normal and halfwayDir    
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float specularValue = pow(max(dot(normal, halfwayDir), 0.f), shininess);
+    vec3 specular = light.specular * specularValue * specularColor;
+    
+    return (1.f - shadow) * ((diffuse + specular) * light.intensity);
+}
+
+vec3 ComputePointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 baseColor, vec3 specularColor, float shininess, float shadow)
+{
+    // Attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.f / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    
+    if(attenuation <= 0.f)
+    {
+        return vec3(0.f);
+    }
+    
+    // Diffuse
+    vec3 lightDir = normalize(light.position - fragPos);
+    float diffuseValue = max(dot(normal, lightDir), 0.f);
+    vec3 diffuse = light.diffuse * diffuseValue * baseColor;
+    diffuse *= attenuation;
+    
+    // Specular
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float specularValue = pow(max(dot(normal, halfwayDir), 0), shininess);
+    vec3 specular = light.specular * specularValue * specularColor;
+    specular *= attenuation;
+    
+    return (1.f - shadow) * ((diffuse + specular) * light.intensity);
+}
+
+vec3 ComputeSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, vec3 baseColor, vec3 specularColor, float shininess, float shadow)
+{
+    // Attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.f / (light.constant + light.linear * distance + light.quadratic * (distance * distance));
+    
+    if(attenuation <= 0.f)
+    {
+        return vec3(0.f);
+    }
+    
+    vec3 lightDir = normalize(light.position - fragPos);
+    
+    float theta = dot(lightDir, normalize(-light.direction));
+    // To smooth edge
+    float epsilon = light.cutoff - light.outerCutoff;
+    float intensity = clamp((theta - light.outerCutoff) / epsilon, 0.f, 1.f);
+    intensity *= attenuation;
+    
+    // Diffuse
+    float diffuseValue = max(dot(normal, lightDir), 0.f);
+    vec3 diffuse = light.diffuse * diffuseValue * baseColor;
+    diffuse *= intensity;
+    
+    // Specular
+    vec3 halfwayDir = normalize(lightDir + viewDir);
+    float specularValue = pow(max(dot(normal, halfwayDir), 0), shininess);
+    vec3 specular = light.specular * specularValue * specularColor;
+    specular *= intensity;
+    
+    return (1.f - shadow) * ((diffuse + specular) * light.intensity);
+}
+
+vec3 ComputeAmbientLight(vec3 baseColor)
+{
+    return baseColor * ambientLight.color;
+}
+
+float ComputeDirectionalShadow(vec4 fragPosLightSpace, vec3 normal, vec3 lightDir, float bias, float normalBias, sampler2D shadowMap)
+{
+    // Perform perspective devide, raging from [-1, 1]
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+
+    // If projected coordinate is further than light's far plane (shadow distance), return no shadow (lit)
+    if(projCoords.z > 1.0)
+    {
+        return 0.f;
+    }
+    
+    // To use our depth map that ranges from [0, 1], we need to transform the NDC coordinates to the range [0, 1] as well
+    projCoords = projCoords * 0.5f + 0.5f;
+
+    float currentDepth = projCoords.z;
+
+    // Bias to fix shadow acne
+    float finalBias = max(normalBias * (1.0 - dot(normal, lightDir)), bias);
+
+    // Apply PCF (percentage-closer filtering)
+    float shadow = 0.f;
+    vec2 texelSize = 1.f / textureSize(shadowMap, 0);
+    for(int x = -1; x <= 1; x++)
+    {
+        for(int y = -1; y <= 1; y++)
+        {
+            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+            shadow += currentDepth - finalBias > pcfDepth ? 1.f : 0.f;
+        }
+    }
+
+    // Average by total samples
+    shadow /= 9.f;
+
+    // Returns 1.f if fragment is in shadow or 0.f if not in shadow
+    return shadow;
+}
+
+float ComputePointShadow(vec3 fragPos, vec3 lightPosition, samplerCube shadowMap)
+{
+    vec3 fragToLight = fragPos - lightPosition;
+    float currentDepth = length(fragToLight);
+
+    vec3 sampleOffsetDirections[20] = vec3[]
+    (
+        vec3( 1,  1,  1), vec3( 1, -1,  1), vec3(-1, -1,  1), vec3(-1,  1,  1), 
+        vec3( 1,  1, -1), vec3( 1, -1, -1), vec3(-1, -1, -1), vec3(-1,  1, -1),
+        vec3( 1,  1,  0), vec3( 1, -1,  0), vec3(-1, -1,  0), vec3(-1,  1,  0),
+        vec3( 1,  0,  1), vec3(-1,  0,  1), vec3( 1,  0, -1), vec3(-1,  0, -1),
+        vec3( 0,  1,  1), vec3( 0, -1,  1), vec3( 0, -1, -1), vec3( 0,  1, -1)
+    );
+
+    float shadow = 0.f;
+    float bias = 0.01f;
+    int totalSamples = 20;
+    float viewDistance = length(viewPosition - fragPos);
+    // float diskRadius = (1.f + (viewDistance / farPlane)) / 25.f;
+    float diskRadius = 0.01f;
+
+    for(int i = 0; i < totalSamples; i++)
+    {
+        float closestDepth = texture(shadowMap, fragToLight + sampleOffsetDirections[i] * diskRadius).r;
+
+        // Closest depth is currently in [0, 1] range, transform back to [0, farPlane] range
+        closestDepth *= farPlane;
+
+        if(currentDepth - bias > closestDepth)
+        {
+            shadow += 1.f;
+        }
+    }
+
+    shadow /= float(totalSamples);
+
+    return shadow;
+}
+
+float ComputeSpotShadow(vec4 fragPosLightSpace, sampler2D shadowMap)
+{
+    // Perform perspective devide, raging from [-1, 1]
+    vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+
+    // If projected coordinate is further than light's far plane (shadow distance), return no shadow (lit)
+    if(projCoords.z > 1.0)
+    {
+        return 0.f;
+    }
+    
+    // To use our depth map that ranges from [0, 1], we need to transform the NDC coordinates to the range [0, 1] as well
+    projCoords = projCoords * 0.5f + 0.5f;
+
+    float currentDepth = projCoords.z;
+
+    // Bias to fix shadow acne
+    float bias = 0.0001f;
+
+    // Apply PCF (percentage-closer filtering)
+    float shadow = 0.f;
+    vec2 texelSize = 1.f / textureSize(shadowMap, 0);
+    for(int x = -1; x <= 1; x++)
+    {
+        for(int y = -1; y <= 1; y++)
+        {
+            float pcfDepth = texture(shadowMap, projCoords.xy + vec2(x, y) * texelSize).r;
+            shadow += currentDepth - bias > pcfDepth ? 1.f : 0.f;
+        }
+    }
+
+    // Average by total samples
+    shadow /= 9.f;
+
+    // Returns 1.f if fragment is in shadow or 0.f if not in shadow
+    return shadow;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 a_Position;
+#include "Include/InstanceTransform.glsl"
+
+// Must match opaque shaders position output bit by bit, lit pass is tested with GL_EQUAL against this depth
+invariant gl_Position;
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+void main()
+{
+    gl_Position = projection * view * vec4(GetInstanceWorldPosition(a_Position), 1.f);
+}
+
+#shader fragment
+#version 330 core
+
+void main()
+{
+}
@@ -0,0 +1,89 @@
+#shader vertex
+#version 330 core
+
+layout(location = 0) in vec4 a_Position;
+layout(location = 1) in vec3 a_Normal;
+layout(location = 2) in vec2 a_TexCoord;
+#include "Include/InstanceTransform.glsl"
+
+out VS_OUT
+{
+    vec2 TexCoord;
+    vec3 Normal;
+    vec3 FragPosition;
+} vsOut;
+
+layout (std140) uniform Matrices
+{
+    mat4 projection;
+    mat4 view;
+};
+
+void main()
+{
+    vsOut.FragPosition = GetInstanceWorldPosition(a_Position);
+    vsOut.TexCoord = a_TexCoord;
+    vsOut.Normal = GetInstanceWorldNormal(a_Normal);
+
+    gl_Position = projection * view * vec4(vsOut.FragPosition, 1.f);
+}
+
+#shader fragment
+#version 330 core
+
+struct AmbientLight
+{
+    vec3 color;
+};
+
+// Each output matches one of the G-buffer color attachments
+layout(location = 0) out vec4 o_Albedo;
+layout(location = 1) out vec4 o_Position;
+layout(location = 2) out vec4 o_Normal;
+layout(location = 3) out vec4 o_Specular;
+
+in VS_OUT
+{
+    vec2 TexCoord;
+    vec3 Normal;
+    vec3 FragPosition;
+} inFrag;
+
+layout (std140) uniform LightingGeneral
+{
+    vec3 viewPosition;
+    float shadowBias;
+    AmbientLight ambientLight;
+    int totalDirectionalLights;
+    int totalPointLights;
+    int totalSpotLights;
+};
+
+// Global Environment
+uniform samplerCube u_Skybox;
+
+// Material
+uniform vec4 u_Color;
+uniform sampler2D u_Diffuse;
+uniform sampler2D u_Specular;
+uniform float u_ReflectionValue;
+uniform int u_MaterialShininess;
+
+void main()
+{
+    vec3 normal = normalize(inFrag.Normal);
+    vec3 viewDir = normalize(viewPosition - inFrag.FragPosition);
+
+    // Reflection only depends on the surface and view, so we bake it on the base color here
+    // instead of carrying the reflection value to the lighting pass
+    vec3 reflectionDir = reflect(-viewDir, normal);
+    vec3 baseColor = texture(u_Diffuse, inFrag.TexCoord).rgb + u_Color.rgb;
+    baseColor += texture(u_Skybox, reflectionDir).rgb * u_ReflectionValue;
+
+    o_Albedo = vec4(baseColor, 1.f);
+
+    // Position alpha is used by the lighting pass to know a fragment was written (cleared to 0)
+    o_Position = vec4(inFrag.FragPosition, 1.f);
+    o_Normal = vec4(normal, float(u_MaterialShininess));
+    o_Specular = vec4(texture(u_Specular, inFrag.TexCoord).rgb, 1.f);
+}
@@ -0,0 +1,21 @@
+// Per instance transform of meshes drawn by RenderSystem. Only the first three rows of the model matrix are streamed,
+// the last one of an affine transform is always (0, 0, 0, 1)
+
+layout(location = 3) in mat3x4 a_InstanceModelRows;
+
+vec3 GetInstanceWorldPosition(vec4 localPosition)
+{
+    // Row vector on the left, each component is the dot product with a model matrix row
+    return localPosition * a_InstanceModelRows;
+}
+
+// Instance matrices only translate, rotate and scale along the object axes (dequantization included), never shear.
+// Inverse transpose of such a matrix is the matrix itself with each axis divided by its squared length,
+// which saves a full inverse on every vertex
+vec3 GetInstanceWorldNormal(vec3 localNormal)
+{
+    mat3 model = transpose(mat3(a_InstanceModelRows[0].xyz, a_InstanceModelRows[1].xyz, a_InstanceModelRows[2].xyz));
+    vec3 inverseSquaredScale = 1.f / vec3(dot(model[0], model[0]), dot(model[1], model[1]), dot(model[2], model[2]));
+
+    return model * (localNormal * inverseSquaredScale);
+}
@@ -0,0 +1,23 @@
+// Convolution of the 3x3 neighbourhood of v_UV, needs v_UV declared and ScreenSampling.glsl included before
+//
+// With kernels (or convolution matrix) we can do some cool effects by multiplying each surrounding pixel
+// by the corresponding kernel position value and then adding them all up as the final color.
+// If the kernel values don't sum up to 1, texture color ends up brighter or darker than original texture value
+
+vec3 ApplyKernel(float[9] kernel)
+{
+    vec2 texelSize = 1.f / vec2(textureSize(u_ScreenTexture, 0));
+    vec3 color = vec3(0.f);
+
+    for(int y = 0; y < 3; y++)
+    {
+        for(int x = 0; x < 3; x++)
+        {
+            // Kernels are written top row first, while v grows upwards
+            vec2 offset = vec2(x - 1, 1 - y) * texelSize;
+            color += SampleScreen(v_UV + offset) * kernel[y * 3 + x];
+        }
+    }
+
+    return color;
+}
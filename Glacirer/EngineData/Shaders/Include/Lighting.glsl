@@ -0,0 +1,74 @@
+// Light layouts shared with LightingSystem, which fills the uniform blocks below (std140)
+
+struct DirectionalLight
+{
+    float intensity;
+    float bias;
+    float normalBias;
+    int CastShadow;
+    vec3 direction;
+    vec3 diffuse;
+    vec3 specular;    
+};
+
+struct PointLight
+{
+    vec3 position;
+    float constant;
+    float linear;
+    float quadratic;
+
+    int CastShadow;
+    
+    vec3 diffuse;
+    vec3 specular;
+    
+    float intensity;
+};
+
+struct SpotLight
+{
+    vec3 position;
+    int CastShadow;
+    vec3 direction;
+    float cutoff;
+    float outerCutoff;
+    float constant;
+    float linear;
+    float quadratic;
+    
+    vec3 diffuse;
+    vec3 specular;
+    
+    float intensity;
+};
+
+struct AmbientLight
+{
+    vec3 color;
+};
+
+layout (std140) uniform LightingGeneral
+{
+    vec3 viewPosition;
+    float shadowBias;
+    AmbientLight ambientLight;
+    int totalDirectionalLights;
+    int totalPointLights;
+    int totalSpotLights;
+};
+
+layout (std140) uniform LightingDirectionals
+{
+    DirectionalLight directionalLights[MAX_DIRECTIONAL_LIGHTS];
+};
+
+layout (std140) uniform LightingPoints
+{
+    PointLight pointLights[MAX_POINT_LIGHTS];
+};
+
+layout (std140) uniform LightingSpots
+{
+   SpotLight spotLights[MAX_SPOT_LIGHTS];
+};
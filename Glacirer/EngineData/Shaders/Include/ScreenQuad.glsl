@@ -0,0 +1,16 @@
+// Vertex stage of fullscreen passes drawing Primitive::CreateScreenQuad.
+// u_UVScale maps the quad onto the region of u_ScreenTexture holding the image, pooled targets
+// are usually allocated larger than what was rendered into them (see RenderTargetPool)
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec2 a_UV;
+
+uniform vec2 u_UVScale;
+
+out vec2 v_UV;
+
+void main()
+{
+    gl_Position = vec4(a_Position, 1.f);
+    v_UV = a_UV * u_UVScale;
+}
@@ -0,0 +1,12 @@
+// Reads of u_ScreenTexture for fullscreen passes, needs u_ScreenTexture declared before including.
+// Coordinates are clamped to the rendered region (u_UVScale, see ScreenQuad.glsl) so neighbour taps
+// and bilinear filtering never pick the unused texels around it
+
+uniform vec2 u_UVScale;
+
+vec3 SampleScreen(vec2 uv)
+{
+    vec2 halfTexelSize = 0.5f / vec2(textureSize(u_ScreenTexture, 0));
+
+    return texture(u_ScreenTexture, clamp(uv, halfTexelSize, u_UVScale - halfTexelSize)).rgb;
+}
@@ -3,7 +3,7 @@
 
 layout(location = 0) in vec4 a_Position;
 layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in mat4 a_InstanceModelMatrix;
+#include "Include/InstanceTransform.glsl"
 
 out vec2 v_TexCoord;
 
@@ -11,7 +11,7 @@ void main()
 {
     // Since the geometry shader will transform all vertices in all light space coordinates
     // we only need to transform in world space during the vertex shader
-    gl_Position = a_InstanceModelMatrix * a_Position;
+    gl_Position = vec4(GetInstanceWorldPosition(a_Position), 1.f);
 
     v_TexCoord = a_TexCoord;
 }
@@ -22,8 +22,6 @@ void main()
 layout (triangles) in;
 layout (triangle_strip, max_vertices=18) out;
 
-#define MAX_POINT_LIGHTS 20
-
 struct PointLightShadowMapData
 {
     mat4 viewProjectionMatrices[6];
@@ -67,8 +65,6 @@ void main()
 #shader fragment
 #version 330 core
 
-#define MAX_POINT_LIGHTS 20
-
 in vec4 v_FragPos;
 in vec2 g_TexCoord;
 
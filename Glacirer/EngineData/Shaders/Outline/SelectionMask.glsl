@@ -0,0 +1,15 @@
+#shader vertex
+#version 330 core
+
+#include "../Include/ScreenQuad.glsl"
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out float o_Mask;
+
+// Drawn with stencil test against the value selected objects wrote, so only their pixels reach the mask
+void main()
+{
+    o_Mask = 1.f;
+}
@@ -0,0 +1,45 @@
+#shader vertex
+#version 330 core
+
+#include "../Include/ScreenQuad.glsl"
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 o_Color;
+
+uniform sampler2D u_ScreenTexture; // Selection mask
+uniform vec4 u_OutlineColor;
+uniform float u_OutlineWidth; // In pixels
+
+in vec2 v_UV;
+
+#include "../Include/ScreenSampling.glsl"
+
+// Dilates the mask with a fixed round footprint stretched to the outline width, the outline is
+// what the dilation adds around the selection. Taps fall between texels, bilinear filtering
+// softens the outer edge a bit
+void main()
+{
+    vec2 texelSize = 1.f / vec2(textureSize(u_ScreenTexture, 0));
+    vec2 stepSize = texelSize * u_OutlineWidth * 0.5f;
+
+    float coverage = SampleScreen(v_UV).r;
+    float dilatedCoverage = coverage;
+
+    for(int y = -2; y <= 2; y++)
+    {
+        for(int x = -2; x <= 2; x++)
+        {
+            if(x * x + y * y > 5)
+            {
+                continue;
+            }
+
+            dilatedCoverage = max(dilatedCoverage, SampleScreen(v_UV + vec2(x, y) * stepSize).r);
+        }
+    }
+
+    float outline = clamp(dilatedCoverage - coverage, 0.f, 1.f);
+    o_Color = vec4(u_OutlineColor.rgb, u_OutlineColor.a * outline);
+}
@@ -4,7 +4,10 @@
 layout(location = 0) in vec4 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in mat4 a_InstanceModelMatrix;    
+#include "Include/InstanceTransform.glsl"
+
+// Same position output as depth pre-pass
+invariant gl_Position;
 
 out VS_OUT
 {
@@ -24,18 +27,17 @@ layout (std140) uniform Matrices
 
 void main()
 {
-    gl_Position = projection * view * a_InstanceModelMatrix * a_Position; // Instancing approach
+    gl_Position = projection * view * vec4(GetInstanceWorldPosition(a_Position), 1.f); // Instancing approach
 
     // Set pointSize when rendering with GL_POINTS
     //gl_PointSize = gl_Position.z;
     
     vsOut.TexCoord = a_TexCoord;
     
-    // Normal attribute is on local space, we need to convert it to world by using the model matrix
-    // But since normal is a direction, it doesn't make sense to translate it, so we cut it by casting to a mat3
-    // We also need to take care of non-uniform scale so it doesn't mess with the actual direction, hence the transpose of inverse    
-    vsOut.Normal = mat3(transpose(inverse(a_InstanceModelMatrix))) * a_Normal;
-    vsOut.FragPosition = vec3(a_InstanceModelMatrix * a_Position);
+    // Normal attribute is on local space, it's a direction so only rotation and scale apply.
+    // Non-uniform scale is undone on the normal so it stays perpendicular to the surface
+    vsOut.Normal = GetInstanceWorldNormal(a_Normal);
+    vsOut.FragPosition = GetInstanceWorldPosition(a_Position);
 }
 
 #shader fragment
@@ -92,10 +94,6 @@ in VS_OUT
     vec3 FragPosition;
 } inFrag;
 
-#define MAX_DIRECTIONAL_LIGHTS 3
-#define MAX_POINT_LIGHTS 20
-#define MAX_SPOT_LIGHTS 20
-
 const int OPAQUE = 0;
 const int ALPHA_CUTOUT = 1;
 const int TRANSPARENT = 2;
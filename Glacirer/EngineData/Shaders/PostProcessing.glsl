@@ -1,29 +1,19 @@
 #shader vertex
 #version 330 core
 
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec2 a_UV;    
-
-out vec2 v_UV;
-
-void main()
-{
-    gl_Position = vec4(a_Position, 1.f);
-    v_UV = a_UV;
-}
+#include "Include/ScreenQuad.glsl"
 
 #shader fragment
 #version 330 core
 
 layout(location = 0) out vec4 o_Color;
 
+// Last step of the post-processing chain (see PostProcessingSystem), per pixel effects that
+// don't need neighbours are done here so they never need a target of their own
 struct PostProcessing
 {
     bool ColorInversionEnabled;
     bool GrayScaleEnabled;
-    bool SharpenEnabled;
-    bool BlurEnabled;
-    bool EdgeDetectionEnabled;
     float Gamma;
 };
 
@@ -32,22 +22,7 @@ uniform PostProcessing u_PostProcessing;
 
 in vec2 v_UV;
 
-const float sampleOffset = 1.f / 300.f;
-
-// We are using a kernel of 3x3, so we need 9 uv offsets to sample texture from
-const vec2 offsets[9] = vec2[](
-    vec2(-sampleOffset, sampleOffset), // top-left
-    vec2(0.f, sampleOffset), // top-center
-    vec2(sampleOffset, sampleOffset), // top-right
-    vec2(-sampleOffset, 0.f),  // center-left
-    vec2(0.f, 0.f), // center-center
-    vec2(sampleOffset, 0.f), // center-right
-    vec2(-sampleOffset, -sampleOffset), // bottom-left
-    vec2(0.f, -sampleOffset), // bottom-center
-    vec2(sampleOffset, -sampleOffset) // bottom-right
-);
-
-vec3 ApplyKernel(float[9] kernel);
+#include "Include/ScreenSampling.glsl"
 
 void main()
 {      
@@ -55,47 +30,9 @@ void main()
     // vec4 colorResult = texture(u_ScreenTexture, v_UV);
 
     // With gamma correction from shader
-    vec4 colorResult = texture(u_ScreenTexture, v_UV);
+    vec4 colorResult = vec4(SampleScreen(v_UV), 1.f);
     colorResult.rgb = pow(colorResult.rgb, vec3(1.0/u_PostProcessing.Gamma));
     
-    if(u_PostProcessing.SharpenEnabled)
-    {
-        // With kernels (or convolution matrix) we can do some cool effects by multiplying each surrounding pixel
-        // by the corresponding kernel position value and then adding them all up as the final color
-        // there are a lot of kernel examples online
-        // the center value (9) is used for the current pixel and the -1 for the 8 surrounding pixels around it
-        // If the kernel values sum up is not 1, texture color ends up brighter or darker than original texture value
-        float kernel[9] = float[](
-            -1.f, -1.f, -1.f,
-            -1.f,  9.f, -1.f,
-            -1.f, -1.f, -1.f
-        );
-        
-        colorResult = vec4(ApplyKernel(kernel), 1.f);
-    }
-    
-    if(u_PostProcessing.BlurEnabled)
-    {
-        float kernel[9] = float[](
-            1.f / 16.f, 2.f / 16.f, 1.f / 16.f,
-            2.f / 16.f, 4.f / 16.f, 2.f / 16.f,
-            1.f / 16.f, 2.f / 16.f, 1.f / 16.f
-        );
-        
-        colorResult = vec4(ApplyKernel(kernel), 1.f);
-    }
-    
-    if(u_PostProcessing.EdgeDetectionEnabled)
-    {
-        float kernel[9] = float[](
-            1.f,  1.f,  1.f,
-            1.f, -8.f,  1.f,
-            1.f,  1.f,  1.f
-        );
-        
-        colorResult = vec4(ApplyKernel(kernel), 1.f);
-    }
-    
     if(u_PostProcessing.ColorInversionEnabled)
     {
         colorResult = vec4(vec3(1.f - colorResult.xyz), 1.f);
@@ -113,22 +50,3 @@ void main()
         
     o_Color = colorResult;
 }
-
-vec3 ApplyKernel(float[9] kernel)
-{
-    // Get the surrounding texture values
-    vec3 sampleTex[9];        
-    for(int i = 0; i < 9; i++)
-    {
-        sampleTex[i] = vec3(texture(u_ScreenTexture, v_UV.xy + offsets[i]));
-    }
-    
-    // // Now we multiply each sample value by the corresponding kernel value and add them all        
-    vec3 color = vec3(0.f);
-    for(int i = 0; i < 9; i++)
-    {
-        color += sampleTex[i] * kernel[i];
-    }
-    
-    return color;
-}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#shader vertex
+#version 330 core
+
+#include "../Include/ScreenQuad.glsl"
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 o_Color;
+
+uniform sampler2D u_ScreenTexture;
+uniform float u_DownsampleFactor; // Source texels per target texel on each axis, 2 or 4
+
+in vec2 v_UV;
+
+#include "../Include/ScreenSampling.glsl"
+
+// Box filter over the source texels covered by the target texel. Taps are a quarter of a target texel
+// away from its center, so each one lands between 2x2 source texels (or on a texel at 2x) and bilinear
+// filtering averages them, a single tap would skip texels and alias at quarter resolution
+void main()
+{
+    vec2 offset = 0.25f * u_DownsampleFactor / vec2(textureSize(u_ScreenTexture, 0));
+
+    vec3 color = SampleScreen(v_UV + vec2(-offset.x, -offset.y));
+    color += SampleScreen(v_UV + vec2(offset.x, -offset.y));
+    color += SampleScreen(v_UV + vec2(-offset.x, offset.y));
+    color += SampleScreen(v_UV + vec2(offset.x, offset.y));
+
+    o_Color = vec4(color * 0.25f, 1.f);
+}
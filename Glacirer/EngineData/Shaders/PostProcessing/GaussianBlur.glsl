@@ -0,0 +1,39 @@
+#shader vertex
+#version 330 core
+
+#include "../Include/ScreenQuad.glsl"
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 o_Color;
+
+uniform sampler2D u_ScreenTexture;
+uniform bool u_Horizontal;
+
+in vec2 v_UV;
+
+#include "../Include/ScreenSampling.glsl"
+
+// 9 tap gaussian run once per axis, so a 9x9 blur costs 2 * 5 samples instead of 81. Source has the
+// resolution of the pass (downsampled first if needed), so texel size is the same in both passes.
+// Neighbour taps are merged in pairs by sampling in between texels and letting
+// bilinear filtering weight them, which is why offsets aren't whole texels
+const float offsets[3] = float[](0.f, 1.3846153846f, 3.2307692308f);
+const float weights[3] = float[](0.2270270270f, 0.3162162162f, 0.0702702703f);
+
+void main()
+{
+    vec2 texelSize = 1.f / vec2(textureSize(u_ScreenTexture, 0));
+    vec2 direction = u_Horizontal ? vec2(texelSize.x, 0.f) : vec2(0.f, texelSize.y);
+
+    vec3 color = SampleScreen(v_UV) * weights[0];
+
+    for(int i = 1; i < 3; i++)
+    {
+        color += SampleScreen(v_UV + direction * offsets[i]) * weights[i];
+        color += SampleScreen(v_UV - direction * offsets[i]) * weights[i];
+    }
+
+    o_Color = vec4(color, 1.f);
+}
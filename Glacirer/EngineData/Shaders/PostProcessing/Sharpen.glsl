@@ -0,0 +1,28 @@
+#shader vertex
+#version 330 core
+
+#include "../Include/ScreenQuad.glsl"
+
+#shader fragment
+#version 330 core
+
+layout(location = 0) out vec4 o_Color;
+
+uniform sampler2D u_ScreenTexture;
+
+in vec2 v_UV;
+
+#include "../Include/ScreenSampling.glsl"
+#include "../Include/Kernel3x3.glsl"
+
+void main()
+{
+    // The center value (9) is used for the current pixel and the -1 for the 8 surrounding pixels around it
+    float kernel[9] = float[](
+        -1.f, -1.f, -1.f,
+        -1.f,  9.f, -1.f,
+        -1.f, -1.f, -1.f
+    );
+
+    o_Color = vec4(ApplyKernel(kernel), 1.f);
+}
@@ -4,7 +4,7 @@
 layout(location = 0) in vec4 a_Position;
 layout(location = 1) in vec3 a_Normal;
 layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in mat4 a_InstanceModelMatrix;
+#include "../Include/InstanceTransform.glsl"
 
 layout (std140) uniform Matrices
 {
@@ -14,7 +14,7 @@ layout (std140) uniform Matrices
 
 void main()
 {
-    gl_Position = projection * view * a_InstanceModelMatrix * a_Position;
+    gl_Position = projection * view * vec4(GetInstanceWorldPosition(a_Position), 1.f);
 }
 
 #shader fragment
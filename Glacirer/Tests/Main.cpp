@@ -0,0 +1,21 @@
+#include "Engine.h"
+#include "FrameAllocationTest.h"
+
+int main()
+{
+    Glacirer::Engine engine{};
+    engine.Initialize("Glacirer Tests");
+    assert(engine.IsInitialized());
+
+    engine.Setup();
+
+    GlacirerTests::FrameAllocationTest frameAllocationTest{engine};
+    frameAllocationTest.SpawnScene();
+
+    bool bPassed = frameAllocationTest.Run(Glacirer::Rendering::RenderPath::Forward);
+    bPassed = frameAllocationTest.Run(Glacirer::Rendering::RenderPath::Deferred) && bPassed;
+
+    engine.Shutdown();
+
+    return bPassed ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+#include "FrameAllocationTest.h"
+
+#include <iostream>
+#include <string>
+
+#include "AllocationCounter.h"
+#include "Engine.h"
+#include "World.h"
+#include "Basics/Components/MeshComponent.h"
+#include "Basics/Objects/Camera.h"
+#include "Basics/Objects/Cube.h"
+#include "Basics/Objects/DirectionalLight.h"
+#include "Basics/Objects/PointLight.h"
+#include "Basics/Objects/Quad.h"
+#include "Basics/Objects/Sphere.h"
+#include "Basics/Objects/SpotLight.h"
+#include "Rendering/Material.h"
+#include "Resources/ResourceManager.h"
+
+namespace GlacirerTests
+{
+    FrameAllocationTest::FrameAllocationTest(Glacirer::Engine& engine)
+        : m_Engine(engine)
+    { }
+
+    void FrameAllocationTest::SpawnScene()
+    {
+        Glacirer::World& world = m_Engine.GetWorld();
+
+        // Default resources only, the test doesn't depend on sandbox assets or async loads
+        world.Spawn<Glacirer::Camera>(glm::vec3{-12.f, 11.f, 12.f}, glm::vec3{-25.f, -47.f, 0.f});
+
+        std::shared_ptr<Glacirer::Cube> floor = world.Spawn<Glacirer::Cube>(glm::vec3{4.f, -0.75f, 4.f}, glm::vec3{0.f}, glm::vec3{44.f, 0.5f, 44.f});
+        std::shared_ptr<Glacirer::MeshComponent> floorMeshComponent = floor->GetComponent<Glacirer::MeshComponent>().lock();
+        if(floorMeshComponent)
+        {
+            floorMeshComponent->SetIsOccluder(true);
+        }
+
+        for(int x = 0; x < 3; x++)
+        {
+            for(int z = 0; z < 3; z++)
+            {
+                std::shared_ptr<Glacirer::Cube> crate = world.Spawn<Glacirer::Cube>(glm::vec3{static_cast<float>(x) * 2.f, 0.f, static_cast<float>(z) * 2.f});
+                crate->SetMobility(Glacirer::Mobility::Static);
+            }
+        }
+
+        m_MovingCube = world.Spawn<Glacirer::Cube>(glm::vec3{0.f, 5.f, 0.f});
+        world.Spawn<Glacirer::Sphere>(glm::vec3{-4.f, 1.f, 2.f});
+
+        std::shared_ptr<Glacirer::Rendering::Material> windowMaterial = Glacirer::Resources::ResourceManager::CreateMaterial("M_TestWindow");
+        windowMaterial->SetColor("u_Color", glm::vec4{0.2f, 0.4f, 0.8f, 0.5f});
+        windowMaterial->SetRenderingMode(Glacirer::Rendering::MaterialRenderingMode::Transparent);
+
+        for(int i = 0; i < 5; i++)
+        {
+            std::shared_ptr<Glacirer::Quad> windowQuad = world.Spawn<Glacirer::Quad>(glm::vec3{static_cast<float>(i) * 2.f, 0.f, -2.f}, glm::vec3{0.f, -90.f, 0.f});
+            windowQuad->SetMaterial(windowMaterial);
+        }
+
+        world.Spawn<Glacirer::DirectionalLight>(glm::vec3{0.f, 10.f, 0.f}, glm::vec3{-45.f, 30.f, 0.f});
+        world.Spawn<Glacirer::PointLight>(glm::vec3{0.f, 3.f, 2.f});
+
+        std::shared_ptr<Glacirer::SpotLight> spotLight = world.Spawn<Glacirer::SpotLight>(glm::vec3{-4.f, 4.f, -4.f}, glm::vec3{-60.f, 0.f, 0.f});
+        spotLight->SetRange(20.f);
+
+        world.BuildStaticBatches();
+    }
+
+    bool FrameAllocationTest::Run(Glacirer::Rendering::RenderPath renderPath)
+    {
+        const char* renderPathName = renderPath == Glacirer::Rendering::RenderPath::Forward ? "forward" : "deferred";
+
+#ifndef _DEBUG
+        std::cout << "FrameAllocationTest (" << renderPathName << "): SKIPPED, heap allocations are only counted by debug builds\n";
+        return true;
+#else
+        m_Engine.GetWorld().GetRenderSystem().SetRenderPath(renderPath);
+
+        for(int frame = 0; frame < TOTAL_WARM_UP_FRAMES; frame++)
+        {
+            RenderFrame();
+        }
+
+        size_t totalAllocations = 0;
+        int totalAllocatingFrames = 0;
+
+        for(int frame = 0; frame < TOTAL_MEASURED_FRAMES; frame++)
+        {
+            const size_t frameAllocations = RenderFrame();
+
+            if(frameAllocations > 0)
+            {
+                std::cout << "ERROR::FRAME_ALLOCATION_TEST: " << frameAllocations << " heap allocations during " << renderPathName << " frame " << frame << "\n";
+
+                totalAllocations += frameAllocations;
+                totalAllocatingFrames++;
+            }
+        }
+
+        if(totalAllocatingFrames > 0)
+        {
+            std::cout << "FrameAllocationTest (" << renderPathName << "): FAILED, " << totalAllocations << " heap allocations in "
+                      << totalAllocatingFrames << " of " << TOTAL_MEASURED_FRAMES << " frames\n";
+            return false;
+        }
+
+        std::cout << "FrameAllocationTest (" << renderPathName << "): PASSED, no heap allocations in " << TOTAL_MEASURED_FRAMES << " frames\n";
+        return true;
+#endif
+    }
+
+    size_t FrameAllocationTest::RenderFrame()
+    {
+        m_MovingCubeAngle += 1.f;
+        m_MovingCube->GetTransform().SetRotation(glm::vec3{0.f, m_MovingCubeAngle, 0.f});
+
+        // Counts the engine module allocations only, this test code is not part of it
+        const size_t startAllocations = Glacirer::AllocationCounter::GetTotalAllocationsOnCurrentThread();
+
+        m_Engine.Update();
+        m_Engine.Render();
+
+        return Glacirer::AllocationCounter::GetTotalAllocationsOnCurrentThread() - startAllocations;
+    }
+}
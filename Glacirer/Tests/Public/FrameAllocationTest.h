@@ -0,0 +1,40 @@
+#pragma once
+#include <memory>
+
+#include "Rendering/RenderSystem.h"
+
+namespace Glacirer
+{
+    class Engine;
+    class GameObject;
+    class World;
+}
+
+namespace GlacirerTests
+{
+    // Renders a small scene until the frame arena, pools and caches stopped growing, then checks the next frames made no
+    // heap allocations on the main thread. Allocations are only counted by debug builds, release ones skip the check
+    class FrameAllocationTest
+    {
+    public:
+
+        explicit FrameAllocationTest(Glacirer::Engine& engine);
+
+        void SpawnScene();
+        // False if any measured frame allocated
+        bool Run(Glacirer::Rendering::RenderPath renderPath);
+
+    private:
+
+        // Same as the engine own check, render targets of a render path are created by its first frames
+        constexpr static int TOTAL_WARM_UP_FRAMES = 120;
+        constexpr static int TOTAL_MEASURED_FRAMES = 300;
+
+        Glacirer::Engine& m_Engine;
+        std::shared_ptr<Glacirer::GameObject> m_MovingCube{};
+        float m_MovingCubeAngle{0.f};
+
+        // Moves a cube every frame, so transforms, shadows and scene queries have something to update
+        size_t RenderFrame();
+    };
+}